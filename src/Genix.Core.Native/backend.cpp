@@ -0,0 +1,302 @@
+#include "stdafx.h"
+#include "backend.h"
+
+#if !defined(GENIX_BACKEND_DYNAMIC)
+
+// The Visual Studio projects link Intel MKL statically.
+GENIXAPI(const char*, backend_name)()
+{
+	return "mkl";
+}
+
+GENIXAPI(BOOL, backend_select)(const char* name)
+{
+	return name != NULL && ::strcmp(name, "mkl") == 0;
+}
+
+#else
+
+#include <atomic>
+#include <mutex>
+
+#if defined(_WIN32)
+#define __load_library(name)		(void*)::LoadLibraryA(name)
+#define __get_proc(lib, name)		(void*)::GetProcAddress((HMODULE)(lib), name)
+#else
+#include <dlfcn.h>
+#define __load_library(name)		::dlopen(name, RTLD_NOW | RTLD_LOCAL)
+#define __get_proc(lib, name)		::dlsym(lib, name)
+#endif
+
+#ifndef GENIX_BACKEND_DEFAULT
+#define GENIX_BACKEND_DEFAULT		"reference"
+#endif
+
+// the reference implementation, see reference.cpp
+extern const genix_backend __reference_backend;
+
+// loads the first library from a list of candidate names
+static void* __load_first(const char* const* names)
+{
+	for (; *names != NULL; names++)
+	{
+		void* lib = __load_library(*names);
+		if (lib != NULL)
+		{
+			return lib;
+		}
+	}
+
+	return NULL;
+}
+
+// resolves an entry point into a typed function pointer; returns false if it is missing
+template<typename F> static bool __resolve(void* lib, const char* name, F& f)
+{
+	f = reinterpret_cast<F>(__get_proc(lib, name));
+	return f != NULL;
+}
+
+// Intel MKL, single dynamic library
+static bool __load_mkl(genix_backend& backend)
+{
+	static const char* const names[] =
+	{
+#if defined(_WIN32)
+		"mkl_rt.2.dll", "mkl_rt.dll",
+#else
+		"libmkl_rt.so.2", "libmkl_rt.so",
+#endif
+		NULL
+	};
+
+	void* lib = __load_first(names);
+	if (lib == NULL)
+	{
+		return false;
+	}
+
+	backend.name = "mkl";
+	return
+		__resolve(lib, "cblas_sdot", backend.sdot) &&
+		__resolve(lib, "cblas_ddot", backend.ddot) &&
+		__resolve(lib, "cblas_saxpy", backend.saxpy) &&
+		__resolve(lib, "cblas_daxpy", backend.daxpy) &&
+		__resolve(lib, "cblas_saxpby", backend.saxpby) &&
+		__resolve(lib, "cblas_sasum", backend.sasum) &&
+		__resolve(lib, "cblas_dasum", backend.dasum) &&
+		__resolve(lib, "cblas_snrm2", backend.snrm2) &&
+		__resolve(lib, "cblas_dnrm2", backend.dnrm2) &&
+		__resolve(lib, "cblas_sswap", backend.sswap) &&
+		__resolve(lib, "cblas_dswap", backend.dswap) &&
+		__resolve(lib, "cblas_sgemv", backend.sgemv) &&
+		__resolve(lib, "cblas_sger", backend.sger) &&
+		__resolve(lib, "cblas_sgemm", backend.sgemm) &&
+		__resolve(lib, "cblas_sgemm_batch", backend.sgemm_batch) &&
+		__resolve(lib, "cblas_gemm_s8u8s32", backend.gemm_s8u8s32) &&
+		__resolve(lib, "mkl_simatcopy", backend.simatcopy) &&
+		__resolve(lib, "vsAbs", backend.vsAbs) &&
+		__resolve(lib, "vdAbs", backend.vdAbs) &&
+		__resolve(lib, "vsInv", backend.vsInv) &&
+		__resolve(lib, "vsSqr", backend.vsSqr) &&
+		__resolve(lib, "vdSqr", backend.vdSqr) &&
+		__resolve(lib, "vsSqrt", backend.vsSqrt) &&
+		__resolve(lib, "vdSqrt", backend.vdSqrt) &&
+		__resolve(lib, "vsHypot", backend.vsHypot) &&
+		__resolve(lib, "vdHypot", backend.vdHypot) &&
+		__resolve(lib, "vsPowx", backend.vsPowx) &&
+		__resolve(lib, "vdPowx", backend.vdPowx) &&
+		__resolve(lib, "vsLn", backend.vsLn) &&
+		__resolve(lib, "vdLn", backend.vdLn) &&
+		__resolve(lib, "vsExp", backend.vsExp) &&
+		__resolve(lib, "vdExp", backend.vdExp) &&
+		__resolve(lib, "vsSin", backend.vsSin) &&
+		__resolve(lib, "vdSin", backend.vdSin) &&
+		__resolve(lib, "vsCos", backend.vsCos) &&
+		__resolve(lib, "vdCos", backend.vdCos) &&
+		__resolve(lib, "vsAtan2", backend.vsAtan2) &&
+		__resolve(lib, "vdAtan2", backend.vdAtan2) &&
+		__resolve(lib, "vsTanh", backend.vsTanh) &&
+		__resolve(lib, "vsPackI", backend.vsPackI) &&
+		__resolve(lib, "vsUnpackI", backend.vsUnpackI);
+}
+
+// OpenBLAS has a different in-place transposition signature
+typedef void(*__openblas_simatcopy)(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE trans, int rows, int cols, float alpha, float* a, int lda, int ldb);
+static __openblas_simatcopy __openblas_simatcopy_ptr = NULL;
+
+static void __openblas_simatcopy_adapter(char ordering, char trans, size_t rows, size_t cols, float alpha, float* ab, size_t lda, size_t ldb)
+{
+	// some OpenBLAS versions (0.3.21) overrun the heap when scaling a column-major matrix in-place without transposition
+	if (trans != 't' && trans != 'T' && trans != 'c' && trans != 'C')
+	{
+		__reference_backend.simatcopy(ordering, trans, rows, cols, alpha, ab, lda, ldb);
+		return;
+	}
+
+	__openblas_simatcopy_ptr(
+		ordering == 'r' || ordering == 'R' ? CblasRowMajor : CblasColMajor,
+		CblasTrans,
+		int(rows),
+		int(cols),
+		alpha,
+		ab,
+		int(lda),
+		int(ldb));
+}
+
+// OpenBLAS provides BLAS only, vector math comes from the reference implementation;
+// it has no grouped batch interface, the reference one hands the products to OpenBLAS sgemm,
+// and no integer matrix product, the reference one runs the vectorized kernels
+static bool __load_openblas(genix_backend& backend)
+{
+	static const char* const names[] =
+	{
+#if defined(_WIN32)
+		"libopenblas.dll", "openblas.dll",
+#else
+		"libopenblas.so.0", "libopenblas.so",
+#endif
+		NULL
+	};
+
+	void* lib = __load_first(names);
+	if (lib == NULL)
+	{
+		return false;
+	}
+
+	backend.name = "openblas";
+	if (!__resolve(lib, "cblas_simatcopy", __openblas_simatcopy_ptr))
+	{
+		return false;
+	}
+
+	backend.simatcopy = __openblas_simatcopy_adapter;
+
+	return
+		__resolve(lib, "cblas_sdot", backend.sdot) &&
+		__resolve(lib, "cblas_ddot", backend.ddot) &&
+		__resolve(lib, "cblas_saxpy", backend.saxpy) &&
+		__resolve(lib, "cblas_daxpy", backend.daxpy) &&
+		__resolve(lib, "cblas_saxpby", backend.saxpby) &&
+		__resolve(lib, "cblas_sasum", backend.sasum) &&
+		__resolve(lib, "cblas_dasum", backend.dasum) &&
+		__resolve(lib, "cblas_snrm2", backend.snrm2) &&
+		__resolve(lib, "cblas_dnrm2", backend.dnrm2) &&
+		__resolve(lib, "cblas_sswap", backend.sswap) &&
+		__resolve(lib, "cblas_dswap", backend.dswap) &&
+		__resolve(lib, "cblas_sgemv", backend.sgemv) &&
+		__resolve(lib, "cblas_sger", backend.sger) &&
+		__resolve(lib, "cblas_sgemm", backend.sgemm);
+}
+
+// Loads the backend with the specified name.
+// Returns NULL if the name is unknown or the backend library cannot be loaded.
+static const genix_backend* __load_backend(const char* name)
+{
+	static std::mutex lock;
+	static genix_backend mkl, openblas;
+	static bool mkl_loaded = false, openblas_loaded = false;
+
+	if (::strcmp(name, "reference") == 0)
+	{
+		return &__reference_backend;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+
+	if (::strcmp(name, "mkl") == 0)
+	{
+		if (!mkl_loaded)
+		{
+			genix_backend backend = __reference_backend;
+			if (!__load_mkl(backend))
+			{
+				return NULL;
+			}
+
+			mkl = backend;
+			mkl_loaded = true;
+		}
+
+		return &mkl;
+	}
+
+	if (::strcmp(name, "openblas") == 0)
+	{
+		if (!openblas_loaded)
+		{
+			genix_backend backend = __reference_backend;
+			if (!__load_openblas(backend))
+			{
+				return NULL;
+			}
+
+			openblas = backend;
+			openblas_loaded = true;
+		}
+
+		return &openblas;
+	}
+
+	return NULL;
+}
+
+// selects the backend at load time: GENIX_BACKEND environment variable, then the build default, then the reference implementation
+static const genix_backend* __select_backend()
+{
+	const char* names[] = { ::getenv("GENIX_BACKEND"), GENIX_BACKEND_DEFAULT };
+	for (const char* name : names)
+	{
+		if (name != NULL)
+		{
+			const genix_backend* backend = __load_backend(name);
+			if (backend != NULL)
+			{
+				return backend;
+			}
+		}
+	}
+
+	return &__reference_backend;
+}
+
+// NULL until the first call to backend_current or backend_select; both may run on any thread
+static std::atomic<const genix_backend*> __current_backend(NULL);
+
+GENIXAPI(const genix_backend*, backend_current)()
+{
+	const genix_backend* backend = __current_backend.load(std::memory_order_acquire);
+	if (backend == NULL)
+	{
+		// the function-local static is initialized once; a concurrent backend_select wins
+		static const genix_backend* selected = __select_backend();
+
+		const genix_backend* expected = NULL;
+		backend = __current_backend.compare_exchange_strong(expected, selected, std::memory_order_acq_rel) ? selected : expected;
+	}
+
+	return backend;
+}
+
+GENIXAPI(const char*, backend_name)()
+{
+	return backend_current()->name;
+}
+
+// Switches all native kernels to a different backend.
+// Must not be called while other threads are running native kernels.
+GENIXAPI(BOOL, backend_select)(const char* name)
+{
+	const genix_backend* backend = name != NULL ? __load_backend(name) : NULL;
+	if (backend == NULL)
+	{
+		return FALSE;
+	}
+
+	__current_backend.store(backend, std::memory_order_release);
+	return TRUE;
+}
+
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+
+// BLAS and vector math (VML) functions used by the native kernels.
+//
+// The Visual Studio projects link Intel MKL statically and call it directly.
+// Builds that define GENIX_BACKEND_DYNAMIC (the CMake build) call the functions declared below instead.
+// They forward to a backend table that is selected once when Genix.Core.Native is loaded:
+// Intel MKL or OpenBLAS loaded from a shared library, or the built-in reference implementation.
+// The GENIX_BACKEND environment variable ("mkl", "openblas" or "reference") overrides the default backend.
+
+#if !defined(GENIX_BACKEND_DYNAMIC)
+
+#include "mkl.h"
+
+#else
+
+enum CBLAS_LAYOUT { CblasRowMajor = 101, CblasColMajor = 102 };
+enum CBLAS_TRANSPOSE { CblasNoTrans = 111, CblasTrans = 112, CblasConjTrans = 113 };
+enum CBLAS_OFFSET { CblasRowOffset = 171, CblasColOffset = 172, CblasFixOffset = 173 };
+
+struct genix_backend
+{
+	// The backend name: "mkl", "openblas" or "reference".
+	const char* name;
+
+	// BLAS level 1
+	float (*sdot)(int n, const float* x, int incx, const float* y, int incy);
+	double (*ddot)(int n, const double* x, int incx, const double* y, int incy);
+	void (*saxpy)(int n, float a, const float* x, int incx, float* y, int incy);
+	void (*daxpy)(int n, double a, const double* x, int incx, double* y, int incy);
+	void (*saxpby)(int n, float a, const float* x, int incx, float b, float* y, int incy);
+	float (*sasum)(int n, const float* x, int incx);
+	double (*dasum)(int n, const double* x, int incx);
+	float (*snrm2)(int n, const float* x, int incx);
+	double (*dnrm2)(int n, const double* x, int incx);
+	void (*sswap)(int n, float* x, int incx, float* y, int incy);
+	void (*dswap)(int n, double* x, int incx, double* y, int incy);
+
+	// BLAS level 2
+	void (*sgemv)(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE trans, int m, int n, float alpha, const float* a, int lda, const float* x, int incx, float beta, float* y, int incy);
+	void (*sger)(CBLAS_LAYOUT layout, int m, int n, float alpha, const float* x, int incx, const float* y, int incy, float* a, int lda);
+
+	// BLAS level 3
+	void (*sgemm)(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE transa, CBLAS_TRANSPOSE transb, int m, int n, int k, float alpha, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc);
+
+	// grouped batch of matrix products, MKL semantics: the products of group g share the parameters at index g
+	void (*sgemm_batch)(CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE* transa, const CBLAS_TRANSPOSE* transb, const int* m, const int* n, const int* k, const float* alpha, const float** a, const int* lda, const float** b, const int* ldb, const float* beta, float** c, const int* ldc, int group_count, const int* group_size);
+
+	// integer matrix product of unsigned bytes A and signed bytes B, MKL semantics:
+	// C := alpha * (op(A) + ao) * (op(B) + bo) + beta * C + co
+	void (*gemm_s8u8s32)(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE transa, CBLAS_TRANSPOSE transb, CBLAS_OFFSET offsetc, int m, int n, int k, float alpha, const void* a, int lda, char ao, const void* b, int ldb, char bo, float beta, int* c, int ldc, const int* co);
+
+	// in-place scaling and transposition, MKL semantics
+	void (*simatcopy)(char ordering, char trans, size_t rows, size_t cols, float alpha, float* ab, size_t lda, size_t ldb);
+
+	// vector math
+	void (*vsAbs)(int n, const float* a, float* y);
+	void (*vdAbs)(int n, const double* a, double* y);
+	void (*vsInv)(int n, const float* a, float* y);
+	void (*vsSqr)(int n, const float* a, float* y);
+	void (*vdSqr)(int n, const double* a, double* y);
+	void (*vsSqrt)(int n, const float* a, float* y);
+	void (*vdSqrt)(int n, const double* a, double* y);
+	void (*vsHypot)(int n, const float* a, const float* b, float* y);
+	void (*vdHypot)(int n, const double* a, const double* b, double* y);
+	void (*vsPowx)(int n, const float* a, float b, float* y);
+	void (*vdPowx)(int n, const double* a, double b, double* y);
+	void (*vsLn)(int n, const float* a, float* y);
+	void (*vdLn)(int n, const double* a, double* y);
+	void (*vsExp)(int n, const float* a, float* y);
+	void (*vdExp)(int n, const double* a, double* y);
+	void (*vsSin)(int n, const float* a, float* y);
+	void (*vdSin)(int n, const double* a, double* y);
+	void (*vsCos)(int n, const float* a, float* y);
+	void (*vdCos)(int n, const double* a, double* y);
+	void (*vsAtan2)(int n, const float* a, const float* b, float* y);
+	void (*vdAtan2)(int n, const double* a, const double* b, double* y);
+	void (*vsTanh)(int n, const float* a, float* y);
+	void (*vsPackI)(int n, const float* a, int inca, float* y);
+	void (*vsUnpackI)(int n, const float* a, float* y, int incy);
+};
+
+// Returns the backend selected for this process.
+extern "C" GENIXCOREAPI const genix_backend* WINAPI backend_current();
+
+#define BACKEND (*::backend_current())
+
+inline float cblas_sdot(int n, const float* x, int incx, const float* y, int incy) { return BACKEND.sdot(n, x, incx, y, incy); }
+inline double cblas_ddot(int n, const double* x, int incx, const double* y, int incy) { return BACKEND.ddot(n, x, incx, y, incy); }
+inline void cblas_saxpy(int n, float a, const float* x, int incx, float* y, int incy) { BACKEND.saxpy(n, a, x, incx, y, incy); }
+inline void cblas_daxpy(int n, double a, const double* x, int incx, double* y, int incy) { BACKEND.daxpy(n, a, x, incx, y, incy); }
+inline void cblas_saxpby(int n, float a, const float* x, int incx, float b, float* y, int incy) { BACKEND.saxpby(n, a, x, incx, b, y, incy); }
+inline float cblas_sasum(int n, const float* x, int incx) { return BACKEND.sasum(n, x, incx); }
+inline double cblas_dasum(int n, const double* x, int incx) { return BACKEND.dasum(n, x, incx); }
+inline float cblas_snrm2(int n, const float* x, int incx) { return BACKEND.snrm2(n, x, incx); }
+inline double cblas_dnrm2(int n, const double* x, int incx) { return BACKEND.dnrm2(n, x, incx); }
+inline void cblas_sswap(int n, float* x, int incx, float* y, int incy) { BACKEND.sswap(n, x, incx, y, incy); }
+inline void cblas_dswap(int n, double* x, int incx, double* y, int incy) { BACKEND.dswap(n, x, incx, y, incy); }
+
+inline void cblas_sgemv(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE trans, int m, int n, float alpha, const float* a, int lda, const float* x, int incx, float beta, float* y, int incy)
+{
+	BACKEND.sgemv(layout, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+inline void cblas_sger(CBLAS_LAYOUT layout, int m, int n, float alpha, const float* x, int incx, const float* y, int incy, float* a, int lda)
+{
+	BACKEND.sger(layout, m, n, alpha, x, incx, y, incy, a, lda);
+}
+
+inline void cblas_sgemm(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE transa, CBLAS_TRANSPOSE transb, int m, int n, int k, float alpha, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc)
+{
+	BACKEND.sgemm(layout, transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+inline void cblas_sgemm_batch(CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE* transa, const CBLAS_TRANSPOSE* transb, const int* m, const int* n, const int* k, const float* alpha, const float** a, const int* lda, const float** b, const int* ldb, const float* beta, float** c, const int* ldc, int group_count, const int* group_size)
+{
+	BACKEND.sgemm_batch(layout, transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, group_count, group_size);
+}
+
+inline void cblas_gemm_s8u8s32(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE transa, CBLAS_TRANSPOSE transb, CBLAS_OFFSET offsetc, int m, int n, int k, float alpha, const void* a, int lda, char ao, const void* b, int ldb, char bo, float beta, int* c, int ldc, const int* co)
+{
+	BACKEND.gemm_s8u8s32(layout, transa, transb, offsetc, m, n, k, alpha, a, lda, ao, b, ldb, bo, beta, c, ldc, co);
+}
+
+inline void mkl_simatcopy(char ordering, char trans, size_t rows, size_t cols, float alpha, float* ab, size_t lda, size_t ldb)
+{
+	BACKEND.simatcopy(ordering, trans, rows, cols, alpha, ab, lda, ldb);
+}
+
+inline void vsAbs(int n, const float* a, float* y) { BACKEND.vsAbs(n, a, y); }
+inline void vdAbs(int n, const double* a, double* y) { BACKEND.vdAbs(n, a, y); }
+inline void vsInv(int n, const float* a, float* y) { BACKEND.vsInv(n, a, y); }
+inline void vsSqr(int n, const float* a, float* y) { BACKEND.vsSqr(n, a, y); }
+inline void vdSqr(int n, const double* a, double* y) { BACKEND.vdSqr(n, a, y); }
+inline void vsSqrt(int n, const float* a, float* y) { BACKEND.vsSqrt(n, a, y); }
+inline void vdSqrt(int n, const double* a, double* y) { BACKEND.vdSqrt(n, a, y); }
+inline void vsHypot(int n, const float* a, const float* b, float* y) { BACKEND.vsHypot(n, a, b, y); }
+inline void vdHypot(int n, const double* a, const double* b, double* y) { BACKEND.vdHypot(n, a, b, y); }
+inline void vsPowx(int n, const float* a, float b, float* y) { BACKEND.vsPowx(n, a, b, y); }
+inline void vdPowx(int n, const double* a, double b, double* y) { BACKEND.vdPowx(n, a, b, y); }
+inline void vsLn(int n, const float* a, float* y) { BACKEND.vsLn(n, a, y); }
+inline void vdLn(int n, const double* a, double* y) { BACKEND.vdLn(n, a, y); }
+inline void vsExp(int n, const float* a, float* y) { BACKEND.vsExp(n, a, y); }
+inline void vdExp(int n, const double* a, double* y) { BACKEND.vdExp(n, a, y); }
+inline void vsSin(int n, const float* a, float* y) { BACKEND.vsSin(n, a, y); }
+inline void vdSin(int n, const double* a, double* y) { BACKEND.vdSin(n, a, y); }
+inline void vsCos(int n, const float* a, float* y) { BACKEND.vsCos(n, a, y); }
+inline void vdCos(int n, const double* a, double* y) { BACKEND.vdCos(n, a, y); }
+inline void vsAtan2(int n, const float* a, const float* b, float* y) { BACKEND.vsAtan2(n, a, b, y); }
+inline void vdAtan2(int n, const double* a, const double* b, double* y) { BACKEND.vdAtan2(n, a, b, y); }
+inline void vsTanh(int n, const float* a, float* y) { BACKEND.vsTanh(n, a, y); }
+inline void vsPackI(int n, const float* a, int inca, float* y) { BACKEND.vsPackI(n, a, inca, y); }
+inline void vsUnpackI(int n, const float* a, float* y, int incy) { BACKEND.vsUnpackI(n, a, y, incy); }
+
+#undef BACKEND
+
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "simdkernels.h"
+
+// 16-bit storage of weights shared by the native libraries, see source/halfprecision.cpp.
+//
+// The weights are stored in IEEE half precision (_f16) or in bfloat16 (_bf16) and converted to single precision
+// in registers by the matrix products, which accumulate in single precision. The matrices are packed
+// into panels of SIMD_PACKED_ROWS rows (see SIMDKernels::packed_gemv), the packed m-by-n matrix takes
+// halfprecision_packed_size(m, n) elements.
+
+// The formats of stored weights.
+enum WEIGHTS_PRECISION { PrecisionSingle = 0, PrecisionHalf = 1, PrecisionBFloat16 = 2 };
+
+inline size_t halfprecision_packed_size(int m, int n)
+{
+	return size_t((m + SIMD_PACKED_ROWS - 1) / SIMD_PACKED_ROWS) * SIMD_PACKED_ROWS * n;
+}
+
+// y := x rounded to nearest even
+extern "C" GENIXCOREAPI void WINAPI convert_f32_f16(
+	int n,
+	const float* x, int offx,
+	unsigned __int16* y, int offy);
+
+extern "C" GENIXCOREAPI void WINAPI convert_f32_bf16(
+	int n,
+	const float* x, int offx,
+	unsigned __int16* y, int offy);
+
+// y := x
+extern "C" GENIXCOREAPI void WINAPI convert_f16_f32(
+	int n,
+	const unsigned __int16* x, int offx,
+	float* y, int offy);
+
+extern "C" GENIXCOREAPI void WINAPI convert_bf16_f32(
+	int n,
+	const unsigned __int16* x, int offx,
+	float* y, int offy);
+
+// Packs the m-by-n matrix A, element (i, j) is at a[i * lda + j], or at a[j * lda + i] when transa is TRUE.
+extern "C" GENIXCOREAPI void WINAPI matrix_pack_f16(
+	int m, int n,
+	const float* a, int offa, int lda, BOOL transa,
+	unsigned __int16* packed);
+
+extern "C" GENIXCOREAPI void WINAPI matrix_pack_bf16(
+	int m, int n,
+	const float* a, int offa, int lda, BOOL transa,
+	unsigned __int16* packed);
+
+// y := A * x or y += A * x depending on cleary, A is a packed m-by-n matrix.
+extern "C" GENIXCOREAPI void WINAPI matrix_mv_f16(
+	int m, int n,
+	const unsigned __int16* a,
+	const float* x, int offx,
+	float* y, int offy, BOOL cleary);
+
+extern "C" GENIXCOREAPI void WINAPI matrix_mv_bf16(
+	int m, int n,
+	const unsigned __int16* a,
+	const float* x, int offx,
+	float* y, int offy, BOOL cleary);
+
+// C := A * B' or C += A * B' depending on clearc.
+// A is a row-major m-by-k matrix, B is a packed n-by-k matrix, C is a row-major m-by-n matrix.
+extern "C" GENIXCOREAPI void WINAPI matrix_mm_f16(
+	int m, int k, int n,
+	const float* a, int offa,
+	const unsigned __int16* b,
+	float* c, int offc, BOOL clearc);
+
+extern "C" GENIXCOREAPI void WINAPI matrix_mm_bf16(
+	int m, int k, int n,
+	const float* a, int offa,
+	const unsigned __int16* b,
+	float* c, int offc, BOOL clearc);
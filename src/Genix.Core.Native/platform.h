@@ -0,0 +1,82 @@
+#pragma once
+
+// Maps the Microsoft-specific keywords, types and intrinsics used by the native libraries
+// onto their GCC/Clang equivalents so the same sources build on Windows and Linux.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+#define GENIXEXPORT				__declspec(dllexport)
+#define GENIXIMPORT				__declspec(dllimport)
+
+#else
+
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define GENIXEXPORT				__attribute__((visibility("default")))
+#define GENIXIMPORT				__attribute__((visibility("default")))
+
+#define WINAPI
+#define APIENTRY
+#define _stdcall
+#define __stdcall
+#define __forceinline			inline __attribute__((always_inline))
+
+#define __int8					char
+#define __int16					short
+#define __int32					int
+#define __int64					long long
+
+typedef int						BOOL;
+#define TRUE					1
+#define FALSE					0
+
+#define _UI32_MAX				UINT32_MAX
+#define _UI64_MAX				UINT64_MAX
+
+#define __min(a, b)				(((a) < (b)) ? (a) : (b))
+#define __max(a, b)				(((a) > (b)) ? (a) : (b))
+
+#define _isnanf(x)				__builtin_isnan(x)
+
+#define __popcnt(x)				((unsigned)__builtin_popcount(x))
+#define __popcnt64(x)			((unsigned __int64)__builtin_popcountll(x))
+
+#define _byteswap_ushort(x)		__builtin_bswap16(x)
+#define _byteswap_ulong(x)		__builtin_bswap32(x)
+#define _byteswap_uint64(x)		__builtin_bswap64(x)
+
+static __forceinline unsigned char _BitScanForward64(unsigned long* index, unsigned __int64 mask)
+{
+	// unlike MSVC, always writes the index so callers never read an uninitialized value
+	*index = mask != 0 ? (unsigned long)__builtin_ctzll(mask) : 0ul;
+	return mask != 0;
+}
+
+static __forceinline unsigned char _BitScanReverse64(unsigned long* index, unsigned __int64 mask)
+{
+	*index = mask != 0 ? 63ul - (unsigned long)__builtin_clzll(mask) : 0ul;
+	return mask != 0;
+}
+
+#define _BitScanForward(index, mask)			_BitScanForward64(index, (unsigned __int32)(mask))
+#define _BitScanReverse(index, mask)			_BitScanReverse64(index, (unsigned __int32)(mask))
+#define _InlineBitScanForward64(index, mask)	_BitScanForward64(index, mask)
+#define _InlineBitScanReverse64(index, mask)	_BitScanReverse64(index, mask)
+
+#endif
+
+// Functions implemented in Genix.Core.Native and shared with the other native libraries.
+#if defined(GENIX_CORE_NATIVE)
+#define GENIXCOREAPI			GENIXEXPORT
+#else
+#define GENIXCOREAPI			GENIXIMPORT
+#endif
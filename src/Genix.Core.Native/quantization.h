@@ -0,0 +1,32 @@
+#pragma once
+
+// 8-bit quantization shared by the native libraries, see source/quantization.cpp.
+//
+// Activations are quantized asymmetrically to unsigned bytes, x ~ scale * (q - zero),
+// weights symmetrically to signed bytes in [-127, 127] with one scale per channel, w ~ scale * q.
+
+// y := clamp(round(x / scale) + zero, 0, 255)
+extern "C" GENIXCOREAPI void WINAPI quantize_u8(
+	int n,
+	const float* x, int offx,
+	float scale, int zero,
+	unsigned __int8* y, int offy);
+
+// Quantizes the m channels of n weights each, channel i is the row i of a row-major m-by-n matrix,
+// or the column i of a row-major n-by-m matrix when transa is TRUE.
+// q receives the channels one after another, scales and sums receive the scale and the sum of the quantized weights of every channel.
+extern "C" GENIXCOREAPI void WINAPI quantize_channels_s8(
+	int m, int n,
+	const float* a, int offa, BOOL transa,
+	__int8* q, int offq,
+	float* scales, int offscales,
+	__int32* sums, int offsums);
+
+// C := ascale * bscales[j] * (A * B' - azero * bsums[j]) or C += that depending on clearc.
+// A is a row-major m-by-k matrix of quantized activations, B holds n channels of k quantized weights,
+// C is a row-major m-by-n matrix. The integer product is computed by cblas_gemm_s8u8s32 of the current backend.
+extern "C" GENIXCOREAPI void WINAPI matrix_mm_u8s8(
+	int m, int k, int n,
+	const unsigned __int8* a, int offa, int azero, float ascale,
+	const __int8* b, int offb, const float* bscales, const __int32* bsums,
+	float* c, int offc, BOOL clearc);
@@ -0,0 +1,609 @@
+#include "stdafx.h"
+
+#if defined(GENIX_BACKEND_DYNAMIC)
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "backend.h"
+#include "simdkernels.h"
+#include "threadpool.h"
+
+// Built-in reference implementation of the BLAS and VML functions used by the native kernels.
+// The matrix routines are written for column-major storage; row-major calls are mapped
+// onto them by transposing the problem.
+
+// returns the offset of the first vector element for a given increment, BLAS convention
+static __forceinline ptrdiff_t __first(int n, int inc)
+{
+	return inc < 0 ? ptrdiff_t(1 - n) * inc : 0;
+}
+
+// BLAS level 1
+template<typename T> static T __ref_dot(int n, const T* x, int incx, const T* y, int incy)
+{
+	T result = T(0);
+
+	if (incx == 1 && incy == 1)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			result += x[i] * y[i];
+		}
+	}
+	else
+	{
+		x += __first(n, incx);
+		y += __first(n, incy);
+		for (int i = 0; i < n; i++, x += incx, y += incy)
+		{
+			result += *x * *y;
+		}
+	}
+
+	return result;
+}
+
+template<typename T> static void __ref_axpby(int n, T a, const T* x, int incx, T b, T* y, int incy)
+{
+	if (incx == 1 && incy == 1)
+	{
+		if (b == T(1))
+		{
+			for (int i = 0; i < n; i++)
+			{
+				y[i] += a * x[i];
+			}
+		}
+		else if (b == T(0))
+		{
+			for (int i = 0; i < n; i++)
+			{
+				y[i] = a * x[i];
+			}
+		}
+		else
+		{
+			for (int i = 0; i < n; i++)
+			{
+				y[i] = (a * x[i]) + (b * y[i]);
+			}
+		}
+	}
+	else
+	{
+		x += __first(n, incx);
+		y += __first(n, incy);
+		for (int i = 0; i < n; i++, x += incx, y += incy)
+		{
+			*y = (a * *x) + (b == T(0) ? T(0) : b * *y);
+		}
+	}
+}
+
+template<typename T> static void __ref_axpy(int n, T a, const T* x, int incx, T* y, int incy)
+{
+	__ref_axpby(n, a, x, incx, T(1), y, incy);
+}
+
+template<typename T> static T __ref_asum(int n, const T* x, int incx)
+{
+	// BLAS returns zero for a non-positive increment
+	if (n <= 0 || incx <= 0)
+	{
+		return T(0);
+	}
+
+	T result = T(0);
+	for (int i = 0; i < n; i++, x += incx)
+	{
+		result += std::abs(*x);
+	}
+
+	return result;
+}
+
+template<typename T> static T __ref_nrm2(int n, const T* x, int incx)
+{
+	// see __ref_asum
+	if (n <= 0 || incx <= 0)
+	{
+		return T(0);
+	}
+
+	T result = T(0);
+	for (int i = 0; i < n; i++, x += incx)
+	{
+		result += *x * *x;
+	}
+
+	return std::sqrt(result);
+}
+
+template<typename T> static void __ref_swap(int n, T* x, int incx, T* y, int incy)
+{
+	x += __first(n, incx);
+	y += __first(n, incy);
+	for (int i = 0; i < n; i++, x += incx, y += incy)
+	{
+		const T temp = *x;
+		*x = *y;
+		*y = temp;
+	}
+}
+
+// scales column-major matrix in-place: c = beta * c
+static void __ref_scale(int m, int n, float beta, float* c, int ldc)
+{
+	if (beta == 1.0f)
+	{
+		return;
+	}
+
+	for (int j = 0; j < n; j++, c += ldc)
+	{
+		if (beta == 0.0f)
+		{
+			::memset(c, 0, size_t(m) * sizeof(float));
+		}
+		else
+		{
+			for (int i = 0; i < m; i++)
+			{
+				c[i] *= beta;
+			}
+		}
+	}
+}
+
+// BLAS level 2
+static void __ref_sgemv_colmajor(bool trans, int m, int n, float alpha, const float* a, int lda, const float* x, int incx, float beta, float* y, int incy)
+{
+	const int leny = trans ? n : m;
+	const int lenx = trans ? m : n;
+
+	// first elements of x and y, the level 1 routines take unadjusted pointers
+	const float* x0 = x + __first(lenx, incx);
+	float* y0 = y + __first(leny, incy);
+
+	for (int i = 0; i < leny; i++)
+	{
+		float& yi = y0[ptrdiff_t(i) * incy];
+		yi = beta == 0.0f ? 0.0f : beta * yi;
+	}
+
+	if (trans)
+	{
+		// y[j] += alpha * dot(A(:, j), x)
+		for (int j = 0; j < n; j++, a += lda)
+		{
+			y0[ptrdiff_t(j) * incy] += alpha * __ref_dot(m, a, 1, x, incx);
+		}
+	}
+	else
+	{
+		// y += alpha * x[j] * A(:, j)
+		for (int j = 0; j < n; j++, a += lda)
+		{
+			const float t = alpha * x0[ptrdiff_t(j) * incx];
+			if (t != 0.0f)
+			{
+				__ref_axpy(m, t, a, 1, y, incy);
+			}
+		}
+	}
+}
+
+static void __ref_sgemv(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE trans, int m, int n, float alpha, const float* a, int lda, const float* x, int incx, float beta, float* y, int incy)
+{
+	if (layout == CblasRowMajor)
+	{
+		__ref_sgemv_colmajor(trans == CblasNoTrans, n, m, alpha, a, lda, x, incx, beta, y, incy);
+	}
+	else
+	{
+		__ref_sgemv_colmajor(trans != CblasNoTrans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+	}
+}
+
+static void __ref_sger_colmajor(int m, int n, float alpha, const float* x, int incx, const float* y, int incy, float* a, int lda)
+{
+	const float* y0 = y + __first(n, incy);
+
+	for (int j = 0; j < n; j++, a += lda)
+	{
+		const float t = alpha * y0[ptrdiff_t(j) * incy];
+		if (t != 0.0f)
+		{
+			__ref_axpy(m, t, x, incx, a, 1);
+		}
+	}
+}
+
+static void __ref_sger(CBLAS_LAYOUT layout, int m, int n, float alpha, const float* x, int incx, const float* y, int incy, float* a, int lda)
+{
+	if (layout == CblasRowMajor)
+	{
+		__ref_sger_colmajor(n, m, alpha, y, incy, x, incx, a, lda);
+	}
+	else
+	{
+		__ref_sger_colmajor(m, n, alpha, x, incx, y, incy, a, lda);
+	}
+}
+
+// BLAS level 3
+static void __ref_sgemm_colmajor(bool transa, bool transb, int m, int n, int k, float alpha, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc)
+{
+	__ref_scale(m, n, beta, c, ldc);
+
+	if (alpha == 0.0f || k == 0)
+	{
+		return;
+	}
+
+	// the panel of B used to compute one column of C
+	std::vector<float> bcol(transb ? k : 0);
+
+	for (int j = 0; j < n; j++, c += ldc)
+	{
+		const float* bj = b + (transb ? ptrdiff_t(j) : ptrdiff_t(j) * ldb);
+		if (transb)
+		{
+			for (int p = 0; p < k; p++)
+			{
+				bcol[p] = bj[ptrdiff_t(p) * ldb];
+			}
+
+			bj = bcol.data();
+		}
+
+		if (transa)
+		{
+			// C(i, j) += alpha * dot(A(:, i), B(:, j))
+			const float* ai = a;
+			for (int i = 0; i < m; i++, ai += lda)
+			{
+				c[i] += alpha * __ref_dot(k, ai, 1, bj, 1);
+			}
+		}
+		else
+		{
+			// C(:, j) += alpha * B(p, j) * A(:, p)
+			const float* ap = a;
+			for (int p = 0; p < k; p++, ap += lda)
+			{
+				const float t = alpha * bj[p];
+				if (t != 0.0f)
+				{
+					for (int i = 0; i < m; i++)
+					{
+						c[i] += t * ap[i];
+					}
+				}
+			}
+		}
+	}
+}
+
+static void __ref_sgemm(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE transa, CBLAS_TRANSPOSE transb, int m, int n, int k, float alpha, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc)
+{
+	if (layout == CblasRowMajor)
+	{
+		// C' = B' * A'
+		__ref_sgemm_colmajor(transb != CblasNoTrans, transa != CblasNoTrans, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+	}
+	else
+	{
+		__ref_sgemm_colmajor(transa != CblasNoTrans, transb != CblasNoTrans, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+	}
+}
+
+// The products of a batch are independent; they are split into ranges of about the same amount of work
+// that run on the thread pool, and every product is computed by sgemm of the current backend.
+static void __ref_sgemm_batch(CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE* transa, const CBLAS_TRANSPOSE* transb, const int* m, const int* n, const int* k, const float* alpha, const float** a, const int* lda, const float** b, const int* ldb, const float* beta, float** c, const int* ldc, int group_count, const int* group_size)
+{
+	int count = 0;
+	double work = 0.0;
+	for (int g = 0; g < group_count; g++)
+	{
+		count += group_size[g];
+		work += double(group_size[g]) * m[g] * n[g] * k[g];
+	}
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// about 64K multiplications per range
+	const int grain = int(__max(1.0, __min(double(count), count * 65536.0 / __max(work, 1.0))));
+	const genix_backend& backend = *::backend_current();
+
+	parallel_for_range(0, count, grain, [&](int start, int end)
+	{
+		// find the group of the first product
+		int g = 0, first = 0;
+		while (first + group_size[g] <= start)
+		{
+			first += group_size[g++];
+		}
+
+		for (int i = start; i < end; i++)
+		{
+			while (i >= first + group_size[g])
+			{
+				first += group_size[g++];
+			}
+
+			backend.sgemm(layout, transa[g], transb[g], m[g], n[g], k[g], alpha[g], a[i], lda[g], b[i], ldb[g], beta[g], c[i], ldc[g]);
+		}
+	});
+}
+
+// The products are computed by the vectorized integer kernel that needs the rows of op(A) and the columns of op(B)
+// stored contiguously; other layouts are copied first. The offsets ao and bo are applied through the row and column sums,
+// so the kernel multiplies the bytes as they are. The ranges of rows of C run on the thread pool.
+static void __ref_gemm_s8u8s32(CBLAS_LAYOUT layout, CBLAS_TRANSPOSE transa, CBLAS_TRANSPOSE transb, CBLAS_OFFSET offsetc, int m, int n, int k, float alpha, const void* a, int lda, char ao, const void* b, int ldb, char bo, float beta, int* c, int ldc, const int* co)
+{
+	if (m <= 0 || n <= 0)
+	{
+		return;
+	}
+
+	// element (i, p) of op(A) is at i * astride + p * astep, element (p, j) of op(B) is at j * bstride + p * bstep
+	const bool rowmajor = layout == CblasRowMajor;
+	const bool ta = transa != CblasNoTrans;
+	const bool tb = transb != CblasNoTrans;
+	const ptrdiff_t astride = rowmajor != ta ? lda : 1;
+	const ptrdiff_t astep = rowmajor != ta ? 1 : lda;
+	const ptrdiff_t bstride = rowmajor != tb ? 1 : ldb;
+	const ptrdiff_t bstep = rowmajor != tb ? ldb : 1;
+
+	const unsigned __int8* ua = static_cast<const unsigned __int8*>(a);
+	const __int8* sb = static_cast<const __int8*>(b);
+
+	std::vector<unsigned __int8> apacked;
+	if (astep != 1 && k > 0)
+	{
+		apacked.resize(size_t(m) * k);
+		for (int i = 0; i < m; i++)
+		{
+			for (int p = 0; p < k; p++)
+			{
+				apacked[(size_t(i) * k) + p] = ua[(i * astride) + (p * astep)];
+			}
+		}
+
+		ua = apacked.data();
+	}
+
+	std::vector<__int8> bpacked;
+	if (bstep != 1 && k > 0)
+	{
+		bpacked.resize(size_t(n) * k);
+		for (int j = 0; j < n; j++)
+		{
+			for (int p = 0; p < k; p++)
+			{
+				bpacked[(size_t(j) * k) + p] = sb[(j * bstride) + (p * bstep)];
+			}
+		}
+
+		sb = bpacked.data();
+	}
+
+	const int ldpa = astep != 1 ? k : int(astride);
+	const int ldpb = bstep != 1 ? k : int(bstride);
+
+	// (a + ao) * (b + bo) = a * b + bo * sum(a) + ao * sum(b) + k * ao * bo
+	std::vector<int> bsums(ao != 0 ? n : 0);
+	for (int j = 0; j < int(bsums.size()); j++)
+	{
+		int sum = 0;
+		for (int p = 0; p < k; p++)
+		{
+			sum += sb[(ptrdiff_t(j) * ldpb) + p];
+		}
+
+		bsums[j] = sum;
+	}
+
+	const SIMDKernels& kernels = SIMDKernels::Current();
+
+	std::vector<__int8> kpacked(kernels.gemm_u8s8_packsize(n, k));
+	kernels.gemm_u8s8_pack(n, k, sb, ldpb, kpacked.data());
+
+	// about 64K multiplications per range
+	const int grain = __max(1, __min(m, int(65536 / __max(ptrdiff_t(1), ptrdiff_t(n) * k))));
+
+	// the plain product goes straight to c
+	if (rowmajor && ao == 0 && bo == 0 && offsetc == CblasFixOffset && co[0] == 0 && alpha == 1.0f && beta == 0.0f && k > 0)
+	{
+		parallel_for_range(0, m, grain, [&](int start, int end)
+		{
+			kernels.gemm_u8s8(end - start, n, k, ua + (ptrdiff_t(start) * ldpa), ldpa, kpacked.data(), c + (ptrdiff_t(start) * ldc), ldc);
+		});
+
+		return;
+	}
+
+	parallel_for_range(0, m, grain, [&](int start, int end)
+	{
+		thread_local std::vector<int> buffer;
+		buffer.resize(size_t(end - start) * n);
+		int* products = buffer.data();
+
+		if (k > 0)
+		{
+			kernels.gemm_u8s8(end - start, n, k, ua + (ptrdiff_t(start) * ldpa), ldpa, kpacked.data(), products, n);
+		}
+		else
+		{
+			std::fill(buffer.begin(), buffer.end(), 0);
+		}
+
+		for (int i = start; i < end; i++)
+		{
+			int asum = 0;
+			if (bo != 0)
+			{
+				const unsigned __int8* ai = ua + (ptrdiff_t(i) * ldpa);
+				for (int p = 0; p < k; p++)
+				{
+					asum += ai[p];
+				}
+			}
+
+			const int* pi = products + (ptrdiff_t(i - start) * n);
+			for (int j = 0; j < n; j++)
+			{
+				int product = pi[j];
+				if (ao != 0 || bo != 0)
+				{
+					product += (bo * asum) + (ao != 0 ? ao * bsums[j] : 0) + (k * ao * bo);
+				}
+
+				const int offset = offsetc == CblasFixOffset ? co[0] : offsetc == CblasColOffset ? co[i] : co[j];
+				int& cij = c[rowmajor ? (ptrdiff_t(i) * ldc) + j : i + (ptrdiff_t(j) * ldc)];
+
+				cij = alpha == 1.0f && beta == 0.0f ?
+					product + offset :
+					int(std::lrint((double(alpha) * product) + (beta == 0.0f ? 0.0 : double(beta) * cij))) + offset;
+			}
+		}
+	});
+}
+
+static void __ref_simatcopy(char ordering, char trans, size_t rows, size_t cols, float alpha, float* ab, size_t lda, size_t ldb)
+{
+	const bool rowmajor = ordering == 'r' || ordering == 'R';
+	const bool transpose = trans == 't' || trans == 'T' || trans == 'c' || trans == 'C';
+
+	// number of vectors and their lengths in the source and destination layouts
+	const size_t srcvectors = rowmajor ? rows : cols;
+	const size_t srclength = rowmajor ? cols : rows;
+	const size_t dstvectors = transpose ? srclength : srcvectors;
+	const size_t dstlength = transpose ? srcvectors : srclength;
+
+	std::vector<float> temp(dstvectors * ldb);
+	for (size_t i = 0; i < srcvectors; i++)
+	{
+		const float* src = ab + (i * lda);
+		for (size_t j = 0; j < srclength; j++)
+		{
+			temp[transpose ? (j * ldb) + i : (i * ldb) + j] = alpha * src[j];
+		}
+	}
+
+	for (size_t i = 0; i < dstvectors; i++)
+	{
+		::memcpy(ab + (i * ldb), temp.data() + (i * ldb), dstlength * sizeof(float));
+	}
+}
+
+// vector math
+template<typename T, T OP(T)> static void __ref_vml(int n, const T* a, T* y)
+{
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = OP(a[i]);
+	}
+}
+
+template<typename T, T OP(T, T)> static void __ref_vml(int n, const T* a, const T* b, T* y)
+{
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = OP(a[i], b[i]);
+	}
+}
+
+template<typename T> static T __ref_abs(T a) { return std::abs(a); }
+template<typename T> static T __ref_inv(T a) { return T(1) / a; }
+template<typename T> static T __ref_sqr(T a) { return a * a; }
+template<typename T> static T __ref_sqrt(T a) { return std::sqrt(a); }
+template<typename T> static T __ref_hypot(T a, T b) { return std::hypot(a, b); }
+template<typename T> static T __ref_ln(T a) { return std::log(a); }
+template<typename T> static T __ref_exp(T a) { return std::exp(a); }
+template<typename T> static T __ref_sin(T a) { return std::sin(a); }
+template<typename T> static T __ref_cos(T a) { return std::cos(a); }
+template<typename T> static T __ref_atan2(T a, T b) { return std::atan2(a, b); }
+template<typename T> static T __ref_tanh(T a) { return std::tanh(a); }
+
+template<typename T> static void __ref_powx(int n, const T* a, T b, T* y)
+{
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = std::pow(a[i], b);
+	}
+}
+
+static void __ref_vsPackI(int n, const float* a, int inca, float* y)
+{
+	for (int i = 0; i < n; i++, a += inca)
+	{
+		y[i] = *a;
+	}
+}
+
+static void __ref_vsUnpackI(int n, const float* a, float* y, int incy)
+{
+	for (int i = 0; i < n; i++, y += incy)
+	{
+		*y = a[i];
+	}
+}
+
+extern const genix_backend __reference_backend =
+{
+	"reference",
+
+	__ref_dot<float>,
+	__ref_dot<double>,
+	__ref_axpy<float>,
+	__ref_axpy<double>,
+	__ref_axpby<float>,
+	__ref_asum<float>,
+	__ref_asum<double>,
+	__ref_nrm2<float>,
+	__ref_nrm2<double>,
+	__ref_swap<float>,
+	__ref_swap<double>,
+
+	__ref_sgemv,
+	__ref_sger,
+
+	__ref_sgemm,
+	__ref_sgemm_batch,
+	__ref_gemm_s8u8s32,
+
+	__ref_simatcopy,
+
+	__ref_vml<float, __ref_abs>,
+	__ref_vml<double, __ref_abs>,
+	__ref_vml<float, __ref_inv>,
+	__ref_vml<float, __ref_sqr>,
+	__ref_vml<double, __ref_sqr>,
+	__ref_vml<float, __ref_sqrt>,
+	__ref_vml<double, __ref_sqrt>,
+	__ref_vml<float, __ref_hypot>,
+	__ref_vml<double, __ref_hypot>,
+	__ref_powx<float>,
+	__ref_powx<double>,
+	__ref_vml<float, __ref_ln>,
+	__ref_vml<double, __ref_ln>,
+	__ref_vml<float, __ref_exp>,
+	__ref_vml<double, __ref_exp>,
+	__ref_vml<float, __ref_sin>,
+	__ref_vml<double, __ref_sin>,
+	__ref_vml<float, __ref_cos>,
+	__ref_vml<double, __ref_cos>,
+	__ref_vml<float, __ref_atan2>,
+	__ref_vml<double, __ref_atan2>,
+	__ref_vml<float, __ref_tanh>,
+	__ref_vsPackI,
+	__ref_vsUnpackI,
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#include "scratch.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+// the arena is a list of chunks used as a stack; the chunks after the current one are empty
+class __scratch_arena
+{
+public:
+	~__scratch_arena()
+	{
+		for (size_t i = 0; i < this->chunks.size(); i++)
+		{
+			::free(this->chunks[i].memory);
+		}
+	}
+
+	void* push(size_t size)
+	{
+		// blocks are rounded up so the next block is aligned too
+		size = (size + (Alignment - 1)) & ~(Alignment - 1);
+
+		for (; this->current < this->chunks.size(); this->current++)
+		{
+			chunk& c = this->chunks[this->current];
+
+			char* p = align(c.memory + c.used);
+			if (size_t(c.memory + c.size - p) >= size)
+			{
+				c.used = size_t(p - c.memory) + size;
+				return p;
+			}
+
+			// an empty chunk that is too small is replaced with a larger one
+			if (c.used == 0)
+			{
+				::free(c.memory);
+				c = allocate(size);
+				c.used = size_t(align(c.memory) - c.memory) + size;
+				return align(c.memory);
+			}
+		}
+
+		this->chunks.push_back(allocate(__max(size, this->chunks.empty() ? 0 : this->chunks.back().size * 2)));
+		chunk& c = this->chunks[this->current];
+		c.used = size_t(align(c.memory) - c.memory) + size;
+		return align(c.memory);
+	}
+
+	void pop(void* ptr)
+	{
+		char* p = static_cast<char*>(ptr);
+
+		for (;; this->current--)
+		{
+			chunk& c = this->chunks[this->current];
+			if (p >= c.memory && p <= c.memory + c.size)
+			{
+				c.used = size_t(p - c.memory);
+				break;
+			}
+
+			c.used = 0;
+		}
+	}
+
+private:
+	static const size_t Alignment = 64;
+	static const size_t MinChunkSize = 64 * 1024;
+
+	struct chunk
+	{
+		char* memory;
+		size_t size;
+		size_t used;
+	};
+
+	std::vector<chunk> chunks;
+	size_t current = 0;
+
+	static char* align(char* p)
+	{
+		return reinterpret_cast<char*>((uintptr_t(p) + (Alignment - 1)) & ~uintptr_t(Alignment - 1));
+	}
+
+	static chunk allocate(size_t size)
+	{
+		chunk c;
+		c.size = __max(size, MinChunkSize) + Alignment;
+		c.memory = static_cast<char*>(::malloc(c.size));
+		c.used = 0;
+		return c;
+	}
+};
+
+static thread_local __scratch_arena __scratch;
+
+GENIXAPI(void*, scratch_push)(size_t size)
+{
+	return __scratch.push(size);
+}
+
+GENIXAPI(void, scratch_pop)(void* p)
+{
+	if (p != NULL)
+	{
+		__scratch.pop(p);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Per-thread scratch arena shared by the native libraries.
+//
+// Kernels take their temporary buffers from the arena of the calling thread instead of the heap.
+// Allocations are released in the reverse order, the memory stays with the thread and is reused
+// by the next call, so a kernel that runs on many threads does not contend for the global allocator.
+// The blocks are aligned on 64 bytes and are freed when the thread exits.
+
+// Allocates size bytes from the arena of the calling thread.
+extern "C" GENIXCOREAPI void* WINAPI scratch_push(size_t size);
+
+// Releases the block returned by scratch_push and all blocks allocated after it by the calling thread.
+// Null pointer is ignored.
+extern "C" GENIXCOREAPI void WINAPI scratch_pop(void* p);
+
+// Scratch buffer of count elements that is released when the buffer goes out of scope.
+template <typename T>
+class scratch_buffer
+{
+public:
+	explicit scratch_buffer(size_t count) : ptr(static_cast<T*>(::scratch_push(count * sizeof(T))))
+	{
+	}
+
+	~scratch_buffer()
+	{
+		::scratch_pop(this->ptr);
+	}
+
+	scratch_buffer(const scratch_buffer&) = delete;
+	scratch_buffer& operator=(const scratch_buffer&) = delete;
+
+	T* data() const
+	{
+		return this->ptr;
+	}
+
+private:
+	T* ptr;
+};
@@ -1,32 +1,85 @@
 #include "stdafx.h"
-#include <intrin.h>
 #include "simddetect.h"
 
+#if defined(SIMD_X86) && !defined(_MSC_VER)
+#include <cpuid.h>
+#undef __cpuid
+#undef __cpuidex
+#define __cpuid(cpui, function)						__cpuid_count(function, 0, (cpui)[0], (cpui)[1], (cpui)[2], (cpui)[3])
+#define __cpuidex(cpui, function, subfunction)		__cpuid_count(function, subfunction, (cpui)[0], (cpui)[1], (cpui)[2], (cpui)[3])
+
+// the _xgetbv intrinsic requires XSAVE code generation in GCC
+static unsigned __int64 __read_xcr(unsigned int xcr)
+{
+	unsigned int eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+	return ((unsigned __int64)edx << 32) | eax;
+}
+#define _xgetbv(xcr)		__read_xcr(xcr)
+#endif
+
 SIMDDetect SIMDDetect::instance;
 // If true, then SSe4.1 has been detected.
 bool SIMDDetect::sse_available = false;
+bool SIMDDetect::popcnt_available = false;
 // If true, then AVX has been detected.
 bool SIMDDetect::avx_available = false;
 bool SIMDDetect::avx2_available = false;
+bool SIMDDetect::fma_available = false;
+bool SIMDDetect::f16c_available = false;
+// If true, then AVX-512 has been detected and the OS saves ZMM registers.
+bool SIMDDetect::avx512f_available = false;
+bool SIMDDetect::avx512bw_available = false;
+bool SIMDDetect::avx512vl_available = false;
+bool SIMDDetect::avx512vnni_available = false;
+bool SIMDDetect::neon_available = false;
 
 SIMDDetect::SIMDDetect()
 {
+#if defined(SIMD_X86)
 	int cpui[4];
 	__cpuid(cpui, 0);
 	int nIds = cpui[0];
+
+	// the OS must save the YMM (XCR0 bits 1-2) and ZMM (XCR0 bits 5-7) registers on context switches
+	bool ymm_enabled = false;
+	bool zmm_enabled = false;
+
 	if (nIds >= 1)
 	{
 		__cpuid(cpui, 1);
 		SIMDDetect::sse_available = (cpui[2] & 0x00080000) != 0;
-		SIMDDetect::avx_available = (cpui[2] & 0x10000000) != 0;
+		SIMDDetect::popcnt_available = (cpui[2] & 0x00800000) != 0;
+
+		if ((cpui[2] & 0x08000000) != 0)	// OSXSAVE
+		{
+			const unsigned __int64 xcr0 = _xgetbv(0);
+			ymm_enabled = (xcr0 & 0x06) == 0x06;
+			zmm_enabled = ymm_enabled && (xcr0 & 0xe0) == 0xe0;
+		}
+
+		SIMDDetect::avx_available = ymm_enabled && (cpui[2] & 0x10000000) != 0;
+		SIMDDetect::fma_available = SIMDDetect::avx_available && (cpui[2] & 0x00001000) != 0;
+		SIMDDetect::f16c_available = SIMDDetect::avx_available && (cpui[2] & 0x20000000) != 0;
 	}
-	
+
 	if (SIMDDetect::avx_available)
 	{
 		if (nIds >= 7)
 		{
 			__cpuidex(cpui, 7, 0);
 			SIMDDetect::avx2_available = (cpui[1] & 0x00000020) != 0;
+
+			if (zmm_enabled)
+			{
+				SIMDDetect::avx512f_available = (cpui[1] & 0x00010000) != 0;
+				SIMDDetect::avx512bw_available = SIMDDetect::avx512f_available && (cpui[1] & 0x40000000) != 0;
+				SIMDDetect::avx512vl_available = SIMDDetect::avx512f_available && (cpui[1] & 0x80000000) != 0;
+				SIMDDetect::avx512vnni_available = SIMDDetect::avx512f_available && (cpui[2] & 0x00000800) != 0;
+			}
 		}
 	}
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	SIMDDetect::neon_available = true;
+#endif
 }
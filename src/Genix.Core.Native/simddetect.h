@@ -1,3 +1,9 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#endif
+
 class SIMDDetect
 {
 private:
@@ -6,16 +12,41 @@ private:
 public:
 	// Returns true if SSE4.1 is available on this system.
 	static __forceinline bool IsSSEAvailable() { return instance.sse_available; }
+	// Returns true if POPCNT instruction is available on this system.
+	static __forceinline bool IsPOPCNTAvailable() { return instance.popcnt_available; }
 	// Returns true if AVX is available on this system.
 	static __forceinline bool IsAVXAvailable() { return instance.avx_available; }
 	// Returns true if AVX2 (integer support) is available on this system.
 	static __forceinline bool IsAVX2Available() { return instance.avx2_available; }
+	// Returns true if FMA3 is available on this system.
+	static __forceinline bool IsFMAAvailable() { return instance.fma_available; }
+	// Returns true if F16C (half-precision conversions) is available on this system.
+	static __forceinline bool IsF16CAvailable() { return instance.f16c_available; }
+	// Returns true if AVX-512 Foundation is available on this system.
+	static __forceinline bool IsAVX512FAvailable() { return instance.avx512f_available; }
+	// Returns true if AVX-512 Byte and Word instructions are available on this system.
+	static __forceinline bool IsAVX512BWAvailable() { return instance.avx512bw_available; }
+	// Returns true if AVX-512 Vector Length extensions are available on this system.
+	static __forceinline bool IsAVX512VLAvailable() { return instance.avx512vl_available; }
+	// Returns true if AVX-512 Vector Neural Network Instructions are available on this system.
+	static __forceinline bool IsAVX512VNNIAvailable() { return instance.avx512vnni_available; }
+	// Returns true if ARM NEON is available on this system.
+	static __forceinline bool IsNEONAvailable() { return instance.neon_available; }
 
 private:
 	static SIMDDetect instance;
 	// If true, then SSe4.1 has been detected.
 	static bool sse_available;
+	static bool popcnt_available;
 	// If true, then AVX has been detected.
 	static bool avx_available;
 	static bool avx2_available;
+	static bool fma_available;
+	static bool f16c_available;
+	// If true, then AVX-512 has been detected and the OS saves ZMM registers.
+	static bool avx512f_available;
+	static bool avx512bw_available;
+	static bool avx512vl_available;
+	static bool avx512vnni_available;
+	static bool neon_available;
 };
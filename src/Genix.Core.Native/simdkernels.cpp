@@ -0,0 +1,81 @@
+#include "stdafx.h"
+#include "simddetect.h"
+#include "simdkernels.h"
+
+// the highest level allowed by the GENIX_ISA environment variable
+static int __simd_level_limit()
+{
+	const char* value = ::getenv("GENIX_ISA");
+	if (value != NULL)
+	{
+		if (::strcmp(value, "generic") == 0 || ::strcmp(value, "neon") == 0) return SIMD_LEVEL_GENERIC;
+		if (::strcmp(value, "sse41") == 0) return SIMD_LEVEL_SSE41;
+		if (::strcmp(value, "avx2") == 0) return SIMD_LEVEL_AVX2;
+		if (::strcmp(value, "avx512") == 0) return SIMD_LEVEL_AVX512;
+	}
+
+	return SIMD_LEVEL_AVX512VNNI;
+}
+
+static const SIMDKernels* __simd_select()
+{
+	const int limit = __simd_level_limit();
+
+#if defined(SIMD_X86)
+	if (limit >= SIMD_LEVEL_AVX512VNNI &&
+		SIMDDetect::IsAVX512VNNIAvailable() &&
+		SIMDDetect::IsAVX512FAvailable() &&
+		SIMDDetect::IsAVX512BWAvailable() &&
+		SIMDDetect::IsAVX512VLAvailable() &&
+		SIMDDetect::IsAVX2Available() &&
+		SIMDDetect::IsFMAAvailable() &&
+		SIMDDetect::IsF16CAvailable() &&
+		SIMDDetect::IsPOPCNTAvailable())
+	{
+		return &__simd_kernels_avx512vnni;
+	}
+
+	if (limit >= SIMD_LEVEL_AVX512 &&
+		SIMDDetect::IsAVX512FAvailable() &&
+		SIMDDetect::IsAVX512BWAvailable() &&
+		SIMDDetect::IsAVX512VLAvailable() &&
+		SIMDDetect::IsAVX2Available() &&
+		SIMDDetect::IsFMAAvailable() &&
+		SIMDDetect::IsF16CAvailable() &&
+		SIMDDetect::IsPOPCNTAvailable())
+	{
+		return &__simd_kernels_avx512;
+	}
+
+	if (limit >= SIMD_LEVEL_AVX2 &&
+		SIMDDetect::IsAVX2Available() &&
+		SIMDDetect::IsFMAAvailable() &&
+		SIMDDetect::IsF16CAvailable() &&
+		SIMDDetect::IsPOPCNTAvailable())
+	{
+		return &__simd_kernels_avx2;
+	}
+
+	if (limit >= SIMD_LEVEL_SSE41 &&
+		SIMDDetect::IsSSEAvailable() &&
+		SIMDDetect::IsPOPCNTAvailable())
+	{
+		return &__simd_kernels_sse41;
+	}
+#endif
+
+	return &__simd_kernels_generic;
+}
+
+const SIMDKernels& SIMDKernels::Current()
+{
+	// selected once, on first use, after the processor features are detected
+	static const SIMDKernels* kernels = __simd_select();
+	return *kernels;
+}
+
+// Returns the name of the instruction set the vectorized kernels use.
+GENIXAPI(const char*, simd_isa)()
+{
+	return SIMDKernels::Current().name;
+}
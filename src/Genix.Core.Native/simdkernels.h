@@ -0,0 +1,160 @@
+#pragma once
+
+#include "simddetect.h"
+
+// Vectorized kernels built for several instruction sets.
+//
+// source/simdkernels.inl is compiled once per instruction set (see simdkernels_*.cpp)
+// and each build fills its own table. The best table supported by the processor is selected once,
+// so the rest of the library can be built for the baseline instruction set and still run
+// the hot loops with AVX2 or AVX-512.
+
+#define SIMD_LEVEL_GENERIC		0	// SSE2 on x86, NEON on ARM
+#define SIMD_LEVEL_SSE41		1	// SSE4.1 and POPCNT
+#define SIMD_LEVEL_AVX2			2	// AVX2, FMA and F16C
+#define SIMD_LEVEL_AVX512		3	// AVX-512 F, BW and VL
+#define SIMD_LEVEL_AVX512VNNI	4	// AVX-512 F, BW, VL and VNNI (8-bit dot products)
+
+// Height of the row panels used by packed_gemv.
+// It does not depend on the instruction set, so a matrix packed once works with any table.
+#define SIMD_PACKED_ROWS		16
+
+struct SIMDKernels
+{
+	// The instruction set the kernels are built for.
+	const char* name;
+
+	// The number of floats in a vector register.
+	int floats;
+
+	// y := |x|
+	void (*abs_s8)(int n, const __int8* x, __int8* y);
+	void (*abs_s16)(int n, const __int16* x, __int16* y);
+	void (*abs_s32)(int n, const __int32* x, __int32* y);
+	void (*abs_s64)(int n, const __int64* x, __int64* y);
+	void (*abs_f32)(int n, const float* x, float* y);
+	void (*abs_f64)(int n, const double* x, double* y);
+
+	// y := softmax(x)
+	void (*softmax_f32)(int n, const float* x, float* y);
+	void (*softmax_f64)(int n, const double* x, double* y);
+
+	// y := log(softmax(x))
+	void (*logsoftmax_f32)(int n, const float* x, float* y);
+	void (*logsoftmax_f64)(int n, const double* x, double* y);
+
+	// distances between two vectors
+	float (*manhattan_distance_f32)(int n, const float* x, const float* y);
+	double (*manhattan_distance_f64)(int n, const double* x, const double* y);
+	float (*euclidean_distance_squared_f32)(int n, const float* x, const float* y);
+	double (*euclidean_distance_squared_f64)(int n, const double* x, const double* y);
+	unsigned __int32 (*hamming_distance_u32)(int n, const unsigned __int32* x, const unsigned __int32* y);
+	unsigned __int64 (*hamming_distance_u64)(int n, const unsigned __int64* x, const unsigned __int64* y);
+
+	// nonlinearities and their gradients computed from the function values y
+	void (*relu)(int n, const float* x, float* y);
+	void (*relu_gradient2)(int n, float* dx, BOOL cleardx, const float* y, const float* dy);
+	void (*relu_gradient2_ip)(int n, float* dxy, const float* y);
+	void (*sigmoid)(int n, const float* x, float* y);
+	void (*sigmoid_gradient2)(int n, float* dx, BOOL cleardx, const float* y, const float* dy);
+	void (*sigmoid_gradient2_ip)(int n, float* dxy, const float* y);
+	void (*tanh_gradient2)(int n, float* dx, BOOL cleardx, const float* y, const float* dy);
+	void (*tanh_gradient2_ip)(int n, float* dxy, const float* y);
+
+	// polynomial approximations of the transcendental functions, see source/simdmath.inl for the error bounds
+	void (*exp_fast)(int n, const float* x, float* y);
+	void (*log_fast)(int n, const float* x, float* y);
+	void (*sigmoid_fast)(int n, const float* x, float* y);
+	void (*tanh_fast)(int n, const float* x, float* y);
+
+	// LSTM cell: applies the nonlinearities to the gates g = [i, j, f, o] in place, then computes
+	// the state s := f * sprev + i * j (s := i * j when sprev is NULL) and the output y := o * tanh(s)
+	void (*lstm_cell)(int n, float* g, const float* sprev, float* s, float* y, float forgetBias);
+
+	// y += A * x, where the m-by-n matrix A is packed into panels of SIMD_PACKED_ROWS rows;
+	// element (i, j) is at ((i / SIMD_PACKED_ROWS) * n + j) * SIMD_PACKED_ROWS + (i % SIMD_PACKED_ROWS)
+	// and the rows past m in the last panel are zero
+	void (*packed_gemv)(int m, int n, const float* a, const float* x, float* y);
+
+	// y[v * ldy + i] += sum(A[i, j] * x[v * ldx + j]) for count vectors, where A is packed as for packed_gemv
+	// but stored in 16 bits: IEEE half precision or bfloat16. The weights are converted in registers
+	// and the sums are accumulated in single precision.
+	void (*packed_gemm_f16)(int m, int n, int count, const unsigned __int16* a, const float* x, int ldx, float* y, int ldy);
+	void (*packed_gemm_bf16)(int m, int n, int count, const unsigned __int16* a, const float* x, int ldx, float* y, int ldy);
+
+	// one step of the CTC forward recursion in log space over n positions of the label sequence with blanks:
+	// next[i] := log(e^prev[i] + e^prev[i-1] + e^(prev[i-2] + skip[i])) + emit[i];
+	// prev[-1] and prev[-2] must be readable, skip[i] is 0 where the transition from i-2 is allowed and -inf elsewhere
+	void (*ctc_step)(int n, const float* prev, const float* skip, const float* emit, float* next);
+
+	// direct convolution of n output columns with m filters, the filters of kernel column i are a k-by-m matrix at w + i * kstep:
+	// y[j * ldy + f] += sum(w[i * kstep + l * m + f] * x[j * xstep + i * xstep1 + l]) over i < kx and l < k
+	void (*conv_direct)(int n, int m, int kx, int k, const float* w, int kstep, const float* x, int xstep, int xstep1, float* y, int ldy);
+
+	// depthwise convolution of n output columns with m channels, the kernel element (i, l) of channel c is w[i * kstep + l * m + c]:
+	// y[j * ldy + c] += sum(w[i * kstep + l * m + c] * x[j * xstep + i * xstep1 + l * xstep2 + c]) over i < kx and l < ky
+	void (*conv_depthwise)(int n, int m, int kx, int ky, const float* w, int kstep, const float* x, int xstep, int xstep1, int xstep2, float* y, int ldy);
+
+	// the gradients of the depthwise convolution with respect to its input and to its weights:
+	// dx[j * xstep + i * xstep1 + l * xstep2 + c] += w[i * kstep + l * m + c] * dy[j * ldy + c];
+	// dw[i * kstep + l * m + c] += sum(x[j * xstep + i * xstep1 + l * xstep2 + c] * dy[j * ldy + c]) over j < n
+	void (*conv_depthwise_dx)(int n, int m, int kx, int ky, const float* w, int kstep, float* dx, int xstep, int xstep1, int xstep2, const float* dy, int ldy);
+	void (*conv_depthwise_dw)(int n, int m, int kx, int ky, float* dw, int kstep, const float* x, int xstep, int xstep1, int xstep2, const float* dy, int ldy);
+
+	// integer matrix product of the rows of a and the rows of b, both with k bytes per row:
+	// c[i * ldc + j] := sum(a[i * lda + l] * b[j * ldb + l]) over l < k, for i < m and j < n
+	// b is first packed into gemm_u8s8_packsize(n, k) bytes, once for all the rows of a
+	size_t (*gemm_u8s8_packsize)(int n, int k);
+	void (*gemm_u8s8_pack)(int n, int k, const __int8* b, int ldb, __int8* packed);
+	void (*gemm_u8s8)(int m, int n, int k, const unsigned __int8* a, int lda, const __int8* packed, __int32* c, int ldc);
+
+	// position of the first smallest and largest element
+	int (*argmin_s8)(int n, const __int8* x);
+	int (*argmin_s16)(int n, const __int16* x);
+	int (*argmin_s32)(int n, const __int32* x);
+	int (*argmin_s64)(int n, const __int64* x);
+	int (*argmin_u8)(int n, const unsigned __int8* x);
+	int (*argmin_u16)(int n, const unsigned __int16* x);
+	int (*argmin_u32)(int n, const unsigned __int32* x);
+	int (*argmin_u64)(int n, const unsigned __int64* x);
+	int (*argmin_f32)(int n, const float* x);
+	int (*argmin_f64)(int n, const double* x);
+	int (*argmax_s8)(int n, const __int8* x);
+	int (*argmax_s16)(int n, const __int16* x);
+	int (*argmax_s32)(int n, const __int32* x);
+	int (*argmax_s64)(int n, const __int64* x);
+	int (*argmax_u8)(int n, const unsigned __int8* x);
+	int (*argmax_u16)(int n, const unsigned __int16* x);
+	int (*argmax_u32)(int n, const unsigned __int32* x);
+	int (*argmax_u64)(int n, const unsigned __int64* x);
+	int (*argmax_f32)(int n, const float* x);
+	int (*argmax_f64)(int n, const double* x);
+
+	// bit arrays: population count of n words and y := y op x on n words
+	unsigned __int32 (*popcount_u32)(int n, const unsigned __int32* x);
+	unsigned __int64 (*popcount_u64)(int n, const unsigned __int64* x);
+	void (*bits_or_u32)(int n, const unsigned __int32* x, unsigned __int32* y);
+	void (*bits_or_u64)(int n, const unsigned __int64* x, unsigned __int64* y);
+	void (*bits_and_u32)(int n, const unsigned __int32* x, unsigned __int32* y);
+	void (*bits_and_u64)(int n, const unsigned __int64* x, unsigned __int64* y);
+	void (*bits_xand_u32)(int n, const unsigned __int32* x, unsigned __int32* y);
+	void (*bits_xand_u64)(int n, const unsigned __int64* x, unsigned __int64* y);
+	void (*bits_xor_u32)(int n, const unsigned __int32* x, unsigned __int32* y);
+	void (*bits_xor_u64)(int n, const unsigned __int64* x, unsigned __int64* y);
+
+	// exchanges n bytes between x and y
+	void (*swap)(size_t n, void* x, void* y);
+
+	// Returns the kernels built for the best instruction set available on this system.
+	// The GENIX_ISA environment variable ("generic", "sse41", "avx2", "avx512" or "avx512vnni") lowers the choice.
+	// Exported, so the other native libraries use the same kernels.
+	static GENIXCOREAPI const SIMDKernels& Current();
+};
+
+extern const SIMDKernels __simd_kernels_generic;
+#if defined(SIMD_X86)
+extern const SIMDKernels __simd_kernels_sse41;
+extern const SIMDKernels __simd_kernels_avx2;
+extern const SIMDKernels __simd_kernels_avx512;
+extern const SIMDKernels __simd_kernels_avx512vnni;
+#endif
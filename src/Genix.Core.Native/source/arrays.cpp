@@ -1,9 +1,7 @@
 #include "stdafx.h"
 #include <math.h>
-#include <intrin.h>
-#include <immintrin.h>
-#include "mkl.h"
-#include "simddetect.h"
+#include "backend.h"
+#include "simdkernels.h"
 
 // compare two arrays element-wise
 template<typename T> int __forceinline __compare(
@@ -164,7 +162,7 @@ GENIXAPI(void, set_inc_u64)(int n, unsigned __int64 a, unsigned __int64* y, int
 GENIXAPI(void, set_inc_f32)(int n, float a, float* y, int offy, int incy) { __set_inc(n, a, y, offy, offy); }
 GENIXAPI(void, set_inc_f64)(int n, double a, double* y, int offy, int incy) { __set_inc(n, a, y, offy, offy); }
 
-extern "C" __declspec(dllexport) void WINAPI sreplace(
+GENIXAPI(void, sreplace)(
 	int n,
 	const float* x, int offx,
 	float oldValue,
@@ -200,7 +198,7 @@ extern "C" __declspec(dllexport) void WINAPI sreplace(
 }
 }
 
-extern "C" __declspec(dllexport) void WINAPI pack(
+GENIXAPI(void, pack)(
 	int n,
 	const float* a, int offa, int inca,
 	float* y, int offy)
@@ -208,7 +206,7 @@ extern "C" __declspec(dllexport) void WINAPI pack(
 	::vsPackI(n, a + offa, inca, y + offy);
 }
 
-extern "C" __declspec(dllexport) void WINAPI unpack(
+GENIXAPI(void, unpack)(
 	int n,
 	const float* a, int offa,
 	float* y, int offy, int incy)
@@ -222,29 +220,7 @@ template<typename T> void __forceinline __swap(
 	T* x, const int offx,
 	T* y, const int offy)
 {
-	x += offx;
-	y += offy;
-
-	int i = 0;
-
-	if (SIMDDetect::IsAVX2Available())
-	{
-		const int TStep = 256 / 8 / sizeof(T);
-		for (int ii = (n / TStep) * TStep; i < ii; i += TStep)
-		{
-			__m256i xtemp = _mm256_loadu_si256(reinterpret_cast<__m256i*>(&x[i]));
-			__m256i ytemp = _mm256_loadu_si256(reinterpret_cast<__m256i*>(&y[i]));
-			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&y[i]), xtemp);
-			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&x[i]), ytemp);
-		}
-	}
-
-	for (; i < n; i++)
-	{
-		T temp = x[i];
-		x[i] = y[i];
-		y[i] = temp;
-	}
+	SIMDKernels::Current().swap(n > 0 ? n * sizeof(T) : 0, x + offx, y + offy);
 }
 
 GENIXAPI(void, swap_s8)(const int n, __int8* x, const int offx, __int8* y, const int offy) { __swap(n, x, offx, y, offy); }
@@ -258,14 +234,12 @@ GENIXAPI(void, swap_u64)(const int n, unsigned __int64* x, const int offx, unsig
 GENIXAPI(void, swap_f32)(const int n, float* x, const int offx, float* y, const int offy) {
 
 	////__swap(n, x, offx, y, offy);
-	const int incxy = 1;
-	::sswap(&n, x, &incxy, y, &incxy);
+	::cblas_sswap(n, x + offx, 1, y + offy, 1);
 }
 GENIXAPI(void, swap_f64)(const int n, double* x, const int offx, double* y, const int offy) {
 
 	////__swap(n, x, offx, y, offy);
-	const int incxy = 1;
-	::dswap(&n, x, &incxy, y, &incxy);
+	::cblas_dswap(n, x + offx, 1, y + offy, 1);
 }
 
 // logical operations
@@ -773,11 +747,11 @@ GENIXAPI(void, op##_ip_u64)(int length, int shift, unsigned __int64* x, int offx
 } \
 GENIXAPI(void, op##_u32)(int length, const unsigned __int32* x, int offx, int shift, unsigned __int32* y, int offy) \
 { \
-	__##op##<unsigned __int32>(length, shift, x, offx, y, offy); \
+	__##op<unsigned __int32>(length, shift, x, offx, y, offy); \
 } \
 GENIXAPI(void, op##_u64)(int length, const unsigned __int64* x, int offx, int shift, unsigned __int64* y, int offy) \
 { \
-	__##op##<unsigned __int64>(length, shift, x, offx, y, offy); \
+	__##op<unsigned __int64>(length, shift, x, offx, y, offy); \
 }
 
 SHIFT(shr);
@@ -5,12 +5,14 @@
 #define BITS_MAX				_UI64_MAX
 #define BITS_MIN				0ul
 #define BITS_NAME(name)			name##_64
+#define BITS_KERNEL(name)		SIMDKernels::Current().name##_u64
 typedef unsigned __int64		__bits;
 #elif BITS_COUNT == 32
 #define BITS_SHIFT				5
 #define BITS_MAX				_UI32_MAX
-#define BITS_MIN				0ui32
+#define BITS_MIN				0u
 #define BITS_NAME(name)			name##_32
+#define BITS_KERNEL(name)		SIMDKernels::Current().name##_u32
 typedef unsigned				__bits;
 #endif
 
@@ -44,18 +46,11 @@ __bits __forceinline _shiftleft(__bits LowPart, __bits HighPart, unsigned char S
 }
 #endif
 
-#if BITS_COUNT == 64
-#ifdef _WIN64
-#define _popcnt				__popcnt64
-#else
-unsigned __int64 __forceinline _popcnt(unsigned __int64 value)
+// POPCNT instruction is not available on every processor, so the bits are counted by the vectorized kernels
+__forceinline __bits _popcnt(__bits value)
 {
-	return (unsigned __int64)(__popcnt(unsigned(value))) + __popcnt((unsigned)(value >> 32));
+	return BITS_KERNEL(popcount)(1, &value);
 }
-#endif
-#elif BITS_COUNT == 32
-#define _popcnt				__popcnt
-#endif
 
 // Searches the source operand for the least significant set bit.
 // If a least significant set bit is found, the result is its offset from bit 0.
@@ -837,10 +832,7 @@ BITSAPI(__bits, bits_count)(
 		const int wordcount = count >> BITS_SHIFT;
 		if (wordcount > 0)
 		{
-			for (int i = 0; i < wordcount; i++)
-			{
-				sum += _popcnt(bits[i]);
-			}
+			sum += BITS_KERNEL(popcount)(wordcount, bits);
 		}
 
 		// count right side
@@ -860,7 +852,8 @@ template<void T2(__bits&, __bits), void T3(__bits&, __bits, __bits)> void __forc
 	const __bits* x, 		// the source array
 	int posx, 				// the zero-based index of starting bit in x
 	__bits* y, 				// the destination array
-	int posy 				// the zero-based index of starting bit in y
+	int posy, 				// the zero-based index of starting bit in y
+	void (*kernel)(int, const __bits*, __bits*)	// the vectorized operation for aligned words
 )
 {
 	x += (posx >> BITS_SHIFT);
@@ -909,10 +902,7 @@ template<void T2(__bits&, __bits), void T3(__bits&, __bits, __bits)> void __forc
 	{
 		if (posx == 0)
 		{
-			for (int i = 0; i < wordcount; i++)
-			{
-				T2(y[i], x[i]);
-			}
+			kernel(wordcount, x, y);
 		}
 		else
 		{
@@ -984,7 +974,7 @@ BITSAPI(void, bits_or)(
 	int posy 				// the zero-based index of starting bit in y
 	)
 {
-	__bits_logical<logical_or2, logical_or3>(count, x, posx, y, posy);
+	__bits_logical<logical_or2, logical_or3>(count, x, posx, y, posy, BITS_KERNEL(bits_or));
 }
 
 // Logical AND
@@ -996,7 +986,7 @@ BITSAPI(void, bits_and)(
 	int posy 				// the zero-based index of starting bit in y
 	)
 {
-	__bits_logical<logical_and2, logical_and3>(count, x, posx, y, posy);
+	__bits_logical<logical_and2, logical_and3>(count, x, posx, y, posy, BITS_KERNEL(bits_and));
 }
 
 // Logical XAND (A AND NOT B)
@@ -1008,7 +998,7 @@ BITSAPI(void, bits_xand)(
 	int posy 				// the zero-based index of starting bit in y
 	)
 {
-	__bits_logical<logical_xand2, logical_xand3>(count, x, posx, y, posy);
+	__bits_logical<logical_xand2, logical_xand3>(count, x, posx, y, posy, BITS_KERNEL(bits_xand));
 }
 
 // Logical XOR
@@ -1020,5 +1010,5 @@ BITSAPI(void, bits_xor)(
 	int posy 				// the zero-based index of starting bit in y
 	)
 {
-	__bits_logical<logical_xor2, logical_xor3>(count, x, posx, y, posy);
+	__bits_logical<logical_xor2, logical_xor3>(count, x, posx, y, posy, BITS_KERNEL(bits_xor));
 }
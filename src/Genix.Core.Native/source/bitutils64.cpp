@@ -1,10 +1,11 @@
 #include "stdafx.h"
 
-#include <intrin.h>
 #include <math.h>
 #include <limits.h>
 #include <assert.h>
 
+#include "simdkernels.h"
+
 #define BITS_COUNT			64
 
 #include "bitutils.inl"
@@ -1,32 +1,18 @@
 #include "stdafx.h"
 #include <cmath>
-#include <intrin.h>
+#include "backend.h"
+#include "scratch.h"
+#include "simdkernels.h"
+#include "threadpool.h"
 
 // Manhattan distance
-template<typename T> T __forceinline __manhattan_distance(
-	const int n,
-	const T* x, const int offx,
-	const T* y, const int offy)
-{
-	x += offx;
-	y += offy;
-
-	T sum = T(0);
-	for (int i = 0; i < n; i++)
-	{
-		sum += ::fabs(x[i] - y[i]);
-	}
-
-	return sum;
-}
-
 GENIXAPI(float, manhattan_distance_f32)(const int n, const float* x, int offx, const float* y, int offy)
 {
-	return __manhattan_distance(n, x, offx, y, offy);
+	return SIMDKernels::Current().manhattan_distance_f32(n, x + offx, y + offy);
 }
 GENIXAPI(double, manhattan_distance_f64)(const int n, const double* x, int offx, const double* y, int offy)
 {
-	return __manhattan_distance(n, x, offx, y, offy);
+	return SIMDKernels::Current().manhattan_distance_f64(n, x + offx, y + offy);
 }
 
 template<typename T> T __forceinline __sparse_manhattan_distance(
@@ -55,22 +41,13 @@ GENIXAPI(double, sparse_manhattan_distance_f64)(const int n, const int* xidx, co
 }
 
 // euclidean distance
-template<typename T> T __forceinline __euclidean_distance_squared(
-	const int n,
-	const T* x, const int offx,
-	const T* y, const int offy)
+float __forceinline __euclidean_distance_squared(const int n, const float* x, const int offx, const float* y, const int offy)
 {
-	x += offx;
-	y += offy;
-
-	T sum = T(0);
-	for (int i = 0; i < n; i++)
-	{
-		T u = x[i] - y[i];
-		sum += u * u;
-	}
-
-	return sum;
+	return SIMDKernels::Current().euclidean_distance_squared_f32(n, x + offx, y + offy);
+}
+double __forceinline __euclidean_distance_squared(const int n, const double* x, const int offx, const double* y, const int offy)
+{
+	return SIMDKernels::Current().euclidean_distance_squared_f64(n, x + offx, y + offy);
 }
 
 GENIXAPI(float, euclidean_distance_squared_f32)(const int n, const float* x, int offx, const float* y, int offy)
@@ -118,41 +95,173 @@ GENIXAPI(double, sparse_euclidean_distance_f64)(const int n, const int* xidx, co
 }
 
 // Hamming distance
-unsigned __int32 __forceinline popcnt32(unsigned __int32 value)
+GENIXAPI(unsigned __int32, hamming_distance_ip_u32)(const int n, const unsigned __int32* x, int offx, const unsigned __int32* y, int offy)
 {
-	return __popcnt(value);
+	return SIMDKernels::Current().hamming_distance_u32(n, x + offx, y + offy);
 }
-unsigned __int64 __forceinline popcnt64(unsigned __int64 value)
+GENIXAPI(unsigned __int64, hamming_distance_ip_u64)(const int n, const unsigned __int64* x, int offx, const unsigned __int64* y, int offy)
 {
-#ifndef _WIN64
-	return (unsigned __int64)(__popcnt(unsigned(value))) + __popcnt((unsigned)(value >> 32));
-#else
-	return __popcnt64(value);
-#endif
+	return SIMDKernels::Current().hamming_distance_u64(n, x + offx, y + offy);
 }
 
-template<typename T, T popcnt(T)> T __forceinline __hamming_distance(
-	const int n,
-	const T* x, const int offx,
-	const T* y, const int offy)
+// Distance matrices.
+// dist(i, j) is the distance between row i of x and row j of y; x has m rows, y has n rows, every row has k elements
+// and dist is a row-major m x n matrix. The matrix is computed in tiles of rows of x and rows of y that run in parallel;
+// the rows of y of a tile stay in the cache while they are compared with the rows of x.
+namespace
+{
+	// the rows of y in a tile take about this many bytes
+	const size_t TileBytes = 64 * 1024;
+
+	// calls func(i0, i1, j0, j1) for the tiles of tilerows x tilecols (or less) elements of the m x n matrix in parallel
+	template<typename _Function> void __distance_tiles(const int m, const int n, const int tilerows, const int tilecols, const _Function& func)
+	{
+		parallel_for_range(0, m, tilerows, 0, n, tilecols, [&](int start0, int end0, int start1, int end1)
+		{
+			for (int i0 = start0; i0 < end0; i0 += tilerows)
+			{
+				for (int j0 = start1; j0 < end1; j0 += tilecols)
+				{
+					func(i0, __min(i0 + tilerows, end0), j0, __min(j0 + tilecols, end1));
+				}
+			}
+		});
+	}
+
+	// the number of rows of y in a tile
+	int __forceinline __tile_columns(const int n, const size_t rowbytes)
+	{
+		return int(__min(__max(TileBytes / __max(rowbytes, size_t(1)), size_t(16)), size_t(__max(n, 1))));
+	}
+
+	// dist(i, j) := distance(k, x(i), y(j)) over the tiles of the distance matrix
+	template<typename T, typename D, typename _Distance> void __distance_matrix(
+		const int m, const int n, const int k,
+		const T* x, const T* y, D* dist,
+		const _Distance& distance)
+	{
+		__distance_tiles(m, n, 16, __tile_columns(n, k * sizeof(T)), [&](int i0, int i1, int j0, int j1)
+		{
+			for (int i = i0; i < i1; i++)
+			{
+				const T* xi = x + (ptrdiff_t(i) * k);
+				D* di = dist + (ptrdiff_t(i) * n);
+
+				for (int j = j0; j < j1; j++)
+				{
+					di[j] = distance(k, xi, y + (ptrdiff_t(j) * k));
+				}
+			}
+		});
+	}
+}
+
+// Computes the Euclidean (or squared Euclidean) distances between the rows of x and y.
+// The distances are expanded as |x|^2 + |y|^2 - 2 * x * y, the products x * y of a tile are computed by sgemm.
+// Rounding may leave a small negative value for very close rows, it is clamped to zero.
+GENIXAPI(void, euclidean_distance_matrix_f32)(
+	const int m, const int n, const int k,
+	const float* x, int offx,
+	const float* y, int offy,
+	float* dist, int offdist,
+	BOOL squared)
 {
 	x += offx;
 	y += offy;
+	dist += offdist;
 
-	T sum = T(0);
-	for (int i = 0; i < n; i++)
+	scratch_buffer<float> buffer(size_t(m) + n);
+	float* xx = buffer.data();
+	float* yy = xx + m;
+
+	for (int i = 0; i < m; i++)
 	{
-		sum += popcnt(x[i] ^ y[i]);
+		const float* xi = x + (ptrdiff_t(i) * k);
+		xx[i] = ::cblas_sdot(k, xi, 1, xi, 1);
 	}
 
-	return sum;
+	for (int j = 0; j < n; j++)
+	{
+		const float* yj = y + (ptrdiff_t(j) * k);
+		yy[j] = ::cblas_sdot(k, yj, 1, yj, 1);
+	}
+
+	// sgemm does its own blocking, the tiles are bands of whole rows
+	__distance_tiles(m, n, 64, __max(n, 1), [&](int i0, int i1, int j0, int j1)
+	{
+		float* d = dist + (ptrdiff_t(i0) * n) + j0;
+
+		::cblas_sgemm(
+			CblasRowMajor,
+			CblasNoTrans,
+			CblasTrans,
+			i1 - i0,
+			j1 - j0,
+			k,
+			-2.0f,
+			x + (ptrdiff_t(i0) * k),
+			k,
+			y + (ptrdiff_t(j0) * k),
+			k,
+			0.0f,
+			d,
+			n);
+
+		for (int i = i0; i < i1; i++, d += n)
+		{
+			const float a = xx[i];
+			for (int j = 0, count = j1 - j0; j < count; j++)
+			{
+				d[j] = __max(d[j] + a + yy[j0 + j], 0.0f);
+			}
+
+			if (!squared)
+			{
+				for (int j = 0, count = j1 - j0; j < count; j++)
+				{
+					d[j] = ::sqrtf(d[j]);
+				}
+			}
+		}
+	});
 }
 
-GENIXAPI(unsigned __int32, hamming_distance_ip_u32)(const int n, const unsigned __int32* x, int offx, const unsigned __int32* y, int offy)
+// Computes the Manhattan distances between the rows of x and y.
+GENIXAPI(void, manhattan_distance_matrix_f32)(
+	const int m, const int n, const int k,
+	const float* x, int offx,
+	const float* y, int offy,
+	float* dist, int offdist)
 {
-	return __hamming_distance<unsigned __int32, popcnt32>(n, x, offx, y, offy);
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	__distance_matrix(m, n, k, x + offx, y + offy, dist + offdist, kernels.manhattan_distance_f32);
 }
-GENIXAPI(unsigned __int64, hamming_distance_ip_u64)(const int n, const unsigned __int64* x, int offx, const unsigned __int64* y, int offy)
+GENIXAPI(void, manhattan_distance_matrix_f64)(
+	const int m, const int n, const int k,
+	const double* x, int offx,
+	const double* y, int offy,
+	double* dist, int offdist)
+{
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	__distance_matrix(m, n, k, x + offx, y + offy, dist + offdist, kernels.manhattan_distance_f64);
+}
+
+// Computes the Hamming distances between the rows of bits of x and y, k is the number of words in a row.
+GENIXAPI(void, hamming_distance_matrix_u32)(
+	const int m, const int n, const int k,
+	const unsigned __int32* x, int offx,
+	const unsigned __int32* y, int offy,
+	unsigned __int32* dist, int offdist)
+{
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	__distance_matrix(m, n, k, x + offx, y + offy, dist + offdist, kernels.hamming_distance_u32);
+}
+GENIXAPI(void, hamming_distance_matrix_u64)(
+	const int m, const int n, const int k,
+	const unsigned __int64* x, int offx,
+	const unsigned __int64* y, int offy,
+	unsigned __int64* dist, int offdist)
 {
-	return __hamming_distance<unsigned __int64, popcnt64>(n, x, offx, y, offy);
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	__distance_matrix(m, n, k, x + offx, y + offy, dist + offdist, kernels.hamming_distance_u64);
 }
@@ -0,0 +1,196 @@
+#include "stdafx.h"
+#include "halfprecision.h"
+#include "simdkernels.h"
+#include "threadpool.h"
+#include "halfprecision.inl"
+
+// 16-bit weights, see halfprecision.h.
+// Converting to 16 bits is done once when the weights are packed and is not vectorized;
+// the products convert the weights back in the SIMD kernels (SIMDKernels::packed_gemm_f16).
+
+namespace
+{
+	typedef void(*packed_gemm_h)(int m, int n, int count, const unsigned __int16* a, const float* x, int ldx, float* y, int ldy);
+
+	template<unsigned __int16 Convert(float)> void __matrix_pack(
+		int m, int n,
+		const float* a, int lda, BOOL transa,
+		unsigned __int16* packed)
+	{
+		const int panels = (m + SIMD_PACKED_ROWS - 1) / SIMD_PACKED_ROWS;
+		for (int p = 0; p < panels; p++)
+		{
+			for (int j = 0; j < n; j++)
+			{
+				for (int r = 0; r < SIMD_PACKED_ROWS; r++)
+				{
+					const int i = (p * SIMD_PACKED_ROWS) + r;
+					*packed++ = i >= m ? 0 : Convert(transa ? a[(ptrdiff_t(j) * lda) + i] : a[(ptrdiff_t(i) * lda) + j]);
+				}
+			}
+		}
+	}
+
+	void __matrix_mv(
+		packed_gemm_h kernel,
+		int m, int n,
+		const unsigned __int16* a,
+		const float* x,
+		float* y, BOOL cleary)
+	{
+		if (cleary)
+		{
+			memset(y, 0, m * sizeof(float));
+		}
+
+		// about 64K multiplications per range
+		const int panels = (m + SIMD_PACKED_ROWS - 1) / SIMD_PACKED_ROWS;
+		const int grain = __max(1, 65536 / (SIMD_PACKED_ROWS * __max(n, 1)));
+
+		parallel_for_range(0, panels, grain, [&](int start, int end)
+		{
+			const int first = start * SIMD_PACKED_ROWS;
+			kernel(
+				__min(m, end * SIMD_PACKED_ROWS) - first, n, 1,
+				a + (ptrdiff_t(first) * n),
+				x, n,
+				y + first, m);
+		});
+	}
+
+	void __matrix_mm(
+		packed_gemm_h kernel,
+		int m, int k, int n,
+		const float* a,
+		const unsigned __int16* b,
+		float* c, BOOL clearc)
+	{
+		if (clearc)
+		{
+			memset(c, 0, size_t(m) * n * sizeof(float));
+		}
+
+		// every range converts its panels once for 16 rows of a or more
+		const int RowGrain = 16;
+		const int panels = (n + SIMD_PACKED_ROWS - 1) / SIMD_PACKED_ROWS;
+		const int grain = __max(1, 65536 / (RowGrain * SIMD_PACKED_ROWS * __max(k, 1)));
+
+		parallel_for_range(0, panels, grain, 0, m, RowGrain, [&](int start0, int end0, int start1, int end1)
+		{
+			const int first = start0 * SIMD_PACKED_ROWS;
+			kernel(
+				__min(n, end0 * SIMD_PACKED_ROWS) - first, k, end1 - start1,
+				b + (ptrdiff_t(first) * k),
+				a + (ptrdiff_t(start1) * k), k,
+				c + (ptrdiff_t(start1) * n) + first, n);
+		});
+	}
+}
+
+GENIXAPI(void, convert_f32_f16)(
+	int n,
+	const float* x, int offx,
+	unsigned __int16* y, int offy)
+{
+	x += offx;
+	y += offy;
+
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = __f32_to_f16(x[i]);
+	}
+}
+
+GENIXAPI(void, convert_f32_bf16)(
+	int n,
+	const float* x, int offx,
+	unsigned __int16* y, int offy)
+{
+	x += offx;
+	y += offy;
+
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = __f32_to_bf16(x[i]);
+	}
+}
+
+GENIXAPI(void, convert_f16_f32)(
+	int n,
+	const unsigned __int16* x, int offx,
+	float* y, int offy)
+{
+	x += offx;
+	y += offy;
+
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = __f16_to_f32(x[i]);
+	}
+}
+
+GENIXAPI(void, convert_bf16_f32)(
+	int n,
+	const unsigned __int16* x, int offx,
+	float* y, int offy)
+{
+	x += offx;
+	y += offy;
+
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = __bf16_to_f32(x[i]);
+	}
+}
+
+GENIXAPI(void, matrix_pack_f16)(
+	int m, int n,
+	const float* a, int offa, int lda, BOOL transa,
+	unsigned __int16* packed)
+{
+	__matrix_pack<__f32_to_f16>(m, n, a + offa, lda, transa, packed);
+}
+
+GENIXAPI(void, matrix_pack_bf16)(
+	int m, int n,
+	const float* a, int offa, int lda, BOOL transa,
+	unsigned __int16* packed)
+{
+	__matrix_pack<__f32_to_bf16>(m, n, a + offa, lda, transa, packed);
+}
+
+GENIXAPI(void, matrix_mv_f16)(
+	int m, int n,
+	const unsigned __int16* a,
+	const float* x, int offx,
+	float* y, int offy, BOOL cleary)
+{
+	__matrix_mv(SIMDKernels::Current().packed_gemm_f16, m, n, a, x + offx, y + offy, cleary);
+}
+
+GENIXAPI(void, matrix_mv_bf16)(
+	int m, int n,
+	const unsigned __int16* a,
+	const float* x, int offx,
+	float* y, int offy, BOOL cleary)
+{
+	__matrix_mv(SIMDKernels::Current().packed_gemm_bf16, m, n, a, x + offx, y + offy, cleary);
+}
+
+GENIXAPI(void, matrix_mm_f16)(
+	int m, int k, int n,
+	const float* a, int offa,
+	const unsigned __int16* b,
+	float* c, int offc, BOOL clearc)
+{
+	__matrix_mm(SIMDKernels::Current().packed_gemm_f16, m, k, n, a + offa, b, c + offc, clearc);
+}
+
+GENIXAPI(void, matrix_mm_bf16)(
+	int m, int k, int n,
+	const float* a, int offa,
+	const unsigned __int16* b,
+	float* c, int offc, BOOL clearc)
+{
+	__matrix_mm(SIMDKernels::Current().packed_gemm_bf16, m, k, n, a + offa, b, c + offc, clearc);
+}
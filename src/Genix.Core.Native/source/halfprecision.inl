@@ -0,0 +1,114 @@
+#include <string.h>
+
+// Conversions between single precision and the 16-bit formats used to store weights:
+// IEEE half precision (fp16) and bfloat16, the upper half of a single precision number.
+// Rounding is to nearest even. Only integer arithmetic is used, so the results do not depend
+// on the floating point mode (flush to zero in particular).
+
+unsigned __int32 __forceinline __float_bits(float x)
+{
+	unsigned __int32 bits;
+	memcpy(&bits, &x, sizeof(bits));
+	return bits;
+}
+
+float __forceinline __bits_float(unsigned __int32 bits)
+{
+	float x;
+	memcpy(&x, &bits, sizeof(x));
+	return x;
+}
+
+unsigned __int16 __forceinline __f32_to_f16(float x)
+{
+	unsigned __int32 f = __float_bits(x);
+	const unsigned __int16 sign = (unsigned __int16)((f >> 16) & 0x8000u);
+	f &= 0x7fffffffu;
+
+	if (f > 0x7f800000u)
+	{
+		// quiet NaN that keeps the upper bits of the payload
+		return sign | (unsigned __int16)(0x7e00u | ((f >> 13) & 0x03ffu));
+	}
+
+	if (f >= 0x477ff000u)
+	{
+		// 65520 and above round to infinity
+		return sign | 0x7c00u;
+	}
+
+	if (f >= 0x38800000u)
+	{
+		// normal: rebias the exponent from 127 to 15 and round the 13 dropped bits
+		return sign | (unsigned __int16)((f - 0x38000000u + 0x0fffu + ((f >> 13) & 1u)) >> 13);
+	}
+
+	if (f <= 0x33000000u)
+	{
+		// 2^-25 and below round to zero
+		return sign;
+	}
+
+	// subnormal: the value in units of 2^-24 is the mantissa shifted right by 126 - exponent
+	const int shift = 126 - int(f >> 23);
+	const unsigned __int32 mantissa = (f & 0x007fffffu) | 0x00800000u;
+	const unsigned __int32 rest = mantissa & ((1u << shift) - 1u);
+	const unsigned __int32 half = 1u << (shift - 1);
+	unsigned __int32 h = mantissa >> shift;
+	if (rest > half || (rest == half && (h & 1u)))
+	{
+		h++;
+	}
+
+	return sign | (unsigned __int16)h;
+}
+
+float __forceinline __f16_to_f32(unsigned __int16 h)
+{
+	const unsigned __int32 sign = (unsigned __int32)(h & 0x8000u) << 16;
+	unsigned __int32 exponent = (h >> 10) & 0x1fu;
+	unsigned __int32 mantissa = h & 0x03ffu;
+
+	if (exponent == 0x1fu)
+	{
+		// infinity, NaN is quieted as F16C does
+		return __bits_float(sign | 0x7f800000u | (mantissa != 0 ? 0x00400000u : 0u) | (mantissa << 13));
+	}
+
+	if (exponent != 0)
+	{
+		return __bits_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+	}
+
+	if (mantissa == 0)
+	{
+		return __bits_float(sign);
+	}
+
+	// subnormal: normalize the mantissa
+	exponent = 113;
+	while ((mantissa & 0x0400u) == 0)
+	{
+		mantissa <<= 1;
+		exponent--;
+	}
+
+	return __bits_float(sign | (exponent << 23) | ((mantissa & 0x03ffu) << 13));
+}
+
+unsigned __int16 __forceinline __f32_to_bf16(float x)
+{
+	const unsigned __int32 f = __float_bits(x);
+	if ((f & 0x7fffffffu) > 0x7f800000u)
+	{
+		// quiet NaN
+		return (unsigned __int16)((f >> 16) | 0x0040u);
+	}
+
+	return (unsigned __int16)((f + 0x7fffu + ((f >> 16) & 1u)) >> 16);
+}
+
+float __forceinline __bf16_to_f32(unsigned __int16 h)
+{
+	return __bits_float((unsigned __int32)h << 16);
+}
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include <cmath>
-#include "mkl.h"
+#include "backend.h"
+#include "simdkernels.h"
 
 GENIXAPI(float, slogSumExp2)(const float a, const float b)
 {
@@ -56,66 +57,20 @@ GENIXAPI(float, slogSumExp3)(const float a, const float b, const float c)
 }
 
 // calculates absolute value of a vector element-wise in-place.
-template<typename T> void __forceinline __abs_ip(
-	int n,
-	T* y, int offy)
-{
-	y += offy;
-
-	for (int i = 0; i < n; i++)
-	{
-		y[i] = abs(y[i]);
-	}
-}
-
-GENIXAPI(void, abs_ip_s8)(int n, __int8* y, int offy) { __abs_ip(n, y, offy); }
-GENIXAPI(void, abs_ip_s16)(int n, __int16* y, int offy) { __abs_ip(n, y, offy); }
-GENIXAPI(void, abs_ip_s32)(int n, __int32* y, int offy) { __abs_ip(n, y, offy); }
-GENIXAPI(void, abs_ip_s64)(int n, __int64* y, int offy) { __abs_ip(n, y, offy); }
-GENIXAPI(void, abs_ip_f32)(int n, float* y, int offy) { __abs_ip(n, y, offy); }
-GENIXAPI(void, abs_ip_f64)(int n, double* y, int offy) { __abs_ip(n, y, offy); }
+GENIXAPI(void, abs_ip_s8)(int n, __int8* y, int offy) { SIMDKernels::Current().abs_s8(n, y + offy, y + offy); }
+GENIXAPI(void, abs_ip_s16)(int n, __int16* y, int offy) { SIMDKernels::Current().abs_s16(n, y + offy, y + offy); }
+GENIXAPI(void, abs_ip_s32)(int n, __int32* y, int offy) { SIMDKernels::Current().abs_s32(n, y + offy, y + offy); }
+GENIXAPI(void, abs_ip_s64)(int n, __int64* y, int offy) { SIMDKernels::Current().abs_s64(n, y + offy, y + offy); }
+GENIXAPI(void, abs_ip_f32)(int n, float* y, int offy) { SIMDKernels::Current().abs_f32(n, y + offy, y + offy); }
+GENIXAPI(void, abs_ip_f64)(int n, double* y, int offy) { SIMDKernels::Current().abs_f64(n, y + offy, y + offy); }
 
 // calculates absolute value of a vector element-wise not-in-place.
-template<typename T> void __forceinline __abs(
-	int n,
-	const T* x, int offx,
-	T* y, int offy)
-{
-	x += offx;
-	y += offy;
-
-	for (int i = 0; i < n; i++)
-	{
-		y[i] = abs(x[i]);
-	}
-}
-
-GENIXAPI(void, abs_s8)(int n, const __int8* x, int offx, __int8* y, int offy) { __abs(n, x, offx, y, offy); }
-GENIXAPI(void, abs_s16)(int n, const __int16* x, int offx, __int16* y, int offy) { __abs(n, x, offx, y, offy); }
-GENIXAPI(void, abs_s32)(int n, const __int32* x, int offx, __int32* y, int offy) { __abs(n, x, offx, y, offy); }
-GENIXAPI(void, abs_s64)(int n, const __int64* x, int offx, __int64* y, int offy) { __abs(n, x, offx, y, offy); }
-GENIXAPI(void, abs_f32)(int n, const float* x, int offx, float* y, int offy)
-{
-	if (n <= 32)
-	{
-		__abs(n, x, offx, y, offy);
-	}
-	else
-	{
-		::vsAbs(n, x + offx, y + offy);
-	}
-}
-GENIXAPI(void, abs_f64)(int n, const double* x, int offx, double* y, int offy)
-{
-	if (n <= 32)
-	{
-		__abs(n, x, offx, y, offy);
-	}
-	else
-	{
-		::vdAbs(n, x + offx, y + offy);
-	}
-}
+GENIXAPI(void, abs_s8)(int n, const __int8* x, int offx, __int8* y, int offy) { SIMDKernels::Current().abs_s8(n, x + offx, y + offy); }
+GENIXAPI(void, abs_s16)(int n, const __int16* x, int offx, __int16* y, int offy) { SIMDKernels::Current().abs_s16(n, x + offx, y + offy); }
+GENIXAPI(void, abs_s32)(int n, const __int32* x, int offx, __int32* y, int offy) { SIMDKernels::Current().abs_s32(n, x + offx, y + offy); }
+GENIXAPI(void, abs_s64)(int n, const __int64* x, int offx, __int64* y, int offy) { SIMDKernels::Current().abs_s64(n, x + offx, y + offy); }
+GENIXAPI(void, abs_f32)(int n, const float* x, int offx, float* y, int offy) { SIMDKernels::Current().abs_f32(n, x + offx, y + offy); }
+GENIXAPI(void, abs_f64)(int n, const double* x, int offx, double* y, int offy) { SIMDKernels::Current().abs_f64(n, x + offx, y + offy); }
 
 template<typename T> void __forceinline __abs_gradient(
 	int n,
@@ -1,5 +1,5 @@
 #include "stdafx.h"
-#include "mkl.h"
+#include "backend.h"
 
 // calculates dot product of two vectors
 template<typename T> T __forceinline __dot(
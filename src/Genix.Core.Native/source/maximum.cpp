@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include <cmath>
+#include "simdkernels.h"
+#include "threadpool.h"
 
 #undef min
 #undef max
@@ -350,44 +352,37 @@ GENIXAPI(void, minmax_gradient_f64)(
 	__minmax_gradient(n, x, dx, offx, cleardx, y, dy, offy);
 }
 
+// the vectorized kernels for each element type
+int __forceinline __argmin_kernel(int n, const __int8* x) { return SIMDKernels::Current().argmin_s8(n, x); }
+int __forceinline __argmin_kernel(int n, const __int16* x) { return SIMDKernels::Current().argmin_s16(n, x); }
+int __forceinline __argmin_kernel(int n, const __int32* x) { return SIMDKernels::Current().argmin_s32(n, x); }
+int __forceinline __argmin_kernel(int n, const __int64* x) { return SIMDKernels::Current().argmin_s64(n, x); }
+int __forceinline __argmin_kernel(int n, const unsigned __int8* x) { return SIMDKernels::Current().argmin_u8(n, x); }
+int __forceinline __argmin_kernel(int n, const unsigned __int16* x) { return SIMDKernels::Current().argmin_u16(n, x); }
+int __forceinline __argmin_kernel(int n, const unsigned __int32* x) { return SIMDKernels::Current().argmin_u32(n, x); }
+int __forceinline __argmin_kernel(int n, const unsigned __int64* x) { return SIMDKernels::Current().argmin_u64(n, x); }
+int __forceinline __argmin_kernel(int n, const float* x) { return SIMDKernels::Current().argmin_f32(n, x); }
+int __forceinline __argmin_kernel(int n, const double* x) { return SIMDKernels::Current().argmin_f64(n, x); }
+
+int __forceinline __argmax_kernel(int n, const __int8* x) { return SIMDKernels::Current().argmax_s8(n, x); }
+int __forceinline __argmax_kernel(int n, const __int16* x) { return SIMDKernels::Current().argmax_s16(n, x); }
+int __forceinline __argmax_kernel(int n, const __int32* x) { return SIMDKernels::Current().argmax_s32(n, x); }
+int __forceinline __argmax_kernel(int n, const __int64* x) { return SIMDKernels::Current().argmax_s64(n, x); }
+int __forceinline __argmax_kernel(int n, const unsigned __int8* x) { return SIMDKernels::Current().argmax_u8(n, x); }
+int __forceinline __argmax_kernel(int n, const unsigned __int16* x) { return SIMDKernels::Current().argmax_u16(n, x); }
+int __forceinline __argmax_kernel(int n, const unsigned __int32* x) { return SIMDKernels::Current().argmax_u32(n, x); }
+int __forceinline __argmax_kernel(int n, const unsigned __int64* x) { return SIMDKernels::Current().argmax_u64(n, x); }
+int __forceinline __argmax_kernel(int n, const float* x) { return SIMDKernels::Current().argmax_f32(n, x); }
+int __forceinline __argmax_kernel(int n, const double* x) { return SIMDKernels::Current().argmax_f64(n, x); }
+
 template<typename T> int __forceinline __argmin(int n, const T* x, int offx)
 {
-	x += offx;
-
-	int win = 0;
-	T min = x[0];
-
-	for (int i = 1; i < n; i++)
-	{
-		const T value = x[i];
-		if (value < min)
-		{
-			win = i;
-			min = value;
-		}
-	}
-
-	return offx + win;
+	return offx + __argmin_kernel(n, x + offx);
 }
 
 template<typename T> int __forceinline __argmax(int n, const T* x, int offx)
 {
-	x += offx;
-
-	int win = 0;
-	T max = x[0];
-
-	for (int i = 1; i < n; i++)
-	{
-		const T value = x[i];
-		if (value > max)
-		{
-			win = i;
-			max = value;
-		}
-	}
-
-	return offx + win;
+	return offx + __argmax_kernel(n, x + offx);
 }
 
 GENIXAPI(int, argmin_ip_s8s32)(int n, const __int8* x, int offx) { return __argmin(n, x, offx); }
@@ -414,6 +409,11 @@ GENIXAPI(int, argmax_ip_f64s32)(int n, const double* x, int offx) { return __arg
 
 template<typename T> int __forceinline __argmin_inc(int n, const T* x, int offx, int incx)
 {
+	if (incx == 1)
+	{
+		return __argmin(n, x, offx);
+	}
+
 	x += offx;
 
 	int win = 0;
@@ -434,6 +434,11 @@ template<typename T> int __forceinline __argmin_inc(int n, const T* x, int offx,
 
 template<typename T> int __forceinline __argmax_inc(int n, const T* x, int offx, int incx)
 {
+	if (incx == 1)
+	{
+		return __argmax(n, x, offx);
+	}
+
 	x += offx;
 
 	int win = 0;
@@ -474,31 +479,11 @@ GENIXAPI(int, argmax_inc_ip_u64s32)(int n, const unsigned __int64* x, int offx,
 GENIXAPI(int, argmax_inc_ip_f32s32)(int n, const float* x, int offx, int incx) { return __argmax_inc(n, x, offx, incx); }
 GENIXAPI(int, argmax_inc_ip_f64s32)(int n, const double* x, int offx, int incx) { return __argmax_inc(n, x, offx, incx); }
 
+// two vectorized passes are faster than a single sequential one
 template<typename T> void __forceinline __argminmax(int n, const T* x, int offx, int& winmin, int& winmax)
 {
-	x += offx;
-
-	winmin = winmax = 0;
-	T min = x[0];
-	T max = x[0];
-
-	for (int i = 1; i < n; i++)
-	{
-		const T value = x[i];
-		if (value < min)
-		{
-			winmin = i;
-			min = value;
-		}
-		else if (value > max)
-		{
-			winmax = i;
-			max = value;
-		}
-	}
-
-	winmin += offx;
-	winmax += offx;
+	winmin = __argmin(n, x, offx);
+	winmax = __argmax(n, x, offx);
 }
 
 GENIXAPI(void, argminmax_s8)(int n, const __int8* x, int offx, int& winmin, int& winmax) { return __argminmax(n, x, offx, winmin, winmax); }
@@ -563,46 +548,77 @@ GENIXAPI(float, _max_inc_ip_f32)(int n, const float* x, int offx, int incx) { re
 GENIXAPI(double, _max_inc_ip_f64)(int n, const double* x, int offx, int incx) { return ___max_inc(n, x, offx, incx); }
 
 // Softmax
-template<typename T> void __forceinline __softmax(int n, const T* x, int offx, T* y, int offy)
+void __forceinline __softmax(int n, const float* x, int offx, float* y, int offy)
 {
-	x += offx;
-	y += offy;
+	SIMDKernels::Current().softmax_f32(n, x + offx, y + offy);
+}
 
-	// compute max activation
-	T amax = ___max(n, x, 0);
+void __forceinline __softmax(int n, const double* x, int offx, double* y, int offy)
+{
+	SIMDKernels::Current().softmax_f64(n, x + offx, y + offy);
+}
 
-	// compute exponentials (carefully to not blow up)
-	T esum = (T)0;
-	for (int i = 0; i < n; i++)
+GENIXAPI(void, softmax_ip_f32)(int n, float* y, int offy) { __softmax(n, y, offy, y, offy); }
+GENIXAPI(void, softmax_ip_f64)(int n, double* y, int offy) { __softmax(n, y, offy, y, offy); }
+GENIXAPI(void, softmax_f32)(int n, const float* x, int offx, float* y, int offy) { __softmax(n, x, offx, y, offy); }
+GENIXAPI(void, softmax_f64)(int n, const double* x, int offx, double* y, int offy) { __softmax(n, x, offx, y, offy); }
+
+// the rows of a batch are independent, about 16K elements per range
+template<typename _Function> void __forceinline __softmax_batch_run(int n, int batchlen, const _Function& func)
+{
+	if (batchlen <= 0)
 	{
-		y[i] = exp(x[i] - amax);
-		esum += y[i];
+		return;
 	}
 
-	// normalize and output to sum to one
-	if (esum != 0)
+	const int rows = n / batchlen;
+	parallel_for_range(0, rows, __max(1, 16384 / batchlen), [&](int start, int end)
 	{
-		for (int i = 0; i < n; i++)
+		for (int i = start; i < end; i++)
 		{
-			y[i] /= esum;
+			func(i * batchlen);
 		}
-	}
+	});
 }
 
-GENIXAPI(void, softmax_ip_f32)(int n, float* y, int offy) { __softmax(n, y, offy, y, offy); }
-GENIXAPI(void, softmax_ip_f64)(int n, double* y, int offy) { __softmax(n, y, offy, y, offy); }
-GENIXAPI(void, softmax_f32)(int n, const float* x, int offx, float* y, int offy) { __softmax(n, x, offx, y, offy); }
-GENIXAPI(void, softmax_f64)(int n, const double* x, int offx, double* y, int offy) { __softmax(n, x, offx, y, offy); }
-
 template<typename T> void __forceinline __softmax_batch(int n, int batchlen, const T* x, int offx, T* y, int offy)
 {
-	for (int i = 0; i < n; i += batchlen, offx += batchlen, offy += batchlen)
+	__softmax_batch_run(n, batchlen, [&](int off)
 	{
-		__softmax(batchlen, x, offx, y, offy);
-	}
+		__softmax(batchlen, x, offx + off, y, offy + off);
+	});
 }
 
 GENIXAPI(void, softmax_batch_ip_f32)(int n, int batchlen, float* y, int offy) { __softmax_batch(n, batchlen, y, offy, y, offy); }
 GENIXAPI(void, softmax_batch_ip_f64)(int n, int batchlen, double* y, int offy) { __softmax_batch(n, batchlen, y, offy, y, offy); }
 GENIXAPI(void, softmax_batch_f32)(int n, const float* x, int offx, int batchlen, float* y, int offy) { __softmax_batch(n, batchlen, x, offx, y, offy); }
 GENIXAPI(void, softmax_batch_f64)(int n, const double* x, int offx, int batchlen, double* y, int offy) { __softmax_batch(n, batchlen, x, offx, y, offy); }
+
+// Log-softmax
+void __forceinline __logsoftmax(int n, const float* x, int offx, float* y, int offy)
+{
+	SIMDKernels::Current().logsoftmax_f32(n, x + offx, y + offy);
+}
+
+void __forceinline __logsoftmax(int n, const double* x, int offx, double* y, int offy)
+{
+	SIMDKernels::Current().logsoftmax_f64(n, x + offx, y + offy);
+}
+
+GENIXAPI(void, logsoftmax_ip_f32)(int n, float* y, int offy) { __logsoftmax(n, y, offy, y, offy); }
+GENIXAPI(void, logsoftmax_ip_f64)(int n, double* y, int offy) { __logsoftmax(n, y, offy, y, offy); }
+GENIXAPI(void, logsoftmax_f32)(int n, const float* x, int offx, float* y, int offy) { __logsoftmax(n, x, offx, y, offy); }
+GENIXAPI(void, logsoftmax_f64)(int n, const double* x, int offx, double* y, int offy) { __logsoftmax(n, x, offx, y, offy); }
+
+template<typename T> void __forceinline __logsoftmax_batch(int n, int batchlen, const T* x, int offx, T* y, int offy)
+{
+	__softmax_batch_run(n, batchlen, [&](int off)
+	{
+		__logsoftmax(batchlen, x, offx + off, y, offy + off);
+	});
+}
+
+GENIXAPI(void, logsoftmax_batch_ip_f32)(int n, int batchlen, float* y, int offy) { __logsoftmax_batch(n, batchlen, y, offy, y, offy); }
+GENIXAPI(void, logsoftmax_batch_ip_f64)(int n, int batchlen, double* y, int offy) { __logsoftmax_batch(n, batchlen, y, offy, y, offy); }
+GENIXAPI(void, logsoftmax_batch_f32)(int n, const float* x, int offx, int batchlen, float* y, int offy) { __logsoftmax_batch(n, batchlen, x, offx, y, offy); }
+GENIXAPI(void, logsoftmax_batch_f64)(int n, const double* x, int offx, int batchlen, double* y, int offy) { __logsoftmax_batch(n, batchlen, x, offx, y, offy); }
@@ -1,7 +1,7 @@
 #include "stdafx.h"
-#include "nonlinearity.inl"
 #include "parallel.inl"
-#include "mkl.h"
+#include "backend.h"
+#include "simdkernels.h"
 
 /*#include <amp.h>
 #include <amp_math.h>
@@ -19,7 +19,7 @@ GENIXAPI(void, relu)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity<__relu>(start, end, x, y);
+		SIMDKernels::Current().relu(end - start, x + start, y + start);
 	});
 }
 
@@ -37,7 +37,7 @@ GENIXAPI(void, relu_gradient2)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity_gradient2<__relu_derivative2>(start, end, dx, cleardx, y, dy);
+		SIMDKernels::Current().relu_gradient2(end - start, dx + start, cleardx, y + start, dy + start);
 	});
 }
 
@@ -53,7 +53,7 @@ GENIXAPI(void, relu_gradient2_ip)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity_gradient2_ip<__relu_derivative2>(start, end, dxy, y);
+		SIMDKernels::Current().relu_gradient2_ip(end - start, dxy + start, y + start);
 	});
 }
 
@@ -69,7 +69,24 @@ GENIXAPI(void, sigmoid)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity<__sigmoid>(start, end, x, y);
+		SIMDKernels::Current().sigmoid(end - start, x + start, y + start);
+	});
+}
+
+// sigmoid computed by the polynomial approximation of exp, up to 3 ulp error
+GENIXAPI(void, sigmoid_fast)(
+	int n,
+	const float* x, int offx,
+	float* y, int offy)
+{
+	const int Partition = 65536;
+
+	x += offx;
+	y += offy;
+
+	parallel(n, Partition, [&](int start, int end) {
+
+		SIMDKernels::Current().sigmoid_fast(end - start, x + start, y + start);
 	});
 }
 
@@ -87,7 +104,7 @@ GENIXAPI(void, sigmoid_gradient2)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity_gradient2<__sigmoid_derivative2>(start, end, dx, cleardx, y, dy);
+		SIMDKernels::Current().sigmoid_gradient2(end - start, dx + start, cleardx, y + start, dy + start);
 	});
 }
 
@@ -103,7 +120,7 @@ GENIXAPI(void, sigmoid_gradient2_ip)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity_gradient2_ip<__sigmoid_derivative2>(start, end, dxy, y);
+		SIMDKernels::Current().sigmoid_gradient2_ip(end - start, dxy + start, y + start);
 	});
 }
 
@@ -137,6 +154,23 @@ GENIXAPI(void, _tanh)(
 	);*/
 }
 
+// tanh computed by polynomial approximations, up to 2 ulp error
+GENIXAPI(void, tanh_fast)(
+	int n,
+	const float* x, int offx,
+	float* y, int offy)
+{
+	const int Partition = 65536;
+
+	x += offx;
+	y += offy;
+
+	parallel(n, Partition, [&](int start, int end) {
+
+		SIMDKernels::Current().tanh_fast(end - start, x + start, y + start);
+	});
+}
+
 GENIXAPI(void, tanh_gradient2)(
 	int n,
 	float* dx, int offdx, BOOL cleardx,
@@ -151,7 +185,7 @@ GENIXAPI(void, tanh_gradient2)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity_gradient2<__tanh_derivative2>(start, end, dx, cleardx, y, dy);
+		SIMDKernels::Current().tanh_gradient2(end - start, dx + start, cleardx, y + start, dy + start);
 	});
 	/*if (cleardx)
 	{
@@ -181,6 +215,23 @@ GENIXAPI(void, tanh_gradient2_ip)(
 
 	parallel(n, Partition, [&](int start, int end) {
 
-		__nonlinearity_gradient2_ip<__tanh_derivative2>(start, end, dxy, y);
+		SIMDKernels::Current().tanh_gradient2_ip(end - start, dxy + start, y + start);
+	});
+}
+
+// exp computed by the polynomial approximation, up to 2 ulp error
+GENIXAPI(void, exp_fast)(
+	int n,
+	const float* x, int offx,
+	float* y, int offy)
+{
+	const int Partition = 65536;
+
+	x += offx;
+	y += offy;
+
+	parallel(n, Partition, [&](int start, int end) {
+
+		SIMDKernels::Current().exp_fast(end - start, x + start, y + start);
 	});
 }
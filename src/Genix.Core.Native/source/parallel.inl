@@ -1,5 +1,4 @@
-#include <ppl.h>
-using namespace concurrency;
+#include "threadpool.h"
 
 template <typename _Index_type, typename _Function>
 void parallel(_Index_type _Length, _Index_type _Partition, const _Function& _Func)
@@ -10,10 +9,8 @@ void parallel(_Index_type _Length, _Index_type _Partition, const _Function& _Fun
 	}
 	else
 	{
-		parallel_for(0, (_Length + _Partition - 1) / _Partition, [&](int idx) {
+		parallel_for_range(0, _Length, _Partition, [&](int start, int end) {
 
-			const int start = idx * _Partition;
-			const int end = __min(start + _Partition, _Length);
 			_Func(start, end);
 		});
 	}
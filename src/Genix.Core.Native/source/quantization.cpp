@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include <cmath>
+#include "backend.h"
+#include "quantization.h"
+#include "scratch.h"
+#include "simdkernels.h"
+
+// 8-bit quantization, see quantization.h.
+// The product of a quantized activation vector and a channel is then
+// ascale * wscale * (sum(qa * qw) - zero * sum(qw)), so the channel sums are kept with the weights.
+
+template<typename T> static __forceinline T __quantize(float x, float invscale, int zero, int lo, int hi)
+{
+	const int q = int(std::lrint(x * invscale)) + zero;
+	return T(q < lo ? lo : (q > hi ? hi : q));
+}
+
+// y := clamp(round(x / scale) + zero, 0, 255)
+GENIXAPI(void, quantize_u8)(
+	int n,
+	const float* x, int offx,
+	float scale, int zero,
+	unsigned __int8* y, int offy)
+{
+	x += offx;
+	y += offy;
+
+	const float invscale = 1.0f / scale;
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = __quantize<unsigned __int8>(x[i], invscale, zero, 0, 255);
+	}
+}
+
+// y := scale * (x - zero)
+GENIXAPI(void, dequantize_u8)(
+	int n,
+	const unsigned __int8* x, int offx,
+	float scale, int zero,
+	float* y, int offy)
+{
+	x += offx;
+	y += offy;
+
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = scale * (int(x[i]) - zero);
+	}
+}
+
+// quantizes the channels of a weight matrix, see quantization.h
+GENIXAPI(void, quantize_channels_s8)(
+	int m, int n,
+	const float* a, int offa, BOOL transa,
+	__int8* q, int offq,
+	float* scales, int offscales,
+	__int32* sums, int offsums)
+{
+	a += offa;
+	q += offq;
+	scales += offscales;
+	sums += offsums;
+
+	const ptrdiff_t stride = transa ? 1 : n;
+	const ptrdiff_t step = transa ? m : 1;
+
+	for (int i = 0; i < m; i++, q += n)
+	{
+		const float* ai = a + (i * stride);
+
+		float amax = 0.0f;
+		for (int j = 0; j < n; j++)
+		{
+			amax = __max(amax, ::fabsf(ai[j * step]));
+		}
+
+		// a channel of zeros keeps a unit scale
+		const float scale = amax > 0.0f ? amax / 127.0f : 1.0f;
+		const float invscale = 1.0f / scale;
+
+		__int32 sum = 0;
+		for (int j = 0; j < n; j++)
+		{
+			q[j] = __quantize<__int8>(ai[j * step], invscale, 0, -127, 127);
+			sum += q[j];
+		}
+
+		scales[i] = scale;
+		sums[i] = sum;
+	}
+}
+
+// product of quantized activations and quantized weights, see quantization.h
+GENIXAPI(void, matrix_mm_u8s8)(
+	int m, int k, int n,
+	const unsigned __int8* a, int offa, int azero, float ascale,
+	const __int8* b, int offb, const float* bscales, const __int32* bsums,
+	float* c, int offc, BOOL clearc)
+{
+	scratch_buffer<__int32> buffer(size_t(m) * n);
+
+	const __int32 co = 0;
+	::cblas_gemm_s8u8s32(
+		CblasRowMajor,
+		CblasNoTrans,
+		CblasTrans,
+		CblasFixOffset,
+		m,
+		n,
+		k,
+		1.0f,
+		a + offa,
+		k,
+		0,
+		b + offb,
+		k,
+		0,
+		0.0f,
+		buffer.data(),
+		n,
+		&co);
+
+	c += offc;
+	const __int32* products = buffer.data();
+	for (int i = 0; i < m; i++, c += n, products += n)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			const float value = ascale * bscales[j] * float(products[j] - (azero * bsums[j]));
+			c[j] = clearc ? value : c[j] + value;
+		}
+	}
+}
+
+// the number of bytes matrix_pack_u8s8 needs for n channels of k quantized weights, depends on the instruction set
+GENIXAPI(int, matrix_packsize_u8s8)(int n, int k)
+{
+	return int(SIMDKernels::Current().gemm_u8s8_packsize(n, k));
+}
+
+// packs n channels of k quantized weights (see quantize_channels_s8) for matrix_mv_u8s8
+GENIXAPI(void, matrix_pack_u8s8)(
+	int n, int k,
+	const __int8* a, int offa,
+	__int8* packed)
+{
+	SIMDKernels::Current().gemm_u8s8_pack(n, k, a + offa, k, packed);
+}
+
+// y := xscale * scales[j] * (A * x - xzero * sums[j]) or y += that depending on cleary.
+// A holds n channels of k quantized weights packed once by matrix_pack_u8s8, x contains k quantized activations.
+GENIXAPI(void, matrix_mv_u8s8)(
+	int n, int k,
+	const __int8* a, const float* scales, const __int32* sums,
+	const unsigned __int8* x, int offx, int xzero, float xscale,
+	float* y, int offy, BOOL cleary)
+{
+	scratch_buffer<__int32> buffer(n);
+
+	// a single row is not worth a matrix product
+	SIMDKernels::Current().gemm_u8s8(1, n, k, x + offx, k, a, buffer.data(), n);
+
+	y += offy;
+	const __int32* products = buffer.data();
+	for (int j = 0; j < n; j++)
+	{
+		const float value = xscale * scales[j] * float(products[j] - (xzero * sums[j]));
+		y[j] = cleary ? value : y[j] + value;
+	}
+}
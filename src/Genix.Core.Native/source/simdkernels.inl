@@ -0,0 +1,1590 @@
+// Kernels compiled once per instruction set.
+//
+// The including file defines SIMD_LEVEL and SIMD_KERNELS_NAME and is built with the matching
+// code generation options. Everything here has internal linkage: the same inline functions are
+// compiled for different instruction sets, and the linker must not merge them across files.
+
+#include <cmath>
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+#include "simdkernels.h"
+
+#if SIMD_LEVEL == SIMD_LEVEL_AVX512VNNI && !defined(__AVX512VNNI__) && !defined(_MSC_VER)
+#error AVX-512 VNNI kernels must be compiled with AVX-512 VNNI code generation.
+#elif SIMD_LEVEL >= SIMD_LEVEL_AVX512 && !defined(__AVX512F__)
+#error AVX-512 kernels must be compiled with AVX-512 code generation.
+#elif SIMD_LEVEL == SIMD_LEVEL_AVX2 && !defined(__AVX2__)
+#error AVX2 kernels must be compiled with AVX2 code generation.
+#endif
+
+// the width of the vector registers, in bytes
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX512
+#define SIMD_WIDTH		64
+#elif SIMD_LEVEL == SIMD_LEVEL_AVX2
+#define SIMD_WIDTH		32
+#else
+#define SIMD_WIDTH		16
+#endif
+
+namespace
+{
+#include "nonlinearity.inl"
+#include "halfprecision.inl"
+
+	float __forceinline __abs_value(float x) { return ::fabsf(x); }
+	double __forceinline __abs_value(double x) { return ::fabs(x); }
+	template<typename T> T __forceinline __abs_value(T x) { return x < 0 ? T(-x) : x; }
+
+	float __forceinline __exp_value(float x) { return ::expf(x); }
+	double __forceinline __exp_value(double x) { return ::exp(x); }
+
+	float __forceinline __log_value(float x) { return ::logf(x); }
+	double __forceinline __log_value(double x) { return ::log(x); }
+
+#include "simdmath.inl"
+
+	// population count of a single word
+#if SIMD_LEVEL == SIMD_LEVEL_GENERIC
+	// POPCNT instruction may be missing, count the bits in parallel
+	unsigned __int32 __forceinline __popcount_value(unsigned __int32 x)
+	{
+		x = x - ((x >> 1) & 0x55555555u);
+		x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+		x = (x + (x >> 4)) & 0x0f0f0f0fu;
+		return (x * 0x01010101u) >> 24;
+	}
+
+	unsigned __int64 __forceinline __popcount_value(unsigned __int64 x)
+	{
+		x = x - ((x >> 1) & 0x5555555555555555ull);
+		x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+		x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return (x * 0x0101010101010101ull) >> 56;
+	}
+#else
+	unsigned __int32 __forceinline __popcount_value(unsigned __int32 x)
+	{
+		return __popcnt(x);
+	}
+
+	unsigned __int64 __forceinline __popcount_value(unsigned __int64 x)
+	{
+#if defined(_MSC_VER) && !defined(_WIN64)
+		return (unsigned __int64)(__popcnt(unsigned(x))) + __popcnt((unsigned)(x >> 32));
+#else
+		return __popcnt64(x);
+#endif
+	}
+#endif
+
+	// y := |x|
+	template<typename T> void __abs(int n, const T* x, T* y)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			y[i] = __abs_value(x[i]);
+		}
+	}
+
+	// the largest (Greater) or the smallest element; the elements are processed in independent lanes, one per vector element.
+	// The lanes start from x[0], so the elements that do not compare (NaN) are skipped the same way in every lane.
+	template<typename T, bool Greater> T __forceinline __best_value(int n, const T* x)
+	{
+		const int Lanes = SIMD_WIDTH / sizeof(T);
+
+		T best = x[0];
+		int i = 1;
+
+		if (n >= 2 * Lanes)
+		{
+			T lanes[Lanes];
+			for (int l = 0; l < Lanes; l++)
+			{
+				lanes[l] = best;
+			}
+
+			for (i = 0; i + Lanes <= n; i += Lanes)
+			{
+				for (int l = 0; l < Lanes; l++)
+				{
+					const T value = x[i + l];
+					lanes[l] = (Greater ? value > lanes[l] : value < lanes[l]) ? value : lanes[l];
+				}
+			}
+
+			for (int l = 0; l < Lanes; l++)
+			{
+				best = (Greater ? lanes[l] > best : lanes[l] < best) ? lanes[l] : best;
+			}
+		}
+
+		for (; i < n; i++)
+		{
+			best = (Greater ? x[i] > best : x[i] < best) ? x[i] : best;
+		}
+
+		return best;
+	}
+
+	template<typename T> T __forceinline __max_value(int n, const T* x)
+	{
+		return __best_value<T, true>(n, x);
+	}
+
+	// position of the first element equal to value, or -1;
+	// a block of elements is tested at once and searched only when it has a match
+	template<typename T> int __forceinline __find_value(int n, const T* x, const T value)
+	{
+		const int Lanes = SIMD_WIDTH / sizeof(T);
+
+		int i = 0;
+		for (; i + Lanes <= n; i += Lanes)
+		{
+			int match = 0;
+			for (int l = 0; l < Lanes; l++)
+			{
+				match |= x[i + l] == value;
+			}
+
+			if (match)
+			{
+				break;
+			}
+		}
+
+		for (; i < n; i++)
+		{
+			if (x[i] == value)
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+#if SIMD_FLOATS > 1
+	// the compiler keeps the float comparisons above scalar because of NaNs, the vector operations compare the same way
+	template<bool Greater> float __forceinline __best_value_f32(int n, const float* x)
+	{
+		float best = x[0];
+		int i = 1;
+
+		if (n >= 2 * SIMD_FLOATS)
+		{
+			__vfloat lanes = __vset(best);
+			for (i = 0; i + SIMD_FLOATS <= n; i += SIMD_FLOATS)
+			{
+				const __vfloat value = __vload(x + i);
+				lanes = __vselect(Greater ? __vless(lanes, value) : __vless(value, lanes), value, lanes);
+			}
+
+			float lane[SIMD_FLOATS];
+			__vstore(lane, lanes);
+			for (int l = 0; l < SIMD_FLOATS; l++)
+			{
+				best = (Greater ? lane[l] > best : lane[l] < best) ? lane[l] : best;
+			}
+		}
+
+		for (; i < n; i++)
+		{
+			best = (Greater ? x[i] > best : x[i] < best) ? x[i] : best;
+		}
+
+		return best;
+	}
+
+	template<> float __best_value<float, true>(int n, const float* x) { return __best_value_f32<true>(n, x); }
+	template<> float __best_value<float, false>(int n, const float* x) { return __best_value_f32<false>(n, x); }
+
+	template<> int __find_value<float>(int n, const float* x, const float value)
+	{
+		const __vfloat v = __vset(value);
+
+		int i = 0;
+		while (i + SIMD_FLOATS <= n && !__vany(__vequal(__vload(x + i), v)))
+		{
+			i += SIMD_FLOATS;
+		}
+
+		for (; i < n; i++)
+		{
+			if (x[i] == value)
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+#endif
+
+	// y := softmax(x)
+	template<typename T> void __softmax(int n, const T* x, T* y)
+	{
+		if (n <= 0)
+		{
+			return;
+		}
+
+		// compute max activation
+		const T amax = __max_value(n, x);
+
+		// compute exponentials (carefully to not blow up)
+		T esum = T(0);
+		for (int i = 0; i < n; i++)
+		{
+			y[i] = __exp_value(x[i] - amax);
+			esum += y[i];
+		}
+
+		// normalize and output to sum to one
+		if (esum != 0)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				y[i] /= esum;
+			}
+		}
+	}
+
+	// y := log(softmax(x))
+	template<typename T> void __logsoftmax(int n, const T* x, T* y)
+	{
+		if (n <= 0)
+		{
+			return;
+		}
+
+		const T amax = __max_value(n, x);
+
+		T esum = T(0);
+		for (int i = 0; i < n; i++)
+		{
+			esum += __exp_value(x[i] - amax);
+		}
+
+		// x - max is exact near the maximum, while max + log(sum) would be rounded to the ulp of max.
+		// The subtractions are separate passes, so fast math does not fold them back into x - (max + log(sum)).
+		for (int i = 0; i < n; i++)
+		{
+			y[i] = x[i] - amax;
+		}
+
+		const T lsum = __log_value(esum);
+		for (int i = 0; i < n; i++)
+		{
+			y[i] -= lsum;
+		}
+	}
+
+	// the scalar builds keep the generic softmax, the polynomial exp pays off only with vectors
+#if SIMD_FLOATS > 1
+	// The largest of n floats and the sum of exponentials relative to it, in a single pass over x (online softmax).
+	// Every lane keeps its own maximum and rescales its sum when the maximum grows.
+	// The exponents are kept above -87, so the lanes that have seen only -inf add nothing instead of NaN.
+	void __forceinline __softmax_normalizer(int n, const float* x, float& max, float& sum)
+	{
+		static const float lanes[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+		const __vfloat floor = __vset(-87.0f);
+		__vfloat vmax = __vset(-INFINITY);
+		__vfloat vsum = __vset(0.0f);
+
+		for (int i = 0; i < n; i += SIMD_FLOATS)
+		{
+			const int count = n - i;
+			const __vfloat v = count >= SIMD_FLOATS ?
+				__vload(x + i) :
+				__vselect(__vless(__vload(lanes), __vset(float(count))), __vload(x + i, count), __vset(-INFINITY));
+
+			const __vfloat newmax = __vmax(vmax, v);
+			vsum = __vfmadd(
+				vsum,
+				__exp_fast(__vmax(__vsub(vmax, newmax), floor)),
+				__exp_fast(__vmax(__vsub(v, newmax), floor)));
+			vmax = newmax;
+		}
+
+		float lane[SIMD_FLOATS];
+		__vstore(lane, vmax);
+
+		max = lane[0];
+		for (int l = 1; l < SIMD_FLOATS; l++)
+		{
+			max = lane[l] > max ? lane[l] : max;
+		}
+
+		// rescale the sums of the lanes to the common maximum
+		__vstore(lane, __vmul(vsum, __exp_fast(__vmax(__vsub(vmax, __vset(max)), floor))));
+
+		sum = 0.0f;
+		for (int l = 0; l < SIMD_FLOATS; l++)
+		{
+			sum += lane[l];
+		}
+	}
+
+	// y := a * exp(x - b)
+	void __forceinline __scaled_exp(int n, const float* x, float a, float b, float* y)
+	{
+		const __vfloat va = __vset(a);
+		const __vfloat vb = __vset(b);
+
+		for (int i = 0; i < n; i += SIMD_FLOATS)
+		{
+			const int count = n - i;
+			if (count >= SIMD_FLOATS)
+			{
+				__vstore(y + i, __vmul(va, __exp_fast(__vsub(__vload(x + i), vb))));
+			}
+			else
+			{
+				__vstore(y + i, __vmul(va, __exp_fast(__vsub(__vload(x + i, count), vb))), count);
+			}
+		}
+	}
+
+	template<> void __softmax<float>(int n, const float* x, float* y)
+	{
+		if (n <= 0)
+		{
+			return;
+		}
+
+		float max, sum;
+		__softmax_normalizer(n, x, max, sum);
+
+		// normalize with a multiplication by the reciprocal
+		__scaled_exp(n, x, sum != 0.0f ? 1.0f / sum : 1.0f, max, y);
+	}
+
+	template<> void __logsoftmax<float>(int n, const float* x, float* y)
+	{
+		if (n <= 0)
+		{
+			return;
+		}
+
+		float max, sum;
+		__softmax_normalizer(n, x, max, sum);
+
+		// two passes, see the generic __logsoftmax
+		for (int i = 0; i < n; i++)
+		{
+			y[i] = x[i] - max;
+		}
+
+		const float lsum = ::logf(sum);
+		for (int i = 0; i < n; i++)
+		{
+			y[i] -= lsum;
+		}
+	}
+#endif
+
+	// sum of |x - y|
+	template<typename T> T __manhattan_distance(int n, const T* x, const T* y)
+	{
+		const int Lanes = SIMD_WIDTH / sizeof(T);
+
+		T sums[Lanes] = {};
+		int i = 0;
+		for (; i + Lanes <= n; i += Lanes)
+		{
+			for (int l = 0; l < Lanes; l++)
+			{
+				sums[l] += __abs_value(x[i + l] - y[i + l]);
+			}
+		}
+
+		T sum = T(0);
+		for (int l = 0; l < Lanes; l++)
+		{
+			sum += sums[l];
+		}
+
+		for (; i < n; i++)
+		{
+			sum += __abs_value(x[i] - y[i]);
+		}
+
+		return sum;
+	}
+
+	// sum of (x - y)^2
+	template<typename T> T __euclidean_distance_squared(int n, const T* x, const T* y)
+	{
+		const int Lanes = SIMD_WIDTH / sizeof(T);
+
+		T sums[Lanes] = {};
+		int i = 0;
+		for (; i + Lanes <= n; i += Lanes)
+		{
+			for (int l = 0; l < Lanes; l++)
+			{
+				const T u = x[i + l] - y[i + l];
+				sums[l] += u * u;
+			}
+		}
+
+		T sum = T(0);
+		for (int l = 0; l < Lanes; l++)
+		{
+			sum += sums[l];
+		}
+
+		for (; i < n; i++)
+		{
+			const T u = x[i] - y[i];
+			sum += u * u;
+		}
+
+		return sum;
+	}
+
+	// number of different bits
+	template<typename T> T __hamming_distance(int n, const T* x, const T* y)
+	{
+		T sum = T(0);
+		for (int i = 0; i < n; i++)
+		{
+			sum += __popcount_value(T(x[i] ^ y[i]));
+		}
+
+		return sum;
+	}
+
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX2
+	// number of different bits in count blocks of SIMD_WIDTH bytes;
+	// the bits are counted with a lookup table of nibbles (vpshufb) and summed with vpsadbw
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX512
+	unsigned __int64 __forceinline __hamming_blocks(int count, const void* x, const void* y)
+	{
+		const __m512i table = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+		const __m512i nibble = _mm512_set1_epi8(0x0f);
+		const __m512i* vx = static_cast<const __m512i*>(x);
+		const __m512i* vy = static_cast<const __m512i*>(y);
+
+		__m512i sum = _mm512_setzero_si512();
+		for (int i = 0; i < count; i++)
+		{
+			const __m512i v = _mm512_xor_si512(_mm512_loadu_si512(vx + i), _mm512_loadu_si512(vy + i));
+			const __m512i bits = _mm512_add_epi8(
+				_mm512_shuffle_epi8(table, _mm512_and_si512(v, nibble)),
+				_mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble)));
+			sum = _mm512_add_epi64(sum, _mm512_sad_epu8(bits, _mm512_setzero_si512()));
+		}
+
+		unsigned __int64 lanes[8];
+		_mm512_storeu_si512(lanes, sum);
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+	}
+#else
+	unsigned __int64 __forceinline __hamming_blocks(int count, const void* x, const void* y)
+	{
+		const __m256i table = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i nibble = _mm256_set1_epi8(0x0f);
+		const __m256i* vx = static_cast<const __m256i*>(x);
+		const __m256i* vy = static_cast<const __m256i*>(y);
+
+		__m256i sum = _mm256_setzero_si256();
+		for (int i = 0; i < count; i++)
+		{
+			const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(vx + i), _mm256_loadu_si256(vy + i));
+			const __m256i bits = _mm256_add_epi8(
+				_mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble)),
+				_mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+			sum = _mm256_add_epi64(sum, _mm256_sad_epu8(bits, _mm256_setzero_si256()));
+		}
+
+		unsigned __int64 lanes[4];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+#endif
+
+	template<> unsigned __int32 __hamming_distance<unsigned __int32>(int n, const unsigned __int32* x, const unsigned __int32* y)
+	{
+		const int blocks = n / (SIMD_WIDTH / 4);
+		unsigned __int32 sum = static_cast<unsigned __int32>(__hamming_blocks(blocks, x, y));
+		for (int i = blocks * (SIMD_WIDTH / 4); i < n; i++)
+		{
+			sum += __popcount_value(static_cast<unsigned __int32>(x[i] ^ y[i]));
+		}
+
+		return sum;
+	}
+
+	template<> unsigned __int64 __hamming_distance<unsigned __int64>(int n, const unsigned __int64* x, const unsigned __int64* y)
+	{
+		const int blocks = n / (SIMD_WIDTH / 8);
+		unsigned __int64 sum = __hamming_blocks(blocks, x, y);
+		for (int i = blocks * (SIMD_WIDTH / 8); i < n; i++)
+		{
+			sum += __popcount_value(static_cast<unsigned __int64>(x[i] ^ y[i]));
+		}
+
+		return sum;
+	}
+#endif
+
+	template<typename T> T __popcount(int n, const T* x)
+	{
+		T sum = T(0);
+		for (int i = 0; i < n; i++)
+		{
+			sum += __popcount_value(x[i]);
+		}
+
+		return sum;
+	}
+
+	// nonlinearities
+	void __relu_array(int n, const float* x, float* y)
+	{
+		__nonlinearity<__relu>(0, n, x, y);
+	}
+
+	void __relu_gradient2_array(int n, float* dx, BOOL cleardx, const float* y, const float* dy)
+	{
+		__nonlinearity_gradient2<__relu_derivative2>(0, n, dx, cleardx, y, dy);
+	}
+
+	void __relu_gradient2_ip_array(int n, float* dxy, const float* y)
+	{
+		__nonlinearity_gradient2_ip<__relu_derivative2>(0, n, dxy, y);
+	}
+
+	void __sigmoid_array(int n, const float* x, float* y)
+	{
+		__nonlinearity<__sigmoid>(0, n, x, y);
+	}
+
+	void __sigmoid_gradient2_array(int n, float* dx, BOOL cleardx, const float* y, const float* dy)
+	{
+		__nonlinearity_gradient2<__sigmoid_derivative2>(0, n, dx, cleardx, y, dy);
+	}
+
+	void __sigmoid_gradient2_ip_array(int n, float* dxy, const float* y)
+	{
+		__nonlinearity_gradient2_ip<__sigmoid_derivative2>(0, n, dxy, y);
+	}
+
+	void __tanh_gradient2_array(int n, float* dx, BOOL cleardx, const float* y, const float* dy)
+	{
+		__nonlinearity_gradient2<__tanh_derivative2>(0, n, dx, cleardx, y, dy);
+	}
+
+	void __tanh_gradient2_ip_array(int n, float* dxy, const float* y)
+	{
+		__nonlinearity_gradient2_ip<__tanh_derivative2>(0, n, dxy, y);
+	}
+
+	// polynomial approximations
+	void __exp_fast_array(int n, const float* x, float* y)
+	{
+		__vtransform<__exp_fast>(n, x, y);
+	}
+
+	void __log_fast_array(int n, const float* x, float* y)
+	{
+		__vtransform<__log_fast>(n, x, y);
+	}
+
+	void __sigmoid_fast_array(int n, const float* x, float* y)
+	{
+		__vtransform<__sigmoid_fast>(n, x, y);
+	}
+
+	void __tanh_fast_array(int n, const float* x, float* y)
+	{
+		__vtransform<__tanh_fast>(n, x, y);
+	}
+
+	void __lstm_cell(int n, float* g, const float* sprev, float* s, float* y, float forgetBias)
+	{
+		float* jg = g + n;
+		float* fg = jg + n;
+		float* og = fg + n;
+
+		const __vfloat bias = __vset(forgetBias);
+
+		for (int i = 0; i < n; i += SIMD_FLOATS)
+		{
+			const int count = n - i;
+			const bool full = count >= SIMD_FLOATS;
+
+			const __vfloat igate = __sigmoid_fast(full ? __vload(g + i) : __vload(g + i, count));
+			const __vfloat jgate = __tanh_fast(full ? __vload(jg + i) : __vload(jg + i, count));
+			const __vfloat fgate = __sigmoid_fast(__vadd(full ? __vload(fg + i) : __vload(fg + i, count), bias));
+			const __vfloat ogate = __sigmoid_fast(full ? __vload(og + i) : __vload(og + i, count));
+
+			__vfloat state = __vmul(igate, jgate);
+			if (sprev != NULL)
+			{
+				state = __vfmadd(fgate, full ? __vload(sprev + i) : __vload(sprev + i, count), state);
+			}
+
+			const __vfloat output = __vmul(ogate, __tanh_fast(state));
+
+			if (full)
+			{
+				__vstore(g + i, igate);
+				__vstore(jg + i, jgate);
+				__vstore(fg + i, fgate);
+				__vstore(og + i, ogate);
+				__vstore(s + i, state);
+				__vstore(y + i, output);
+			}
+			else
+			{
+				__vstore(g + i, igate, count);
+				__vstore(jg + i, jgate, count);
+				__vstore(fg + i, fgate, count);
+				__vstore(og + i, ogate, count);
+				__vstore(s + i, state, count);
+				__vstore(y + i, output, count);
+			}
+		}
+	}
+
+	// y += A * x, A is packed by panels, see SIMDKernels::packed_gemv
+	// Each panel is streamed once and the partial sums of its rows stay in registers.
+	void __packed_gemv(int m, int n, const float* a, const float* x, float* y)
+	{
+		const int Lanes = SIMD_PACKED_ROWS / SIMD_FLOATS;
+
+		for (int i = 0; i < m; i += SIMD_PACKED_ROWS, a += n * SIMD_PACKED_ROWS)
+		{
+			__vfloat sum[Lanes];
+			for (int k = 0; k < Lanes; k++)
+			{
+				sum[k] = __vset(0.0f);
+			}
+
+			const float* aj = a;
+			for (int j = 0; j < n; j++, aj += SIMD_PACKED_ROWS)
+			{
+				const __vfloat xj = __vset(x[j]);
+				for (int k = 0; k < Lanes; k++)
+				{
+					sum[k] = __vadd(sum[k], __vmul(__vload(aj + (k * SIMD_FLOATS)), xj));
+				}
+			}
+
+			const int rows = __min(m - i, SIMD_PACKED_ROWS);
+			for (int k = 0; k < Lanes && k * SIMD_FLOATS < rows; k++)
+			{
+				float* yk = y + i + (k * SIMD_FLOATS);
+				const int count = rows - (k * SIMD_FLOATS);
+				if (count >= SIMD_FLOATS)
+				{
+					__vstore(yk, __vadd(__vload(yk), sum[k]));
+				}
+				else
+				{
+					__vstore(yk, __vadd(__vload(yk, count), sum[k]), count);
+				}
+			}
+		}
+	}
+
+	// Loads SIMD_FLOATS weights stored in 16 bits and converts them to single precision.
+	// bfloat16 is the upper half of a single precision number, half precision is converted by F16C.
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX512
+	template<bool BF16> __vfloat __forceinline __vload_h(const unsigned __int16* x)
+	{
+		const __m256i h = _mm256_loadu_si256((const __m256i*)x);
+		return BF16 ? _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16)) : _mm512_cvtph_ps(h);
+	}
+#elif SIMD_LEVEL == SIMD_LEVEL_AVX2
+	template<bool BF16> __vfloat __forceinline __vload_h(const unsigned __int16* x)
+	{
+		const __m128i h = _mm_loadu_si128((const __m128i*)x);
+		return BF16 ? _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16)) : _mm256_cvtph_ps(h);
+	}
+#else
+	template<bool BF16> __vfloat __forceinline __vload_h(const unsigned __int16* x)
+	{
+		return BF16 ? __bf16_to_f32(*x) : __f16_to_f32(*x);
+	}
+#endif
+
+	// y[v * ldy + i] += A * x[v * ldx] for V vectors and the rows < rows of one panel of 16-bit weights.
+	// Every column of the panel is converted once for all the vectors; the columns are split
+	// between U independent sums, so the additions do not wait for each other.
+	template<bool BF16, int V, int U> void __packed_gemm_h_panel(int n, const unsigned __int16* a, const float* x, int ldx, float* y, int ldy, int rows)
+	{
+		const int Lanes = SIMD_PACKED_ROWS / SIMD_FLOATS;
+
+		__vfloat sum[U][V][Lanes];
+		for (int u = 0; u < U; u++)
+		{
+			for (int v = 0; v < V; v++)
+			{
+				for (int k = 0; k < Lanes; k++)
+				{
+					sum[u][v][k] = __vset(0.0f);
+				}
+			}
+		}
+
+		int j = 0;
+		for (; j + U <= n; j += U)
+		{
+			for (int u = 0; u < U; u++)
+			{
+				const unsigned __int16* aj = a + ((ptrdiff_t(j) + u) * SIMD_PACKED_ROWS);
+
+				__vfloat w[Lanes];
+				for (int k = 0; k < Lanes; k++)
+				{
+					w[k] = __vload_h<BF16>(aj + (k * SIMD_FLOATS));
+				}
+
+				for (int v = 0; v < V; v++)
+				{
+					const __vfloat xj = __vset(x[(ptrdiff_t(v) * ldx) + j + u]);
+					for (int k = 0; k < Lanes; k++)
+					{
+						sum[u][v][k] = __vadd(sum[u][v][k], __vmul(w[k], xj));
+					}
+				}
+			}
+		}
+
+		for (; j < n; j++)
+		{
+			const unsigned __int16* aj = a + (ptrdiff_t(j) * SIMD_PACKED_ROWS);
+			for (int v = 0; v < V; v++)
+			{
+				const __vfloat xj = __vset(x[(ptrdiff_t(v) * ldx) + j]);
+				for (int k = 0; k < Lanes; k++)
+				{
+					sum[0][v][k] = __vadd(sum[0][v][k], __vmul(__vload_h<BF16>(aj + (k * SIMD_FLOATS)), xj));
+				}
+			}
+		}
+
+		for (int v = 0; v < V; v++)
+		{
+			float* yv = y + (ptrdiff_t(v) * ldy);
+			for (int k = 0; k < Lanes && k * SIMD_FLOATS < rows; k++)
+			{
+				__vfloat s = sum[0][v][k];
+				for (int u = 1; u < U; u++)
+				{
+					s = __vadd(s, sum[u][v][k]);
+				}
+
+				float* yk = yv + (k * SIMD_FLOATS);
+				const int count = rows - (k * SIMD_FLOATS);
+				if (count >= SIMD_FLOATS)
+				{
+					__vstore(yk, __vadd(__vload(yk), s));
+				}
+				else
+				{
+					__vstore(yk, __vadd(__vload(yk, count), s), count);
+				}
+			}
+		}
+	}
+
+	// y[v * ldy] += A * x[v * ldx] for count vectors, A holds 16-bit weights, see SIMDKernels::packed_gemm_f16
+	// Up to four vectors share a pass over a panel. The scalar builds keep 16 sums per panel already.
+	template<bool BF16> void __packed_gemm_h(int m, int n, int count, const unsigned __int16* a, const float* x, int ldx, float* y, int ldy)
+	{
+		for (int i = 0; i < m; i += SIMD_PACKED_ROWS, a += ptrdiff_t(n) * SIMD_PACKED_ROWS)
+		{
+			const int rows = __min(m - i, SIMD_PACKED_ROWS);
+
+			int v = 0;
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX2
+			for (; v + 4 <= count; v += 4)
+			{
+				__packed_gemm_h_panel<BF16, 4, 1>(n, a, x + (ptrdiff_t(v) * ldx), ldx, y + (ptrdiff_t(v) * ldy) + i, ldy, rows);
+			}
+
+			if (v + 2 <= count)
+			{
+				__packed_gemm_h_panel<BF16, 2, 2>(n, a, x + (ptrdiff_t(v) * ldx), ldx, y + (ptrdiff_t(v) * ldy) + i, ldy, rows);
+				v += 2;
+			}
+
+			if (v < count)
+			{
+				__packed_gemm_h_panel<BF16, 1, 4>(n, a, x + (ptrdiff_t(v) * ldx), ldx, y + (ptrdiff_t(v) * ldy) + i, ldy, rows);
+			}
+#else
+			for (; v < count; v++)
+			{
+				__packed_gemm_h_panel<BF16, 1, 1>(n, a, x + (ptrdiff_t(v) * ldx), ldx, y + (ptrdiff_t(v) * ldy) + i, ldy, rows);
+			}
+#endif
+		}
+	}
+
+	// CTC forward recursion, see SIMDKernels::ctc_step
+	// The sum is taken relative to the largest term, so it lies in [1, 3] and its logarithm is exact enough;
+	// the positions where all three terms are -inf stay -inf.
+	void __ctc_step(int n, const float* prev, const float* skip, const float* emit, float* next)
+	{
+		const __vfloat zero = __vset(0.0f);
+		const __vfloat lowest = __vset(-FLT_MAX);
+		const __vfloat floor = __vset(-87.0f);
+
+		for (int i = 0; i < n; i += SIMD_FLOATS)
+		{
+			const int count = n - i;
+			const bool full = count >= SIMD_FLOATS;
+
+			const __vfloat a = full ? __vload(prev + i) : __vload(prev + i, count);
+			const __vfloat b = full ? __vload(prev + i - 1) : __vload(prev + i - 1, count);
+			const __vfloat c = __vadd(
+				full ? __vload(prev + i - 2) : __vload(prev + i - 2, count),
+				full ? __vload(skip + i) : __vload(skip + i, count));
+
+			const __vfloat max = __vmax(__vmax(a, b), c);
+			const __vmask empty = __vless(max, lowest);
+			const __vfloat shift = __vselect(empty, zero, max);
+
+			// the terms below e^-87 do not change the sum, keeping them normal avoids slow subnormal arithmetic
+			const __vfloat sum = __vadd(
+				__vadd(__exp_fast(__vmax(__vsub(a, shift), floor)), __exp_fast(__vmax(__vsub(b, shift), floor))),
+				__exp_fast(__vmax(__vsub(c, shift), floor)));
+
+			__vfloat result = __vadd(__vadd(shift, __log_fast(sum)), full ? __vload(emit + i) : __vload(emit + i, count));
+			result = __vselect(empty, __vset(-INFINITY), result);
+
+			if (full)
+			{
+				__vstore(next + i, result);
+			}
+			else
+			{
+				__vstore(next + i, result, count);
+			}
+		}
+	}
+
+	// Number of output columns computed at once by the direct convolution for V vectors of filters,
+	// so the R * V sums, the V filter vectors and the broadcast input fit into the vector registers.
+	template<int V> struct __conv_direct_rows
+	{
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX512
+		static const int value = V == 1 ? 12 : V == 2 ? 12 : V == 3 ? 8 : 6;
+#else
+		static const int value = V == 1 ? 8 : V == 2 ? 6 : V == 3 ? 4 : 3;
+#endif
+	};
+
+	// R output columns by V vectors of filters, the last vector has count filters when Full is false.
+	template<int R, int V, bool Full> __forceinline void __conv_direct_tile(
+		int m, int kx, int k, const float* w, int kstep, const float* x, int xstep, int xstep1, float* y, int ldy, int count)
+	{
+		__vfloat sum[R][V];
+		for (int r = 0; r < R; r++)
+		{
+			for (int v = 0; v < V; v++)
+			{
+				const float* yv = y + (r * ldy) + (v * SIMD_FLOATS);
+				sum[r][v] = Full || v < V - 1 ? __vload(yv) : __vload(yv, count);
+			}
+		}
+
+		for (int i = 0; i < kx; i++, w += kstep, x += xstep1)
+		{
+			const float* wl = w;
+			for (int l = 0; l < k; l++, wl += m)
+			{
+				__vfloat wv[V];
+				for (int v = 0; v < V; v++)
+				{
+					wv[v] = Full || v < V - 1 ? __vload(wl + (v * SIMD_FLOATS)) : __vload(wl + (v * SIMD_FLOATS), count);
+				}
+
+				for (int r = 0; r < R; r++)
+				{
+					const __vfloat xr = __vset(x[(r * xstep) + l]);
+					for (int v = 0; v < V; v++)
+					{
+						sum[r][v] = __vadd(sum[r][v], __vmul(wv[v], xr));
+					}
+				}
+			}
+		}
+
+		for (int r = 0; r < R; r++)
+		{
+			for (int v = 0; v < V; v++)
+			{
+				float* yv = y + (r * ldy) + (v * SIMD_FLOATS);
+				if (Full || v < V - 1)
+				{
+					__vstore(yv, sum[r][v]);
+				}
+				else
+				{
+					__vstore(yv, sum[r][v], count);
+				}
+			}
+		}
+	}
+
+	template<int V, bool Full> void __conv_direct_panel(
+		int n, int m, int kx, int k, const float* w, int kstep, const float* x, int xstep, int xstep1, float* y, int ldy, int count)
+	{
+		const int R = __conv_direct_rows<V>::value;
+
+		int j = 0;
+		for (; j + R <= n; j += R)
+		{
+			__conv_direct_tile<R, V, Full>(m, kx, k, w, kstep, x + (ptrdiff_t(j) * xstep), xstep, xstep1, y + (ptrdiff_t(j) * ldy), ldy, count);
+		}
+
+		if (j + (R / 2) <= n)
+		{
+			__conv_direct_tile<R / 2, V, Full>(m, kx, k, w, kstep, x + (ptrdiff_t(j) * xstep), xstep, xstep1, y + (ptrdiff_t(j) * ldy), ldy, count);
+			j += R / 2;
+		}
+
+		for (; j < n; j++)
+		{
+			__conv_direct_tile<1, V, Full>(m, kx, k, w, kstep, x + (ptrdiff_t(j) * xstep), xstep, xstep1, y + (ptrdiff_t(j) * ldy), ldy, count);
+		}
+	}
+
+	template<int V> __forceinline void __conv_direct_vectors(
+		int n, int m, int kx, int k, const float* w, int kstep, const float* x, int xstep, int xstep1, float* y, int ldy, int count)
+	{
+		if (count == SIMD_FLOATS)
+		{
+			__conv_direct_panel<V, true>(n, m, kx, k, w, kstep, x, xstep, xstep1, y, ldy, count);
+		}
+		else
+		{
+			__conv_direct_panel<V, false>(n, m, kx, k, w, kstep, x, xstep, xstep1, y, ldy, count);
+		}
+	}
+
+	// Direct convolution, see SIMDKernels::conv_direct
+	// The filters are split into panels of up to four vectors; the sums of a block of output columns
+	// stay in registers while the whole kernel is applied, so y is read and written once per panel.
+	void __conv_direct(int n, int m, int kx, int k, const float* w, int kstep, const float* x, int xstep, int xstep1, float* y, int ldy)
+	{
+		for (int f = 0; f < m; f += 4 * SIMD_FLOATS)
+		{
+			const int width = __min(m - f, 4 * SIMD_FLOATS);
+			const int vectors = (width + SIMD_FLOATS - 1) / SIMD_FLOATS;
+			const int count = width - ((vectors - 1) * SIMD_FLOATS);
+
+			switch (vectors)
+			{
+			case 1:
+				__conv_direct_vectors<1>(n, m, kx, k, w + f, kstep, x, xstep, xstep1, y + f, ldy, count);
+				break;
+
+			case 2:
+				__conv_direct_vectors<2>(n, m, kx, k, w + f, kstep, x, xstep, xstep1, y + f, ldy, count);
+				break;
+
+			case 3:
+				__conv_direct_vectors<3>(n, m, kx, k, w + f, kstep, x, xstep, xstep1, y + f, ldy, count);
+				break;
+
+			default:
+				__conv_direct_vectors<4>(n, m, kx, k, w + f, kstep, x, xstep, xstep1, y + f, ldy, count);
+				break;
+			}
+		}
+	}
+
+	// One output of the depthwise convolution for V vectors of channels, the last vector has count channels when Full is false.
+	template<int V, bool Full> __forceinline void __conv_depthwise_tile(
+		int m, int kx, int ky, const float* w, int kstep, const float* x, int xstep1, int xstep2, float* y, int count)
+	{
+		__vfloat sum[V];
+		for (int v = 0; v < V; v++)
+		{
+			sum[v] = Full || v < V - 1 ? __vload(y + (v * SIMD_FLOATS)) : __vload(y + (v * SIMD_FLOATS), count);
+		}
+
+		for (int i = 0; i < kx; i++, w += kstep, x += xstep1)
+		{
+			const float* wl = w;
+			const float* xl = x;
+			for (int l = 0; l < ky; l++, wl += m, xl += xstep2)
+			{
+				for (int v = 0; v < V; v++)
+				{
+					const int offset = v * SIMD_FLOATS;
+					sum[v] = Full || v < V - 1 ?
+						__vadd(sum[v], __vmul(__vload(wl + offset), __vload(xl + offset))) :
+						__vadd(sum[v], __vmul(__vload(wl + offset, count), __vload(xl + offset, count)));
+				}
+			}
+		}
+
+		for (int v = 0; v < V; v++)
+		{
+			if (Full || v < V - 1)
+			{
+				__vstore(y + (v * SIMD_FLOATS), sum[v]);
+			}
+			else
+			{
+				__vstore(y + (v * SIMD_FLOATS), sum[v], count);
+			}
+		}
+	}
+
+	template<int V> void __conv_depthwise_vectors(
+		int n, int m, int kx, int ky, const float* w, int kstep, const float* x, int xstep, int xstep1, int xstep2, float* y, int ldy, int count)
+	{
+		for (int j = 0; j < n; j++, x += xstep, y += ldy)
+		{
+			if (count == SIMD_FLOATS)
+			{
+				__conv_depthwise_tile<V, true>(m, kx, ky, w, kstep, x, xstep1, xstep2, y, count);
+			}
+			else
+			{
+				__conv_depthwise_tile<V, false>(m, kx, ky, w, kstep, x, xstep1, xstep2, y, count);
+			}
+		}
+	}
+
+	// Depthwise convolution, see SIMDKernels::conv_depthwise
+	// The channels are split into panels of up to four vectors whose sums stay in registers while the kernel is applied.
+	void __conv_depthwise(int n, int m, int kx, int ky, const float* w, int kstep, const float* x, int xstep, int xstep1, int xstep2, float* y, int ldy)
+	{
+		for (int c = 0; c < m; c += 4 * SIMD_FLOATS)
+		{
+			const int width = __min(m - c, 4 * SIMD_FLOATS);
+			const int vectors = (width + SIMD_FLOATS - 1) / SIMD_FLOATS;
+			const int count = width - ((vectors - 1) * SIMD_FLOATS);
+
+			switch (vectors)
+			{
+			case 1:
+				__conv_depthwise_vectors<1>(n, m, kx, ky, w + c, kstep, x + c, xstep, xstep1, xstep2, y + c, ldy, count);
+				break;
+
+			case 2:
+				__conv_depthwise_vectors<2>(n, m, kx, ky, w + c, kstep, x + c, xstep, xstep1, xstep2, y + c, ldy, count);
+				break;
+
+			case 3:
+				__conv_depthwise_vectors<3>(n, m, kx, ky, w + c, kstep, x + c, xstep, xstep1, xstep2, y + c, ldy, count);
+				break;
+
+			default:
+				__conv_depthwise_vectors<4>(n, m, kx, ky, w + c, kstep, x + c, xstep, xstep1, xstep2, y + c, ldy, count);
+				break;
+			}
+		}
+	}
+
+	// Input gradient of the depthwise convolution, see SIMDKernels::conv_depthwise_dx
+	void __conv_depthwise_dx(int n, int m, int kx, int ky, const float* w, int kstep, float* dx, int xstep, int xstep1, int xstep2, const float* dy, int ldy)
+	{
+		for (int j = 0; j < n; j++, dx += xstep, dy += ldy)
+		{
+			for (int c = 0; c < m; c += SIMD_FLOATS)
+			{
+				const int count = m - c;
+				const bool full = count >= SIMD_FLOATS;
+				const __vfloat d = full ? __vload(dy + c) : __vload(dy + c, count);
+
+				const float* wi = w + c;
+				float* dxi = dx + c;
+				for (int i = 0; i < kx; i++, wi += kstep, dxi += xstep1)
+				{
+					const float* wl = wi;
+					float* dxl = dxi;
+					for (int l = 0; l < ky; l++, wl += m, dxl += xstep2)
+					{
+						if (full)
+						{
+							__vstore(dxl, __vadd(__vload(dxl), __vmul(__vload(wl), d)));
+						}
+						else
+						{
+							__vstore(dxl, __vadd(__vload(dxl, count), __vmul(__vload(wl, count), d)), count);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Weights gradient of the depthwise convolution, see SIMDKernels::conv_depthwise_dw
+	// The gradient of one kernel element stays in a register while the outputs are summed.
+	void __conv_depthwise_dw(int n, int m, int kx, int ky, float* dw, int kstep, const float* x, int xstep, int xstep1, int xstep2, const float* dy, int ldy)
+	{
+		for (int c = 0; c < m; c += SIMD_FLOATS)
+		{
+			const int count = m - c;
+			const bool full = count >= SIMD_FLOATS;
+
+			for (int i = 0; i < kx; i++)
+			{
+				for (int l = 0; l < ky; l++)
+				{
+					float* dwl = dw + (ptrdiff_t(i) * kstep) + (ptrdiff_t(l) * m) + c;
+					const float* xl = x + (ptrdiff_t(i) * xstep1) + (ptrdiff_t(l) * xstep2) + c;
+					const float* dyl = dy + c;
+
+					__vfloat sum = full ? __vload(dwl) : __vload(dwl, count);
+					for (int j = 0; j < n; j++, xl += xstep, dyl += ldy)
+					{
+						sum = full ?
+							__vadd(sum, __vmul(__vload(xl), __vload(dyl))) :
+							__vadd(sum, __vmul(__vload(xl, count), __vload(dyl, count)));
+					}
+
+					if (full)
+					{
+						__vstore(dwl, sum);
+					}
+					else
+					{
+						__vstore(dwl, sum, count);
+					}
+				}
+			}
+		}
+	}
+
+	// Products of unsigned and signed bytes summed into 32-bit integers.
+	// The bytes are widened to 16 bits and multiplied by pairs, so the sums are exact for any input,
+	// unlike the u8 x s8 instruction that saturates the sum of each pair to 16 bits.
+#if SIMD_LEVEL == SIMD_LEVEL_AVX512
+#define SIMD_DOT_BYTES	32
+	typedef __m512i			__vdot;
+	__forceinline __vdot __vdot_zero() { return _mm512_setzero_si512(); }
+	__forceinline __vdot __vdot_load(const unsigned __int8* x) { return _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)x)); }
+	__forceinline __vdot __vdot_load(const __int8* x) { return _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)x)); }
+	__forceinline __vdot __vdot_madd(__vdot s, __vdot a, __vdot b) { return _mm512_add_epi32(s, _mm512_madd_epi16(a, b)); }
+	__forceinline __int32 __vdot_sum(__vdot s) { return _mm512_reduce_add_epi32(s); }
+#elif SIMD_LEVEL == SIMD_LEVEL_AVX2
+#define SIMD_DOT_BYTES	16
+	typedef __m256i			__vdot;
+	__forceinline __vdot __vdot_zero() { return _mm256_setzero_si256(); }
+	__forceinline __vdot __vdot_load(const unsigned __int8* x) { return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)x)); }
+	__forceinline __vdot __vdot_load(const __int8* x) { return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)x)); }
+	__forceinline __vdot __vdot_madd(__vdot s, __vdot a, __vdot b) { return _mm256_add_epi32(s, _mm256_madd_epi16(a, b)); }
+	__forceinline __int32 __vdot_sum(__vdot s)
+	{
+		__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+		return _mm_cvtsi128_si32(sum);
+	}
+#else
+#define SIMD_DOT_BYTES	0
+#endif
+
+	// R rows of a by C rows of b; the sums stay in registers while the k bytes are streamed once.
+	template<int R, int C> __forceinline void __gemm_u8s8_tile(
+		int k, const unsigned __int8* a, int lda, const __int8* b, int ldb, __int32* c, int ldc)
+	{
+		__int32 sum[R][C];
+		int l = 0;
+
+#if SIMD_DOT_BYTES > 0
+		__vdot acc[R][C];
+		for (int r = 0; r < R; r++)
+		{
+			for (int j = 0; j < C; j++)
+			{
+				acc[r][j] = __vdot_zero();
+			}
+		}
+
+		for (; l + SIMD_DOT_BYTES <= k; l += SIMD_DOT_BYTES)
+		{
+			__vdot ar[R];
+			for (int r = 0; r < R; r++)
+			{
+				ar[r] = __vdot_load(a + (ptrdiff_t(r) * lda) + l);
+			}
+
+			for (int j = 0; j < C; j++)
+			{
+				const __vdot bj = __vdot_load(b + (ptrdiff_t(j) * ldb) + l);
+				for (int r = 0; r < R; r++)
+				{
+					acc[r][j] = __vdot_madd(acc[r][j], ar[r], bj);
+				}
+			}
+		}
+
+		for (int r = 0; r < R; r++)
+		{
+			for (int j = 0; j < C; j++)
+			{
+				sum[r][j] = __vdot_sum(acc[r][j]);
+			}
+		}
+#else
+		for (int r = 0; r < R; r++)
+		{
+			for (int j = 0; j < C; j++)
+			{
+				sum[r][j] = 0;
+			}
+		}
+#endif
+
+		for (; l < k; l++)
+		{
+			for (int r = 0; r < R; r++)
+			{
+				const __int32 ar = a[(ptrdiff_t(r) * lda) + l];
+				for (int j = 0; j < C; j++)
+				{
+					sum[r][j] += ar * b[(ptrdiff_t(j) * ldb) + l];
+				}
+			}
+		}
+
+		for (int r = 0; r < R; r++)
+		{
+			for (int j = 0; j < C; j++)
+			{
+				c[(ptrdiff_t(r) * ldc) + j] = sum[r][j];
+			}
+		}
+	}
+
+	template<int R> void __gemm_u8s8_rows(
+		int n, int k, const unsigned __int8* a, int lda, const __int8* b, int ldb, __int32* c, int ldc)
+	{
+		int j = 0;
+		for (; j + 4 <= n; j += 4)
+		{
+			__gemm_u8s8_tile<R, 4>(k, a, lda, b + (ptrdiff_t(j) * ldb), ldb, c + j, ldc);
+		}
+
+		for (; j < n; j++)
+		{
+			__gemm_u8s8_tile<R, 1>(k, a, lda, b + (ptrdiff_t(j) * ldb), ldb, c + j, ldc);
+		}
+	}
+
+#if SIMD_LEVEL == SIMD_LEVEL_AVX512VNNI
+	// R rows of a by V blocks of packed b: four bytes of a row are broadcast to every lane
+	// and each instruction adds them times the next four bytes of 16 columns to 16 sums.
+	template<int R, int V> __forceinline void __gemm_u8s8_packed_tile(
+		int k, const unsigned __int8* a, int lda, const __int8* packed, int groups, __int32* c, int ldc, __mmask16 last)
+	{
+		__m512i acc[R][V];
+		for (int r = 0; r < R; r++)
+		{
+			for (int v = 0; v < V; v++)
+			{
+				acc[r][v] = _mm512_setzero_si512();
+			}
+		}
+
+		for (int g = 0; g < groups; g++)
+		{
+			__m512i bv[V];
+			for (int v = 0; v < V; v++)
+			{
+				bv[v] = _mm512_loadu_si512((const void*)(packed + (((ptrdiff_t(v) * groups) + g) * 64)));
+			}
+
+			// the bytes past the end of the rows meet the zeros that pad the last group
+			const int count = __min(4, k - (g * 4));
+			for (int r = 0; r < R; r++)
+			{
+				const unsigned __int8* ar = a + (ptrdiff_t(r) * lda) + (g * 4);
+
+				__int32 bytes = 0;
+				if (count == 4)
+				{
+					::memcpy(&bytes, ar, 4);
+				}
+				else
+				{
+					for (int l = 0; l < count; l++)
+					{
+						bytes |= __int32(ar[l]) << (8 * l);
+					}
+				}
+
+				const __m512i av = _mm512_set1_epi32(bytes);
+				for (int v = 0; v < V; v++)
+				{
+					acc[r][v] = _mm512_dpbusd_epi32(acc[r][v], av, bv[v]);
+				}
+			}
+		}
+
+		for (int r = 0; r < R; r++)
+		{
+			for (int v = 0; v < V; v++)
+			{
+				_mm512_mask_storeu_epi32(c + (ptrdiff_t(r) * ldc) + (v * 16), v == V - 1 ? last : __mmask16(0xffff), acc[r][v]);
+			}
+		}
+	}
+
+	template<int R> void __gemm_u8s8_packed_rows(
+		int n, int k, const unsigned __int8* a, int lda, const __int8* packed, __int32* c, int ldc)
+	{
+		const int groups = (k + 3) / 4;
+		const ptrdiff_t blocksize = ptrdiff_t(groups) * 64;
+
+		int j = 0;
+		for (; j + 64 <= n; j += 64)
+		{
+			__gemm_u8s8_packed_tile<R, 4>(k, a, lda, packed + ((j / 16) * blocksize), groups, c + j, ldc, 0xffff);
+		}
+
+		for (; j < n; j += 16)
+		{
+			const __mmask16 last = n - j >= 16 ? __mmask16(0xffff) : __mmask16((1u << (n - j)) - 1);
+			__gemm_u8s8_packed_tile<R, 1>(k, a, lda, packed + ((j / 16) * blocksize), groups, c + j, ldc, last);
+		}
+	}
+
+	// With VNNI the rows of b are packed by blocks of 16: group g of a block holds bytes 4g..4g+3 of its 16 rows
+	// one row after another, and zeros pad the last group and the last block.
+	size_t __gemm_u8s8_packsize(int n, int k)
+	{
+		return size_t((n + 15) / 16) * ((k + 3) / 4) * 64;
+	}
+
+	void __gemm_u8s8_pack(int n, int k, const __int8* b, int ldb, __int8* packed)
+	{
+		const int groups = (k + 3) / 4;
+		::memset(packed, 0, __gemm_u8s8_packsize(n, k));
+
+		for (int j = 0; j < n; j++)
+		{
+			const __int8* bj = b + (ptrdiff_t(j) * ldb);
+			__int8* pj = packed + ((ptrdiff_t(j / 16) * groups) * 64) + ((j % 16) * 4);
+			for (int l = 0; l < k; l++)
+			{
+				pj[((l / 4) * 64) + (l % 4)] = bj[l];
+			}
+		}
+	}
+
+	// Integer matrix product, see SIMDKernels::gemm_u8s8
+	// Blocks of four rows of a by 64 columns keep 16 sums in every one of 16 registers.
+	void __gemm_u8s8(int m, int n, int k, const unsigned __int8* a, int lda, const __int8* packed, __int32* c, int ldc)
+	{
+		int i = 0;
+		for (; i + 4 <= m; i += 4)
+		{
+			__gemm_u8s8_packed_rows<4>(n, k, a + (ptrdiff_t(i) * lda), lda, packed, c + (ptrdiff_t(i) * ldc), ldc);
+		}
+
+		for (; i < m; i++)
+		{
+			__gemm_u8s8_packed_rows<1>(n, k, a + (ptrdiff_t(i) * lda), lda, packed, c + (ptrdiff_t(i) * ldc), ldc);
+		}
+	}
+#else
+	// Without VNNI the packed rows of b are simply k bytes long.
+	size_t __gemm_u8s8_packsize(int n, int k)
+	{
+		return size_t(n) * k;
+	}
+
+	void __gemm_u8s8_pack(int n, int k, const __int8* b, int ldb, __int8* packed)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			::memcpy(packed + (ptrdiff_t(j) * k), b + (ptrdiff_t(j) * ldb), k);
+		}
+	}
+
+	// Integer matrix product, see SIMDKernels::gemm_u8s8
+	// Blocks of two rows of a by four rows of b share every load of the other operand.
+	void __gemm_u8s8(int m, int n, int k, const unsigned __int8* a, int lda, const __int8* packed, __int32* c, int ldc)
+	{
+		int i = 0;
+		for (; i + 2 <= m; i += 2)
+		{
+			__gemm_u8s8_rows<2>(n, k, a + (ptrdiff_t(i) * lda), lda, packed, k, c + (ptrdiff_t(i) * ldc), ldc);
+		}
+
+		if (i < m)
+		{
+			__gemm_u8s8_rows<1>(n, k, a + (ptrdiff_t(i) * lda), lda, packed, k, c + (ptrdiff_t(i) * ldc), ldc);
+		}
+	}
+#endif
+
+	// Position of the first smallest or largest (Greater is true) element.
+	// The best value is found with a vector reduction and its first position with a vector search,
+	// which is faster than carrying the positions along, especially for the narrow types.
+	template<typename T, bool Greater> int __argbest(int n, const T* x)
+	{
+		if (n <= 0)
+		{
+			return 0;
+		}
+
+		// nothing matches when x[0] is NaN, the sequential loop returns 0 then
+		const int win = __find_value(n, x, __best_value<T, Greater>(n, x));
+		return win >= 0 ? win : 0;
+	}
+
+	template<typename T> int __argmin(int n, const T* x) { return __argbest<T, false>(n, x); }
+	template<typename T> int __argmax(int n, const T* x) { return __argbest<T, true>(n, x); }
+
+	// y := y op x
+	template<typename T> void __bits_or(int n, const T* x, T* y)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			y[i] |= x[i];
+		}
+	}
+
+	template<typename T> void __bits_and(int n, const T* x, T* y)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			y[i] &= x[i];
+		}
+	}
+
+	template<typename T> void __bits_xand(int n, const T* x, T* y)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			y[i] &= ~x[i];
+		}
+	}
+
+	template<typename T> void __bits_xor(int n, const T* x, T* y)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			y[i] ^= x[i];
+		}
+	}
+
+	// exchanges n bytes one vector at a time
+	void __swap(size_t n, void* x, void* y)
+	{
+		unsigned char* px = static_cast<unsigned char*>(x);
+		unsigned char* py = static_cast<unsigned char*>(y);
+
+		for (; n >= SIMD_WIDTH; n -= SIMD_WIDTH, px += SIMD_WIDTH, py += SIMD_WIDTH)
+		{
+			unsigned char tx[SIMD_WIDTH];
+			unsigned char ty[SIMD_WIDTH];
+			::memcpy(tx, px, SIMD_WIDTH);
+			::memcpy(ty, py, SIMD_WIDTH);
+			::memcpy(px, ty, SIMD_WIDTH);
+			::memcpy(py, tx, SIMD_WIDTH);
+		}
+
+		for (size_t i = 0; i < n; i++)
+		{
+			const unsigned char temp = px[i];
+			px[i] = py[i];
+			py[i] = temp;
+		}
+	}
+}
+
+extern const SIMDKernels SIMD_KERNELS_NAME =
+{
+	SIMD_KERNELS_ISA,
+	SIMD_FLOATS,
+
+	__abs<__int8>,
+	__abs<__int16>,
+	__abs<__int32>,
+	__abs<__int64>,
+	__abs<float>,
+	__abs<double>,
+
+	__softmax<float>,
+	__softmax<double>,
+	__logsoftmax<float>,
+	__logsoftmax<double>,
+
+	__manhattan_distance<float>,
+	__manhattan_distance<double>,
+	__euclidean_distance_squared<float>,
+	__euclidean_distance_squared<double>,
+	__hamming_distance<unsigned __int32>,
+	__hamming_distance<unsigned __int64>,
+
+	__relu_array,
+	__relu_gradient2_array,
+	__relu_gradient2_ip_array,
+	__sigmoid_array,
+	__sigmoid_gradient2_array,
+	__sigmoid_gradient2_ip_array,
+	__tanh_gradient2_array,
+	__tanh_gradient2_ip_array,
+
+	__exp_fast_array,
+	__log_fast_array,
+	__sigmoid_fast_array,
+	__tanh_fast_array,
+	__lstm_cell,
+	__packed_gemv,
+	__packed_gemm_h<false>,
+	__packed_gemm_h<true>,
+	__ctc_step,
+	__conv_direct,
+	__conv_depthwise,
+	__conv_depthwise_dx,
+	__conv_depthwise_dw,
+	__gemm_u8s8_packsize,
+	__gemm_u8s8_pack,
+	__gemm_u8s8,
+
+	__argmin<__int8>,
+	__argmin<__int16>,
+	__argmin<__int32>,
+	__argmin<__int64>,
+	__argmin<unsigned __int8>,
+	__argmin<unsigned __int16>,
+	__argmin<unsigned __int32>,
+	__argmin<unsigned __int64>,
+	__argmin<float>,
+	__argmin<double>,
+	__argmax<__int8>,
+	__argmax<__int16>,
+	__argmax<__int32>,
+	__argmax<__int64>,
+	__argmax<unsigned __int8>,
+	__argmax<unsigned __int16>,
+	__argmax<unsigned __int32>,
+	__argmax<unsigned __int64>,
+	__argmax<float>,
+	__argmax<double>,
+
+	__popcount<unsigned __int32>,
+	__popcount<unsigned __int64>,
+	__bits_or<unsigned __int32>,
+	__bits_or<unsigned __int64>,
+	__bits_and<unsigned __int32>,
+	__bits_and<unsigned __int64>,
+	__bits_xand<unsigned __int32>,
+	__bits_xand<unsigned __int64>,
+	__bits_xor<unsigned __int32>,
+	__bits_xor<unsigned __int64>,
+
+	__swap,
+};
@@ -0,0 +1,13 @@
+#include "stdafx.h"
+#include "simddetect.h"
+
+#if defined(SIMD_X86)
+
+// AVX2, FMA and F16C, see the compiler options of this file
+#define SIMD_LEVEL				SIMD_LEVEL_AVX2
+#define SIMD_KERNELS_NAME		__simd_kernels_avx2
+#define SIMD_KERNELS_ISA		"avx2"
+
+#include "simdkernels.inl"
+
+#endif
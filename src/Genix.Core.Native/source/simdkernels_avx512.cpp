@@ -0,0 +1,13 @@
+#include "stdafx.h"
+#include "simddetect.h"
+
+#if defined(SIMD_X86)
+
+// AVX-512 F, BW and VL, see the compiler options of this file
+#define SIMD_LEVEL				SIMD_LEVEL_AVX512
+#define SIMD_KERNELS_NAME		__simd_kernels_avx512
+#define SIMD_KERNELS_ISA		"avx512"
+
+#include "simdkernels.inl"
+
+#endif
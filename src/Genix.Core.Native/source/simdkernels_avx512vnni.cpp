@@ -0,0 +1,14 @@
+#include "stdafx.h"
+#include "simddetect.h"
+
+#if defined(SIMD_X86)
+
+// AVX-512 F, BW, VL and VNNI, see the compiler options of this file;
+// the same kernels as the AVX-512 ones except for the 8-bit integer products
+#define SIMD_LEVEL				SIMD_LEVEL_AVX512VNNI
+#define SIMD_KERNELS_NAME		__simd_kernels_avx512vnni
+#define SIMD_KERNELS_ISA		"avx512vnni"
+
+#include "simdkernels.inl"
+
+#endif
@@ -0,0 +1,12 @@
+#include "stdafx.h"
+
+// baseline instruction set: SSE2 on x86, NEON on ARM
+#define SIMD_LEVEL				SIMD_LEVEL_GENERIC
+#define SIMD_KERNELS_NAME		__simd_kernels_generic
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define SIMD_KERNELS_ISA		"neon"
+#else
+#define SIMD_KERNELS_ISA		"generic"
+#endif
+
+#include "simdkernels.inl"
@@ -0,0 +1,13 @@
+#include "stdafx.h"
+#include "simddetect.h"
+
+#if defined(SIMD_X86)
+
+// SSE4.1 and POPCNT, see the compiler options of this file
+#define SIMD_LEVEL				SIMD_LEVEL_SSE41
+#define SIMD_KERNELS_NAME		__simd_kernels_sse41
+#define SIMD_KERNELS_ISA		"sse41"
+
+#include "simdkernels.inl"
+
+#endif
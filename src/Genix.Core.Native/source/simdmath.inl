@@ -0,0 +1,313 @@
+// Polynomial approximations of exp, log, sigmoid and tanh.
+//
+// The functions are written once over a small set of vector operations (__vfloat, __vadd, ...)
+// that map onto AVX-512, AVX2 or plain scalar code depending on SIMD_LEVEL.
+// Included by simdkernels.inl inside of its anonymous namespace.
+//
+// Maximum error, measured over all finite single precision inputs against double precision results:
+//   __exp_fast			2 ulp
+//   __log_fast			1 ulp
+//   __sigmoid_fast		3 ulp
+//   __tanh_fast		2 ulp
+// Infinities, NaNs and overflow are handled: exp(+inf) = +inf, exp(-inf) = 0, exp(NaN) = NaN,
+// log(0) = -inf, log(+inf) = +inf, log(x < 0) = NaN,
+// sigmoid(+-inf) = 1 or 0, tanh(+-inf) = +-1. Results smaller than FLT_MIN may be flushed to zero.
+
+#if SIMD_LEVEL >= SIMD_LEVEL_AVX512
+
+#define SIMD_FLOATS		16
+
+typedef __m512			__vfloat;
+typedef __mmask16		__vmask;
+
+__forceinline __vfloat __vset(float a) { return _mm512_set1_ps(a); }
+__forceinline __vfloat __vload(const float* x) { return _mm512_loadu_ps(x); }
+__forceinline void __vstore(float* y, __vfloat a) { _mm512_storeu_ps(y, a); }
+
+// loads and stores first n < SIMD_FLOATS elements
+__forceinline __vfloat __vload(const float* x, int n) { return _mm512_maskz_loadu_ps((__mmask16)((1u << n) - 1), x); }
+__forceinline void __vstore(float* y, __vfloat a, int n) { _mm512_mask_storeu_ps(y, (__mmask16)((1u << n) - 1), a); }
+
+__forceinline __vfloat __vadd(__vfloat a, __vfloat b) { return _mm512_add_ps(a, b); }
+__forceinline __vfloat __vsub(__vfloat a, __vfloat b) { return _mm512_sub_ps(a, b); }
+__forceinline __vfloat __vmul(__vfloat a, __vfloat b) { return _mm512_mul_ps(a, b); }
+__forceinline __vfloat __vdiv(__vfloat a, __vfloat b) { return _mm512_div_ps(a, b); }
+
+// a * b + c and c - a * b
+__forceinline __vfloat __vfmadd(__vfloat a, __vfloat b, __vfloat c) { return _mm512_fmadd_ps(a, b, c); }
+__forceinline __vfloat __vfnmadd(__vfloat a, __vfloat b, __vfloat c) { return _mm512_fnmadd_ps(a, b, c); }
+
+// limits b to the range [lo, hi], NaNs are returned unchanged
+__forceinline __vfloat __vclamp(__vfloat lo, __vfloat b, __vfloat hi) { return _mm512_min_ps(hi, _mm512_max_ps(lo, b)); }
+
+__forceinline __vfloat __vround(__vfloat a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+__forceinline __vfloat __vabs(__vfloat a) { return _mm512_abs_ps(a); }
+
+// the magnitude of a with the sign of b
+__forceinline __vfloat __vcopysign(__vfloat a, __vfloat b)
+{
+	const __m512i sign = _mm512_set1_epi32(0x80000000);
+	return _mm512_castsi512_ps(_mm512_ternarylogic_epi32(sign, _mm512_castps_si512(a), _mm512_castps_si512(b), 0xac));
+}
+
+__forceinline __vfloat __vmax(__vfloat a, __vfloat b) { return _mm512_max_ps(a, b); }
+
+__forceinline __vmask __vless(__vfloat a, __vfloat b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+__forceinline __vmask __vequal(__vfloat a, __vfloat b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+__forceinline bool __vany(__vmask mask) { return mask != 0; }
+__forceinline __vfloat __vselect(__vmask mask, __vfloat a, __vfloat b) { return _mm512_mask_blend_ps(mask, b, a); }
+
+// splits positive normal a into a mantissa in [0.5, 1), that is returned, and the exponent e
+__forceinline __vfloat __vfrexp(__vfloat a, __vfloat& e)
+{
+	e = _mm512_add_ps(_mm512_getexp_ps(a), _mm512_set1_ps(1.0f));
+	return _mm512_getmant_ps(a, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_zero);
+}
+
+// a * 2^n, where n is an integer in the range [-254, 254]
+__forceinline __vfloat __vscale(__vfloat a, __vfloat n)
+{
+	const __m512i n0 = _mm512_cvtps_epi32(n);
+	const __m512i n1 = _mm512_srai_epi32(n0, 1);
+	const __m512i n2 = _mm512_sub_epi32(n0, n1);
+	const __m512i bias = _mm512_set1_epi32(127);
+	a = _mm512_mul_ps(a, _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n1, bias), 23)));
+	return _mm512_mul_ps(a, _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n2, bias), 23)));
+}
+
+#elif SIMD_LEVEL == SIMD_LEVEL_AVX2
+
+#define SIMD_FLOATS		8
+
+typedef __m256			__vfloat;
+typedef __m256			__vmask;
+
+__forceinline __vfloat __vset(float a) { return _mm256_set1_ps(a); }
+__forceinline __vfloat __vload(const float* x) { return _mm256_loadu_ps(x); }
+__forceinline void __vstore(float* y, __vfloat a) { _mm256_storeu_ps(y, a); }
+
+__forceinline __m256i __vtailmask(int n)
+{
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+__forceinline __vfloat __vload(const float* x, int n) { return _mm256_maskload_ps(x, __vtailmask(n)); }
+__forceinline void __vstore(float* y, __vfloat a, int n) { _mm256_maskstore_ps(y, __vtailmask(n), a); }
+
+__forceinline __vfloat __vadd(__vfloat a, __vfloat b) { return _mm256_add_ps(a, b); }
+__forceinline __vfloat __vsub(__vfloat a, __vfloat b) { return _mm256_sub_ps(a, b); }
+__forceinline __vfloat __vmul(__vfloat a, __vfloat b) { return _mm256_mul_ps(a, b); }
+__forceinline __vfloat __vdiv(__vfloat a, __vfloat b) { return _mm256_div_ps(a, b); }
+
+__forceinline __vfloat __vfmadd(__vfloat a, __vfloat b, __vfloat c) { return _mm256_fmadd_ps(a, b, c); }
+__forceinline __vfloat __vfnmadd(__vfloat a, __vfloat b, __vfloat c) { return _mm256_fnmadd_ps(a, b, c); }
+
+__forceinline __vfloat __vclamp(__vfloat lo, __vfloat b, __vfloat hi) { return _mm256_min_ps(hi, _mm256_max_ps(lo, b)); }
+
+__forceinline __vfloat __vround(__vfloat a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+__forceinline __vfloat __vabs(__vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+
+__forceinline __vfloat __vcopysign(__vfloat a, __vfloat b)
+{
+	const __m256 sign = _mm256_set1_ps(-0.0f);
+	return _mm256_or_ps(_mm256_andnot_ps(sign, a), _mm256_and_ps(sign, b));
+}
+
+__forceinline __vfloat __vmax(__vfloat a, __vfloat b) { return _mm256_max_ps(a, b); }
+
+__forceinline __vmask __vless(__vfloat a, __vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+__forceinline __vmask __vequal(__vfloat a, __vfloat b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+__forceinline bool __vany(__vmask mask) { return _mm256_movemask_ps(mask) != 0; }
+__forceinline __vfloat __vselect(__vmask mask, __vfloat a, __vfloat b) { return _mm256_blendv_ps(b, a, mask); }
+
+__forceinline __vfloat __vfrexp(__vfloat a, __vfloat& e)
+{
+	const __m256i bits = _mm256_castps_si256(a);
+	e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+	return _mm256_castsi256_ps(_mm256_or_si256(
+		_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+		_mm256_set1_epi32(0x3f000000)));
+}
+
+__forceinline __vfloat __vscale(__vfloat a, __vfloat n)
+{
+	const __m256i n0 = _mm256_cvtps_epi32(n);
+	const __m256i n1 = _mm256_srai_epi32(n0, 1);
+	const __m256i n2 = _mm256_sub_epi32(n0, n1);
+	const __m256i bias = _mm256_set1_epi32(127);
+	a = _mm256_mul_ps(a, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n1, bias), 23)));
+	return _mm256_mul_ps(a, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n2, bias), 23)));
+}
+
+#else
+
+#define SIMD_FLOATS		1
+
+typedef float			__vfloat;
+typedef bool			__vmask;
+
+__forceinline __vfloat __vset(float a) { return a; }
+__forceinline __vfloat __vload(const float* x) { return *x; }
+__forceinline void __vstore(float* y, __vfloat a) { *y = a; }
+__forceinline __vfloat __vload(const float* x, int n) { return *x; }
+__forceinline void __vstore(float* y, __vfloat a, int n) { *y = a; }
+
+__forceinline __vfloat __vadd(__vfloat a, __vfloat b) { return a + b; }
+__forceinline __vfloat __vsub(__vfloat a, __vfloat b) { return a - b; }
+__forceinline __vfloat __vmul(__vfloat a, __vfloat b) { return a * b; }
+__forceinline __vfloat __vdiv(__vfloat a, __vfloat b) { return a / b; }
+
+// the product of two floats is exact in double precision, so these round once like the FMA instructions do;
+// this also keeps the fast floating point model from reassociating the argument reduction in __exp_fast
+__forceinline __vfloat __vfmadd(__vfloat a, __vfloat b, __vfloat c) { return float((double(a) * double(b)) + double(c)); }
+__forceinline __vfloat __vfnmadd(__vfloat a, __vfloat b, __vfloat c) { return float(double(c) - (double(a) * double(b))); }
+
+__forceinline __vfloat __vclamp(__vfloat lo, __vfloat b, __vfloat hi) { return b < lo ? lo : (b > hi ? hi : b); }
+
+// the argument is limited by the callers, so it always fits into an integer
+__forceinline __vfloat __vround(__vfloat a) { return a == a ? float(int(a + (a >= 0.0f ? 0.5f : -0.5f))) : a; }
+__forceinline __vfloat __vabs(__vfloat a) { return ::fabsf(a); }
+__forceinline __vfloat __vcopysign(__vfloat a, __vfloat b) { return ::copysignf(a, b); }
+
+__forceinline __vfloat __vmax(__vfloat a, __vfloat b) { return a > b ? a : b; }
+
+__forceinline __vmask __vless(__vfloat a, __vfloat b) { return a < b; }
+__forceinline __vmask __vequal(__vfloat a, __vfloat b) { return a == b; }
+__forceinline bool __vany(__vmask mask) { return mask; }
+__forceinline __vfloat __vselect(__vmask mask, __vfloat a, __vfloat b) { return mask ? a : b; }
+
+// the bits are taken the same way as in the vector versions, a library call would dominate the polynomial
+__forceinline __vfloat __vfrexp(__vfloat a, __vfloat& e)
+{
+	unsigned __int32 bits;
+	::memcpy(&bits, &a, sizeof(bits));
+	e = float(int(bits >> 23) - 126);
+	bits = (bits & 0x007fffffu) | 0x3f000000u;
+	::memcpy(&a, &bits, sizeof(bits));
+	return a;
+}
+
+// the two step scaling of the vector versions could be reassociated by the fast floating point model,
+// so the product is computed in double precision, where 2^n is exact, and rounded once
+__forceinline __vfloat __vscale(__vfloat a, __vfloat n)
+{
+	if (n != n)
+	{
+		return n;
+	}
+
+	const unsigned __int64 bits = (unsigned __int64)(int(n) + 1023) << 52;
+	double scale;
+	::memcpy(&scale, &bits, sizeof(scale));
+	return float(double(a) * scale);
+}
+
+#endif
+
+// e^x
+// The argument is reduced to r = x - n * ln(2), |r| <= ln(2) / 2, e^r is computed by the Cephes polynomial
+// and the result is scaled by 2^n in two steps, so that subnormal and overflowing results come out right.
+__forceinline __vfloat __exp_fast(__vfloat x)
+{
+	// beyond these limits the result is zero or infinity
+	x = __vclamp(__vset(-104.0f), x, __vset(89.0f));
+
+	const __vfloat n = __vround(__vmul(x, __vset(1.44269504088896341f)));
+
+	// ln(2) is split into a part that is exact in single precision and a correction
+	__vfloat r = __vfnmadd(n, __vset(0.693359375f), x);
+	r = __vfnmadd(n, __vset(-2.12194440e-4f), r);
+
+	__vfloat p = __vset(1.9875691500e-4f);
+	p = __vfmadd(p, r, __vset(1.3981999507e-3f));
+	p = __vfmadd(p, r, __vset(8.3334519073e-3f));
+	p = __vfmadd(p, r, __vset(4.1665795894e-2f));
+	p = __vfmadd(p, r, __vset(1.6666665459e-1f));
+	p = __vfmadd(p, r, __vset(5.0000001201e-1f));
+	p = __vadd(__vfmadd(p, __vmul(r, r), r), __vset(1.0f));
+
+	return __vscale(p, n);
+}
+
+// ln(x)
+// x = m * 2^e, the mantissa is moved to [sqrt(0.5), sqrt(2)) and ln(m) is computed by the Cephes polynomial.
+// Subnormal arguments are scaled up first, so that the mantissa is normalized on every instruction set.
+__forceinline __vfloat __log_fast(__vfloat x)
+{
+	const __vfloat one = __vset(1.0f);
+
+	const __vmask subnormal = __vless(x, __vset(1.17549435e-38f));
+	__vfloat e;
+	__vfloat m = __vfrexp(__vselect(subnormal, __vmul(x, __vset(8388608.0f)), x), e);
+	e = __vselect(subnormal, __vsub(e, __vset(23.0f)), e);
+
+	const __vmask small = __vless(m, __vset(0.707106781186547524f));
+	e = __vselect(small, __vsub(e, one), e);
+	m = __vsub(__vselect(small, __vadd(m, m), m), one);
+
+	const __vfloat z = __vmul(m, m);
+	__vfloat p = __vset(7.0376836292e-2f);
+	p = __vfmadd(p, m, __vset(-1.1514610310e-1f));
+	p = __vfmadd(p, m, __vset(1.1676998740e-1f));
+	p = __vfmadd(p, m, __vset(-1.2420140846e-1f));
+	p = __vfmadd(p, m, __vset(1.4249322787e-1f));
+	p = __vfmadd(p, m, __vset(-1.6668057665e-1f));
+	p = __vfmadd(p, m, __vset(2.0000714765e-1f));
+	p = __vfmadd(p, m, __vset(-2.4999993993e-1f));
+	p = __vfmadd(p, m, __vset(3.3333331174e-1f));
+
+	// ln(2) is split the same way as in __exp_fast
+	__vfloat r = __vmul(__vmul(p, m), z);
+	r = __vfmadd(e, __vset(-2.12194440e-4f), r);
+	r = __vfnmadd(__vset(0.5f), z, r);
+	r = __vfmadd(e, __vset(0.693359375f), __vadd(m, r));
+
+	r = __vselect(__vequal(x, __vset(0.0f)), __vset(-INFINITY), r);
+	r = __vselect(__vequal(x, __vset(INFINITY)), x, r);
+	r = __vselect(__vless(x, __vset(0.0f)), __vset(NAN), r);
+	return __vselect(__vequal(x, x), r, x);
+}
+
+// 1 / (1 + e^-x)
+__forceinline __vfloat __sigmoid_fast(__vfloat x)
+{
+	const __vfloat one = __vset(1.0f);
+	return __vdiv(one, __vadd(one, __exp_fast(__vsub(__vset(0.0f), x))));
+}
+
+// tanh(x)
+// Small arguments use the odd Cephes polynomial, the others use 1 - 2 / (e^2|x| + 1) that does not lose precision there.
+__forceinline __vfloat __tanh_fast(__vfloat x)
+{
+	const __vfloat one = __vset(1.0f);
+	const __vfloat ax = __vabs(x);
+
+	const __vfloat z = __vmul(x, x);
+	__vfloat p = __vset(-5.70498872745e-3f);
+	p = __vfmadd(p, z, __vset(2.06390887954e-2f));
+	p = __vfmadd(p, z, __vset(-5.37397155531e-2f));
+	p = __vfmadd(p, z, __vset(1.33314422036e-1f));
+	p = __vfmadd(p, z, __vset(-3.33332819422e-1f));
+	const __vfloat small = __vfmadd(__vmul(p, z), x, x);
+
+	const __vfloat e = __exp_fast(__vadd(ax, ax));
+	const __vfloat large = __vcopysign(__vsub(one, __vdiv(__vset(2.0f), __vadd(e, one))), x);
+
+	return __vselect(__vless(ax, __vset(0.625f)), small, large);
+}
+
+// applies the function to n elements
+template <__vfloat _Func(__vfloat)>
+void __forceinline __vtransform(int n, const float* x, float* y)
+{
+	int i = 0;
+	for (; i + SIMD_FLOATS <= n; i += SIMD_FLOATS)
+	{
+		__vstore(y + i, _Func(__vload(x + i)));
+	}
+
+	if (i < n)
+	{
+		__vstore(y + i, _Func(__vload(x + i, n - i)), n - i);
+	}
+}
@@ -1,159 +1,529 @@
 #include "stdafx.h"
+#include <string.h>
+#include "scratch.h"
+#include "threadpool.h"
 
-template<typename T> void __forceinline swap(T* data, int i, int j)
+// Sorting of keys and of key/value pairs.
+//
+// The integer keys up to 32 bits and the floats are sorted with an LSD radix sort,
+// the other keys and the short ranges are sorted with an introsort: a quicksort with a median-of-three pivot
+// that switches to a heapsort when the recursion gets too deep and to an insertion sort for small partitions.
+// With more than one thread, large ranges are partitioned first and the partitions are sorted in parallel.
+// The values are moved together with the keys.
+//
+// Partial sorting selects the first k keys with an introselect and sorts only them;
+// top-k selection keeps the k best elements of a read-only array in a heap.
+namespace
 {
-	if (i != j)
+	// partitions of this size or smaller are sorted by insertion
+	const int InsertionSize = 16;
+
+	// ranges of this size or larger are sorted with the radix sort, when the key allows it
+	const int RadixSize = 256;
+
+	// both partitions must have this many elements to be sorted in parallel
+	const int ParallelSize = 65536;
+
+	template<typename T, bool Ascending> bool __forceinline __before(const T a, const T b)
 	{
-		const T temp = data[i];
-		data[i] = data[j];
-		data[j] = temp;
+		return Ascending ? a < b : b < a;
 	}
-}
-
-template<typename T> static void qsort_asc(T* keys, const int lo, const int hi)
-{
-	const T pivot = keys[(lo + hi) >> 1]; // find pivot item
-	int i = lo;
-	int j = hi;
 
-	while (i <= j)
+	template<typename T, bool Values> void __forceinline __swap(T* keys, int* values, const int i, const int j)
 	{
-		while (keys[i] < pivot)	i++;
-		while (keys[j] > pivot) j--;
+		const T key = keys[i];
+		keys[i] = keys[j];
+		keys[j] = key;
 
-		if (i <= j)
+		if (Values)
 		{
-			swap(keys, i, j);
-			i++;
-			j--;
+			const int value = values[i];
+			values[i] = values[j];
+			values[j] = value;
 		}
 	}
 
-	if (lo < j)
+	template<typename T, bool Ascending, bool Values> void __insertion_sort(const int n, T* keys, int* values)
 	{
-		qsort_asc(keys, lo, j);
+		for (int i = 1; i < n; i++)
+		{
+			const T key = keys[i];
+			const int value = Values ? values[i] : 0;
+
+			int j = i;
+			for (; j > 0 && __before<T, Ascending>(key, keys[j - 1]); j--)
+			{
+				keys[j] = keys[j - 1];
+				if (Values)
+				{
+					values[j] = values[j - 1];
+				}
+			}
+
+			keys[j] = key;
+			if (Values)
+			{
+				values[j] = value;
+			}
+		}
 	}
 
-	if (i < hi)
+	template<typename T, bool Ascending, bool Values> void __sift_down(const int n, T* keys, int* values, int i)
 	{
-		qsort_asc(keys, i, hi);
-	}
-}
+		for (int child = (2 * i) + 1; child < n; i = child, child = (2 * i) + 1)
+		{
+			if (child + 1 < n && __before<T, Ascending>(keys[child], keys[child + 1]))
+			{
+				child++;
+			}
 
-template<typename T> static void qsort_asc(T* keys, int* values, const int lo, const int hi)
-{
-	const T pivot = keys[(lo + hi) >> 1]; // find pivot item
-	int i = lo;
-	int j = hi;
+			if (!__before<T, Ascending>(keys[i], keys[child]))
+			{
+				break;
+			}
+
+			__swap<T, Values>(keys, values, i, child);
+		}
+	}
 
-	while (i <= j)
+	template<typename T, bool Ascending, bool Values> void __heap_sort(const int n, T* keys, int* values)
 	{
-		while (keys[i] < pivot)	i++;
-		while (keys[j] > pivot) j--;
+		for (int i = (n / 2) - 1; i >= 0; i--)
+		{
+			__sift_down<T, Ascending, Values>(n, keys, values, i);
+		}
 
-		if (i <= j)
+		for (int i = n - 1; i > 0; i--)
 		{
-			swap(keys, i, j);
-			swap(values, i, j);
-			i++;
-			j--;
+			__swap<T, Values>(keys, values, 0, i);
+			__sift_down<T, Ascending, Values>(i, keys, values, 0);
 		}
 	}
 
-	if (lo < j)
+	// Splits the range into [0, j] with the keys that do not go after the pivot and [i, n) with the keys that do not go before it.
+	// The pivot is the median of the first, middle and last keys; equal keys are spread over both partitions.
+	template<typename T, bool Ascending, bool Values> void __partition(const int n, T* keys, int* values, int& i, int& j)
 	{
-		qsort_asc(keys, lo, j);
+		const int mid = n >> 1;
+		if (__before<T, Ascending>(keys[mid], keys[0]))
+		{
+			__swap<T, Values>(keys, values, mid, 0);
+		}
+
+		if (__before<T, Ascending>(keys[n - 1], keys[mid]))
+		{
+			__swap<T, Values>(keys, values, n - 1, mid);
+			if (__before<T, Ascending>(keys[mid], keys[0]))
+			{
+				__swap<T, Values>(keys, values, mid, 0);
+			}
+		}
+
+		const T pivot = keys[mid];
+		i = 0;
+		j = n - 1;
+
+		while (i <= j)
+		{
+			while (__before<T, Ascending>(keys[i], pivot)) i++;
+			while (__before<T, Ascending>(pivot, keys[j])) j--;
+
+			if (i <= j)
+			{
+				__swap<T, Values>(keys, values, i, j);
+				i++;
+				j--;
+			}
+		}
 	}
 
-	if (i < hi)
+	// The radix sort orders unsigned keys, the key type is mapped to an unsigned type of the same size
+	// with the same order. Negative floats have all bits flipped, the other floats only the sign bit.
+	// The 64-bit keys need too many passes and are not sorted with the radix sort (enabled is false),
+	// their mapping is used by the top-k filter.
+	template<typename T> struct radix_key;
+
+	template<> struct radix_key<unsigned __int64>
 	{
-		qsort_asc(keys, i, hi);
-	}
-}
+		static const bool enabled = false;
+		typedef unsigned __int64 type;
+		static type get(const unsigned __int64 x) { return x; }
+	};
 
-template<typename T> static void qsort_desc(T* keys, const int lo, const int hi)
-{
-	const T pivot = keys[(lo + hi) >> 1]; // find pivot item
-	int i = lo;
-	int j = hi;
+	template<> struct radix_key<__int64>
+	{
+		static const bool enabled = false;
+		typedef unsigned __int64 type;
+		static type get(const __int64 x) { return type(x) ^ 0x8000000000000000ull; }
+	};
+
+	template<> struct radix_key<double>
+	{
+		static const bool enabled = false;
+		typedef unsigned __int64 type;
+		static type get(const double x)
+		{
+			type bits;
+			::memcpy(&bits, &x, sizeof(bits));
+			return bits ^ ((type(0) - (bits >> 63)) | 0x8000000000000000ull);
+		}
+	};
+
+	template<> struct radix_key<unsigned __int8>
+	{
+		static const bool enabled = true;
+		typedef unsigned __int8 type;
+		static type get(const unsigned __int8 x) { return x; }
+	};
 
-	while (i <= j)
+	template<> struct radix_key<unsigned __int16>
 	{
-		while (keys[i] > pivot)	i++;
-		while (keys[j] < pivot) j--;
+		static const bool enabled = true;
+		typedef unsigned __int16 type;
+		static type get(const unsigned __int16 x) { return x; }
+	};
 
-		if (i <= j)
+	template<> struct radix_key<unsigned __int32>
+	{
+		static const bool enabled = true;
+		typedef unsigned __int32 type;
+		static type get(const unsigned __int32 x) { return x; }
+	};
+
+	template<> struct radix_key<__int8>
+	{
+		static const bool enabled = true;
+		typedef unsigned __int8 type;
+		static type get(const __int8 x) { return type(x) ^ 0x80u; }
+	};
+
+	template<> struct radix_key<__int16>
+	{
+		static const bool enabled = true;
+		typedef unsigned __int16 type;
+		static type get(const __int16 x) { return type(x) ^ 0x8000u; }
+	};
+
+	template<> struct radix_key<__int32>
+	{
+		static const bool enabled = true;
+		typedef unsigned __int32 type;
+		static type get(const __int32 x) { return type(x) ^ 0x80000000u; }
+	};
+
+	template<> struct radix_key<float>
+	{
+		static const bool enabled = true;
+		typedef unsigned __int32 type;
+		static type get(const float x)
 		{
-			swap(keys, i, j);
-			i++;
-			j--;
+			type bits;
+			::memcpy(&bits, &x, sizeof(bits));
+			return bits ^ (type(-__int32(bits >> 31)) | 0x80000000u);
 		}
-	}
+	};
 
-	if (lo < j)
+	// Sorts the keys with one counting pass per byte, from the least significant one.
+	// The descending order sorts the complements of the keys. The passes where all keys have the same byte are skipped.
+	template<typename T, bool Ascending, bool Values> void __radix_sort(const int n, T* keys, int* values)
 	{
-		qsort_desc(keys, lo, j);
+		typedef radix_key<T> key;
+		typedef typename key::type K;
+		const int Passes = sizeof(K);
+		const K flip = Ascending ? K(0) : K(~K(0));
+
+		int counts[Passes][256];
+		::memset(counts, 0, sizeof(counts));
+		for (int i = 0; i < n; i++)
+		{
+			const K k = key::get(keys[i]) ^ flip;
+			for (int pass = 0; pass < Passes; pass++)
+			{
+				counts[pass][(k >> (8 * pass)) & 0xff]++;
+			}
+		}
+
+		scratch_buffer<T> keybuffer(n);
+		scratch_buffer<int> valuebuffer(Values ? n : 0);
+
+		T* src = keys;
+		T* dst = keybuffer.data();
+		int* vsrc = values;
+		int* vdst = valuebuffer.data();
+
+		for (int pass = 0; pass < Passes; pass++)
+		{
+			const int shift = 8 * pass;
+			int* offsets = counts[pass];
+			if (offsets[((key::get(src[0]) ^ flip) >> shift) & 0xff] == n)
+			{
+				continue;
+			}
+
+			for (int d = 0, sum = 0; d < 256; d++)
+			{
+				const int count = offsets[d];
+				offsets[d] = sum;
+				sum += count;
+			}
+
+			for (int i = 0; i < n; i++)
+			{
+				const int pos = offsets[((key::get(src[i]) ^ flip) >> shift) & 0xff]++;
+				dst[pos] = src[i];
+				if (Values)
+				{
+					vdst[pos] = vsrc[i];
+				}
+			}
+
+			T* t = src; src = dst; dst = t;
+			int* vt = vsrc; vsrc = vdst; vdst = vt;
+		}
+
+		if (src != keys)
+		{
+			::memcpy(keys, src, size_t(n) * sizeof(T));
+			if (Values)
+			{
+				::memcpy(values, vsrc, size_t(n) * sizeof(int));
+			}
+		}
 	}
 
-	if (i < hi)
+	template<typename T, bool Ascending, bool Values> void __introsort(int n, T* keys, int* values, int depth, const bool parallel)
 	{
-		qsort_desc(keys, i, hi);
+		for (;;)
+		{
+			if (n <= InsertionSize)
+			{
+				__insertion_sort<T, Ascending, Values>(n, keys, values);
+				return;
+			}
+
+			if (radix_key<T>::enabled && n >= RadixSize && !(parallel && n >= 2 * ParallelSize))
+			{
+				__radix_sort<T, Ascending, Values>(n, keys, values);
+				return;
+			}
+
+			if (depth == 0)
+			{
+				__heap_sort<T, Ascending, Values>(n, keys, values);
+				return;
+			}
+
+			depth--;
+
+			int i, j;
+			__partition<T, Ascending, Values>(n, keys, values, i, j);
+
+			const int nleft = j + 1;
+			const int nright = n - i;
+			if (parallel && nleft >= ParallelSize && nright >= ParallelSize)
+			{
+				parallel_invoke(
+					[&]() { __introsort<T, Ascending, Values>(nleft, keys, values, depth, parallel); },
+					[&]() { __introsort<T, Ascending, Values>(nright, keys + i, Values ? values + i : values, depth, parallel); });
+				return;
+			}
+
+			// recurse into the smaller partition and loop over the larger one, so the stack stays logarithmic
+			if (nleft < nright)
+			{
+				__introsort<T, Ascending, Values>(nleft, keys, values, depth, parallel);
+				keys += i;
+				values = Values ? values + i : values;
+				n = nright;
+			}
+			else
+			{
+				__introsort<T, Ascending, Values>(nright, keys + i, Values ? values + i : values, depth, parallel);
+				n = nleft;
+			}
+		}
 	}
-}
 
-template<typename T> static void qsort_desc(T* keys, int* values, const int lo, const int hi)
-{
-	const T pivot = keys[(lo + hi) >> 1]; // find pivot item
-	int i = lo;
-	int j = hi;
+	// the heapsort takes over after 2 * log2(n) levels of partitioning
+	int __forceinline __depth_limit(const int n)
+	{
+		int depth = 0;
+		for (int i = n; i > 1; i >>= 1)
+		{
+			depth += 2;
+		}
+
+		return depth;
+	}
 
-	while (i <= j)
+	template<typename T, bool Values> void __sort(const int n, T* keys, int* values, BOOL ascending)
 	{
-		while (keys[i] > pivot)	i++;
-		while (keys[j] < pivot) j--;
+		if (n <= 1)
+		{
+			return;
+		}
+
+		const bool parallel = n >= 2 * ParallelSize && ::threadpool_get_threads() > 1;
 
-		if (i <= j)
+		if (ascending)
+		{
+			__introsort<T, true, Values>(n, keys, values, __depth_limit(n), parallel);
+		}
+		else
 		{
-			swap(keys, i, j);
-			swap(values, i, j);
-			i++;
-			j--;
+			__introsort<T, false, Values>(n, keys, values, __depth_limit(n), parallel);
 		}
 	}
 
-	if (lo < j)
+	// Moves the first k keys in the sort order to the front of the range, in no particular order (introselect).
+	template<typename T, bool Ascending, bool Values> void __select(int n, T* keys, int* values, int k)
 	{
-		qsort_desc(keys, values, lo, j);
+		for (int depth = __depth_limit(n); n > InsertionSize; depth--)
+		{
+			if (depth == 0)
+			{
+				__heap_sort<T, Ascending, Values>(n, keys, values);
+				return;
+			}
+
+			int i, j;
+			__partition<T, Ascending, Values>(n, keys, values, i, j);
+
+			if (k <= j + 1)
+			{
+				n = j + 1;
+			}
+			else if (k >= i)
+			{
+				keys += i;
+				values = Values ? values + i : values;
+				k -= i;
+				n -= i;
+			}
+			else
+			{
+				// the keys between the partitions are equal to the pivot
+				return;
+			}
+		}
+
+		__insertion_sort<T, Ascending, Values>(n, keys, values);
 	}
 
-	if (i < hi)
+	// The top-k heap keeps the k best keys with the worst one at the root.
+	// Of the equal keys the one with the larger index is worse, so the earlier elements win the ties.
+	template<typename T, bool Largest> bool __forceinline __worse(const T a, const int ia, const T b, const int ib)
 	{
-		qsort_desc(keys, values, i, hi);
+		return (Largest ? a < b : b < a) || (a == b && ia > ib);
 	}
-}
 
-template<typename T> void __forceinline qsort(const int n, T* keys, BOOL ascending)
-{
-	if (ascending)
+	template<typename T, bool Largest> void __topk_sift_down(const int k, T* keys, int* indices, int i)
 	{
-		::qsort_asc(keys, 0, n - 1);
+		for (int child = (2 * i) + 1; child < k; i = child, child = (2 * i) + 1)
+		{
+			if (child + 1 < k && __worse<T, Largest>(keys[child + 1], indices[child + 1], keys[child], indices[child]))
+			{
+				child++;
+			}
+
+			if (!__worse<T, Largest>(keys[child], indices[child], keys[i], indices[i]))
+			{
+				break;
+			}
+
+			__swap<T, true>(keys, indices, i, child);
+		}
 	}
-	else
+
+	// Checks whether any of the Count elements is better than the threshold.
+	// The keys are compared mapped to unsigned integers, which the compiler vectorizes for every type;
+	// a NaN may pass the check, it is rejected later by the exact comparison.
+	template<typename T, bool Largest, int Count> bool __forceinline __any_better(const T* x, const T threshold)
 	{
-		::qsort_desc(keys, 0, n - 1);
+		typedef radix_key<T> key;
+		const typename key::type t = key::get(threshold);
+
+		int count = 0;
+		for (int i = 0; i < Count; i++)
+		{
+			const typename key::type value = key::get(x[i]);
+			count += Largest ? value > t : value < t;
+		}
+
+		return count != 0;
+	}
+
+	// Writes the k largest or smallest keys and their positions in x best first; returns the number of keys, min(n, k).
+	// The elements are checked against the root of the heap in blocks, and most blocks of a long array have nothing to add.
+	template<typename T, bool Largest> int __topk(const int n, const T* x, int k, T* keys, int* indices)
+	{
+		// a block this long is vectorized by the compiler, a shorter one is unrolled into scalar code
+		const int Block = 32;
+
+		k = __min(k, n);
+		if (k <= 0)
+		{
+			return 0;
+		}
+
+		for (int i = 0; i < k; i++)
+		{
+			keys[i] = x[i];
+			indices[i] = i;
+		}
+
+		for (int i = (k / 2) - 1; i >= 0; i--)
+		{
+			__topk_sift_down<T, Largest>(k, keys, indices, i);
+		}
+
+		// an element that ties the root comes later and loses, so only the better elements are taken
+		int i = k;
+		for (; i + Block <= n; i += Block)
+		{
+			if (__any_better<T, Largest, Block>(x + i, keys[0]))
+			{
+				for (int l = 0; l < Block; l++)
+				{
+					if (Largest ? x[i + l] > keys[0] : x[i + l] < keys[0])
+					{
+						keys[0] = x[i + l];
+						indices[0] = i + l;
+						__topk_sift_down<T, Largest>(k, keys, indices, 0);
+					}
+				}
+			}
+		}
+
+		for (; i < n; i++)
+		{
+			if (Largest ? x[i] > keys[0] : x[i] < keys[0])
+			{
+				keys[0] = x[i];
+				indices[0] = i;
+				__topk_sift_down<T, Largest>(k, keys, indices, 0);
+			}
+		}
+
+		// take the worst key from the heap until it is empty, the best one ends up first
+		for (int last = k - 1; last > 0; last--)
+		{
+			__swap<T, true>(keys, indices, 0, last);
+			__topk_sift_down<T, Largest>(last, keys, indices, 0);
+		}
+
+		return k;
 	}
 }
 
+template<typename T> void __forceinline qsort(const int n, T* keys, BOOL ascending)
+{
+	__sort<T, false>(n, keys, NULL, ascending);
+}
+
 template<typename T> void __forceinline qsort(const int n, T* keys, int* values, BOOL ascending)
 {
-	if (ascending)
-	{
-		::qsort_asc(keys, values, 0, n - 1);
-	}
-	else
-	{
-		::qsort_desc(keys, values, 0, n - 1);
-	}
+	__sort<T, true>(n, keys, values, ascending);
 }
 
 GENIXAPI(void, qsort_s8)(const int n, __int8*  x, const int offx, BOOL ascending) { qsort(n, x + offx, ascending); }
@@ -177,3 +547,84 @@ GENIXAPI(void, qsortv_u32)(const int n, unsigned __int32* x, const int offx, int
 GENIXAPI(void, qsortv_u64)(const int n, unsigned __int64* x, const int offx, int* y, const int offy, BOOL ascending) { qsort(n, x + offx, y + offy, ascending); }
 GENIXAPI(void, qsortv_f32)(const int n, float* x, const int offx, int* y, const int offy, BOOL ascending) { qsort(n, x + offx, y + offy, ascending); }
 GENIXAPI(void, qsortv_f64)(const int n, double* x, const int offx, int* y, const int offy, BOOL ascending) { qsort(n, x + offx, y + offy, ascending); }
+
+// Rearranges the keys and the values, so the first k keys are the k smallest (ascending) or largest keys in sorted order.
+// The order of the remaining keys is not defined.
+template<typename T> void __forceinline partial_sort(const int n, T* keys, int* values, const int k, BOOL ascending)
+{
+	if (k > 0 && k < n)
+	{
+		if (ascending)
+		{
+			__select<T, true, true>(n, keys, values, k);
+		}
+		else
+		{
+			__select<T, false, true>(n, keys, values, k);
+		}
+	}
+
+	__sort<T, true>(__min(k, n), keys, values, ascending);
+}
+
+GENIXAPI(void, partial_sortv_s8)(const int n, __int8*  x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_s16)(const int n, __int16* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_s32)(const int n, __int32* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_s64)(const int n, __int64* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_u8)(const int n, unsigned __int8*  x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_u16)(const int n, unsigned __int16* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_u32)(const int n, unsigned __int32* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_u64)(const int n, unsigned __int64* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_f32)(const int n, float* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+GENIXAPI(void, partial_sortv_f64)(const int n, double* x, const int offx, int* y, const int offy, const int k, BOOL ascending) { partial_sort(n, x + offx, y + offy, k, ascending); }
+
+// Finds the k largest or smallest elements of x and writes them to y and their positions in x to indices, the best element first.
+// Of the equal elements the earlier ones are taken first. Returns the number of elements written, min(n, k).
+template<typename T> int __forceinline topk(const int n, const T* x, const int k, T* y, int* indices, BOOL largest)
+{
+	return largest ? __topk<T, true>(n, x, k, y, indices) : __topk<T, false>(n, x, k, y, indices);
+}
+
+// Runs topk over the rows of rowlen elements of x in parallel.
+// The result of every row takes min(rowlen, k) elements of y and indices, the indices are the positions in the row.
+template<typename T> void __forceinline topk_batch(const int n, const T* x, const int rowlen, const int k, T* y, int* indices, BOOL largest)
+{
+	// nothing to select, and rowlen is a divisor below
+	if (rowlen <= 0 || n <= 0)
+	{
+		return;
+	}
+
+	const int count = __min(rowlen, k);
+
+	parallel_for_range(0, n / rowlen, __max(16384 / rowlen, 1), [&](int start, int end)
+	{
+		for (int row = start; row < end; row++)
+		{
+			const ptrdiff_t off = ptrdiff_t(row) * count;
+			topk(rowlen, x + (ptrdiff_t(row) * rowlen), k, y + off, indices + off, largest);
+		}
+	});
+}
+
+GENIXAPI(int, topk_s8)(const int n, const __int8* x, const int offx, const int k, __int8* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_s16)(const int n, const __int16* x, const int offx, const int k, __int16* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_s32)(const int n, const __int32* x, const int offx, const int k, __int32* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_s64)(const int n, const __int64* x, const int offx, const int k, __int64* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_u8)(const int n, const unsigned __int8* x, const int offx, const int k, unsigned __int8* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_u16)(const int n, const unsigned __int16* x, const int offx, const int k, unsigned __int16* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_u32)(const int n, const unsigned __int32* x, const int offx, const int k, unsigned __int32* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_u64)(const int n, const unsigned __int64* x, const int offx, const int k, unsigned __int64* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_f32)(const int n, const float* x, const int offx, const int k, float* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+GENIXAPI(int, topk_f64)(const int n, const double* x, const int offx, const int k, double* y, const int offy, int* indices, const int offindices, BOOL largest) { return topk(n, x + offx, k, y + offy, indices + offindices, largest); }
+
+GENIXAPI(void, topk_batch_s8)(const int n, const __int8* x, const int offx, const int rowlen, const int k, __int8* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_s16)(const int n, const __int16* x, const int offx, const int rowlen, const int k, __int16* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_s32)(const int n, const __int32* x, const int offx, const int rowlen, const int k, __int32* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_s64)(const int n, const __int64* x, const int offx, const int rowlen, const int k, __int64* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_u8)(const int n, const unsigned __int8* x, const int offx, const int rowlen, const int k, unsigned __int8* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_u16)(const int n, const unsigned __int16* x, const int offx, const int rowlen, const int k, unsigned __int16* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_u32)(const int n, const unsigned __int32* x, const int offx, const int rowlen, const int k, unsigned __int32* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_u64)(const int n, const unsigned __int64* x, const int offx, const int rowlen, const int k, unsigned __int64* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_f32)(const int n, const float* x, const int offx, const int rowlen, const int k, float* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
+GENIXAPI(void, topk_batch_f64)(const int n, const double* x, const int offx, const int rowlen, const int k, double* y, const int offy, int* indices, const int offindices, BOOL largest) { topk_batch(n, x + offx, rowlen, k, y + offy, indices + offindices, largest); }
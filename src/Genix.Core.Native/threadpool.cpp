@@ -0,0 +1,368 @@
+#include "stdafx.h"
+#include "simddetect.h"
+#include "threadpool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// tells the processor that the thread is spinning
+static __forceinline void __cpu_relax()
+{
+#if defined(SIMD_X86)
+	_mm_pause();
+#elif defined(_MSC_VER)
+	__yield();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#else
+	std::this_thread::yield();
+#endif
+}
+
+// a call to threadpool_run
+struct __threadpool_job
+{
+	threadpool_body body;
+	void* context;
+	int grain0;
+	int grain1;
+
+	// the number of range elements that are not processed yet
+	std::atomic<long long> remaining;
+};
+
+// a range of the job waiting in a deque
+struct __threadpool_task
+{
+	__threadpool_job* job;
+	int start0, end0;
+	int start1, end1;
+
+	// the number of times the range can be split again
+	int splits;
+};
+
+struct __threadpool_deque
+{
+	std::mutex lock;
+	std::deque<__threadpool_task> tasks;
+};
+
+// the number of extra splits a range gets when it is stolen by another thread
+static const int __steal_splits = 2;
+
+class __threadpool
+{
+public:
+	__threadpool(int count) : queued(0), sleepers(0), stop(false)
+	{
+		this->start(count);
+	}
+
+	int threads() const
+	{
+		return int(this->deques.size());
+	}
+
+	void resize(int count)
+	{
+		this->shutdown();
+		this->start(count);
+	}
+
+	void run(int first0, int last0, int grain0, int first1, int last1, int grain1, threadpool_body body, void* context)
+	{
+		__threadpool_job job;
+		job.body = body;
+		job.context = context;
+		job.grain0 = grain0;
+		job.grain1 = grain1;
+		job.remaining = (long long)(last0 - first0) * (last1 - first1);
+
+		// about four ranges per thread before any stealing happens
+		int splits = 2;
+		for (int n = this->threads(); n > 1; n = (n + 1) / 2)
+		{
+			splits++;
+		}
+
+		__threadpool_deque& own = this->current();
+		this->execute(own, { &job, first0, last0, first1, last1, splits });
+
+		// help with the other ranges while the job is processed
+		for (int spin = 0; job.remaining.load(std::memory_order_acquire) > 0; )
+		{
+			__threadpool_task task;
+			if (this->pop(own, task) || this->steal(own, task))
+			{
+				this->execute(own, task);
+				spin = 0;
+			}
+			else if (++spin < 64)
+			{
+				__cpu_relax();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+private:
+	// deque 0 is shared by all threads outside of the pool, the workers own the others
+	std::vector<__threadpool_deque*> deques;
+	std::vector<std::thread> workers;
+
+	std::atomic<int> queued;
+	std::atomic<int> sleepers;
+	std::mutex sleeplock;
+	std::condition_variable wakeup;
+	bool stop;
+
+	static thread_local int slot;
+
+	__threadpool_deque& current()
+	{
+		return *this->deques[slot];
+	}
+
+	void start(int count)
+	{
+		this->stop = false;
+		this->deques.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			this->deques[i] = new __threadpool_deque();
+		}
+
+		for (int i = 1; i < count; i++)
+		{
+			this->workers.emplace_back([this, i]()
+			{
+				slot = i;
+				this->work(*this->deques[i]);
+			});
+		}
+	}
+
+	void shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> guard(this->sleeplock);
+			this->stop = true;
+		}
+
+		this->wakeup.notify_all();
+
+		for (std::thread& worker : this->workers)
+		{
+			worker.join();
+		}
+
+		this->workers.clear();
+
+		for (__threadpool_deque* deque : this->deques)
+		{
+			delete deque;
+		}
+
+		this->deques.clear();
+	}
+
+	// processes the range, splitting it in half while it is larger than grain size
+	void execute(__threadpool_deque& own, __threadpool_task task)
+	{
+		__threadpool_job& job = *task.job;
+
+		for (; task.splits > 0; task.splits--)
+		{
+			const int chunks0 = (task.end0 - task.start0 + job.grain0 - 1) / job.grain0;
+			const int chunks1 = (task.end1 - task.start1 + job.grain1 - 1) / job.grain1;
+			if (chunks0 <= 1 && chunks1 <= 1)
+			{
+				break;
+			}
+
+			// the second half goes to the deque where other threads can steal it
+			__threadpool_task half = task;
+			half.splits--;
+			if (chunks0 >= chunks1)
+			{
+				task.end0 = half.start0 = task.start0 + ((chunks0 / 2) * job.grain0);
+			}
+			else
+			{
+				task.end1 = half.start1 = task.start1 + ((chunks1 / 2) * job.grain1);
+			}
+
+			this->push(own, half);
+		}
+
+		job.body(job.context, task.start0, task.end0, task.start1, task.end1);
+
+		job.remaining.fetch_sub(
+			(long long)(task.end0 - task.start0) * (task.end1 - task.start1),
+			std::memory_order_release);
+	}
+
+	void push(__threadpool_deque& own, const __threadpool_task& task)
+	{
+		{
+			std::lock_guard<std::mutex> guard(own.lock);
+			own.tasks.push_back(task);
+		}
+
+		this->queued.fetch_add(1);
+		if (this->sleepers.load() > 0)
+		{
+			std::lock_guard<std::mutex> guard(this->sleeplock);
+			this->wakeup.notify_one();
+		}
+	}
+
+	// takes the most recent range from the thread's own deque
+	bool pop(__threadpool_deque& own, __threadpool_task& task)
+	{
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (own.tasks.empty())
+		{
+			return false;
+		}
+
+		task = own.tasks.back();
+		own.tasks.pop_back();
+		this->queued.fetch_sub(1);
+		return true;
+	}
+
+	// takes the oldest (largest) range from another deque
+	bool steal(__threadpool_deque& own, __threadpool_task& task)
+	{
+		const int count = this->threads();
+		for (int i = 0, start = slot + 1; i < count; i++)
+		{
+			__threadpool_deque& victim = *this->deques[(start + i) % count];
+			if (&victim == &own)
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if (!victim.tasks.empty())
+			{
+				task = victim.tasks.front();
+				victim.tasks.pop_front();
+				this->queued.fetch_sub(1);
+
+				task.splits += __steal_splits;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void work(__threadpool_deque& own)
+	{
+		for (int spin = 0; ; )
+		{
+			__threadpool_task task;
+			if (this->pop(own, task) || this->steal(own, task))
+			{
+				this->execute(own, task);
+				spin = 0;
+			}
+			else if (++spin < 256)
+			{
+				if (spin < 64)
+				{
+					__cpu_relax();
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+			else
+			{
+				// the sleeper count is raised before the queue is checked, so a push either sees it or is seen here
+				std::unique_lock<std::mutex> guard(this->sleeplock);
+				this->sleepers.fetch_add(1);
+				this->wakeup.wait(guard, [this]() { return this->stop || this->queued.load() > 0; });
+				this->sleepers.fetch_sub(1);
+
+				if (this->stop)
+				{
+					return;
+				}
+
+				spin = 0;
+			}
+		}
+	}
+};
+
+thread_local int __threadpool::slot = 0;
+
+// the default number of threads: GENIX_NUM_THREADS environment variable or the number of logical processors
+static int __default_threads()
+{
+	const char* value = ::getenv("GENIX_NUM_THREADS");
+	const int count = value != NULL ? ::atoi(value) : 0;
+	return count > 0 ? count : __max(int(std::thread::hardware_concurrency()), 1);
+}
+
+// The pool is never destroyed: worker threads cannot be joined safely while the library is unloaded.
+static __threadpool& __pool()
+{
+	static __threadpool* pool = new __threadpool(__default_threads());
+	return *pool;
+}
+
+GENIXAPI(void, threadpool_run)(
+	int first0, int last0, int grain0,
+	int first1, int last1, int grain1,
+	threadpool_body body, void* context)
+{
+	if (first0 >= last0 || first1 >= last1)
+	{
+		return;
+	}
+
+	grain0 = __max(grain0, 1);
+	grain1 = __max(grain1, 1);
+
+	// run small ranges in the calling thread
+	__threadpool& pool = __pool();
+	if (pool.threads() == 1 || (last0 - first0 <= grain0 && last1 - first1 <= grain1))
+	{
+		body(context, first0, last0, first1, last1);
+		return;
+	}
+
+	pool.run(first0, last0, grain0, first1, last1, grain1, body, context);
+}
+
+GENIXAPI(int, threadpool_get_threads)()
+{
+	return __pool().threads();
+}
+
+GENIXAPI(void, threadpool_set_threads)(int count)
+{
+	if (count <= 0)
+	{
+		count = __max(int(std::thread::hardware_concurrency()), 1);
+	}
+
+	__threadpool& pool = __pool();
+	if (count != pool.threads())
+	{
+		pool.resize(count);
+	}
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// Work-stealing thread pool shared by the native libraries.
+//
+// Every pool thread owns a deque of ranges. A thread takes ranges from the back of its own deque
+// and steals from the front of the other deques when its own deque is empty.
+// Ranges are split in half (along the longer dimension) until they reach the grain size or
+// run out of the split budget; stolen ranges get a new budget so the work spreads out on demand.
+//
+// The calling thread takes part in the computation, so a pool of N threads runs N - 1 workers.
+// Nested calls push their ranges to the deque of the thread that makes the call and do not
+// start new threads, so they never oversubscribe the machine.
+
+// Processes the range [start0, end0) x [start1, end1).
+typedef void(*threadpool_body)(void* context, int start0, int end0, int start1, int end1);
+
+// Runs the body over [first0, last0) x [first1, last1) and returns when the whole range is processed.
+// The body receives ranges that are at least grain0 x grain1 in size, except for the remainders.
+extern "C" GENIXCOREAPI void WINAPI threadpool_run(
+	int first0, int last0, int grain0,
+	int first1, int last1, int grain1,
+	threadpool_body body, void* context);
+
+// Returns the number of threads used by the pool, including the calling thread.
+extern "C" GENIXCOREAPI int WINAPI threadpool_get_threads();
+
+// Sets the number of threads used by the pool, including the calling thread.
+// Zero or negative count selects the number of logical processors.
+// Must not be called while other threads are running native kernels.
+extern "C" GENIXCOREAPI void WINAPI threadpool_set_threads(int count);
+
+// Runs the function over [first0, last0) x [first1, last1) split into ranges.
+// The function is called as func(start0, end0, start1, end1).
+template <typename _Function>
+void parallel_for_range(int first0, int last0, int grain0, int first1, int last1, int grain1, const _Function& func)
+{
+	::threadpool_run(
+		first0, last0, grain0,
+		first1, last1, grain1,
+		[](void* context, int start0, int end0, int start1, int end1)
+		{
+			(*static_cast<const _Function*>(context))(start0, end0, start1, end1);
+		},
+		const_cast<_Function*>(&func));
+}
+
+// Runs the function over [first, last) split into ranges of at least grain elements.
+// The function is called as func(start, end).
+template <typename _Function>
+void parallel_for_range(int first, int last, int grain, const _Function& func)
+{
+	parallel_for_range(first, last, grain, 0, 1, 1, [&](int start0, int end0, int, int)
+	{
+		func(start0, end0);
+	});
+}
+
+// Calls func(i) for every i in [first, last).
+template <typename _Function>
+void parallel_for(int first, int last, const _Function& func)
+{
+	parallel_for_range(first, last, 1, [&](int start, int end)
+	{
+		for (int i = start; i < end; i++)
+		{
+			func(i);
+		}
+	});
+}
+
+// Calls func(i) for every i in [first, last) taken with the specified step.
+template <typename _Function>
+void parallel_for(int first, int last, int step, const _Function& func)
+{
+	const int count = first < last ? (last - first + step - 1) / step : 0;
+	parallel_for_range(0, count, 1, [&](int start, int end)
+	{
+		for (int i = start; i < end; i++)
+		{
+			func(first + (i * step));
+		}
+	});
+}
+
+// Calls func(i0, i1) for every i0 in [first0, last0) and every i1 in [first1, last1).
+template <typename _Function>
+void parallel_for(int first0, int last0, int first1, int last1, const _Function& func)
+{
+	parallel_for_range(first0, last0, 1, first1, last1, 1, [&](int start0, int end0, int start1, int end1)
+	{
+		for (int i0 = start0; i0 < end0; i0++)
+		{
+			for (int i1 = start1; i1 < end1; i1++)
+			{
+				func(i0, i1);
+			}
+		}
+	});
+}
+
+// Runs the functions in parallel.
+template <typename _Function1, typename _Function2>
+void parallel_invoke(const _Function1& func1, const _Function2& func2)
+{
+	parallel_for(0, 2, [&](int i)
+	{
+		if (i == 0)
+		{
+			func1();
+		}
+		else
+		{
+			func2();
+		}
+	});
+}
+
+template <typename _Function1, typename _Function2, typename _Function3>
+void parallel_invoke(const _Function1& func1, const _Function2& func2, const _Function3& func3)
+{
+	parallel_for(0, 3, [&](int i)
+	{
+		switch (i)
+		{
+		case 0: func1(); break;
+		case 1: func2(); break;
+		default: func3(); break;
+		}
+	});
+}
@@ -0,0 +1,127 @@
+﻿namespace Genix.Core.Test
+{
+    using System;
+    using System.Linq;
+    using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+    [TestClass]
+    public class HalfPrecisionTest
+    {
+        [TestMethod]
+        public void HalfTest()
+        {
+            // ties round to even, 65520 overflows, 2^-24 is the smallest subnormal
+            float[] x = new float[] { 1.0f, -2.0f, 65504.0f, 65520.0f, 1.0f + (1.0f / 2048), 1.0f + (3.0f / 2048), 5.9604645E-08f, 2.9802322E-08f, 0.1f };
+            ushort[] h = new ushort[x.Length + 1];
+            HalfPrecision.ToHalf(x.Length, x, 0, h, 1);
+            CollectionAssert.AreEqual(new ushort[] { 0, 0x3c00, 0xc000, 0x7bff, 0x7c00, 0x3c00, 0x3c02, 0x0001, 0x0000, 0x2e66 }, h);
+
+            float[] y = new float[x.Length];
+            HalfPrecision.FromHalf(x.Length, h, 1, y, 0);
+            CollectionAssert.AreEqual(
+                new float[] { 1.0f, -2.0f, 65504.0f, float.PositiveInfinity, 1.0f, 1.0f + (1.0f / 512), 5.9604645E-08f, 0.0f, 0.099975586f },
+                y);
+        }
+
+        [TestMethod]
+        public void BFloat16Test()
+        {
+            float[] x = new float[] { 1.0f, -2.0f, 1.0f + (1.0f / 256), 1.0f + (3.0f / 256), float.MaxValue, 1e-40f };
+            ushort[] h = new ushort[x.Length];
+            HalfPrecision.ToBFloat16(x.Length, x, 0, h, 0);
+            CollectionAssert.AreEqual(new ushort[] { 0x3f80, 0xc000, 0x3f80, 0x3f82, 0x7f80, 0x0001 }, h);
+
+            float[] y = new float[x.Length];
+            HalfPrecision.FromBFloat16(x.Length, h, 0, y, 0);
+            Assert.AreEqual(1.0f + (1.0f / 64), y[3]);
+            Assert.AreEqual(float.PositiveInfinity, y[4]);
+        }
+
+        [TestMethod]
+        public void MxMTest()
+        {
+            Random random = new Random(0);
+
+            foreach (bool bfloat16 in new[] { false, true })
+            {
+                foreach (int m in new[] { 1, 2, 5 })
+                {
+                    foreach (int k in new[] { 1, 7, 64, 131 })
+                    {
+                        foreach (int n in new[] { 1, 3, 16, 21 })
+                        {
+                            float[] a = Enumerable.Range(0, m * k).Select(_ => (float)random.NextDouble() - 0.5f).ToArray();
+                            float[] b = Enumerable.Range(0, n * k).Select(_ => (float)random.NextDouble() - 0.5f).ToArray();
+
+                            // the product uses the rounded weights
+                            ushort[] h = new ushort[b.Length];
+                            float[] rounded = new float[b.Length];
+                            if (bfloat16)
+                            {
+                                HalfPrecision.ToBFloat16(b.Length, b, 0, h, 0);
+                                HalfPrecision.FromBFloat16(b.Length, h, 0, rounded, 0);
+                            }
+                            else
+                            {
+                                HalfPrecision.ToHalf(b.Length, b, 0, h, 0);
+                                HalfPrecision.FromHalf(b.Length, h, 0, rounded, 0);
+                            }
+
+                            float[] expected = new float[m * n];
+                            for (int i = 0; i < m; i++)
+                            {
+                                for (int j = 0; j < n; j++)
+                                {
+                                    double sum = 0;
+                                    for (int l = 0; l < k; l++)
+                                    {
+                                        sum += (double)a[(i * k) + l] * rounded[(j * k) + l];
+                                    }
+
+                                    expected[(i * n) + j] = (float)sum;
+                                }
+                            }
+
+                            ushort[] packed = new ushort[HalfPrecision.PackedLength(n, k)];
+                            HalfPrecision.Pack(n, k, b, 0, false, bfloat16, packed);
+
+                            // c := product
+                            float[] c = new float[m * n];
+                            HalfPrecision.MxM(m, k, n, a, 0, packed, bfloat16, c, 0, true);
+                            for (int i = 0; i < c.Length; i++)
+                            {
+                                Assert.AreEqual(expected[i], c[i], 1e-5f * k);
+                            }
+
+                            // c += product
+                            HalfPrecision.MxM(m, k, n, a, 0, packed, bfloat16, c, 0, false);
+                            for (int i = 0; i < c.Length; i++)
+                            {
+                                Assert.AreEqual(2 * expected[i], c[i], 2e-5f * k);
+                            }
+
+                            // the first row alone as a vector, the weights packed from the transposed matrix
+                            float[] bt = new float[b.Length];
+                            for (int j = 0; j < n; j++)
+                            {
+                                for (int l = 0; l < k; l++)
+                                {
+                                    bt[(l * n) + j] = b[(j * k) + l];
+                                }
+                            }
+
+                            HalfPrecision.Pack(n, k, bt, 0, true, bfloat16, packed);
+
+                            float[] y = new float[n];
+                            HalfPrecision.MxV(n, k, packed, bfloat16, a, 0, y, 0, true);
+                            for (int j = 0; j < n; j++)
+                            {
+                                Assert.AreEqual(expected[j], y[j], 1e-5f * k);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -323,5 +323,71 @@
             };
             GenixAssert.AreArraysEqual(expected, c);
         }
+
+        [TestMethod]
+        public void DistancesTest()
+        {
+            Random random = new Random(0);
+
+            foreach (int[] size in new[] { new[] { 1, 1, 1 }, new[] { 7, 5, 3 }, new[] { 33, 65, 70 }, new[] { 100, 300, 257 } })
+            {
+                int m = size[0], n = size[1], k = size[2];
+                float[] x = new float[1 + (m * k)];
+                float[] y = new float[2 + (n * k)];
+                double[] xd = new double[x.Length];
+                double[] yd = new double[y.Length];
+                uint[] xu = new uint[x.Length];
+                uint[] yu = new uint[y.Length];
+                ulong[] xl = new ulong[x.Length];
+                ulong[] yl = new ulong[y.Length];
+                for (int i = 0; i < x.Length; i++)
+                {
+                    xd[i] = x[i] = (float)random.NextDouble() - 0.5f;
+                    xu[i] = (uint)random.Next();
+                    xl[i] = ((ulong)random.Next() << 32) | (uint)random.Next();
+                }
+
+                for (int i = 0; i < y.Length; i++)
+                {
+                    yd[i] = y[i] = (float)random.NextDouble() - 0.5f;
+                    yu[i] = (uint)random.Next();
+                    yl[i] = ((ulong)random.Next() << 32) | (uint)random.Next();
+                }
+
+                float[] euclidean = new float[3 + (m * n)];
+                float[] squared = new float[3 + (m * n)];
+                float[] manhattan = new float[3 + (m * n)];
+                double[] manhattand = new double[3 + (m * n)];
+                uint[] hamming = new uint[3 + (m * n)];
+                ulong[] hammingl = new ulong[3 + (m * n)];
+                Matrix.EuclideanDistances(m, n, k, x, 1, y, 2, euclidean, 3, false);
+                Matrix.EuclideanDistances(m, n, k, x, 1, y, 2, squared, 3, true);
+                Matrix.ManhattanDistances(m, n, k, x, 1, y, 2, manhattan, 3);
+                Matrix.ManhattanDistances(m, n, k, xd, 1, yd, 2, manhattand, 3);
+                Matrix.HammingDistances(m, n, k, xu, 1, yu, 2, hamming, 3);
+                Matrix.HammingDistances(m, n, k, xl, 1, yl, 2, hammingl, 3);
+
+                for (int i = 0; i < m; i++)
+                {
+                    for (int j = 0; j < n; j++)
+                    {
+                        int offx = 1 + (i * k);
+                        int offy = 2 + (j * k);
+                        int offd = 3 + (i * n) + j;
+
+                        float expected = Vectors.EuclideanDistanceSquared(k, x, offx, y, offy);
+                        Assert.AreEqual(expected, squared[offd], 1e-4f * (1.0f + expected));
+                        Assert.AreEqual((float)Math.Sqrt(expected), euclidean[offd], 1e-3f);
+
+                        expected = Vectors.ManhattanDistance(k, x, offx, y, offy);
+                        Assert.AreEqual(expected, manhattan[offd], 1e-4f * (1.0f + expected));
+                        Assert.AreEqual(Vectors.ManhattanDistance(k, xd, offx, yd, offy), manhattand[offd], 1e-10);
+
+                        Assert.AreEqual(Vectors.HammingDistance(k, xu, offx, yu, offy), hamming[offd]);
+                        Assert.AreEqual(Vectors.HammingDistance(k, xl, offx, yl, offy), hammingl[offd]);
+                    }
+                }
+            }
+        }
     }
 }
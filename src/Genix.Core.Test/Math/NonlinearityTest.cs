@@ -0,0 +1,158 @@
+﻿namespace Genix.Core.Test
+{
+    using System;
+    using System.Diagnostics;
+    using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+    [TestClass]
+    public class NonlinearityTest
+    {
+        private const int Length = 100000;
+        private const int Count = 100;
+
+        [TestMethod]
+        public void ExpFastTest()
+        {
+            float[] x = NonlinearityTest.CreateArguments(-87.0f, 88.0f);
+            float[] y = new float[x.Length];
+
+            Nonlinearity.ExpFast(x.Length, x, 0, y, 0);
+            NonlinearityTest.AssertUlp(x, y, Math.Exp, 2);
+
+            float[] special = new float[] { float.NegativeInfinity, -200.0f, 0.0f, 200.0f, float.PositiveInfinity, float.NaN };
+            Nonlinearity.ExpFast(special.Length, special, 0, special, 0);
+            CollectionAssert.AreEqual(new float[] { 0.0f, 0.0f, 1.0f, float.PositiveInfinity, float.PositiveInfinity, float.NaN }, special);
+
+            NonlinearityTest.Benchmark(
+                "exp",
+                x,
+                (a, b) => Nonlinearity.ExpFast(a.Length, a, 0, b, 0),
+                "vml",
+                (a, b) => Vectors.Exp(a.Length, a, 0, b, 0),
+                Math.Exp);
+        }
+
+        [TestMethod]
+        public void SigmoidFastTest()
+        {
+            float[] x = NonlinearityTest.CreateArguments(-50.0f, 50.0f);
+            float[] y = new float[x.Length];
+
+            Nonlinearity.SigmoidFast(x.Length, x, 0, y, 0);
+            NonlinearityTest.AssertUlp(x, y, a => 1.0 / (1.0 + Math.Exp(-a)), 3);
+
+            float[] special = new float[] { float.NegativeInfinity, 0.0f, float.PositiveInfinity };
+            Nonlinearity.SigmoidFast(special.Length, special, 0, special, 0);
+            CollectionAssert.AreEqual(new float[] { 0.0f, 0.5f, 1.0f }, special);
+
+            NonlinearityTest.Benchmark(
+                "sigmoid",
+                x,
+                (a, b) => Nonlinearity.SigmoidFast(a.Length, a, 0, b, 0),
+                "expf",
+                (a, b) => Nonlinearity.Sigmoid(a.Length, a, 0, b, 0),
+                a => 1.0 / (1.0 + Math.Exp(-a)));
+        }
+
+        [TestMethod]
+        public void TanhFastTest()
+        {
+            float[] x = NonlinearityTest.CreateArguments(-10.0f, 10.0f);
+            float[] y = new float[x.Length];
+
+            Nonlinearity.TanhFast(x.Length, x, 0, y, 0);
+            NonlinearityTest.AssertUlp(x, y, Math.Tanh, 2);
+
+            float[] special = new float[] { float.NegativeInfinity, -0.0f, 0.0f, float.PositiveInfinity };
+            Nonlinearity.TanhFast(special.Length, special, 0, special, 0);
+            CollectionAssert.AreEqual(new float[] { -1.0f, -0.0f, 0.0f, 1.0f }, special);
+
+            NonlinearityTest.Benchmark(
+                "tanh",
+                x,
+                (a, b) => Nonlinearity.TanhFast(a.Length, a, 0, b, 0),
+                "vml",
+                (a, b) => Nonlinearity.Tanh(a.Length, a, 0, b, 0),
+                Math.Tanh);
+        }
+
+        private static float[] CreateArguments(float min, float max)
+        {
+            // an odd length, so the vector tails are tested too
+            float[] x = new float[Length + 7];
+            for (int i = 0; i < x.Length; i++)
+            {
+                x[i] = min + ((max - min) * i / (x.Length - 1));
+            }
+
+            return x;
+        }
+
+        private static double Ulp(float y, double expected)
+        {
+            float e = (float)expected;
+            if (e == 0.0f)
+            {
+                return Math.Abs(y) <= float.Epsilon ? 0.0 : Math.Abs(y) / float.Epsilon;
+            }
+
+            // the distance between e and the next float away from zero
+            int bits = BitConverter.ToInt32(BitConverter.GetBytes(Math.Abs(e)), 0);
+            float next = BitConverter.ToSingle(BitConverter.GetBytes(bits + 1), 0);
+            return Math.Abs(y - expected) / (next - Math.Abs(e));
+        }
+
+        private static void AssertUlp(float[] x, float[] y, Func<double, double> func, double maxUlp)
+        {
+            for (int i = 0; i < x.Length; i++)
+            {
+                double ulp = NonlinearityTest.Ulp(y[i], func(x[i]));
+                Assert.IsTrue(ulp <= maxUlp, "f({0}) = {1}: {2:F2} ulp", x[i], y[i], ulp);
+            }
+        }
+
+        // other is the exact native function the fast one replaces: the backend vector math (vsExp, vsTanh)
+        // or, for sigmoid that the vector math does not have, the element-wise expf
+        private static void Benchmark(
+            string name,
+            float[] x,
+            Action<float[], float[]> fast,
+            string otherName,
+            Action<float[], float[]> other,
+            Func<double, double> scalar)
+        {
+            float[] y = new float[x.Length];
+            Stopwatch stopwatch = new Stopwatch();
+
+            stopwatch.Restart();
+            for (int i = 0; i < Count; i++)
+            {
+                fast(x, y);
+            }
+
+            stopwatch.Stop();
+            Console.WriteLine("{0} fast: {1:F4} ms", name, (double)stopwatch.ElapsedMilliseconds / Count);
+
+            stopwatch.Restart();
+            for (int i = 0; i < Count; i++)
+            {
+                other(x, y);
+            }
+
+            stopwatch.Stop();
+            Console.WriteLine("{0} {1}: {2:F4} ms", name, otherName, (double)stopwatch.ElapsedMilliseconds / Count);
+
+            stopwatch.Restart();
+            for (int i = 0; i < Count; i++)
+            {
+                for (int j = 0; j < x.Length; j++)
+                {
+                    y[j] = (float)scalar(x[j]);
+                }
+            }
+
+            stopwatch.Stop();
+            Console.WriteLine("{0} scalar: {1:F4} ms", name, (double)stopwatch.ElapsedMilliseconds / Count);
+        }
+    }
+}
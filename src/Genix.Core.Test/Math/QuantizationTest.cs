@@ -0,0 +1,108 @@
+﻿namespace Genix.Core.Test
+{
+    using System;
+    using System.Linq;
+    using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+    [TestClass]
+    public class QuantizationTest
+    {
+        [TestMethod]
+        public void QuantizeTest()
+        {
+            float[] x = new float[] { -3.0f, -1.0f, 0.0f, 0.26f, 1.0f, 200.0f };
+            byte[] q = new byte[x.Length + 1];
+            Quantization.Quantize(x.Length, x, 0, 0.5f, 4, q, 1);
+            CollectionAssert.AreEqual(new byte[] { 0, 0, 2, 4, 5, 6, 255 }, q);
+
+            float[] y = new float[x.Length];
+            Quantization.Dequantize(x.Length, q, 1, 0.5f, 4, y, 0);
+            CollectionAssert.AreEqual(new float[] { -2.0f, -1.0f, 0.0f, 0.5f, 1.0f, 125.5f }, y);
+        }
+
+        [TestMethod]
+        public void QuantizeChannelsTest()
+        {
+            // two channels of three weights, the second one all zeros
+            float[] a = new float[] { 1.0f, -0.5f, 0.25f, 0.0f, 0.0f, 0.0f };
+
+            foreach (bool transa in new[] { false, true })
+            {
+                float[] w = transa ? new float[] { a[0], a[3], a[1], a[4], a[2], a[5] } : a;
+
+                sbyte[] q = new sbyte[6];
+                float[] scales = new float[2];
+                int[] sums = new int[2];
+                Quantization.QuantizeChannels(2, 3, w, 0, transa, q, 0, scales, 0, sums, 0);
+
+                CollectionAssert.AreEqual(new sbyte[] { 127, -64, 32, 0, 0, 0 }, q);
+                Assert.AreEqual(1.0f / 127, scales[0], 1e-7f);
+                Assert.AreEqual(1.0f, scales[1]);
+                CollectionAssert.AreEqual(new int[] { 127 - 64 + 32, 0 }, sums);
+            }
+        }
+
+        [TestMethod]
+        public void MxMTest()
+        {
+            Random random = new Random(0);
+
+            foreach (int m in new[] { 1, 2, 5 })
+            {
+                foreach (int k in new[] { 1, 7, 64, 131 })
+                {
+                    foreach (int n in new[] { 1, 3, 16, 21 })
+                    {
+                        byte[] a = Enumerable.Range(0, m * k).Select(_ => (byte)random.Next(256)).ToArray();
+                        sbyte[] b = Enumerable.Range(0, n * k).Select(_ => (sbyte)random.Next(-127, 128)).ToArray();
+                        float[] bscales = Enumerable.Range(0, n).Select(j => 0.01f * (j + 1)).ToArray();
+                        int[] bsums = Enumerable.Range(0, n).Select(j => Enumerable.Range(0, k).Sum(l => (int)b[(j * k) + l])).ToArray();
+                        const int AZero = 100;
+                        const float AScale = 0.05f;
+
+                        float[] expected = new float[m * n];
+                        for (int i = 0; i < m; i++)
+                        {
+                            for (int j = 0; j < n; j++)
+                            {
+                                long sum = 0;
+                                for (int l = 0; l < k; l++)
+                                {
+                                    sum += (a[(i * k) + l] - AZero) * b[(j * k) + l];
+                                }
+
+                                expected[(i * n) + j] = AScale * bscales[j] * sum;
+                            }
+                        }
+
+                        // c := product
+                        float[] c = new float[m * n];
+                        Quantization.MxM(m, k, n, a, 0, AZero, AScale, b, 0, bscales, bsums, c, 0, true);
+                        for (int i = 0; i < c.Length; i++)
+                        {
+                            Assert.AreEqual(expected[i], c[i], 1e-4f * Math.Abs(expected[i]) + 1e-4f);
+                        }
+
+                        // c += product
+                        Quantization.MxM(m, k, n, a, 0, AZero, AScale, b, 0, bscales, bsums, c, 0, false);
+                        for (int i = 0; i < c.Length; i++)
+                        {
+                            Assert.AreEqual(2 * expected[i], c[i], 2e-4f * Math.Abs(expected[i]) + 1e-4f);
+                        }
+
+                        // the first row alone as a vector, the weights packed once
+                        sbyte[] packed = new sbyte[Quantization.PackedLength(n, k)];
+                        Quantization.Pack(n, k, b, 0, packed);
+
+                        float[] y = new float[n];
+                        Quantization.MxV(n, k, packed, bscales, bsums, a, 0, AZero, AScale, y, 0, true);
+                        for (int j = 0; j < n; j++)
+                        {
+                            Assert.AreEqual(expected[j], y[j], 1e-4f * Math.Abs(expected[j]) + 1e-4f);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
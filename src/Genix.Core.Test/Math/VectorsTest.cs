@@ -135,5 +135,197 @@
             Assert.IsTrue(Vectors.Equals(Length, workarray1, 0, array2, 0));
             Assert.IsTrue(Vectors.Equals(Length, workarray2, 0, array1, 0));
         }
+
+        [TestMethod]
+        public void ArgMinMaxTest()
+        {
+            Random random = new Random(0);
+
+            foreach (int length in new[] { 1, 7, 64, 100, 1000 })
+            {
+                // few distinct values, so the first of equal elements must win
+                byte[] x8 = Enumerable.Range(0, length).Select(_ => (byte)random.Next(0, 256)).ToArray();
+                Assert.AreEqual(Array.IndexOf(x8, x8.Min()), Vectors.ArgMin(length, x8, 0));
+                Assert.AreEqual(Array.IndexOf(x8, x8.Max()), Vectors.ArgMax(length, x8, 0));
+
+                float[] x = Enumerable.Range(0, length).Select(_ => (float)random.Next(-20, 20)).ToArray();
+                Assert.AreEqual(Array.IndexOf(x, x.Min()), Vectors.ArgMin(length, x, 0));
+                Assert.AreEqual(Array.IndexOf(x, x.Max()), Vectors.ArgMax(length, x, 0));
+
+                Vectors.ArgMinMax(length, x, 0, out int min, out int max);
+                Assert.AreEqual(Array.IndexOf(x, x.Min()), min);
+                Assert.AreEqual(Array.IndexOf(x, x.Max()), max);
+            }
+        }
+
+        [TestMethod]
+        public void SortTest()
+        {
+            Random random = new Random(0);
+
+            foreach (int length in new[] { 1, 10, 300, 5000 })
+            {
+                foreach (bool ascending in new[] { true, false })
+                {
+                    float[] x = Enumerable.Range(0, length).Select(_ => (float)random.Next(-100, 100)).ToArray();
+                    int[] ix = Enumerable.Range(0, length).Select(_ => random.Next(-100, 100)).ToArray();
+
+                    float[] expected = ascending ? x.OrderBy(a => a).ToArray() : x.OrderByDescending(a => a).ToArray();
+                    int[] iexpected = ascending ? ix.OrderBy(a => a).ToArray() : ix.OrderByDescending(a => a).ToArray();
+
+                    float[] keys = x.ToArray();
+                    Vectors.Sort(length, keys, 0, ascending);
+                    CollectionAssert.AreEqual(expected, keys);
+
+                    int[] ikeys = ix.ToArray();
+                    Vectors.Sort(length, ikeys, 0, ascending);
+                    CollectionAssert.AreEqual(iexpected, ikeys);
+
+                    // the values follow the keys
+                    int[] values = Enumerable.Range(0, length).ToArray();
+                    keys = x.ToArray();
+                    Vectors.Sort(length, keys, 0, values, 0, ascending);
+                    CollectionAssert.AreEqual(expected, keys);
+                    CollectionAssert.AreEqual(expected, values.Select(i => x[i]).ToArray());
+
+                    values = Enumerable.Range(0, length).ToArray();
+                    long[] lkeys = ix.Select(a => (long)a).ToArray();
+                    Vectors.Sort(length, lkeys, 0, values, 0, ascending);
+                    CollectionAssert.AreEqual(iexpected.Select(a => (long)a).ToArray(), lkeys);
+                    CollectionAssert.AreEqual(iexpected, values.Select(i => ix[i]).ToArray());
+                }
+            }
+        }
+
+        [TestMethod]
+        public void TopKTest()
+        {
+            Random random = new Random(0);
+
+            foreach (int length in new[] { 1, 10, 300, 5000 })
+            {
+                foreach (int k in new[] { 1, 5, 100 })
+                {
+                    float[] x = Enumerable.Range(0, length).Select(_ => (float)random.Next(-100, 100)).ToArray();
+                    int count = Math.Min(length, k);
+
+                    // the equal elements are taken in the order they come
+                    int[] expected = Enumerable.Range(0, length).OrderByDescending(i => x[i]).Take(count).ToArray();
+
+                    float[] y = new float[k];
+                    int[] indices = new int[k];
+                    Assert.AreEqual(count, Vectors.TopK(length, x, 0, k, y, 0, indices, 0, true));
+                    CollectionAssert.AreEqual(expected, indices.Take(count).ToArray());
+                    CollectionAssert.AreEqual(expected.Select(i => x[i]).ToArray(), y.Take(count).ToArray());
+
+                    expected = Enumerable.Range(0, length).OrderBy(i => x[i]).Take(count).ToArray();
+                    Assert.AreEqual(count, Vectors.TopK(length, x, 0, k, y, 0, indices, 0, false));
+                    CollectionAssert.AreEqual(expected, indices.Take(count).ToArray());
+
+                    // partial sort
+                    float[] keys = x.ToArray();
+                    int[] values = Enumerable.Range(0, length).ToArray();
+                    Vectors.PartialSort(length, keys, 0, values, 0, k, true);
+                    CollectionAssert.AreEqual(x.OrderBy(a => a).Take(count).ToArray(), keys.Take(count).ToArray());
+                    CollectionAssert.AreEqual(keys, values.Select(i => x[i]).ToArray());
+                }
+            }
+        }
+
+        [TestMethod]
+        public void TopKBatchTest()
+        {
+            const int RowLength = 37;
+            const int Count = 50;
+            const int K = 5;
+
+            float[] x = new RandomGeneratorF().Generate(-20.0f, 20.0f, RowLength * Count);
+
+            float[] y = new float[K * Count];
+            int[] indices = new int[K * Count];
+            Vectors.TopK(x.Length, x, 0, RowLength, K, y, 0, indices, 0, true);
+
+            float[] expected = new float[K];
+            int[] expectedIndices = new int[K];
+            for (int i = 0; i < Count; i++)
+            {
+                Vectors.TopK(RowLength, x, i * RowLength, K, expected, 0, expectedIndices, 0, true);
+                GenixAssert.AreArraysEqual(K, expected, 0, y, i * K);
+                CollectionAssert.AreEqual(expectedIndices, indices.Skip(i * K).Take(K).ToArray());
+            }
+        }
+
+        [TestMethod]
+        public void SoftMaxTest()
+        {
+            foreach (int length in new[] { 1, 7, 16, 100, 1000 })
+            {
+                float[] x = new RandomGeneratorF().Generate(-20.0f, 20.0f, length);
+
+                double max = x.Max();
+                double sum = x.Sum(a => Math.Exp(a - max));
+
+                float[] y = new float[length];
+                Vectors.SoftMax(length, x, 0, y, 0);
+                for (int i = 0; i < length; i++)
+                {
+                    double expected = Math.Exp(x[i] - max) / sum;
+                    Assert.AreEqual(expected, y[i], 1e-5 * expected);
+                }
+
+                Vectors.LogSoftMax(length, x, 0, y, 0);
+                for (int i = 0; i < length; i++)
+                {
+                    double expected = x[i] - max - Math.Log(sum);
+                    Assert.AreEqual(expected, y[i], 1e-5 * (1.0 + Math.Abs(expected)));
+                }
+            }
+        }
+
+        [TestMethod]
+        public void LogSoftMaxLargeLogitsTest()
+        {
+            // the result must not be rounded to the precision of the logits
+            foreach (float offset in new[] { -10000.0f, -1000.0f, 1000.0f, 10000.0f })
+            {
+                float[] x = new RandomGeneratorF().Generate(offset - 4.0f, offset + 4.0f, 37);
+
+                double max = x.Max();
+                double sum = x.Sum(a => Math.Exp(a - max));
+
+                float[] y = new float[x.Length];
+                Vectors.LogSoftMax(x.Length, x, 0, y, 0);
+                for (int i = 0; i < x.Length; i++)
+                {
+                    double expected = x[i] - max - Math.Log(sum);
+                    Assert.AreEqual(expected, y[i], 1e-5 * (1.0 + Math.Abs(expected)));
+                }
+            }
+        }
+
+        [TestMethod]
+        public void SoftMaxBatchTest()
+        {
+            const int BatchLength = 37;
+            const int Count = 50;
+
+            float[] x = new RandomGeneratorF().Generate(-20.0f, 20.0f, BatchLength * Count);
+
+            float[] y = new float[x.Length];
+            Vectors.SoftMax(x.Length, x, 0, BatchLength, y, 0);
+
+            float[] logy = new float[x.Length];
+            Vectors.LogSoftMax(x.Length, x, 0, BatchLength, logy, 0);
+
+            float[] expected = new float[BatchLength];
+            for (int i = 0; i < x.Length; i += BatchLength)
+            {
+                Vectors.SoftMax(BatchLength, x, i, expected, 0);
+                GenixAssert.AreArraysEqual(BatchLength, expected, 0, y, i);
+
+                Vectors.LogSoftMax(BatchLength, x, i, expected, 0);
+                GenixAssert.AreArraysEqual(BatchLength, expected, 0, logy, i);
+            }
+        }
     }
 }
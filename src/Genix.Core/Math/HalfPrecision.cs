@@ -0,0 +1,270 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="HalfPrecision.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.Core
+{
+    using System.Runtime.CompilerServices;
+    using System.Runtime.InteropServices;
+    using System.Security;
+
+    /// <summary>
+    /// Provides 16-bit storage of single-precision floating point numbers and products of matrices stored in 16 bits.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Two formats are supported: IEEE half precision, that has 11 bits of precision and the range of ±65504,
+    /// and bfloat16, the upper half of a single-precision number, that has 8 bits of precision and the range of single precision.
+    /// The numbers are rounded to nearest even.
+    /// </para>
+    /// <para>
+    /// The matrix products convert the packed matrices back to single precision as they read them and accumulate in single precision,
+    /// so they read half the memory the single-precision products read.
+    /// </para>
+    /// </remarks>
+    public static class HalfPrecision
+    {
+        /// <summary>
+        /// The number of rows in a panel of a packed matrix.
+        /// </summary>
+        private const int PanelRows = 16;
+
+        /// <summary>
+        /// Converts single-precision numbers from one array starting at the specified index
+        /// to half precision and stores them in another array starting at the specified index.
+        /// </summary>
+        /// <param name="length">The number of elements to convert.</param>
+        /// <param name="x">The array that contains the source data.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which conversion begins.</param>
+        /// <param name="y">The array that receives the converted data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void ToHalf(int length, float[] x, int offx, ushort[] y, int offy)
+        {
+            NativeMethods.convert_f32_f16(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Converts half-precision numbers from one array starting at the specified index
+        /// to single precision and stores them in another array starting at the specified index.
+        /// </summary>
+        /// <param name="length">The number of elements to convert.</param>
+        /// <param name="x">The array that contains the source data.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which conversion begins.</param>
+        /// <param name="y">The array that receives the converted data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void FromHalf(int length, ushort[] x, int offx, float[] y, int offy)
+        {
+            NativeMethods.convert_f16_f32(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Converts single-precision numbers from one array starting at the specified index
+        /// to bfloat16 and stores them in another array starting at the specified index.
+        /// </summary>
+        /// <param name="length">The number of elements to convert.</param>
+        /// <param name="x">The array that contains the source data.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which conversion begins.</param>
+        /// <param name="y">The array that receives the converted data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void ToBFloat16(int length, float[] x, int offx, ushort[] y, int offy)
+        {
+            NativeMethods.convert_f32_bf16(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Converts bfloat16 numbers from one array starting at the specified index
+        /// to single precision and stores them in another array starting at the specified index.
+        /// </summary>
+        /// <param name="length">The number of elements to convert.</param>
+        /// <param name="x">The array that contains the source data.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which conversion begins.</param>
+        /// <param name="y">The array that receives the converted data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void FromBFloat16(int length, ushort[] x, int offx, float[] y, int offy)
+        {
+            NativeMethods.convert_bf16_f32(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Returns the number of elements in a packed matrix.
+        /// </summary>
+        /// <param name="m">The number of rows in the matrix.</param>
+        /// <param name="n">The number of columns in the matrix.</param>
+        /// <returns>
+        /// The length of the array that <see cref="Pack"/> needs for the matrix.
+        /// </returns>
+        public static int PackedLength(int m, int n)
+        {
+            return (m + HalfPrecision.PanelRows - 1) / HalfPrecision.PanelRows * HalfPrecision.PanelRows * n;
+        }
+
+        /// <summary>
+        /// Packs a matrix for the products <see cref="MxM"/> and <see cref="MxV"/>.
+        /// </summary>
+        /// <param name="m">The number of rows in the matrix A.</param>
+        /// <param name="n">The number of columns in the matrix A.</param>
+        /// <param name="a">The array that contains the matrix A.</param>
+        /// <param name="offa">The index in the <paramref name="a"/> at which the matrix A begins.</param>
+        /// <param name="transa">
+        /// <b>false</b> if the matrix A is row-major (element (i, j) is at i * n + j);
+        /// <b>true</b> if it is column-major (element (i, j) is at j * m + i).
+        /// </param>
+        /// <param name="bfloat16"><b>true</b> to store the matrix in bfloat16; <b>false</b> to store it in half precision.</param>
+        /// <param name="packed">The array that receives the packed matrix, <see cref="PackedLength"/> elements.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void Pack(int m, int n, float[] a, int offa, bool transa, bool bfloat16, ushort[] packed)
+        {
+            if (bfloat16)
+            {
+                NativeMethods.matrix_pack_bf16(m, n, a, offa, transa ? m : n, transa, packed);
+            }
+            else
+            {
+                NativeMethods.matrix_pack_f16(m, n, a, offa, transa ? m : n, transa, packed);
+            }
+        }
+
+        /// <summary>
+        /// Computes a product of a matrix and a packed matrix.
+        /// The operation is defined as C := A * B' or as C += A * B' depending on value of <paramref name="clearc"/> parameter.
+        /// </summary>
+        /// <param name="m">The number of rows in the matrices A and C.</param>
+        /// <param name="k">The number of columns in the matrices A and B.</param>
+        /// <param name="n">The number of rows in the matrix B and columns in the matrix C.</param>
+        /// <param name="a">The array that contains the row-major matrix A.</param>
+        /// <param name="offa">The index in the <paramref name="a"/> at which the matrix A begins.</param>
+        /// <param name="b">The array that contains the matrix B packed by <see cref="Pack"/>.</param>
+        /// <param name="bfloat16"><b>true</b> if the matrix B is stored in bfloat16; <b>false</b> if it is stored in half precision.</param>
+        /// <param name="c">The array that receives the row-major matrix C.</param>
+        /// <param name="offc">The index in the <paramref name="c"/> at which the matrix C begins.</param>
+        /// <param name="clearc">Specifies whether the <paramref name="c"/> should be cleared before operation.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void MxM(int m, int k, int n, float[] a, int offa, ushort[] b, bool bfloat16, float[] c, int offc, bool clearc)
+        {
+            if (bfloat16)
+            {
+                NativeMethods.matrix_mm_bf16(m, k, n, a, offa, b, c, offc, clearc);
+            }
+            else
+            {
+                NativeMethods.matrix_mm_f16(m, k, n, a, offa, b, c, offc, clearc);
+            }
+        }
+
+        /// <summary>
+        /// Computes a product of a packed matrix and a vector.
+        /// The operation is defined as y := A * x or as y += A * x depending on value of <paramref name="cleary"/> parameter.
+        /// </summary>
+        /// <param name="m">The number of rows in the matrix A.</param>
+        /// <param name="n">The number of columns in the matrix A.</param>
+        /// <param name="a">The array that contains the matrix A packed by <see cref="Pack"/>.</param>
+        /// <param name="bfloat16"><b>true</b> if the matrix A is stored in bfloat16; <b>false</b> if it is stored in half precision.</param>
+        /// <param name="x">The array that contains the vector x.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the vector x begins.</param>
+        /// <param name="y">The array that receives the vector y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the vector y begins.</param>
+        /// <param name="cleary">Specifies whether the <paramref name="y"/> should be cleared before operation.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void MxV(int m, int n, ushort[] a, bool bfloat16, float[] x, int offx, float[] y, int offy, bool cleary)
+        {
+            if (bfloat16)
+            {
+                NativeMethods.matrix_mv_bf16(m, n, a, x, offx, y, offy, cleary);
+            }
+            else
+            {
+                NativeMethods.matrix_mv_f16(m, n, a, x, offx, y, offy, cleary);
+            }
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.Core.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void convert_f32_f16(int n, [In] float[] x, int offx, [Out] ushort[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void convert_f16_f32(int n, [In] ushort[] x, int offx, [Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void convert_f32_bf16(int n, [In] float[] x, int offx, [Out] ushort[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void convert_bf16_f32(int n, [In] ushort[] x, int offx, [Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_pack_f16(
+                int m,
+                int n,
+                [In] float[] a,
+                int offa,
+                int lda,
+                [MarshalAs(UnmanagedType.Bool)] bool transa,
+                [Out] ushort[] packed);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_pack_bf16(
+                int m,
+                int n,
+                [In] float[] a,
+                int offa,
+                int lda,
+                [MarshalAs(UnmanagedType.Bool)] bool transa,
+                [Out] ushort[] packed);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_mm_f16(
+                int m,
+                int k,
+                int n,
+                [In] float[] a,
+                int offa,
+                [In] ushort[] b,
+                [In, Out] float[] c,
+                int offc,
+                [MarshalAs(UnmanagedType.Bool)] bool clearc);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_mm_bf16(
+                int m,
+                int k,
+                int n,
+                [In] float[] a,
+                int offa,
+                [In] ushort[] b,
+                [In, Out] float[] c,
+                int offc,
+                [MarshalAs(UnmanagedType.Bool)] bool clearc);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_mv_f16(
+                int m,
+                int n,
+                [In] ushort[] a,
+                [In] float[] x,
+                int offx,
+                [In, Out] float[] y,
+                int offy,
+                [MarshalAs(UnmanagedType.Bool)] bool cleary);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_mv_bf16(
+                int m,
+                int n,
+                [In] ushort[] a,
+                [In] float[] x,
+                int offx,
+                [In, Out] float[] y,
+                int offy,
+                [MarshalAs(UnmanagedType.Bool)] bool cleary);
+        }
+    }
+}
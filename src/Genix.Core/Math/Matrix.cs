@@ -158,6 +158,118 @@ namespace Genix.Core
             NativeMethods.matrix_transpose(matrixLayout == MatrixLayout.RowMajor, m, n, ab, offab);
         }
 
+        /// <summary>
+        /// Computes the Euclidean distances between the rows of two matrices of single-precision floating point numbers.
+        /// The operation is defined as D(i, j) := |X(i) - Y(j)|.
+        /// </summary>
+        /// <param name="m">The number of rows of the matrix X and of the matrix D.</param>
+        /// <param name="n">The number of rows of the matrix Y and the number of columns of the matrix D.</param>
+        /// <param name="k">The number of columns of the matrices X and Y.</param>
+        /// <param name="x">The array that contains the row-major matrix X.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix X begins.</param>
+        /// <param name="y">The array that contains the row-major matrix Y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the matrix Y begins.</param>
+        /// <param name="d">The array that receives the row-major matrix D.</param>
+        /// <param name="offd">The index in the <paramref name="d"/> at which the matrix D begins.</param>
+        /// <param name="squared">Specifies whether the squared distances should be computed.</param>
+        /// <remarks>
+        /// The distances are expanded as |X(i)|^2 + |Y(j)|^2 - 2 * X(i) * Y(j) and the products are computed by the matrix multiplication.
+        /// Very close rows may get a distance that differs from zero by a rounding error.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void EuclideanDistances(int m, int n, int k, float[] x, int offx, float[] y, int offy, float[] d, int offd, bool squared)
+        {
+            NativeMethods.euclidean_distance_matrix_f32(m, n, k, x, offx, y, offy, d, offd, squared);
+        }
+
+        /// <summary>
+        /// Computes the Manhattan distances between the rows of two matrices of single-precision floating point numbers.
+        /// The operation is defined as D(i, j) := sum(|X(i) - Y(j)|).
+        /// </summary>
+        /// <param name="m">The number of rows of the matrix X and of the matrix D.</param>
+        /// <param name="n">The number of rows of the matrix Y and the number of columns of the matrix D.</param>
+        /// <param name="k">The number of columns of the matrices X and Y.</param>
+        /// <param name="x">The array that contains the row-major matrix X.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix X begins.</param>
+        /// <param name="y">The array that contains the row-major matrix Y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the matrix Y begins.</param>
+        /// <param name="d">The array that receives the row-major matrix D.</param>
+        /// <param name="offd">The index in the <paramref name="d"/> at which the matrix D begins.</param>
+        /// <remarks>
+        /// The rows of the matrix Y are processed in blocks that fit into the cache.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void ManhattanDistances(int m, int n, int k, float[] x, int offx, float[] y, int offy, float[] d, int offd)
+        {
+            NativeMethods.manhattan_distance_matrix_f32(m, n, k, x, offx, y, offy, d, offd);
+        }
+
+        /// <summary>
+        /// Computes the Manhattan distances between the rows of two matrices of double-precision floating point numbers.
+        /// The operation is defined as D(i, j) := sum(|X(i) - Y(j)|).
+        /// </summary>
+        /// <param name="m">The number of rows of the matrix X and of the matrix D.</param>
+        /// <param name="n">The number of rows of the matrix Y and the number of columns of the matrix D.</param>
+        /// <param name="k">The number of columns of the matrices X and Y.</param>
+        /// <param name="x">The array that contains the row-major matrix X.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix X begins.</param>
+        /// <param name="y">The array that contains the row-major matrix Y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the matrix Y begins.</param>
+        /// <param name="d">The array that receives the row-major matrix D.</param>
+        /// <param name="offd">The index in the <paramref name="d"/> at which the matrix D begins.</param>
+        /// <remarks>
+        /// The rows of the matrix Y are processed in blocks that fit into the cache.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void ManhattanDistances(int m, int n, int k, double[] x, int offx, double[] y, int offy, double[] d, int offd)
+        {
+            NativeMethods.manhattan_distance_matrix_f64(m, n, k, x, offx, y, offy, d, offd);
+        }
+
+        /// <summary>
+        /// Computes the Hamming distances between the rows of two bit matrices packed into 32-bit unsigned integers.
+        /// The operation is defined as D(i, j) := popcount(X(i) ^ Y(j)).
+        /// </summary>
+        /// <param name="m">The number of rows of the matrix X and of the matrix D.</param>
+        /// <param name="n">The number of rows of the matrix Y and the number of columns of the matrix D.</param>
+        /// <param name="k">The number of words of bits in a row of the matrices X and Y.</param>
+        /// <param name="x">The array that contains the row-major matrix X.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix X begins.</param>
+        /// <param name="y">The array that contains the row-major matrix Y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the matrix Y begins.</param>
+        /// <param name="d">The array that receives the row-major matrix D.</param>
+        /// <param name="offd">The index in the <paramref name="d"/> at which the matrix D begins.</param>
+        /// <remarks>
+        /// The rows of the matrix Y are processed in blocks that fit into the cache.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void HammingDistances(int m, int n, int k, uint[] x, int offx, uint[] y, int offy, uint[] d, int offd)
+        {
+            NativeMethods.hamming_distance_matrix_u32(m, n, k, x, offx, y, offy, d, offd);
+        }
+
+        /// <summary>
+        /// Computes the Hamming distances between the rows of two bit matrices packed into 64-bit unsigned integers.
+        /// The operation is defined as D(i, j) := popcount(X(i) ^ Y(j)).
+        /// </summary>
+        /// <param name="m">The number of rows of the matrix X and of the matrix D.</param>
+        /// <param name="n">The number of rows of the matrix Y and the number of columns of the matrix D.</param>
+        /// <param name="k">The number of words of bits in a row of the matrices X and Y.</param>
+        /// <param name="x">The array that contains the row-major matrix X.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix X begins.</param>
+        /// <param name="y">The array that contains the row-major matrix Y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the matrix Y begins.</param>
+        /// <param name="d">The array that receives the row-major matrix D.</param>
+        /// <param name="offd">The index in the <paramref name="d"/> at which the matrix D begins.</param>
+        /// <remarks>
+        /// The rows of the matrix Y are processed in blocks that fit into the cache.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void HammingDistances(int m, int n, int k, ulong[] x, int offx, ulong[] y, int offy, ulong[] d, int offd)
+        {
+            NativeMethods.hamming_distance_matrix_u64(m, n, k, x, offx, y, offy, d, offd);
+        }
+
         [SuppressUnmanagedCodeSecurity]
         private static class NativeMethods
         {
@@ -219,6 +331,31 @@ namespace Genix.Core
                 int n,
                 [In] float[] ab,
                 int offab);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void euclidean_distance_matrix_f32(
+                int m,
+                int n,
+                int k,
+                [In] float[] x,
+                int offx,
+                [In] float[] y,
+                int offy,
+                [Out] float[] dist,
+                int offdist,
+                [MarshalAs(UnmanagedType.Bool)] bool squared);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void manhattan_distance_matrix_f32(int m, int n, int k, [In] float[] x, int offx, [In] float[] y, int offy, [Out] float[] dist, int offdist);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void manhattan_distance_matrix_f64(int m, int n, int k, [In] double[] x, int offx, [In] double[] y, int offy, [Out] double[] dist, int offdist);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void hamming_distance_matrix_u32(int m, int n, int k, [In] uint[] x, int offx, [In] uint[] y, int offy, [Out] uint[] dist, int offdist);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void hamming_distance_matrix_u64(int m, int n, int k, [In] ulong[] x, int offx, [In] ulong[] y, int offy, [Out] ulong[] dist, int offdist);
         }
     }
 }
@@ -102,6 +102,21 @@ namespace Genix.Core
             NativeMethods.sigmoid(length, x, offx, y, offy);
         }
 
+        /// <summary>
+        /// Computes a sigmoid nonlinearity element wise on one array and puts results into another array.
+        /// Uses a polynomial approximation of the exponent that is faster than <see cref="Sigmoid(int, float[], int, float[], int)"/> and has maximum error of 3 ulp.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The array that contains data used for computation.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which computation begins.</param>
+        /// <param name="y">The array that receives the computed data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which computation begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void SigmoidFast(int length, float[] x, int offx, float[] y, int offy)
+        {
+            NativeMethods.sigmoid_fast(length, x, offx, y, offy);
+        }
+
         /// <summary>
         /// Computes a gradient of sigmoid nonlinearity element wise on one array and puts results into another array.
         /// </summary>
@@ -133,6 +148,36 @@ namespace Genix.Core
             NativeMethods._tanh(length, x, offx, y, offy);
         }
 
+        /// <summary>
+        /// Computes a hyperbolic tangent nonlinearity element wise on one array and puts results into another array.
+        /// Uses polynomial approximations that are faster than <see cref="Tanh(int, float[], int, float[], int)"/> and have maximum error of 2 ulp.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The array that contains data used for computation.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which computation begins.</param>
+        /// <param name="y">The array that receives the computed data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which computation begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TanhFast(int length, float[] x, int offx, float[] y, int offy)
+        {
+            NativeMethods.tanh_fast(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Computes an exponential of elements of one array and puts results into another array.
+        /// Uses a polynomial approximation that has maximum error of 2 ulp.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The array that contains data used for computation.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which computation begins.</param>
+        /// <param name="y">The array that receives the computed data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which computation begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void ExpFast(int length, float[] x, int offx, float[] y, int offy)
+        {
+            NativeMethods.exp_fast(length, x, offx, y, offy);
+        }
+
         /// <summary>
         /// Computes a hyperbolic tangent of the specified value.
         /// </summary>
@@ -231,6 +276,14 @@ namespace Genix.Core
                 [Out] float[] y,
                 int offy);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void sigmoid_fast(
+                int n,
+                [In] float[] x,
+                int offx,
+                [Out] float[] y,
+                int offy);
+
             [DllImport(NativeMethods.DllName)]
             public static extern void sigmoid_gradient2(
                 int n,
@@ -250,6 +303,22 @@ namespace Genix.Core
                 [Out] float[] y,
                 int offy);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void tanh_fast(
+                int n,
+                [In] float[] x,
+                int offx,
+                [Out] float[] y,
+                int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void exp_fast(
+                int n,
+                [In] float[] x,
+                int offx,
+                [Out] float[] y,
+                int offy);
+
             [DllImport(NativeMethods.DllName)]
             public static extern void tanh_gradient2(
                 int n,
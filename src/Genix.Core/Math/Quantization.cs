@@ -0,0 +1,264 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="Quantization.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.Core
+{
+    using System.Runtime.CompilerServices;
+    using System.Runtime.InteropServices;
+    using System.Security;
+
+    /// <summary>
+    /// Provides 8-bit quantization of single-precision floating point numbers and products of quantized matrices.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Activations are quantized to unsigned bytes with a scale and a zero point: x ~ scale * (q - zero).
+    /// </para>
+    /// <para>
+    /// Weights are quantized to signed bytes in [-127, 127] with a separate scale for every channel (neuron or filter): w ~ scale * q.
+    /// The sums of the quantized weights of every channel are kept with them to take the zero point of the activations out of the products.
+    /// </para>
+    /// </remarks>
+    public static class Quantization
+    {
+        /// <summary>
+        /// Quantizes values from one array starting at the specified index
+        /// and stores them in another array starting at the specified index.
+        /// The operation is defined as y := clamp(round(x / scale) + zero, 0, 255).
+        /// </summary>
+        /// <param name="length">The number of elements to quantize.</param>
+        /// <param name="x">The array that contains the source data.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which quantization begins.</param>
+        /// <param name="scale">The quantization step.</param>
+        /// <param name="zero">The quantized value that represents zero.</param>
+        /// <param name="y">The array that receives the quantized data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void Quantize(int length, float[] x, int offx, float scale, int zero, byte[] y, int offy)
+        {
+            NativeMethods.quantize_u8(length, x, offx, scale, zero, y, offy);
+        }
+
+        /// <summary>
+        /// Restores values from one array of quantized values starting at the specified index
+        /// and stores them in another array starting at the specified index.
+        /// The operation is defined as y := scale * (x - zero).
+        /// </summary>
+        /// <param name="length">The number of elements to restore.</param>
+        /// <param name="x">The array that contains the quantized data.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which restoring begins.</param>
+        /// <param name="scale">The quantization step.</param>
+        /// <param name="zero">The quantized value that represents zero.</param>
+        /// <param name="y">The array that receives the restored data.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void Dequantize(int length, byte[] x, int offx, float scale, int zero, float[] y, int offy)
+        {
+            NativeMethods.dequantize_u8(length, x, offx, scale, zero, y, offy);
+        }
+
+        /// <summary>
+        /// Quantizes the channels of a weight matrix symmetrically, one scale per channel.
+        /// </summary>
+        /// <param name="m">The number of channels.</param>
+        /// <param name="n">The number of weights in each channel.</param>
+        /// <param name="a">The array that contains the weights.</param>
+        /// <param name="offa">The index in the <paramref name="a"/> at which the weights begin.</param>
+        /// <param name="transa">
+        /// <b>false</b> if the channels are rows of a row-major m x n matrix (weight j of channel i is at i * n + j);
+        /// <b>true</b> if they are its columns (weight j of channel i is at j * m + i).
+        /// </param>
+        /// <param name="q">The array that receives the quantized weights, <paramref name="n"/> consecutive bytes per channel.</param>
+        /// <param name="offq">The index in the <paramref name="q"/> at which storing begins.</param>
+        /// <param name="scales">The array that receives the scales of the channels.</param>
+        /// <param name="offscales">The index in the <paramref name="scales"/> at which storing begins.</param>
+        /// <param name="sums">The array that receives the sums of the quantized weights of the channels.</param>
+        /// <param name="offsums">The index in the <paramref name="sums"/> at which storing begins.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void QuantizeChannels(
+            int m,
+            int n,
+            float[] a,
+            int offa,
+            bool transa,
+            sbyte[] q,
+            int offq,
+            float[] scales,
+            int offscales,
+            int[] sums,
+            int offsums)
+        {
+            NativeMethods.quantize_channels_s8(m, n, a, offa, transa, q, offq, scales, offscales, sums, offsums);
+        }
+
+        /// <summary>
+        /// Computes a product of quantized activations and quantized weights.
+        /// The operation is defined as c := ascale * bscales[j] * (A * B' - azero * bsums[j]) or as c += that depending on value of <paramref name="clearc"/> parameter.
+        /// </summary>
+        /// <param name="m">The number of rows in the matrices A and C.</param>
+        /// <param name="k">The number of columns in the matrices A and B.</param>
+        /// <param name="n">The number of rows in the matrix B and columns in the matrix C.</param>
+        /// <param name="a">The array that contains the row-major matrix A of quantized activations.</param>
+        /// <param name="offa">The index in the <paramref name="a"/> at which the matrix A begins.</param>
+        /// <param name="azero">The quantized value that represents zero in the matrix A.</param>
+        /// <param name="ascale">The quantization step of the matrix A.</param>
+        /// <param name="b">The array that contains the row-major matrix B of quantized weights, one row per channel.</param>
+        /// <param name="offb">The index in the <paramref name="b"/> at which the matrix B begins.</param>
+        /// <param name="bscales">The scales of the channels of the matrix B.</param>
+        /// <param name="bsums">The sums of the quantized weights of the channels of the matrix B.</param>
+        /// <param name="c">The array that receives the row-major matrix C.</param>
+        /// <param name="offc">The index in the <paramref name="c"/> at which the matrix C begins.</param>
+        /// <param name="clearc">Specifies whether the <paramref name="c"/> should be cleared before operation.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void MxM(
+            int m,
+            int k,
+            int n,
+            byte[] a,
+            int offa,
+            int azero,
+            float ascale,
+            sbyte[] b,
+            int offb,
+            float[] bscales,
+            int[] bsums,
+            float[] c,
+            int offc,
+            bool clearc)
+        {
+            NativeMethods.matrix_mm_u8s8(m, k, n, a, offa, azero, ascale, b, offb, bscales, bsums, c, offc, clearc);
+        }
+
+        /// <summary>
+        /// Returns the number of bytes in packed quantized weights.
+        /// </summary>
+        /// <param name="n">The number of channels.</param>
+        /// <param name="k">The number of weights in each channel.</param>
+        /// <returns>
+        /// The length of the array that <see cref="Pack"/> needs for the weights.
+        /// </returns>
+        /// <remarks>
+        /// The layout of the packed weights depends on the instruction set of the processor, so they should not be stored.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int PackedLength(int n, int k)
+        {
+            return NativeMethods.matrix_packsize_u8s8(n, k);
+        }
+
+        /// <summary>
+        /// Packs quantized weights for the product <see cref="MxV"/>.
+        /// </summary>
+        /// <param name="n">The number of channels.</param>
+        /// <param name="k">The number of weights in each channel.</param>
+        /// <param name="a">The array that contains the quantized weights, <paramref name="k"/> consecutive bytes per channel.</param>
+        /// <param name="offa">The index in the <paramref name="a"/> at which the weights begin.</param>
+        /// <param name="packed">The array that receives the packed weights, <see cref="PackedLength"/> elements.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void Pack(int n, int k, sbyte[] a, int offa, sbyte[] packed)
+        {
+            NativeMethods.matrix_pack_u8s8(n, k, a, offa, packed);
+        }
+
+        /// <summary>
+        /// Computes a product of packed quantized weights and a vector of quantized activations.
+        /// The operation is defined as y := xscale * scales[j] * (A * x - xzero * sums[j]) or as y += that depending on value of <paramref name="cleary"/> parameter.
+        /// </summary>
+        /// <param name="n">The number of channels in the matrix A.</param>
+        /// <param name="k">The number of weights in each channel and the number of elements in the vector x.</param>
+        /// <param name="a">The array that contains the matrix A of quantized weights packed by <see cref="Pack"/>.</param>
+        /// <param name="scales">The scales of the channels of the matrix A.</param>
+        /// <param name="sums">The sums of the quantized weights of the channels of the matrix A.</param>
+        /// <param name="x">The array that contains the vector x of quantized activations.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the vector x begins.</param>
+        /// <param name="xzero">The quantized value that represents zero in the vector x.</param>
+        /// <param name="xscale">The quantization step of the vector x.</param>
+        /// <param name="y">The array that receives the vector y.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the vector y begins.</param>
+        /// <param name="cleary">Specifies whether the <paramref name="y"/> should be cleared before operation.</param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void MxV(
+            int n,
+            int k,
+            sbyte[] a,
+            float[] scales,
+            int[] sums,
+            byte[] x,
+            int offx,
+            int xzero,
+            float xscale,
+            float[] y,
+            int offy,
+            bool cleary)
+        {
+            NativeMethods.matrix_mv_u8s8(n, k, a, scales, sums, x, offx, xzero, xscale, y, offy, cleary);
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.Core.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void quantize_u8(int n, [In] float[] x, int offx, float scale, int zero, [Out] byte[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void dequantize_u8(int n, [In] byte[] x, int offx, float scale, int zero, [Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void quantize_channels_s8(
+                int m,
+                int n,
+                [In] float[] a,
+                int offa,
+                [MarshalAs(UnmanagedType.Bool)] bool transa,
+                [Out] sbyte[] q,
+                int offq,
+                [Out] float[] scales,
+                int offscales,
+                [Out] int[] sums,
+                int offsums);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_mm_u8s8(
+                int m,
+                int k,
+                int n,
+                [In] byte[] a,
+                int offa,
+                int azero,
+                float ascale,
+                [In] sbyte[] b,
+                int offb,
+                [In] float[] bscales,
+                [In] int[] bsums,
+                [In, Out] float[] c,
+                int offc,
+                [MarshalAs(UnmanagedType.Bool)] bool clearc);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int matrix_packsize_u8s8(int n, int k);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_pack_u8s8(int n, int k, [In] sbyte[] a, int offa, [Out] sbyte[] packed);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void matrix_mv_u8s8(
+                int n,
+                int k,
+                [In] sbyte[] a,
+                [In] float[] scales,
+                [In] int[] sums,
+                [In] byte[] x,
+                int offx,
+                int xzero,
+                float xscale,
+                [In, Out] float[] y,
+                int offy,
+                [MarshalAs(UnmanagedType.Bool)] bool cleary);
+        }
+    }
+}
@@ -1427,6 +1427,74 @@ namespace Genix.Core
             NativeMethods.qsortv_s8(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, sbyte[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_s8(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 8-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, sbyte[] x, int offx, int k, sbyte[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_s8(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 8-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, sbyte[] x, int offx, int rowLength, int k, sbyte[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_s8(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 8-bit unsigned integers with the specified length and starting value.
         /// </summary>
@@ -2696,6 +2764,74 @@ namespace Genix.Core
             NativeMethods.qsortv_u8(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, byte[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_u8(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 8-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, byte[] x, int offx, int k, byte[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_u8(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 8-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, byte[] x, int offx, int rowLength, int k, byte[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_u8(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 16-bit signed integers with the specified length and starting value.
         /// </summary>
@@ -4093,6 +4229,74 @@ namespace Genix.Core
             NativeMethods.qsortv_s16(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, short[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_s16(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 16-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, short[] x, int offx, int k, short[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_s16(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 16-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, short[] x, int offx, int rowLength, int k, short[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_s16(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 16-bit unsigned integers with the specified length and starting value.
         /// </summary>
@@ -5362,6 +5566,74 @@ namespace Genix.Core
             NativeMethods.qsortv_u16(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, ushort[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_u16(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 16-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, ushort[] x, int offx, int k, ushort[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_u16(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 16-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, ushort[] x, int offx, int rowLength, int k, ushort[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_u16(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 32-bit signed integers with the specified length and starting value.
         /// </summary>
@@ -6759,6 +7031,74 @@ namespace Genix.Core
             NativeMethods.qsortv_s32(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, int[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_s32(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 32-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, int[] x, int offx, int k, int[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_s32(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 32-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, int[] x, int offx, int rowLength, int k, int[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_s32(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 32-bit unsigned integers with the specified length and starting value.
         /// </summary>
@@ -9081,6 +9421,74 @@ namespace Genix.Core
             NativeMethods.qsortv_u32(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, uint[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_u32(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 32-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, uint[] x, int offx, int k, uint[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_u32(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 32-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, uint[] x, int offx, int rowLength, int k, uint[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_u32(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 64-bit signed integers with the specified length and starting value.
         /// </summary>
@@ -10478,6 +10886,74 @@ namespace Genix.Core
             NativeMethods.qsortv_s64(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, long[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_s64(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 64-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, long[] x, int offx, int k, long[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_s64(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 64-bit signed integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, long[] x, int offx, int rowLength, int k, long[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_s64(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of 64-bit unsigned integers with the specified length and starting value.
         /// </summary>
@@ -12800,6 +13276,74 @@ namespace Genix.Core
             NativeMethods.qsortv_u64(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, ulong[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_u64(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of 64-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, ulong[] x, int offx, int k, ulong[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_u64(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of 64-bit unsigned integers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, ulong[] x, int offx, int rowLength, int k, ulong[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_u64(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of single-precision floating point numbers with the specified length and starting value.
         /// </summary>
@@ -14345,6 +14889,135 @@ namespace Genix.Core
             NativeMethods.softmax_batch_f32(length, x, 0, batchLength, y, 0);
         }
 
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of single-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, float[] y, int offy)
+        {
+            Debug.Assert(y.Length > offy + length - 1, "The destination array should be big enough.");
+            NativeMethods.logsoftmax_ip_f32(length, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of single-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, float* y)
+        {
+            NativeMethods.logsoftmax_ip_f32(length, y, 0);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of single-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="offx">The starting element position in <paramref name="x"/>.</param>
+        /// <param name="y">The destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// <para>The method performs operation defined as <c>y = log(softmax(x))</c>.</para>
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, float[] x, int offx, float[] y, int offy)
+        {
+            Debug.Assert(x.Length > offx + length - 1, "The source array should be big enough.");
+            Debug.Assert(y.Length > offy + length - 1, "The destination array should be big enough.");
+            NativeMethods.logsoftmax_f32(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of single-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="y">The destination array.</param>
+        /// <remarks>
+        /// <para>The method performs operation defined as <c>y = log(softmax(x))</c>.</para>
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, float* x, float* y)
+        {
+            NativeMethods.logsoftmax_f32(length, x, 0, y, 0);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of single-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, int batchLength, float[] y, int offy)
+        {
+            NativeMethods.logsoftmax_batch_ip_f32(length, batchLength, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of single-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, int batchLength, float* y)
+        {
+            NativeMethods.logsoftmax_batch_ip_f32(length, batchLength, y, 0);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of single-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="offx">The starting element position in <paramref name="x"/>.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(x))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, float[] x, int offx, int batchLength, float[] y, int offy)
+        {
+            NativeMethods.logsoftmax_batch_f32(length, x, offx, batchLength, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of single-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The destination array.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(x))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, float* x, int batchLength, float* y)
+        {
+            NativeMethods.logsoftmax_batch_f32(length, x, 0, batchLength, y, 0);
+        }
+
         /// <summary>
         /// Computes the sum of all elements in the array of single-precision floating point numbers.
         /// </summary>
@@ -14774,6 +15447,74 @@ namespace Genix.Core
             NativeMethods.qsortv_f32(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, float[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_f32(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of single-precision floating point numbers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, float[] x, int offx, int k, float[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_f32(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of single-precision floating point numbers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, float[] x, int offx, int rowLength, int k, float[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_f32(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         /// <summary>
         /// Creates an array of double-precision floating point numbers with the specified length and starting value.
         /// </summary>
@@ -16319,6 +17060,135 @@ namespace Genix.Core
             NativeMethods.softmax_batch_f64(length, x, 0, batchLength, y, 0);
         }
 
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of double-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, double[] y, int offy)
+        {
+            Debug.Assert(y.Length > offy + length - 1, "The destination array should be big enough.");
+            NativeMethods.logsoftmax_ip_f64(length, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of double-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, double* y)
+        {
+            NativeMethods.logsoftmax_ip_f64(length, y, 0);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of double-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="offx">The starting element position in <paramref name="x"/>.</param>
+        /// <param name="y">The destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// <para>The method performs operation defined as <c>y = log(softmax(x))</c>.</para>
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, double[] x, int offx, double[] y, int offy)
+        {
+            Debug.Assert(x.Length > offx + length - 1, "The source array should be big enough.");
+            Debug.Assert(y.Length > offy + length - 1, "The destination array should be big enough.");
+            NativeMethods.logsoftmax_f64(length, x, offx, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of array of double-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="y">The destination array.</param>
+        /// <remarks>
+        /// <para>The method performs operation defined as <c>y = log(softmax(x))</c>.</para>
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, double* x, double* y)
+        {
+            NativeMethods.logsoftmax_f64(length, x, 0, y, 0);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of double-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, int batchLength, double[] y, int offy)
+        {
+            NativeMethods.logsoftmax_batch_ip_f64(length, batchLength, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of double-precision floating point numbers in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The source and destination array.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(y))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, int batchLength, double* y)
+        {
+            NativeMethods.logsoftmax_batch_ip_f64(length, batchLength, y, 0);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of double-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="offx">The starting element position in <paramref name="x"/>.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The destination array.</param>
+        /// <param name="offy">The starting element position in <paramref name="y"/>.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(x))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void LogSoftMax(int length, double[] x, int offx, int batchLength, double[] y, int offy)
+        {
+            NativeMethods.logsoftmax_batch_f64(length, x, offx, batchLength, y, offy);
+        }
+
+        /// <summary>
+        /// Computes logarithms of softmax probabilities for values of batch array of double-precision floating point numbers not-in-place.
+        /// </summary>
+        /// <param name="length">The number of elements to compute.</param>
+        /// <param name="x">The source array.</param>
+        /// <param name="batchLength">The length of a batch in the source array.</param>
+        /// <param name="y">The destination array.</param>
+        /// <remarks>
+        /// The method performs operation defined as <c>y = log(softmax(x))</c>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe void LogSoftMax(int length, double* x, int batchLength, double* y)
+        {
+            NativeMethods.logsoftmax_batch_f64(length, x, 0, batchLength, y, 0);
+        }
+
         /// <summary>
         /// Computes the sum of all elements in the array of double-precision floating point numbers.
         /// </summary>
@@ -16748,6 +17618,74 @@ namespace Genix.Core
             NativeMethods.qsortv_f64(length, x, offx, y, offy, ascending);
         }
 
+        /// <summary>
+        /// Rearranges the elements in a range of elements in a pair of arrays
+        /// (one contains the keys and the other contains the corresponding items),
+        /// so the first <paramref name="k"/> keys are the smallest or the largest keys in sorted order.
+        /// </summary>
+        /// <param name="length">The number of elements in the range to sort.</param>
+        /// <param name="x">The array that contains the keys to sort.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which sorting begins.</param>
+        /// <param name="y">The array that contains the items that correspond to each of the keys in the <paramref name="x"/>.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which sorting begins.</param>
+        /// <param name="k">The number of keys to sort.</param>
+        /// <param name="ascending"><b>true</b> to use ascending sorting order; <b>false</b> to use descending sorting order.</param>
+        /// <remarks>
+        /// The order of the remaining keys is not defined.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void PartialSort(int length, double[] x, int offx, int[] y, int offy, int k, bool ascending)
+        {
+            NativeMethods.partial_sortv_f64(length, x, offx, y, offy, k, ascending);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in a range of elements in an array of double-precision floating point numbers.
+        /// </summary>
+        /// <param name="length">The number of elements to search.</param>
+        /// <param name="x">The array that contains the elements to search.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the search begins.</param>
+        /// <param name="k">The number of elements to find.</param>
+        /// <param name="y">The array that receives the elements found, the best element first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found, relative to <paramref name="offx"/>.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <returns>
+        /// The number of elements found, the smaller of <paramref name="length"/> and <paramref name="k"/>.
+        /// </returns>
+        /// <remarks>
+        /// Of the equal elements the ones that come first are found first.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static int TopK(int length, double[] x, int offx, int k, double[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            return NativeMethods.topk_f64(length, x, offx, k, y, offy, indices, offindices, largest);
+        }
+
+        /// <summary>
+        /// Finds the largest or the smallest elements in each row of a matrix of double-precision floating point numbers.
+        /// </summary>
+        /// <param name="length">The number of elements in the matrix.</param>
+        /// <param name="x">The array that contains the matrix.</param>
+        /// <param name="offx">The index in the <paramref name="x"/> at which the matrix begins.</param>
+        /// <param name="rowLength">The number of elements in each row.</param>
+        /// <param name="k">The number of elements to find in each row.</param>
+        /// <param name="y">The array that receives the elements found, the best element of each row first.</param>
+        /// <param name="offy">The index in the <paramref name="y"/> at which the elements are written.</param>
+        /// <param name="indices">The array that receives the positions of the elements found in their rows.</param>
+        /// <param name="offindices">The index in the <paramref name="indices"/> at which the positions are written.</param>
+        /// <param name="largest"><b>true</b> to find the largest elements; <b>false</b> to find the smallest elements.</param>
+        /// <remarks>
+        /// The rows are processed in parallel. The results of each row take the smaller of <paramref name="rowLength"/> and <paramref name="k"/> elements
+        /// of <paramref name="y"/> and <paramref name="indices"/>.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void TopK(int length, double[] x, int offx, int rowLength, int k, double[] y, int offy, int[] indices, int offindices, bool largest)
+        {
+            NativeMethods.topk_batch_f64(length, x, offx, rowLength, k, y, offy, indices, offindices, largest);
+        }
+
         [SuppressUnmanagedCodeSecurity]
         private static class NativeMethods
         {
@@ -16988,6 +17926,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_s8(
+                int n,
+                [In, Out] sbyte[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_s8(
+                int n,
+                [In] sbyte[] x,
+                int offx,
+                int k,
+                [Out] sbyte[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_s8(
+                int n,
+                [In] sbyte[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] sbyte[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_u8(int n, [In] byte[] x, int offx, [Out] byte[] y, int offy);
 
@@ -17199,6 +18172,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_u8(
+                int n,
+                [In, Out] byte[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_u8(
+                int n,
+                [In] byte[] x,
+                int offx,
+                int k,
+                [Out] byte[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_u8(
+                int n,
+                [In] byte[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] byte[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_s16(int n, [In] short[] x, int offx, [Out] short[] y, int offy);
 
@@ -17434,6 +18442,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_s16(
+                int n,
+                [In, Out] short[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_s16(
+                int n,
+                [In] short[] x,
+                int offx,
+                int k,
+                [Out] short[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_s16(
+                int n,
+                [In] short[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] short[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_u16(int n, [In] ushort[] x, int offx, [Out] ushort[] y, int offy);
 
@@ -17645,6 +18688,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_u16(
+                int n,
+                [In, Out] ushort[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_u16(
+                int n,
+                [In] ushort[] x,
+                int offx,
+                int k,
+                [Out] ushort[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_u16(
+                int n,
+                [In] ushort[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] ushort[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_s32(int n, [In] int[] x, int offx, [Out] int[] y, int offy);
 
@@ -17880,6 +18958,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_s32(
+                int n,
+                [In, Out] int[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_s32(
+                int n,
+                [In] int[] x,
+                int offx,
+                int k,
+                [Out] int[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_s32(
+                int n,
+                [In] int[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] int[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_u32(int n, [In] uint[] x, int offx, [Out] uint[] y, int offy);
 
@@ -18276,6 +19389,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_u32(
+                int n,
+                [In, Out] uint[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_u32(
+                int n,
+                [In] uint[] x,
+                int offx,
+                int k,
+                [Out] uint[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_u32(
+                int n,
+                [In] uint[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] uint[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_s64(int n, [In] long[] x, int offx, [Out] long[] y, int offy);
 
@@ -18511,6 +19659,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_s64(
+                int n,
+                [In, Out] long[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_s64(
+                int n,
+                [In] long[] x,
+                int offx,
+                int k,
+                [Out] long[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_s64(
+                int n,
+                [In] long[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] long[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_u64(int n, [In] ulong[] x, int offx, [Out] ulong[] y, int offy);
 
@@ -18907,6 +20090,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_u64(
+                int n,
+                [In, Out] ulong[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_u64(
+                int n,
+                [In] ulong[] x,
+                int offx,
+                int k,
+                [Out] ulong[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_u64(
+                int n,
+                [In] ulong[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] ulong[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_f32(int n, [In] float[] x, int offx, [Out] float[] y, int offy);
 
@@ -19192,6 +20410,30 @@ namespace Genix.Core
 
             [DllImport(NativeMethods.DllName)]
             public static extern unsafe void softmax_batch_f32(int n, [In] float* x, int offx, int batchLength, [Out] float* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_ip_f32(int n, [In, Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_ip_f32(int n, [In, Out] float* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_f32(int n, [In] float[] x, int offx, [Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_f32(int n, [In] float* x, int offx, [Out] float* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_batch_ip_f32(int n, int batchLength, [In, Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_batch_ip_f32(int n, int batchLength, [In, Out] float* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_batch_f32(int n, [In] float[] x, int offx, int batchLength, [Out] float[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_batch_f32(int n, [In] float* x, int offx, int batchLength, [Out] float* y, int offy);
             [DllImport(NativeMethods.DllName)]
             public static extern float sum_ip_f32(int n, [In] float[] x, int offx);
 
@@ -19267,6 +20509,41 @@ namespace Genix.Core
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_f32(
+                int n,
+                [In, Out] float[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_f32(
+                int n,
+                [In] float[] x,
+                int offx,
+                int k,
+                [Out] float[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_f32(
+                int n,
+                [In] float[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] float[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
             [DllImport(NativeMethods.DllName)]
             public static extern int compare_f64(int n, [In] double[] x, int offx, [Out] double[] y, int offy);
 
@@ -19552,6 +20829,30 @@ namespace Genix.Core
 
             [DllImport(NativeMethods.DllName)]
             public static extern unsafe void softmax_batch_f64(int n, [In] double* x, int offx, int batchLength, [Out] double* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_ip_f64(int n, [In, Out] double[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_ip_f64(int n, [In, Out] double* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_f64(int n, [In] double[] x, int offx, [Out] double[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_f64(int n, [In] double* x, int offx, [Out] double* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_batch_ip_f64(int n, int batchLength, [In, Out] double[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_batch_ip_f64(int n, int batchLength, [In, Out] double* y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void logsoftmax_batch_f64(int n, [In] double[] x, int offx, int batchLength, [Out] double[] y, int offy);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern unsafe void logsoftmax_batch_f64(int n, [In] double* x, int offx, int batchLength, [Out] double* y, int offy);
             [DllImport(NativeMethods.DllName)]
             public static extern double sum_ip_f64(int n, [In] double[] x, int offx);
 
@@ -19626,6 +20927,41 @@ namespace Genix.Core
                 [In, Out] int[] y,
                 int offy,
                 [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void partial_sortv_f64(
+                int n,
+                [In, Out] double[] x,
+                int offx,
+                [In, Out] int[] y,
+                int offy,
+                int k,
+                [MarshalAs(UnmanagedType.Bool)] bool ascending);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int topk_f64(
+                int n,
+                [In] double[] x,
+                int offx,
+                int k,
+                [Out] double[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void topk_batch_f64(
+                int n,
+                [In] double[] x,
+                int offx,
+                int rowlen,
+                int k,
+                [Out] double[] y,
+                int offy,
+                [Out] int[] indices,
+                int offindices,
+                [MarshalAs(UnmanagedType.Bool)] bool largest);
         }
     }
 }
@@ -0,0 +1,54 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="NativeThreadPool.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.Core
+{
+    using System;
+    using System.Runtime.InteropServices;
+    using System.Security;
+
+    /// <summary>
+    /// Controls the thread pool used by the native libraries.
+    /// </summary>
+    public static class NativeThreadPool
+    {
+        /// <summary>
+        /// Gets or sets the number of threads the native libraries use to run parallel operations.
+        /// </summary>
+        /// <value>
+        /// The number of threads, including the calling thread. Set to zero to use all logical processors.
+        /// </value>
+        /// <remarks>
+        /// Do not change the number of threads while native operations are running.
+        /// </remarks>
+        public static int ThreadCount
+        {
+            get => NativeMethods.threadpool_get_threads();
+
+            set
+            {
+                if (value < 0)
+                {
+                    throw new ArgumentOutOfRangeException(nameof(value));
+                }
+
+                NativeMethods.threadpool_set_threads(value);
+            }
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.Core.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern int threadpool_get_threads();
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void threadpool_set_threads(int count);
+        }
+    }
+}
@@ -1,10 +1,13 @@
 #include "stdafx.h"
+#include "scratch.h"
+#include "simdkernels.h"
+#include "threadpool.h"
 
 #include <stdlib.h> 
 #include <math.h> 
-#include <numeric>
+#include <algorithm>
 
-extern "C" __declspec(dllexport) float __forceinline WINAPI logSumExp2(
+GENIXAPI(float, logSumExp2)(
 	const float a,
 	const float b)
 {
@@ -21,7 +24,7 @@ extern "C" __declspec(dllexport) float __forceinline WINAPI logSumExp2(
 	return ::log1pf(::expf(-::abs(a - b))) + __max(a, b);
 }
 
-extern "C" __declspec(dllexport) float __forceinline WINAPI logSumExp3(
+GENIXAPI(float, logSumExp3)(
 	const float a,
 	const float b,
 	const float c)
@@ -55,138 +58,196 @@ extern "C" __declspec(dllexport) float __forceinline WINAPI logSumExp3(
 	}
 }
 
-GENIXAPI(void, CTCComputeAlphas)(
+// Computes CTC loss and, if dy is not NULL, its gradient for one sequence of T probability vectors of size A.
+// The recursions over the label positions are vectorized, see SIMDKernels::ctc_step.
+// Betas are computed on the reversed label sequence, so they use the same kernel as alphas,
+// and each row of betas is reduced into the gradient as soon as it is computed.
+static float __ctc_loss(
 	int T,
 	int A,
-	int S,
-	const float* py,
+	const float* y,
+	int L,
 	const int* labels,
-	float* pa)
+	int blank,
+	float* dy)
 {
-	std::fill(pa, pa + (ptrdiff_t(S) * T), -INFINITY);
+	const SIMDKernels& kernels = SIMDKernels::Current();
 
-	int start = __max(0, S - (2 * T));
-	int end = __min(2, S);
+	// not enough elements to compute
+	int repeats = 0;
+	for (int i = 1; i < L; i++)
+	{
+		if (labels[i] == labels[i - 1])
+		{
+			repeats++;
+		}
+	}
 
-	for (int i = start; i < end; i++)
+	if (T == 0 || L + repeats > T)
 	{
-		pa[i] = py[labels[i]];
+		if (dy != NULL)
+		{
+			::memcpy(dy, y, sizeof(float) * A * T);
+		}
+
+		return INFINITY;
 	}
 
-	const float* paprev = pa;
-	pa += S;
-	py += A;
+	const int S = (2 * L) + 1;		// number of labels with blanks
+	const int W = S + 2;			// row of alphas or betas, with two -inf elements in front
 
-	for (int t = 1; t < T; t++, pa += S, paprev += S, py += A)
+	scratch_buffer<int> extbuffer(S);
+	int* ext = extbuffer.data();
+	for (int i = 0; i < L; i++)
 	{
-		start = __max(0, S - (2 * (T - t)));
-		end = __min(2 * (t + 1), S);
+		ext[2 * i] = blank;
+		ext[(2 * i) + 1] = labels[i];
+	}
 
-		int i = start;
+	ext[S - 1] = blank;
 
-		if (i == 0)
-		{
-			pa[0] = paprev[0] + py[labels[0]];
-			i++;
-		}
+	scratch_buffer<float> buffer((2 * S) + (ptrdiff_t(T) * S) + (ptrdiff_t(T) * W) + (2 * W) + (2 * S));
+	float* skip = buffer.data();						// transitions from i - 2 to i, in forward order
+	float* skipr = skip + S;					// the same, in reversed order
+	float* emit = skipr + S;					// log(y) for each time and label
+	float* alphas = emit + (ptrdiff_t(T) * S);
+	float* betas = alphas + (ptrdiff_t(T) * W);	// two rows, reversed order
+	float* emitr = betas + (2 * W);
+	float* post = emitr + S;
 
-		if (i == 1)
-		{
-			pa[1] = logSumExp2(paprev[1], paprev[0]) + py[labels[1]];
-			i++;
-		}
+	for (int i = 0; i < S; i++)
+	{
+		const bool label = (i % 2) != 0 && i >= 2;
+		skip[i] = label && ext[i] != ext[i - 2] ? 0.0f : -INFINITY;
+		skipr[i] = label && ext[S - 1 - i] != ext[S + 1 - i] ? 0.0f : -INFINITY;
+	}
 
-		for (; i < end; i++)
+	for (int t = 0; t < T; t++)
+	{
+		const float* yt = y + (ptrdiff_t(t) * A);
+		float* emitt = emit + (ptrdiff_t(t) * S);
+		for (int i = 0; i < S; i++)
 		{
-			if ((i % 2) != 0 && labels[i] != labels[i - 2])
-			{
-				pa[i] = logSumExp3(paprev[i], paprev[i - 1], paprev[i - 2]) + py[labels[i]];
-			}
-			else
-			{
-				pa[i] = logSumExp2(paprev[i], paprev[i - 1]) + py[labels[i]];
-			}
+			emitt[i] = yt[ext[i]];
 		}
 	}
-}
-
-GENIXAPI(void, CTCComputeBetas)(
-	int T,
-	int A,
-	int S,
-	const float* py,
-	const int* labels,
-	float* pb)
-{
-	std::fill(pb, pb + (ptrdiff_t(S) * T), -INFINITY);
 
-	int start = __max(0, S - 2);
-	int end = __min(2 * T, S);
+	kernels.log_fast(T * S, emit, emit);
 
-	pb += ptrdiff_t(S) * (ptrdiff_t(T) - 1);
-	py += ptrdiff_t(A) * (ptrdiff_t(T) - 1);
+	// alphas
+	std::fill(alphas, alphas + (ptrdiff_t(T) * W), -INFINITY);
 
-	for (int i = start; i < end; i++)
+	float* pa = alphas + 2;
+	pa[0] = emit[0];
+	if (S > 1)
 	{
-		pb[i] = py[labels[i]];
+		pa[1] = emit[1];
 	}
 
-	const float* pbnext = pb;
-	pb -= S;
-	py -= A;
-
-	for (int t = T - 2; t >= 0; t--, pb -= S, pbnext -= S, py -= A)
+	for (int t = 1; t < T; t++, pa += W)
 	{
-		start = __max(0, S - (2 * (T - t)));
-		end = __min(2 * (t + 1), S);
-
-		int i = end - 1;
+		kernels.ctc_step(__min(2 * (t + 1), S), pa, skip, emit + (ptrdiff_t(t) * S), pa + W);
+	}
 
-		if (i == S - 1)
+	const float logLoss = S > 1 ? logSumExp2(pa[S - 1], pa[S - 2]) : pa[0];
+	if (logLoss == -INFINITY)
+	{
+		if (dy != NULL)
 		{
-			pb[i] = pbnext[i] + py[labels[i]];
-			i--;
+			::memcpy(dy, y, sizeof(float) * A * T);
 		}
+	}
+	else if (dy != NULL)
+	{
+		// betas, reduced into the gradient
+		// dy(t, a) = sum(alpha(t, i) * beta(t, i)) / (y(t, a) * loss) over all i where label is a
+		std::fill(betas, betas + (2 * W), -INFINITY);
+		std::fill(dy, dy + (ptrdiff_t(T) * A), 0.0f);
 
-		if (i == S - 2)
+		float* pb = betas + 2;
+		float* pbnext = pb + W;
+
+		const float* emitt = emit + (ptrdiff_t(T - 1) * S);
+		pb[0] = emitt[S - 1];
+		if (S > 1)
 		{
-			pb[i] = logSumExp2(pbnext[i], pbnext[i + 1]) + py[labels[i]];
-			i--;
+			pb[1] = emitt[S - 2];
 		}
 
-		for (; i >= start; i--)
+		for (int t = T - 1; t >= 0; t--)
 		{
-			if ((i % 2) != 0 && labels[i] != labels[i + 2])
+			if (t < T - 1)
+			{
+				std::swap(pb, pbnext);
+
+				for (int i = 0; i < S; i++)
+				{
+					emitr[i] = emitt[S - 1 - i];
+				}
+
+				kernels.ctc_step(__min(2 * (T - t), S), pbnext, skipr, emitr, pb);
+			}
+
+			const float* pat = alphas + (ptrdiff_t(t) * W) + 2;
+			for (int i = 0; i < S; i++)
 			{
-				pb[i] = logSumExp3(pbnext[i], pbnext[i + 1], pbnext[i + 2]) + py[labels[i]];
+				post[i] = pat[i] + pb[S - 1 - i] - emitt[i] - logLoss;
 			}
-			else
+
+			kernels.exp_fast(S, post, post);
+
+			// NaN may come from log(y) where y = 0
+			float* dyt = dy + (ptrdiff_t(t) * A);
+			for (int i = 0; i < S; i++)
 			{
-				pb[i] = logSumExp2(pbnext[i], pbnext[i + 1]) + py[labels[i]];
+				if (post[i] == post[i])
+				{
+					dyt[ext[i]] += post[i];
+				}
 			}
+
+			emitt -= S;
 		}
 	}
+
+	return logLoss == -INFINITY ? INFINITY : -logLoss;
 }
 
-GENIXAPI(void, CTCReduceAlphasBetas)(
+// Computes CTC loss for a padded batch of N sequences and, if dy is not NULL, its gradient.
+// y and dy are N sequences of T probability vectors of size A, sequence n uses first lengths[n] vectors;
+// the gradient in the rest of the vectors is zero.
+// labels are N sequences of L labels without blanks, sequence n uses first labelLengths[n] labels.
+// The sequences are processed in parallel.
+GENIXAPI(void, CTCLossBatch)(
+	int N,
 	int T,
 	int A,
-	int S,
-	const float* pab,
+	const float* y,
+	const int* lengths,
+	int L,
 	const int* labels,
-	float* pdy)
+	const int* labelLengths,
+	int blank,
+	float* losses,
+	float* dy)
 {
-	std::fill(pdy, pdy + (ptrdiff_t(A) * T), -INFINITY);
-
-	for (int t = 0; t < T; t++, pab += S, pdy += A)
+	parallel_for(0, N, [&](int n)
 	{
-		const int start = __max(0, S - (2 * (T - t)));
-		const int end = __min(2 * (t + 1), S);
-
-		for (int i = start; i < end; i++)
+		const ptrdiff_t offy = ptrdiff_t(n) * T * A;
+		const int Tn = lengths[n];
+
+		losses[n] = __ctc_loss(
+			Tn,
+			A,
+			y + offy,
+			labelLengths[n],
+			labels + (ptrdiff_t(n) * L),
+			blank,
+			dy != NULL ? dy + offy : NULL);
+
+		if (dy != NULL)
 		{
-			const int li = labels[i];
-			pdy[li] = logSumExp2(pdy[li], pab[i]);
+			std::fill(dy + offy + (ptrdiff_t(Tn) * A), dy + offy + (ptrdiff_t(T) * A), 0.0f);
 		}
-	}
+	});
 }
@@ -0,0 +1,454 @@
+#include "stdafx.h"
+#include "simdkernels.h"
+#include "threadpool.h"
+
+#include <math.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// Language model that scores the hypotheses of CTCBeamSearch.
+// The states are integers chosen by the model, the decoder only passes them back.
+// The decoder asks about every state once per call and never calls the model from two threads at once.
+struct ctc_language_model
+{
+	void* context;
+	int initialState;
+
+	// Writes up to capacity continuations of the state and returns their total number.
+	// A continuation is a class (negative for the characters missing from the alphabet),
+	// the log probability of appending it to the hypothesis and the state that follows.
+	int (WINAPI *expand)(void* context, int state, int capacity, int* labels, float* scores, int* nextStates);
+
+	// Returns the log probability of a word that ends in the state, or -inf if the state does not end a word.
+	float (WINAPI *final)(void* context, int state);
+};
+
+namespace
+{
+	__forceinline float __logsumexp(float a, float b)
+	{
+		if (a == -INFINITY)
+		{
+			return b;
+		}
+
+		if (b == -INFINITY)
+		{
+			return a;
+		}
+
+		return a >= b ? a + ::log1pf(::expf(b - a)) : b + ::log1pf(::expf(a - b));
+	}
+
+	// A node of the prefix trie; every hypothesis is a path from the root.
+	struct ctc_node
+	{
+		int parent;
+		int label;
+		int length;
+		int child;			// first child
+		int sibling;		// next child of the parent
+		int state;			// language model state
+		int stamp;			// the last step the node was added to the beam at
+		int slot;			// position in the beam at step stamp
+	};
+
+	// A hypothesis in the beam: the probabilities of its prefix ending with blank and with non-blank class.
+	struct ctc_beam
+	{
+		int node;
+		float pb;
+		float pnb;
+		float p;
+	};
+
+	// The continuations of the language model states and the scores of the words that end in them,
+	// shared by all the lines of one call. The threads look the states up concurrently,
+	// a state missing from the cache is asked from the model under the exclusive lock.
+	class ctc_lm_cache
+	{
+	public:
+		// see ctc_language_model::expand and ctc_language_model::final
+		struct entry
+		{
+			std::vector<int> labels;
+			std::vector<float> scores;
+			std::vector<int> states;
+			float final;
+		};
+
+		explicit ctc_lm_cache(const ctc_language_model* lm) : lm(lm)
+		{
+		}
+
+		int initialState() const
+		{
+			return this->lm->initialState;
+		}
+
+		// the entries are never removed, so the reference stays valid until the end of the call
+		const entry& find(int state)
+		{
+			{
+				std::shared_lock<std::shared_timed_mutex> guard(this->mutex);
+
+				auto it = this->entries.find(state);
+				if (it != this->entries.end())
+				{
+					return it->second;
+				}
+			}
+
+			std::unique_lock<std::shared_timed_mutex> guard(this->mutex);
+
+			auto result = this->entries.emplace(state, entry());
+			entry& e = result.first->second;
+			if (result.second)
+			{
+				int capacity = 64;
+				for (;;)
+				{
+					e.labels.resize(capacity);
+					e.scores.resize(capacity);
+					e.states.resize(capacity);
+
+					const int count = this->lm->expand(
+						this->lm->context,
+						state,
+						capacity,
+						e.labels.data(),
+						e.scores.data(),
+						e.states.data());
+
+					if (count <= capacity)
+					{
+						capacity = count;
+						break;
+					}
+
+					capacity = count;
+				}
+
+				e.labels.resize(capacity);
+				e.scores.resize(capacity);
+				e.states.resize(capacity);
+
+				e.final = this->lm->final(this->lm->context, state);
+			}
+
+			return e;
+		}
+
+	private:
+		const ctc_language_model* lm;
+		std::shared_timed_mutex mutex;
+		std::unordered_map<int, entry> entries;
+	};
+
+	// Decodes one line at a time. The trie and the beams are kept between the lines decoded
+	// by the same thread, so the memory is allocated only when a line needs more of it than the previous ones.
+	class ctc_decoder
+	{
+	public:
+		void decode(
+			int T,
+			int A,
+			const float* y,
+			int blank,
+			int space,
+			int beamWidth,
+			int topk,
+			ctc_lm_cache* lm,
+			float missingLogProb,
+			int resultCount,
+			int* results,
+			int resultStride,
+			int* resultLengths,
+			float* scores)
+		{
+			this->nodes.clear();
+			this->expansions.clear();
+
+			// convert predicted probabilities into log space
+			this->ylog.resize(size_t(T) * A);
+			if (T > 0)
+			{
+				SIMDKernels::Current().log_fast(T * A, y, this->ylog.data());
+			}
+
+			this->classes.resize(A);
+			topk = lm == NULL ? __max(1, __min(topk, A)) : 0;
+
+			this->nodes.push_back({ -1, -1, 0, -1, -1, lm != NULL ? lm->initialState() : 0, -1, 0 });
+			this->beam.assign(1, { 0, 0.0f, -INFINITY, 0.0f });
+
+			for (int t = 0; t < T; t++)
+			{
+				const float* yt = this->ylog.data() + (ptrdiff_t(t) * A);
+				this->next.clear();
+
+				// classes with the highest probabilities at this step
+				if (lm == NULL)
+				{
+					for (int i = 0; i < A; i++)
+					{
+						this->classes[i] = i;
+					}
+
+					std::partial_sort(
+						this->classes.begin(),
+						this->classes.begin() + topk,
+						this->classes.end(),
+						[yt](int a, int b) { return yt[a] > yt[b]; });
+				}
+
+				for (size_t b = 0, bb = this->beam.size(); b < bb; b++)
+				{
+					const ctc_beam beam = this->beam[b];
+					const int node = beam.node;
+					const int length = this->nodes[node].length;
+					const int last = this->nodes[node].label;
+
+					// the same prefix followed by blank or by its last class repeated
+					this->add(t, node, beam.p + yt[blank], -INFINITY);
+					if (length > 0)
+					{
+						this->add(t, node, -INFINITY, beam.pnb + (last >= 0 ? yt[last] : missingLogProb));
+					}
+
+					// the prefix extended by one class
+					if (lm == NULL)
+					{
+						for (int i = 0; i < topk; i++)
+						{
+							this->extend(t, beam, this->classes[i], yt[this->classes[i]], 0.0f, 0, blank, space);
+						}
+					}
+					else
+					{
+						const ctc_lm_cache::entry& e = this->expand(lm, this->nodes[node].state);
+
+						for (size_t i = 0, ii = e.labels.size(); i < ii; i++)
+						{
+							const int label = e.labels[i];
+							this->extend(
+								t,
+								beam,
+								label,
+								label >= 0 ? yt[label] : missingLogProb,
+								e.scores[i],
+								e.states[i],
+								blank,
+								space);
+						}
+					}
+				}
+
+				// keep the best hypotheses
+				if (int(this->next.size()) > beamWidth)
+				{
+					std::nth_element(
+						this->next.begin(),
+						this->next.begin() + beamWidth,
+						this->next.end(),
+						[](const ctc_beam& a, const ctc_beam& b) { return a.p > b.p; });
+
+					this->next.resize(beamWidth);
+				}
+
+				std::swap(this->beam, this->next);
+			}
+
+			// score the hypotheses that end a word
+			if (lm != NULL)
+			{
+				for (ctc_beam& beam : this->beam)
+				{
+					beam.p += this->expand(lm, this->nodes[beam.node].state).final;
+				}
+			}
+
+			std::sort(
+				this->beam.begin(),
+				this->beam.end(),
+				[](const ctc_beam& a, const ctc_beam& b) { return a.p > b.p; });
+
+			int count = 0;
+			for (size_t b = 0; b < this->beam.size() && count < resultCount; b++)
+			{
+				const ctc_beam& beam = this->beam[b];
+				if (beam.p == -INFINITY)
+				{
+					break;
+				}
+
+				int* result = results + (ptrdiff_t(count) * resultStride);
+				const int length = this->nodes[beam.node].length;
+				for (int node = beam.node; node > 0; node = this->nodes[node].parent)
+				{
+					result[this->nodes[node].length - 1] = this->nodes[node].label;
+				}
+
+				resultLengths[count] = length;
+				scores[count] = beam.p;
+				count++;
+			}
+
+			for (; count < resultCount; count++)
+			{
+				resultLengths[count] = 0;
+				scores[count] = -INFINITY;
+			}
+		}
+
+	private:
+		std::vector<ctc_node> nodes;
+		std::vector<ctc_beam> beam;
+		std::vector<ctc_beam> next;
+		std::vector<float> ylog;
+		std::vector<int> classes;
+
+		// the language model states this line has already looked up in the shared cache
+		std::unordered_map<int, const ctc_lm_cache::entry*> expansions;
+
+		// adds the prefix to the beam of step t, or merges it with the one already there
+		__forceinline void add(int t, int node, float pb, float pnb)
+		{
+			ctc_node& n = this->nodes[node];
+			if (n.stamp == t)
+			{
+				ctc_beam& beam = this->next[n.slot];
+				beam.pb = __logsumexp(beam.pb, pb);
+				beam.pnb = __logsumexp(beam.pnb, pnb);
+				beam.p = __logsumexp(beam.pb, beam.pnb);
+			}
+			else
+			{
+				n.stamp = t;
+				n.slot = int(this->next.size());
+				this->next.push_back({ node, pb, pnb, __logsumexp(pb, pnb) });
+			}
+		}
+
+		__forceinline void extend(int t, const ctc_beam& beam, int label, float emission, float lmScore, int state, int blank, int space)
+		{
+			if (label == blank)
+			{
+				return;
+			}
+
+			const ctc_node& parent = this->nodes[beam.node];
+
+			// do not start with spaces and do not repeat them
+			if (label == space && (parent.length == 0 || parent.label == space))
+			{
+				return;
+			}
+
+			// the same class can follow only a blank
+			const float p = (label == parent.label ? beam.pb : beam.p) + emission + lmScore;
+			if (p == -INFINITY)
+			{
+				return;
+			}
+
+			this->add(t, this->child(beam.node, label, state), -INFINITY, p);
+		}
+
+		// finds the child of the node or adds it to the trie
+		__forceinline int child(int node, int label, int state)
+		{
+			int last = -1;
+			for (int c = this->nodes[node].child; c >= 0; c = this->nodes[c].sibling)
+			{
+				if (this->nodes[c].label == label)
+				{
+					return c;
+				}
+
+				last = c;
+			}
+
+			const int c = int(this->nodes.size());
+			this->nodes.push_back({ node, label, this->nodes[node].length + 1, -1, -1, state, -1, 0 });
+
+			if (last >= 0)
+			{
+				this->nodes[last].sibling = c;
+			}
+			else
+			{
+				this->nodes[node].child = c;
+			}
+
+			return c;
+		}
+
+		// continuations of the language model state, looked up in the shared cache once per line
+		__forceinline const ctc_lm_cache::entry& expand(ctc_lm_cache* lm, int state)
+		{
+			const ctc_lm_cache::entry*& e = this->expansions[state];
+			if (e == NULL)
+			{
+				e = &lm->find(state);
+			}
+
+			return *e;
+		}
+	};
+}
+
+// CTC prefix beam search over a padded batch of N lines.
+// y is N sequences of T probability vectors of size A, line n uses first lengths[n] vectors.
+// Without language model (lm is NULL) the prefixes are extended by topk most probable classes at each step,
+// otherwise by the continuations the model returns, see ctc_language_model.
+// The classes missing from the alphabet have probability missingLogProb at every step.
+// space is the class that cannot start a hypothesis or follow itself, -1 if none.
+// For each line up to resultCount best hypotheses are written to results (N x resultCount x T),
+// their lengths to resultLengths (N x resultCount) and their log probabilities to scores (N x resultCount);
+// the missing hypotheses have zero length and -inf score. The lines are decoded in parallel
+// and share the continuations of the language model states.
+GENIXAPI(void, CTCBeamSearch)(
+	int N,
+	int T,
+	int A,
+	const float* y,
+	const int* lengths,
+	int blank,
+	int space,
+	int beamWidth,
+	int topk,
+	const ctc_language_model* lm,
+	float missingLogProb,
+	int resultCount,
+	int* results,
+	int* resultLengths,
+	float* scores)
+{
+	std::unique_ptr<ctc_lm_cache> cache(lm != NULL ? new ctc_lm_cache(lm) : NULL);
+
+	parallel_for(0, N, [&](int n)
+	{
+		static thread_local ctc_decoder decoder;
+
+		decoder.decode(
+			lengths[n],
+			A,
+			y + (ptrdiff_t(n) * T * A),
+			blank,
+			space,
+			beamWidth,
+			topk,
+			cache.get(),
+			missingLogProb,
+			resultCount,
+			results + (ptrdiff_t(n) * resultCount * T),
+			T,
+			resultLengths + (ptrdiff_t(n) * resultCount),
+			scores + (ptrdiff_t(n) * resultCount));
+	});
+}
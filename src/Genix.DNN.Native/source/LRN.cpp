@@ -1,54 +1,365 @@
 #include "stdafx.h"
+#include "scratch.h"
+#include "simdkernels.h"
+#include "threadpool.h"
 
-#include <stdlib.h> 
+#include <math.h>
 
-GENIXAPI(void, LRNKernel)(
-	const float* src, float* dst,
+// Local response normalization across channels:
+// scale(c) = k + alpha / n * sum(x(j) ^ 2) and y(c) = x(c) * scale(c) ^ -beta,
+// where j runs over the channels [c - n / 2, c + n / 2] that exist.
+//
+// The tensors are described by the axes and strides [batch, positions, channels]
+// and are dense along either the channels (channel stride is 1) or the positions (position stride is 1).
+// In the first case a block of positions is a contiguous array of whole channel vectors,
+// in the second case each channel of a block of positions is a contiguous row and the window slides over the rows.
+namespace
+{
+	// the number of elements processed by one task
+	const int BlockSize = 4096;
+
+	// the number of positions processed by one task when the positions are contiguous
+	const int RowSize = 1024;
+
+	// the number of positions whose window sums slide over the channels together when the channels are contiguous
+	const int WindowLanes = 8;
+
+	// y := x ^ power
+	void __forceinline __powx(const SIMDKernels& kernels, const int n, const float* x, const float power, float* y)
+	{
+		if (power == -0.75f)
+		{
+			// the default LRN exponent does not need the logarithm
+			for (int i = 0; i < n; i++)
+			{
+				const float s = ::sqrtf(x[i]);
+				y[i] = 1.0f / (s * ::sqrtf(s));
+			}
+		}
+		else if (power == -0.5f)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				y[i] = 1.0f / ::sqrtf(x[i]);
+			}
+		}
+		else
+		{
+			kernels.log_fast(n, x, y);
+			for (int i = 0; i < n; i++)
+			{
+				y[i] *= power;
+			}
+
+			kernels.exp_fast(n, y, y);
+		}
+	}
+
+	// y(c) := sum(x(j)) over j in [c - half, c + half] for Lanes contiguous vectors of channels
+	// The window slides over the channels: it gains the channel c + half and then loses the channel c - half.
+	// Each position keeps its own sum, so the sums of the Lanes positions are independent and load the channels with a stride.
+	template<int Lanes> void __forceinline __window_sum_block(const int channels, const int half, const float* x, float* y)
+	{
+		float sum[Lanes] = {};
+		for (int c = 0; c < __min(half, channels); c++)
+		{
+			for (int i = 0; i < Lanes; i++)
+			{
+				sum[i] += x[(ptrdiff_t(i) * channels) + c];
+			}
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			if (c + half < channels)
+			{
+				for (int i = 0; i < Lanes; i++)
+				{
+					sum[i] += x[(ptrdiff_t(i) * channels) + c + half];
+				}
+			}
+
+			for (int i = 0; i < Lanes; i++)
+			{
+				y[(ptrdiff_t(i) * channels) + c] = sum[i];
+			}
+
+			if (c >= half)
+			{
+				for (int i = 0; i < Lanes; i++)
+				{
+					sum[i] -= x[(ptrdiff_t(i) * channels) + c - half];
+				}
+			}
+		}
+	}
+
+	// y(c) := sum(x(j)) over j in [c - half, c + half] for count contiguous vectors of channels
+	void __forceinline __window_sum(const int count, const int channels, const int half, const float* x, float* y)
+	{
+		if (count < WindowLanes)
+		{
+			for (int p = 0; p < count; p++)
+			{
+				__window_sum_block<1>(channels, half, x + (ptrdiff_t(p) * channels), y + (ptrdiff_t(p) * channels));
+			}
+		}
+		else
+		{
+			// the last block overlaps the previous one and computes some positions again
+			for (int p = 0; p < count; p += WindowLanes)
+			{
+				const ptrdiff_t off = ptrdiff_t(__min(p, count - WindowLanes)) * channels;
+				__window_sum_block<WindowLanes>(channels, half, x + off, y + off);
+			}
+		}
+	}
+
+	// the normalized tensor dimensions
+	struct lrn_dimensions
+	{
+		int batch, positions, channels;
+		int bstride, pstride, cstride;
+
+		lrn_dimensions(const int* axes, const int* strides) :
+			batch(axes[0]), positions(axes[1]), channels(axes[2]),
+			bstride(strides[0]), pstride(strides[1]), cstride(strides[2])
+		{
+		}
+
+		// calls func(offset, p0, p1) for the blocks of positions [p0, p1) of every image in parallel,
+		// offset is the position of the first element of the block
+		template<typename _Function> void run(const int blockSize, const _Function& func) const
+		{
+			const int blocks = (this->positions + blockSize - 1) / blockSize;
+
+			parallel_for(0, this->batch, 0, blocks, [&](int b, int block)
+			{
+				const int p0 = block * blockSize;
+				const int p1 = __min(p0 + blockSize, this->positions);
+
+				func((ptrdiff_t(b) * this->bstride) + (ptrdiff_t(p0) * this->pstride), p0, p1);
+			});
+		}
+	};
+}
+
+// Computes the local response normalization over kernelSize channels.
+// scale receives k + alpha / n * sum(x(j) ^ 2), it is used again by lrn_gradient.
+GENIXAPI(void, lrn)(
 	const int kernelSize,
-	const int b,
+	const float alpha,
+	const float beta,
+	const float k,
+	const float* xw,
 	const int* axes,
-	const int* strides)
+	const int* strides,
+	float* scalew,
+	float* yw)
 {
-	const int W = axes[1];
-	const int H = axes[2];
-	const int C = axes[3];
-	const int BStride = strides[0];
-	const int WStride = strides[1];
-	const int HStride = strides[2];
-	const int CStride = strides[3];
+	const lrn_dimensions dims(axes, strides);
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	const int half = kernelSize / 2;
+	const float factor = alpha / kernelSize;
+
+	if (dims.cstride == 1)
+	{
+		// the channels are contiguous, a block of positions is a contiguous array
+		dims.run(__max(BlockSize / dims.channels, 1), [&](ptrdiff_t off, int p0, int p1)
+		{
+			const int n = (p1 - p0) * dims.channels;
+			const float* x = xw + off;
+			float* scale = scalew + off;
+			float* y = yw + off;
+
+			// y is used as a temporary buffer for the squares
+			for (int i = 0; i < n; i++)
+			{
+				y[i] = x[i] * x[i];
+			}
+
+			__window_sum(p1 - p0, dims.channels, half, y, scale);
 
-	const int kernelSize2 = kernelSize / 2;
-	const int kernelCStride = kernelSize2 * CStride;
-	const int anchor1 = __min(C, kernelSize2 + 1);
+			for (int i = 0; i < n; i++)
+			{
+				scale[i] = k + (factor * scale[i]);
+			}
 
-	for (int x = 0, ix = b * BStride; x < W; x++, ix += WStride)
+			__powx(kernels, n, scale, -beta, y);
+
+			for (int i = 0; i < n; i++)
+			{
+				y[i] *= x[i];
+			}
+		});
+	}
+	else
 	{
-		for (int y = 0, iy = ix; y < H; y++, iy += HStride)
+		// the positions are contiguous, the window sum slides over the channel rows
+		dims.run(RowSize, [&](ptrdiff_t off, int p0, int p1)
 		{
-			// calculate first
-			float sum = 0.0f;
-			for (int c = 0, ic = iy; c < anchor1; c++, ic += CStride)
+			const int n = p1 - p0;
+			const int channels = dims.channels;
+			const ptrdiff_t cstride = dims.cstride;
+			const float* x = xw + off;
+			float* scale = scalew + off;
+			float* y = yw + off;
+
+			float sum[RowSize];
+			::memset(sum, 0, n * sizeof(float));
+			for (int c = 0; c < __min(half, channels); c++)
 			{
-				sum += src[ic];
+				const float* xc = x + (c * cstride);
+				for (int i = 0; i < n; i++)
+				{
+					sum[i] += xc[i] * xc[i];
+				}
 			}
 
-			dst[iy] = sum;
+			for (int c = 0; c < channels; c++)
+			{
+				const ptrdiff_t rc = c * cstride;
+
+				// the window of the channel c ends at c + half
+				if (c + half < channels)
+				{
+					const float* xa = x + rc + (half * cstride);
+					for (int i = 0; i < n; i++)
+					{
+						sum[i] += xa[i] * xa[i];
+					}
+				}
+
+				for (int i = 0; i < n; i++)
+				{
+					scale[rc + i] = k + (factor * sum[i]);
+				}
+
+				__powx(kernels, n, scale + rc, -beta, y + rc);
+
+				for (int i = 0; i < n; i++)
+				{
+					y[rc + i] *= x[rc + i];
+				}
 
-			// calculate others
-			for (int c = 1, ic = iy + CStride; c < C; c++, ic += CStride)
+				// and the window of the channel c + 1 starts at c + 1 - half
+				if (c >= half)
+				{
+					const float* xs = x + rc - (half * cstride);
+					for (int i = 0; i < n; i++)
+					{
+						sum[i] -= xs[i] * xs[i];
+					}
+				}
+			}
+		});
+	}
+}
+
+// Computes the gradient of the local response normalization:
+// dx(c) += dy(c) * scale(c) ^ -beta - 2 * alpha * beta / n * x(c) * sum(y(j) * dy(j) / scale(j)),
+// where scale and y are computed by lrn.
+GENIXAPI(void, lrn_gradient)(
+	const int kernelSize,
+	const float alpha,
+	const float beta,
+	const float* xw,
+	float* dxw,
+	const int* axes,
+	const int* strides,
+	const float* scalew,
+	const float* yw,
+	const float* dyw)
+{
+	const lrn_dimensions dims(axes, strides);
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	const int half = kernelSize / 2;
+	const float factor = -2.0f * alpha * beta / kernelSize;
+
+	if (dims.cstride == 1)
+	{
+		dims.run(__max(BlockSize / dims.channels, 1), [&](ptrdiff_t off, int p0, int p1)
+		{
+			const int n = (p1 - p0) * dims.channels;
+			const float* x = xw + off;
+			float* dx = dxw + off;
+			const float* scale = scalew + off;
+			const float* y = yw + off;
+			const float* dy = dyw + off;
+
+			scratch_buffer<float> buffer(2 * size_t(n));
+			float* work = buffer.data();
+			float* sum = work + n;
+
+			for (int i = 0; i < n; i++)
+			{
+				work[i] = y[i] * dy[i] / scale[i];
+			}
+
+			__window_sum(p1 - p0, dims.channels, half, work, sum);
+
+			__powx(kernels, n, scale, -beta, work);
+
+			for (int i = 0; i < n; i++)
 			{
-				if (c + kernelSize2 < C)
+				dx[i] += (dy[i] * work[i]) + (factor * x[i] * sum[i]);
+			}
+		});
+	}
+	else
+	{
+		dims.run(RowSize, [&](ptrdiff_t off, int p0, int p1)
+		{
+			const int n = p1 - p0;
+			const int channels = dims.channels;
+			const ptrdiff_t cstride = dims.cstride;
+			const float* x = xw + off;
+			float* dx = dxw + off;
+			const float* scale = scalew + off;
+			const float* y = yw + off;
+			const float* dy = dyw + off;
+
+			float sum[RowSize];
+			float work[RowSize];
+			::memset(sum, 0, n * sizeof(float));
+			for (int c = 0; c < __min(half, channels); c++)
+			{
+				const ptrdiff_t ra = c * cstride;
+				for (int i = 0; i < n; i++)
 				{
-					sum += src[ic + kernelCStride];
+					sum[i] += y[ra + i] * dy[ra + i] / scale[ra + i];
 				}
+			}
 
-				dst[ic] = sum;
+			for (int c = 0; c < channels; c++)
+			{
+				const ptrdiff_t rc = c * cstride;
 
-				if (c >= kernelSize2)
+				if (c + half < channels)
 				{
-					sum -= src[ic - kernelCStride];
+					const ptrdiff_t ra = rc + (half * cstride);
+					for (int i = 0; i < n; i++)
+					{
+						sum[i] += y[ra + i] * dy[ra + i] / scale[ra + i];
+					}
+				}
+
+				__powx(kernels, n, scale + rc, -beta, work);
+
+				for (int i = 0; i < n; i++)
+				{
+					dx[rc + i] += (dy[rc + i] * work[i]) + (factor * x[rc + i] * sum[i]);
+				}
+
+				if (c >= half)
+				{
+					const ptrdiff_t rs = rc - (half * cstride);
+					for (int i = 0; i < n; i++)
+					{
+						sum[i] -= y[rs + i] * dy[rs + i] / scale[rs + i];
+					}
 				}
 			}
-		}
+		});
 	}
 }
@@ -1,7 +1,198 @@
 #include "stdafx.h"
-#include "mkl.h"
+#include "backend.h"
+#include "halfprecision.h"
+#include "simdkernels.h"
+#include "threadpool.h"
 #include "nonlinearity.inl"
 
+// Hidden weights packed once for repeated inference, see lstm_pack and gru_pack.
+// The matrices are stored in the panel layout of SIMDKernels::packed_gemv,
+// so every time step streams them sequentially and no layout conversion is done per call.
+// Stored in 16 bits (see halfprecision.h), they take half the memory bandwidth.
+struct rnn_weights
+{
+	struct matrix
+	{
+		int m;
+		int n;
+		WEIGHTS_PRECISION precision;
+		void* data;
+	};
+
+	int count;
+	matrix matrices[4];
+};
+
+// packs the m-by-n matrix a with the leading dimension lda
+static void __pack_matrix(rnn_weights::matrix& packed, int m, int n, const float* a, int lda, BOOL rowmajor, WEIGHTS_PRECISION precision)
+{
+	packed.m = m;
+	packed.n = n;
+	packed.precision = precision;
+
+	if (precision != PrecisionSingle)
+	{
+		unsigned __int16* data = new unsigned __int16[halfprecision_packed_size(m, n)];
+		if (precision == PrecisionHalf)
+		{
+			::matrix_pack_f16(m, n, a, 0, lda, !rowmajor, data);
+		}
+		else
+		{
+			::matrix_pack_bf16(m, n, a, 0, lda, !rowmajor, data);
+		}
+
+		packed.data = data;
+		return;
+	}
+
+	const int panels = (m + SIMD_PACKED_ROWS - 1) / SIMD_PACKED_ROWS;
+
+	float* dst = new float[size_t(panels) * n * SIMD_PACKED_ROWS];
+	packed.data = dst;
+
+	for (int p = 0; p < panels; p++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			for (int r = 0; r < SIMD_PACKED_ROWS; r++)
+			{
+				const int i = (p * SIMD_PACKED_ROWS) + r;
+				*dst++ = i >= m ? 0.0f : (rowmajor ? a[(ptrdiff_t(i) * lda) + j] : a[(ptrdiff_t(j) * lda) + i]);
+			}
+		}
+	}
+}
+
+// y += A * x for a packed matrix
+static void __forceinline __packed_gemv(const SIMDKernels& kernels, const rnn_weights::matrix& a, const float* x, float* y)
+{
+	switch (a.precision)
+	{
+	case PrecisionHalf:
+		kernels.packed_gemm_f16(a.m, a.n, 1, static_cast<const unsigned __int16*>(a.data), x, a.n, y, a.m);
+		break;
+
+	case PrecisionBFloat16:
+		kernels.packed_gemm_bf16(a.m, a.n, 1, static_cast<const unsigned __int16*>(a.data), x, a.n, y, a.m);
+		break;
+
+	default:
+		kernels.packed_gemv(a.m, a.n, static_cast<const float*>(a.data), x, y);
+		break;
+	}
+}
+
+// Packs the hidden weights of LSTM, the matrix u used by lstm.
+GENIXAPI(rnn_weights*, lstm_pack)(
+	int ylen,
+	const float* u,
+	BOOL rowmajor,
+	WEIGHTS_PRECISION precision)
+{
+	const int m = 4 * ylen;
+	const int n = ylen;
+
+	rnn_weights* weights = new rnn_weights();
+	weights->count = 1;
+	__pack_matrix(weights->matrices[0], m, n, u, rowmajor ? n : m, rowmajor, precision);
+
+	return weights;
+}
+
+// Packs the hidden weights of GRU, the matrix u used by gru.
+GENIXAPI(rnn_weights*, gru_pack)(
+	const int ystep,
+	const float* u,
+	const BOOL bidirectional,
+	const BOOL rowmajor,
+	const WEIGHTS_PRECISION precision)
+{
+	const int hstep = bidirectional ? ystep >> 1 : ystep;
+	const int gstep = 3 * ystep;
+	const int m = 2 * hstep;
+	const int n = hstep;
+	const int ldu = rowmajor ? n : gstep;
+	const float* uc = u + (rowmajor ? m * n : m);
+	const int off = rowmajor ? (m + n) * n : m + n;
+
+	rnn_weights* weights = new rnn_weights();
+	weights->count = bidirectional ? 4 : 2;
+	for (int i = 0; i < weights->count; i += 2)
+	{
+		__pack_matrix(weights->matrices[i], m, n, u + ((i >> 1) * off), ldu, rowmajor, precision);
+		__pack_matrix(weights->matrices[i + 1], n, n, uc + ((i >> 1) * off), ldu, rowmajor, precision);
+	}
+
+	return weights;
+}
+
+GENIXAPI(void, rnn_weights_free)(
+	rnn_weights* weights)
+{
+	if (weights != NULL)
+	{
+		for (int i = 0; i < weights->count; i++)
+		{
+			const rnn_weights::matrix& a = weights->matrices[i];
+			if (a.precision == PrecisionSingle)
+			{
+				delete[] static_cast<float*>(a.data);
+			}
+			else
+			{
+				delete[] static_cast<unsigned __int16*>(a.data);
+			}
+		}
+
+		delete weights;
+	}
+}
+
+// Runs LSTM over one sequence.
+// Time steps are gstep elements apart in g and ystep elements apart in s and y.
+// gemv(x, y) computes y += U * x with the hidden weights matrix U.
+template <typename _Gemv>
+static void __lstm(
+	int steps,
+	int ylen,
+	int gstep,
+	int ystep,
+	float* g,
+	float* s,
+	float* y,
+	float forgetBias,
+	BOOL forward,
+	const _Gemv& gemv)
+{
+	int ginc = gstep, yinc = ystep;
+	if (!forward)
+	{
+		ginc = -gstep; yinc = -ystep;
+
+		ptrdiff_t tstart = ptrdiff_t(steps) - 1;
+		g += tstart * gstep;
+		s += tstart * ystep;
+		y += tstart * ystep;
+	}
+
+	const SIMDKernels& kernels = SIMDKernels::Current();
+
+	for (int t = 0; t < steps; t++, g += ginc, s += yinc, y += yinc)
+	{
+		if (t == 0)
+		{
+			kernels.lstm_cell(ylen, g, NULL, s, y, forgetBias);
+		}
+		else
+		{
+			gemv(y - yinc, g);
+
+			kernels.lstm_cell(ylen, g, s - yinc, s, y, forgetBias);
+		}
+	}
+}
+
 GENIXAPI(void, lstm)(
 	int steps,
 	int ylen,
@@ -13,64 +204,154 @@ GENIXAPI(void, lstm)(
 	BOOL forward,
 	BOOL rowmajor)
 {
-	const int glen = 4 * ylen;
-	const int m = glen;
+	const int m = 4 * ylen;
 	const int n = ylen;
 	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
 	const int lda = rowmajor ? n : m;
 
-	int ginc = glen, yinc = ylen;
-	if (!forward)
+	__lstm(steps, ylen, m, n, g, s, y, forgetBias, forward, [&](const float* x, float* gx)
 	{
-		ginc = -glen; yinc = -ylen;
+		::cblas_sgemv(layout, CblasNoTrans, m, n, 1.0f, u, lda, x, 1, 1.0f, gx, 1);
+	});
+}
 
-		ptrdiff_t tstart = ptrdiff_t(steps) - 1;
-		g += tstart * glen;
-		s += tstart * ylen;
-		y += tstart * ylen;
-	}
+GENIXAPI(void, lstm_packed)(
+	int steps,
+	int ylen,
+	const rnn_weights* weights,
+	float* g,
+	float* s,
+	float* y,
+	float forgetBias,
+	BOOL forward)
+{
+	const SIMDKernels& kernels = SIMDKernels::Current();
+	const rnn_weights::matrix& u = weights->matrices[0];
 
-	for (int t = 0; t < steps; t++, g += ginc, s += yinc, y += yinc)
+	__lstm(steps, ylen, 4 * ylen, ylen, g, s, y, forgetBias, forward, [&](const float* x, float* gx)
 	{
-		float* jg = g + ylen;
-		float* fg = jg + ylen;
-		float* og = fg + ylen;
+		__packed_gemv(kernels, u, x, gx);
+	});
+}
 
-		if (t == 0)
+// Runs bidirectional LSTM over one sequence; the two directions run concurrently.
+// Each time step holds the forward and then the backward half: ystep = 2 * hidden size,
+// the gates of a step take 4 * ystep elements and u holds the forward and then the backward matrix.
+GENIXAPI(void, lstm_bidirectional)(
+	int steps,
+	int ystep,
+	const float* u,
+	float* g,
+	float* s,
+	float* y,
+	float forgetBias,
+	BOOL rowmajor)
+{
+	const int hstep = ystep >> 1;
+	const int gstep = 4 * ystep;
+	const int m = 4 * hstep;
+	const int n = hstep;
+	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
+	const int ldu = rowmajor ? n : gstep;
+	const int off = rowmajor ? m * n : m;
+
+	parallel_for(0, 2, [&](int i)
+	{
+		const float* ui = u + (i * off);
+		__lstm(steps, hstep, gstep, ystep, g + (i * m), s + (i * n), y + (i * n), forgetBias, i == 0, [&](const float* x, float* gx)
 		{
-			for (int i = 0; i < ylen; i++)
-			{
-				const float igate = g[i] = __sigmoid(g[i]);
-				const float jgate = jg[i] = ::tanhf(jg[i]);
-				const float fgate = fg[i] = __sigmoid(fg[i] + forgetBias);
-				const float ogate = og[i] = __sigmoid(og[i]);
+			::cblas_sgemv(layout, CblasNoTrans, m, n, 1.0f, ui, ldu, x, 1, 1.0f, gx, 1);
+		});
+	});
+}
+
+// Runs LSTM over a mini-batch of sequences.
+// The gates, states and outputs are stored time-major: element t of sequence b starts at (t * batch + b) * length,
+// so the recurrent product for all sequences is a single matrix multiplication per time step.
+// Sequence b has lengths[b] elements (steps when lengths is NULL); the states and outputs past its end are set to zero.
+GENIXAPI(void, lstm_batch)(
+	int steps,
+	int batch,
+	int ylen,
+	const int* lengths,
+	const float* u,
+	float* g,
+	float* s,
+	float* y,
+	float forgetBias,
+	BOOL forward,
+	BOOL rowmajor)
+{
+	const int glen = 4 * ylen;
+	const ptrdiff_t gstep = ptrdiff_t(batch) * glen;
+	const ptrdiff_t ystep = ptrdiff_t(batch) * ylen;
+
+	// the batch is multiplied by u transposed
+	const CBLAS_TRANSPOSE transu = rowmajor ? CblasTrans : CblasNoTrans;
+	const int ldu = rowmajor ? ylen : glen;
 
-				s[i] = igate * jgate;
-				y[i] = ogate * ::tanhf(s[i]);
+	// enough rows for each thread to amortize the scheduling
+	const int grain = __max(1, 4096 / __max(glen, 1));
+
+	const SIMDKernels& kernels = SIMDKernels::Current();
+
+	for (int k = 0; k < steps; k++)
+	{
+		const int t = forward ? k : steps - 1 - k;
+		float* gt = g + (t * gstep);
+		float* st = s + (t * ystep);
+		float* yt = y + (t * ystep);
+
+		const ptrdiff_t prev = forward ? -ystep : ystep;
+		const float* sprev = k == 0 ? NULL : st + prev;
+		const float* yprev = k == 0 ? NULL : yt + prev;
+
+		// the rows past the last active sequence do not need the product
+		int active = batch;
+		if (lengths != NULL)
+		{
+			while (active > 0 && lengths[active - 1] <= t)
+			{
+				active--;
 			}
 		}
-		else
+
+		// the outputs of finished or not yet started sequences are zero, so they do not contribute here
+		if (yprev != NULL && active > 0)
 		{
-			::cblas_sgemv(layout, CblasNoTrans, m, n, 1.0f, u, lda, y - yinc, 1, 1.0f, g, 1);
+			::cblas_sgemm(CblasRowMajor, CblasNoTrans, transu, active, glen, ylen, 1.0f, yprev, ylen, u, ldu, 1.0f, gt, glen);
+		}
 
-			const float* sprev = s - ylen;
-			for (int i = 0; i < ylen; i++)
+		parallel_for_range(0, batch, grain, [&](int start, int end)
+		{
+			for (int b = start; b < end; b++)
 			{
-				const float igate = g[i] = __sigmoid(g[i]);
-				const float jgate = jg[i] = ::tanhf(jg[i]);
-				const float fgate = fg[i] = __sigmoid(fg[i] + forgetBias);
-				const float ogate = og[i] = __sigmoid(og[i]);
+				float* sb = st + (b * ylen);
+				float* yb = yt + (b * ylen);
 
-				s[i] = (fgate * sprev[i]) + (igate * jgate);
-				y[i] = ogate * ::tanhf(s[i]);
+				if (lengths == NULL || t < lengths[b])
+				{
+					kernels.lstm_cell(ylen, gt + (b * glen), sprev != NULL ? sprev + (b * ylen) : NULL, sb, yb, forgetBias);
+				}
+				else
+				{
+					::memset(sb, 0, ylen * sizeof(float));
+					::memset(yb, 0, ylen * sizeof(float));
+				}
 			}
-		}
+		});
 	}
 }
 
-GENIXAPI(void, lstm_gradient)(
+// Computes LSTM gradients over one sequence.
+// Time steps are gstep elements apart in g and dg and ystep elements apart in s, ds, y and dy.
+static void __lstm_gradient(
 	int steps,
 	int ylen,
+	int gstep,
+	int ystep,
+	CBLAS_LAYOUT layout,
+	int lda,
 	const float* u,
 	float* du,
 	const float* g,
@@ -79,29 +360,25 @@ GENIXAPI(void, lstm_gradient)(
 	float* ds,
 	const float* y,
 	float* dy,
-	BOOL forward,
-	BOOL rowmajor)
+	BOOL forward)
 {
-	const int glen = 4 * ylen;
-	const int m = glen;
+	const int m = 4 * ylen;
 	const int n = ylen;
-	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
-	const int lda = rowmajor ? n : m;
 
-	int ginc = glen, yinc = ylen;
+	int ginc = gstep, yinc = ystep;
 	if (forward)
 	{
 		ptrdiff_t tstart = ptrdiff_t(steps) - 1;
-		g += tstart * glen;
-		dg += tstart * glen;
-		s += tstart * ylen;
-		ds += tstart * ylen;
-		y += tstart * ylen;
-		dy += tstart * ylen;
+		g += tstart * gstep;
+		dg += tstart * gstep;
+		s += tstart * ystep;
+		ds += tstart * ystep;
+		y += tstart * ystep;
+		dy += tstart * ystep;
 	}
 	else
 	{
-		ginc = -glen; yinc = -ylen;
+		ginc = -gstep; yinc = -ystep;
 	}
 
 	for (int t = steps - 1; t >= 0; t--, g -= ginc, dg -= ginc, s -= yinc, ds -= yinc, y -= yinc, dy -= yinc)
@@ -184,147 +461,231 @@ GENIXAPI(void, lstm_gradient)(
 	}
 }
 
-GENIXAPI(void, gru)(
-	const int steps,
-	const int ystep,
+GENIXAPI(void, lstm_gradient)(
+	int steps,
+	int ylen,
 	const float* u,
-	float* g,
-	float* y,
-	const BOOL bidirectional,
-	const BOOL rowmajor)
+	float* du,
+	const float* g,
+	float* dg,
+	const float* s,
+	float* ds,
+	const float* y,
+	float* dy,
+	BOOL forward,
+	BOOL rowmajor)
 {
-	const int hstep = bidirectional ? ystep >> 1 : ystep;
-	const int gstep = 3 * ystep;
-	const int m = 2 * hstep;
+	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
+	const int lda = rowmajor ? ylen : 4 * ylen;
+
+	__lstm_gradient(steps, ylen, 4 * ylen, ylen, layout, lda, u, du, g, dg, s, ds, y, dy, forward);
+}
+
+// Computes the gradients of lstm_bidirectional; the two directions run concurrently.
+GENIXAPI(void, lstm_bidirectional_gradient)(
+	int steps,
+	int ystep,
+	const float* u,
+	float* du,
+	const float* g,
+	float* dg,
+	const float* s,
+	float* ds,
+	const float* y,
+	float* dy,
+	BOOL rowmajor)
+{
+	const int hstep = ystep >> 1;
+	const int gstep = 4 * ystep;
+	const int m = 4 * hstep;
 	const int n = hstep;
 	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
 	const int ldu = rowmajor ? n : gstep;
-	const float* uc = u + (rowmajor ? m * n : m);
+	const int off = rowmajor ? m * n : m;
+
+	// the directions use disjoint halves of every array
+	parallel_for(0, 2, [&](int i)
+	{
+		__lstm_gradient(
+			steps, hstep, gstep, ystep, layout, ldu,
+			u + (i * off), du + (i * off),
+			g + (i * m), dg + (i * m),
+			s + (i * n), ds + (i * n),
+			y + (i * n), dy + (i * n),
+			i == 0);
+	});
+}
+
+// Runs one direction of GRU over a sequence.
+// Time steps are gstep elements apart in g and ystep elements apart in y.
+// gemv(i, x, y) computes y += U * x, where U is the update and reset gates matrix (i = 0) or the candidate matrix (i = 1).
+template <typename _Gemv>
+static void __gru_pass(
+	const int steps,
+	const int hstep,
+	const int gstep,
+	const int ystep,
+	float* g,
+	float* y,
+	const BOOL forward,
+	const _Gemv& gemv)
+{
+	int ginc = gstep, yinc = ystep;
+	if (!forward)
+	{
+		ginc = -gstep; yinc = -ystep;
+
+		ptrdiff_t tstart = ptrdiff_t(steps) - 1;
+		g += tstart * gstep;
+		y += tstart * ystep;
+	}
 
-	for (int t = 0; t < steps; t++, y += ystep, g += gstep)
+	const SIMDKernels& kernels = SIMDKernels::Current();
+
+	for (int t = 0; t < steps; t++, y += yinc, g += ginc)
 	{
 		float* rg = g + hstep;		// reset gate
 		float* cg = rg + hstep;		// candidate
 
 		if (t == 0)
 		{
+			kernels.sigmoid_fast(2 * hstep, g, g);
+			kernels.tanh_fast(hstep, cg, cg);
+
 			for (int i = 0; i < hstep; i++)
 			{
-				g[i] = __sigmoid(g[i]);
-				rg[i] = __sigmoid(rg[i]);
-				cg[i] = ::tanhf(cg[i]);
-
 				y[i] = g[i] * cg[i];
 			}
 		}
 		else
 		{
-			const float* state = y - ystep;
-			::cblas_sgemv(layout, CblasNoTrans, m, n, 1.0f, u, ldu, state, 1, 1.0f, g, 1);
+			const float* state = y - yinc;
+			gemv(0, state, g);
+
+			kernels.sigmoid_fast(2 * hstep, g, g);
 
 			for (int i = 0; i < hstep; i++)
 			{
-				g[i] = __sigmoid(g[i]);
-				rg[i] = __sigmoid(rg[i]);
-
 				// use y as a temporary buffer for r * state
 				y[i] = rg[i] * state[i];
 			}
 
-			::cblas_sgemv(layout, CblasNoTrans, n, n, 1.0f, uc, ldu, y, 1, 1.0f, cg, 1);
+			gemv(1, y, cg);
+
+			kernels.tanh_fast(hstep, cg, cg);
 
 			for (int i = 0; i < hstep; i++)
 			{
-				cg[i] = ::tanhf(cg[i]);
-
 				const float s = state[i];
 				y[i] = s + (g[i] * (cg[i] - s));
 			}
 		}
 	}
+}
 
-	// backward pass
-	if (bidirectional)
-	{
-		y -= ystep / 2;
-		g -= gstep / 2;
-
-		int off = rowmajor ? (m + n) * n : m + n;
-		u += off;
-		uc += off;
+// Runs GRU over one sequence, in both directions when bidirectional is TRUE.
+// The directions use disjoint halves of g and y and run concurrently.
+// gemv(i, x, y) computes y += U * x, where U is the update and reset gates matrix (i = 0)
+// or the candidate matrix (i = 1) of the forward direction, i = 2 and 3 select the backward direction.
+template <typename _Gemv>
+static void __gru(
+	const int steps,
+	const int ystep,
+	float* g,
+	float* y,
+	const BOOL bidirectional,
+	const _Gemv& gemv)
+{
+	const int hstep = bidirectional ? ystep >> 1 : ystep;
+	const int gstep = 3 * ystep;
 
-		for (int t = steps - 1; t >= 0; t--, y -= ystep, g -= gstep)
+	parallel_for(0, bidirectional ? 2 : 1, [&](int d)
+	{
+		__gru_pass(steps, hstep, gstep, ystep, g + (d * (gstep / 2)), y + (d * hstep), d == 0, [&](int i, const float* x, float* gx)
 		{
-			float* rg = g + hstep;		// reset gate
-			float* cg = rg + hstep;		// candidate
-
-			if (t == steps - 1)
-			{
-				for (int i = 0; i < hstep; i++)
-				{
-					g[i] = __sigmoid(g[i]);
-					rg[i] = __sigmoid(rg[i]);
-					cg[i] = ::tanhf(cg[i]);
-
-					y[i] = g[i] * cg[i];
-				}
-			}
-			else
-			{
-				const float* state = y + ystep;
-				::cblas_sgemv(layout, CblasNoTrans, m, n, 1.0f, u, ldu, state, 1, 1.0f, g, 1);
-
-				for (int i = 0; i < hstep; i++)
-				{
-					g[i] = __sigmoid(g[i]);
-					rg[i] = __sigmoid(rg[i]);
+			gemv((2 * d) + i, x, gx);
+		});
+	});
+}
 
-					// use y as a temporary buffer for r * state
-					y[i] = rg[i] * state[i];
-				}
+GENIXAPI(void, gru)(
+	const int steps,
+	const int ystep,
+	const float* u,
+	float* g,
+	float* y,
+	const BOOL bidirectional,
+	const BOOL rowmajor)
+{
+	const int hstep = bidirectional ? ystep >> 1 : ystep;
+	const int gstep = 3 * ystep;
+	const int m = 2 * hstep;
+	const int n = hstep;
+	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
+	const int ldu = rowmajor ? n : gstep;
+	const float* uc = u + (rowmajor ? m * n : m);
+	const int off = rowmajor ? (m + n) * n : m + n;
 
-				::cblas_sgemv(layout, CblasNoTrans, n, n, 1.0f, uc, ldu, y, 1, 1.0f, cg, 1);
+	__gru(steps, ystep, g, y, bidirectional, [&](int i, const float* x, float* gx)
+	{
+		const float* a = ((i & 1) ? uc : u) + ((i >> 1) * off);
+		const int rows = (i & 1) ? n : m;
+		::cblas_sgemv(layout, CblasNoTrans, rows, n, 1.0f, a, ldu, x, 1, 1.0f, gx, 1);
+	});
+}
 
-				for (int i = 0; i < hstep; i++)
-				{
-					cg[i] = ::tanhf(cg[i]);
+GENIXAPI(void, gru_packed)(
+	const int steps,
+	const int ystep,
+	const rnn_weights* weights,
+	float* g,
+	float* y,
+	const BOOL bidirectional)
+{
+	const SIMDKernels& kernels = SIMDKernels::Current();
 
-					const float s = state[i];
-					y[i] = s + (g[i] * (cg[i] - s));
-				}
-			}
-		}
-	}
+	__gru(steps, ystep, g, y, bidirectional, [&](int i, const float* x, float* gx)
+	{
+		__packed_gemv(kernels, weights->matrices[i], x, gx);
+	});
 }
 
-GENIXAPI(void, gru_gradient)(
+// Computes the gradients of one direction of GRU over a sequence, see __gru_pass.
+static void __gru_gradient_pass(
 	const int steps,
+	const int hstep,
+	const int gstep,
 	const int ystep,
+	const CBLAS_LAYOUT layout,
+	const int ldu,
 	const float* u,
 	float* du,
+	const float* uc,
+	float* duc,
 	const float* g,
 	float* dg,
 	const float* y,
 	float* dy,
-	const BOOL bidirectional,
-	const BOOL rowmajor)
+	const BOOL forward)
 {
-	const int hstep = bidirectional ? ystep >> 1 : ystep;
-	const int gstep = 3 * ystep;
 	const int m = 2 * hstep;
 	const int n = hstep;
-	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
-	const int ldu = rowmajor ? n : gstep;
-	const float* uc = u + (rowmajor ? m * n : m);
-	float* duc = du + (rowmajor ? m * n : m);
 
-	ptrdiff_t tstart = ptrdiff_t(steps) - 1;
-	g += tstart * gstep;
-	dg += tstart * gstep;
-	y += tstart * ystep;
-	dy += tstart * ystep;
+	int ginc = gstep, yinc = ystep;
+	if (forward)
+	{
+		ptrdiff_t tstart = ptrdiff_t(steps) - 1;
+		g += tstart * gstep;
+		dg += tstart * gstep;
+		y += tstart * ystep;
+		dy += tstart * ystep;
+	}
+	else
+	{
+		ginc = -gstep; yinc = -ystep;
+	}
 
-	for (int t = steps - 1; t >= 0; t--, y -= ystep, dy -= ystep, g -= gstep, dg -= gstep)
+	for (int t = steps - 1; t >= 0; t--, y -= yinc, dy -= yinc, g -= ginc, dg -= ginc)
 	{
 		const float* rg = g + hstep;		// reset gate
 		float* drg = dg + hstep;
@@ -352,8 +713,8 @@ GENIXAPI(void, gru_gradient)(
 		}
 		else
 		{
-			const float* state = y - ystep;
-			float* dstate = dy - ystep;
+			const float* state = y - yinc;
+			float* dstate = dy - yinc;
 
 			for (int i = 0; i < hstep; i++)
 			{
@@ -394,93 +755,38 @@ GENIXAPI(void, gru_gradient)(
 			::cblas_sgemv(layout, CblasTrans, m, n, 1.0f, u, ldu, dg, 1, 1.0f, dstate, 1);
 		}
 	}
+}
 
-	// backward pass
-	if (bidirectional)
-	{
-		int off = ystep + (ystep / 2);
-		y += off;
-		dy += off;
-
-		off = gstep + (gstep / 2);
-		g += off;
-		dg += off;
-
-		off = rowmajor ? (m + n) * n : m + n;
-		u += off;
-		du += off;
-		uc += off;
-		duc += off;
-
-		for (int t = 0; t < steps; t++, y += ystep, dy += ystep, g += gstep, dg += gstep)
-		{
-			const float* rg = g + hstep;		// reset gate
-			float* drg = dg + hstep;
-
-			const float* cg = rg + hstep;		// candidate
-			float* dcg = drg + hstep;
-
-			if (t == steps - 1)
-			{
-				for (int i = 0; i < hstep; i++)
-				{
-					const float ugate = g[i];
-					const float candidate = cg[i];
-					const float dyi = dy[i];
-
-					// update gate
-					dg[i] = dyi * candidate * __sigmoid_derivative2(ugate);
-
-					// reset gate
-					drg[i] = 0;
-
-					// candidate
-					dcg[i] = dyi * ugate * __tanh_derivative2(candidate);
-				}
-			}
-			else
-			{
-				const float* state = y + ystep;
-				float* dstate = dy + ystep;
-
-				for (int i = 0; i < hstep; i++)
-				{
-					const float ugate = g[i];
-					const float candidate = cg[i];
-					const float dyi = dy[i];
-
-					// update gate
-					dg[i] = dyi * (candidate - state[i]) * __sigmoid_derivative2(ugate);
-
-					// calculate r * state again
-					// we will need it to update candidate weights
-					// use drg as a temporary buffer
-					drg[i] = rg[i] * state[i];
-
-					// candidate
-					dcg[i] = dyi * ugate * __tanh_derivative2(candidate);
-
-					// state gradient
-					dstate[i] += dyi * (1.0f - ugate);
-				}
-
-				::cblas_sger(layout, n, n, 1.0f, dcg, 1, drg, 1, duc, ldu);
-				// use drg as a temporary buffer for d(r * state)
-				::cblas_sgemv(layout, CblasTrans, n, n, 1.0f, uc, ldu, dcg, 1, 0.0f, drg, 1);
-
-				// update state gradient and calculate reset gate
-				for (int i = 0; i < hstep; i++)
-				{
-					// state gradient
-					dstate[i] += drg[i] * rg[i];
-
-					// reset gate
-					drg[i] = drg[i] * state[i] * __sigmoid_derivative2(rg[i]);
-				}
+GENIXAPI(void, gru_gradient)(
+	const int steps,
+	const int ystep,
+	const float* u,
+	float* du,
+	const float* g,
+	float* dg,
+	const float* y,
+	float* dy,
+	const BOOL bidirectional,
+	const BOOL rowmajor)
+{
+	const int hstep = bidirectional ? ystep >> 1 : ystep;
+	const int gstep = 3 * ystep;
+	const int m = 2 * hstep;
+	const int n = hstep;
+	const CBLAS_LAYOUT layout = rowmajor ? CblasRowMajor : CblasColMajor;
+	const int ldu = rowmajor ? n : gstep;
+	const int ucoff = rowmajor ? m * n : m;
+	const int off = rowmajor ? (m + n) * n : m + n;
 
-				::cblas_sger(layout, m, n, 1.0f, dg, 1, state, 1, du, ldu);
-				::cblas_sgemv(layout, CblasTrans, m, n, 1.0f, u, ldu, dg, 1, 1.0f, dstate, 1);
-			}
-		}
-	}
+	// the directions use disjoint halves of every array
+	parallel_for(0, bidirectional ? 2 : 1, [&](int d)
+	{
+		__gru_gradient_pass(
+			steps, hstep, gstep, ystep, layout, ldu,
+			u + (d * off), du + (d * off),
+			u + (d * off) + ucoff, du + (d * off) + ucoff,
+			g + (d * (gstep / 2)), dg + (d * (gstep / 2)),
+			y + (d * hstep), dy + (d * hstep),
+			d == 0);
+	});
 }
@@ -0,0 +1,343 @@
+#include "stdafx.h"
+#include <stdlib.h>
+
+#include "simdkernels.h"
+#include "threadpool.h"
+
+// Adaptive pooling: the size of the output is given and the windows are derived from it.
+// Output element i of an axis of length y pools the inputs [floor(i * x / y), ceil((i + 1) * x / y))
+// of the corresponding input axis of length x, so the windows cover the input and are never empty.
+// Global pooling is adaptive pooling to a single output element.
+//
+// The tensors are described the same way as in max and average pooling: axis 0 is the batch,
+// axes 1 and 2 are pooled and every position holds xstride2 contiguous channels.
+namespace
+{
+	// the number of channels processed by one task
+	const int ChannelBlock = 64;
+
+	int __forceinline __window_begin(const int i, const int x, const int y)
+	{
+		return int((ptrdiff_t(i) * x) / y);
+	}
+
+	int __forceinline __window_end(const int i, const int x, const int y)
+	{
+		return int(((ptrdiff_t(i + 1) * x) + y - 1) / y);
+	}
+
+	// the pooled tensor dimensions
+	struct adaptive_pooling
+	{
+		int x0, x1, x2;
+		int xstride0, xstride1, xstride2;
+		int y1, y2;
+		int ystride0, ystride1, ystride2;
+
+		adaptive_pooling(const int* xaxes, const int* xstrides, const int* yaxes, const int* ystrides) :
+			x0(xaxes[0]), x1(xaxes[1]), x2(xaxes[2]),
+			xstride0(xstrides[0]), xstride1(xstrides[1]), xstride2(xstrides[2]),
+			y1(yaxes[1]), y2(yaxes[2]),
+			ystride0(ystrides[0]), ystride1(ystrides[1]), ystride2(ystrides[2])
+		{
+			// a global window over a contiguous plane is read as a single row
+			if (this->y1 == 1 && this->y2 == 1 && this->xstride1 == this->x2 * this->xstride2)
+			{
+				this->x2 *= this->x1;
+				this->x1 = 1;
+			}
+		}
+
+		// calls func(ix0, c0, c1, iy1, iy2, b1, e1, b2, e2) for every output position of the channels [c0, c1) of every image;
+		// the channel blocks are processed in parallel and do not share any element of x or y
+		template<typename _Function> void run(const _Function& func) const
+		{
+			const int channels = this->xstride2;
+			const int blocks = (channels + ChannelBlock - 1) / ChannelBlock;
+
+			parallel_for(0, this->x0, 0, blocks, [&](int ix0, int block)
+			{
+				const int c0 = block * ChannelBlock;
+				const int c1 = __min(c0 + ChannelBlock, channels);
+
+				for (int iy1 = 0; iy1 < this->y1; iy1++)
+				{
+					const int b1 = __window_begin(iy1, this->x1, this->y1);
+					const int e1 = __window_end(iy1, this->x1, this->y1);
+
+					for (int iy2 = 0; iy2 < this->y2; iy2++)
+					{
+						const int b2 = __window_begin(iy2, this->x2, this->y2);
+						const int e2 = __window_end(iy2, this->x2, this->y2);
+
+						func(ix0, c0, c1, iy1, iy2, b1, e1, b2, e2);
+					}
+				}
+			});
+		}
+
+		ptrdiff_t xoffset(const int ix0, const int c, const int ix1, const int ix2) const
+		{
+			return (ptrdiff_t(ix0) * this->xstride0) + (ptrdiff_t(ix1) * this->xstride1) + (ptrdiff_t(ix2) * this->xstride2) + c;
+		}
+
+		ptrdiff_t yoffset(const int ix0, const int c, const int iy1, const int iy2) const
+		{
+			return (ptrdiff_t(ix0) * this->ystride0) + (ptrdiff_t(iy1) * this->ystride1) + (ptrdiff_t(iy2) * this->ystride2) + c;
+		}
+	};
+
+	// y := alpha * (sum of the rows x cols window) for each of n <= ChannelBlock channels
+	void __forceinline __avg_window(
+		const int n,
+		const float* x,
+		const int rows,
+		const int cols,
+		const int xstride1,
+		const int xstride2,
+		const float alpha,
+		float* y)
+	{
+		if (n == 1 && xstride2 == 1)
+		{
+			// a single channel, the window rows are contiguous
+			float sum = 0.0f;
+			for (int r = 0; r < rows; r++, x += xstride1)
+			{
+				for (int c = 0; c < cols; c++)
+				{
+					sum += x[c];
+				}
+			}
+
+			y[0] = alpha * sum;
+		}
+		else
+		{
+			float sum[ChannelBlock];
+			::memset(sum, 0, n * sizeof(float));
+
+			for (int r = 0; r < rows; r++, x += xstride1)
+			{
+				for (int c = 0, off = 0; c < cols; c++, off += xstride2)
+				{
+					for (int i = 0; i < n; i++)
+					{
+						sum[i] += x[off + i];
+					}
+				}
+			}
+
+			for (int i = 0; i < n; i++)
+			{
+				y[i] = alpha * sum[i];
+			}
+		}
+	}
+
+	// x += alpha for each element of the rows x cols window of n channels
+	void __forceinline __add_window(const int n, const float* alpha, const int rows, const int cols, const int xstride1, const int xstride2, float* x)
+	{
+		if (n == 1 && xstride2 == 1)
+		{
+			const float value = alpha[0];
+			for (int r = 0; r < rows; r++, x += xstride1)
+			{
+				for (int c = 0; c < cols; c++)
+				{
+					x[c] += value;
+				}
+			}
+		}
+		else
+		{
+			for (int r = 0; r < rows; r++, x += xstride1)
+			{
+				for (int c = 0, off = 0; c < cols; c++, off += xstride2)
+				{
+					for (int i = 0; i < n; i++)
+					{
+						x[off + i] += alpha[i];
+					}
+				}
+			}
+		}
+	}
+
+	// max, index := value, k when value > max; the index is selected with a mask, see __max_index in maxpooling.cpp
+	void __forceinline __max_select(const float value, const int k, float& max, int& index)
+	{
+		const bool greater = value > max;
+		max = greater ? value : max;
+		index += (k - index) & -int(greater);
+	}
+
+	// y, index := maximum of the rows x cols window for each of n <= ChannelBlock channels and its position in the window, r * cols + c;
+	// the first of equal maxima wins
+	template<bool Indices> void __forceinline __max_window(
+		const int n,
+		const float* x,
+		const int rows,
+		const int cols,
+		const int xstride1,
+		const int xstride2,
+		float* y,
+		__int32* index)
+	{
+		if (n == 1 && xstride2 == 1)
+		{
+			// a single channel, the window rows are contiguous
+			const SIMDKernels& kernels = SIMDKernels::Current();
+
+			float max = x[0];
+			int k = 0;
+			for (int r = 0, kr = 0; r < rows; r++, kr += cols, x += xstride1)
+			{
+				const int c = kernels.argmax_f32(cols, x);
+				if (x[c] > max)
+				{
+					max = x[c];
+					k = kr + c;
+				}
+			}
+
+			y[0] = max;
+			if (Indices)
+			{
+				index[0] = k;
+			}
+		}
+		else
+		{
+			float max[ChannelBlock];
+			int k[ChannelBlock];
+			::memcpy(max, x, n * sizeof(float));
+			::memset(k, 0, n * sizeof(int));
+
+			for (int r = 0, kr = 0; r < rows; r++, kr += cols, x += xstride1)
+			{
+				for (int c = 0, off = 0; c < cols; c++, off += xstride2)
+				{
+					for (int i = 0; i < n; i++)
+					{
+						__max_select(x[off + i], kr + c, max[i], k[i]);
+					}
+				}
+			}
+
+			::memcpy(y, max, n * sizeof(float));
+			if (Indices)
+			{
+				::memcpy(index, k, n * sizeof(__int32));
+			}
+		}
+	}
+}
+
+// Adaptive average pooling to the output size given by yaxes.
+GENIXAPI(void, adaptive_avgpooling)(
+	const float* xw,
+	const int* xaxes,
+	const int* xstrides,
+	float* yw,
+	const int* yaxes,
+	const int* ystrides)
+{
+	const adaptive_pooling p(xaxes, xstrides, yaxes, ystrides);
+
+	p.run([&](int ix0, int c0, int c1, int iy1, int iy2, int b1, int e1, int b2, int e2)
+	{
+		__avg_window(
+			c1 - c0,
+			xw + p.xoffset(ix0, c0, b1, b2),
+			e1 - b1,
+			e2 - b2,
+			p.xstride1,
+			p.xstride2,
+			1.0f / float((e1 - b1) * (e2 - b2)),
+			yw + p.yoffset(ix0, c0, iy1, iy2));
+	});
+}
+
+// dx += dy / (window size) for every element of the window, see adaptive_avgpooling.
+GENIXAPI(void, adaptive_avgpooling_gradient)(
+	float* dxw,
+	const int* xaxes,
+	const int* xstrides,
+	const float* dyw,
+	const int* yaxes,
+	const int* ystrides)
+{
+	const adaptive_pooling p(xaxes, xstrides, yaxes, ystrides);
+
+	p.run([&](int ix0, int c0, int c1, int iy1, int iy2, int b1, int e1, int b2, int e2)
+	{
+		float alpha[ChannelBlock];
+		const float* dy = dyw + p.yoffset(ix0, c0, iy1, iy2);
+		const float scale = 1.0f / float((e1 - b1) * (e2 - b2));
+		for (int i = 0, n = c1 - c0; i < n; i++)
+		{
+			alpha[i] = dy[i] * scale;
+		}
+
+		__add_window(c1 - c0, alpha, e1 - b1, e2 - b2, p.xstride1, p.xstride2, dxw + p.xoffset(ix0, c0, b1, b2));
+	});
+}
+
+// Adaptive max pooling to the output size given by yaxes.
+// When indices is not null, it receives the position of every maximum in its window, (k1 * window size2) + k2,
+// in the layout of the output.
+GENIXAPI(void, adaptive_maxpooling)(
+	const float* xw,
+	const int* xaxes,
+	const int* xstrides,
+	float* yw,
+	const int* yaxes,
+	const int* ystrides,
+	__int32* indices)
+{
+	const adaptive_pooling p(xaxes, xstrides, yaxes, ystrides);
+
+	p.run([&](int ix0, int c0, int c1, int iy1, int iy2, int b1, int e1, int b2, int e2)
+	{
+		const float* x = xw + p.xoffset(ix0, c0, b1, b2);
+		const ptrdiff_t yoff = p.yoffset(ix0, c0, iy1, iy2);
+
+		if (indices != NULL)
+		{
+			__max_window<true>(c1 - c0, x, e1 - b1, e2 - b2, p.xstride1, p.xstride2, yw + yoff, indices + yoff);
+		}
+		else
+		{
+			__max_window<false>(c1 - c0, x, e1 - b1, e2 - b2, p.xstride1, p.xstride2, yw + yoff, NULL);
+		}
+	});
+}
+
+// dx += dy routed through the positions written by adaptive_maxpooling.
+GENIXAPI(void, adaptive_maxpooling_gradient)(
+	float* dxw,
+	const int* xaxes,
+	const int* xstrides,
+	const float* dyw,
+	const int* yaxes,
+	const int* ystrides,
+	const __int32* indices)
+{
+	const adaptive_pooling p(xaxes, xstrides, yaxes, ystrides);
+
+	p.run([&](int ix0, int c0, int c1, int iy1, int iy2, int b1, int e1, int b2, int e2)
+	{
+		float* dx = dxw + p.xoffset(ix0, c0, b1, b2);
+		const ptrdiff_t yoff = p.yoffset(ix0, c0, iy1, iy2);
+		const float* dy = dyw + yoff;
+		const __int32* index = indices + yoff;
+		const int cols = e2 - b2;
+
+		for (int i = 0, n = c1 - c0; i < n; i++)
+		{
+			const int k = index[i];
+			dx[(ptrdiff_t(k / cols) * p.xstride1) + (ptrdiff_t(k % cols) * p.xstride2) + i] += dy[i];
+		}
+	});
+}
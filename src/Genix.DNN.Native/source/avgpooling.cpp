@@ -1,8 +1,8 @@
 #include "stdafx.h"
 #include <stdlib.h>
 
-#include <ppl.h>
-using namespace concurrency;
+#include "scratch.h"
+#include "threadpool.h"
 
 #define MT
 
@@ -168,17 +168,6 @@ void __forceinline add_productc(const int n, const float* x, const float alpha,
 	}
 }
 
-template <typename _Index_type, typename _Function>
-void _parallel_for(_Index_type _First0, _Index_type _Last0, _Index_type _First1, _Index_type _Last1, const _Function& _Func, const auto_partitioner& _Part = auto_partitioner())
-{
-	_Index_type count = (_Last0 - _First0) * (_Last1 - _First1);
-	parallel_for(0, count, [&](_Index_type i) {
-		const _Index_type i0 = (i / (_Last1 - _First1)) + _First0;
-		const _Index_type i1 = (i % (_Last1 - _First1)) + _First1;
-		_Func(i0, i1);
-	}, _Part);
-}
-
 GENIXAPI(void, avgpooling)(
 	const int ksize1,
 	const int ksize2,
@@ -226,7 +215,7 @@ GENIXAPI(void, avgpooling)(
 	if (ksize1 == 2 && ksize2 == 2)
 	{
 #ifdef MT
-		_parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
+		parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
 		{
 #else
 		for (int ixy0 = 0; ixy0 < y0; ixy0++)
@@ -235,8 +224,8 @@ GENIXAPI(void, avgpooling)(
 			{
 #endif
 				const int ix1 = (iy1 * kstride1) - kpadding1;
-				const int ix1b = max(ix1, 0);
-				const int ix1e = min(ix1 + ksize1, x1);
+				const int ix1b = __max(ix1, 0);
+				const int ix1e = __min(ix1 + ksize1, x1);
 
 				const float* xww = xw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(ix1b) * xstride1);
 				float* yww = yw + (ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
@@ -246,18 +235,20 @@ GENIXAPI(void, avgpooling)(
 				int size1 = ix1e - ix1b;
 				if (size1 > 0)
 				{
+					// the rows of the window combined along the horizontal axis
+					scratch_buffer<float> buffer(size1 > 1 ? xstride1 : 0);
 					float* xww1 = NULL;
 					if (size1 > 1)
 					{
-						xww1 = new float[xstride1];
+						xww1 = buffer.data();
 						sum(xstride1, xww, xww + xstride1, xww1);
 					}
 
 					// add along vertical axis
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2, yww += ystride2)
 					{
-						const int ix2b = max(ix2, 0);
-						const int ix2e = min(ix2 + ksize2, x2);
+						const int ix2b = __max(ix2, 0);
+						const int ix2e = __min(ix2 + ksize2, x2);
 						const float* xww2 = (xww1 != NULL ? xww1 : xww) + (ptrdiff_t(ix2b) * xstride2);
 
 						switch (ix2e - ix2b)
@@ -273,11 +264,6 @@ GENIXAPI(void, avgpooling)(
 							break;
 						}
 					}
-
-					if (xww1 != NULL)
-					{
-						delete[] xww1;
-					}
 				}
 				else
 				{
@@ -293,7 +279,7 @@ GENIXAPI(void, avgpooling)(
 	else
 	{
 #ifdef MT
-		_parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
+		parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
 		{
 #else
 		for (int ixy0 = 0; ixy0 < y0; ixy0++)
@@ -302,8 +288,8 @@ GENIXAPI(void, avgpooling)(
 			{
 #endif
 				const int ix1 = (iy1 * kstride1) - kpadding1;
-				const int ix1b = max(ix1, 0);
-				const int ix1e = min(ix1 + ksize1, x1);
+				const int ix1b = __max(ix1, 0);
+				const int ix1e = __min(ix1 + ksize1, x1);
 
 				const float* xww = xw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(ix1b) * xstride1);
 				float* yww = yw + (ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
@@ -313,10 +299,12 @@ GENIXAPI(void, avgpooling)(
 				int size1 = ix1e - ix1b;
 				if (size1 > 0)
 				{
+					// the rows of the window combined along the horizontal axis
+					scratch_buffer<float> buffer(size1 > 1 ? xstride1 : 0);
 					float* xww1 = NULL;
 					if (size1 > 1)
 					{
-						xww1 = new float[xstride1];
+						xww1 = buffer.data();
 
 						switch (size1)
 						{
@@ -356,8 +344,8 @@ GENIXAPI(void, avgpooling)(
 					// add along vertical axis
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2, yww += ystride2)
 					{
-						const int ix2b = max(ix2, 0);
-						const int ix2e = min(ix2 + ksize2, x2);
+						const int ix2b = __max(ix2, 0);
+						const int ix2e = __min(ix2 + ksize2, x2);
 
 						int size2 = ix2e - ix2b;
 						if (size2 > 0)
@@ -410,11 +398,6 @@ GENIXAPI(void, avgpooling)(
 							::memset(yww, 0, ystride2 * sizeof(float));
 						}
 					}
-
-					if (xww1 != NULL)
-					{
-						delete[] xww1;
-					}
 				}
 				else
 				{
@@ -489,8 +472,8 @@ GENIXAPI(void, avgpooling_gradient)(
 			for (int ix0 = 0; ix0 < x0; ix0++, dyw0 += ystride0, dxw0 += xstride0)
 			{
 				const int ix1 = (iy1 * 2) - kpadding1;
-				const int kb1 = max(ix1, 0);
-				const int ke1 = min(ix1 + 2, x1);
+				const int kb1 = __max(ix1, 0);
+				const int ke1 = __min(ix1 + 2, x1);
 				float* dxw1 = dxw0 + (ptrdiff_t(kb1) * xstride1);
 				const float* dyw2 = dyw0;
 
@@ -499,8 +482,8 @@ GENIXAPI(void, avgpooling_gradient)(
 				case 2:
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += 2, dyw2 += ystride2)
 					{
-						const int kb2 = max(ix2, 0);
-						const int ke2 = min(ix2 + 2, x2);
+						const int kb2 = __max(ix2, 0);
+						const int ke2 = __min(ix2 + 2, x2);
 						float* dxw2 = dxw1 + (ptrdiff_t(kb2) * xstride2);
 
 						switch (ke2 - kb2)
@@ -519,8 +502,8 @@ GENIXAPI(void, avgpooling_gradient)(
 				case 1:
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += 2, dyw2 += ystride2)
 					{
-						const int kb2 = max(ix2, 0);
-						const int ke2 = min(ix2 + 2, x2);
+						const int kb2 = __max(ix2, 0);
+						const int ke2 = __min(ix2 + 2, x2);
 						float* dxw2 = dxw1 + (ptrdiff_t(kb2) * xstride2);
 
 						switch (ke2 - kb2)
@@ -559,15 +542,15 @@ GENIXAPI(void, avgpooling_gradient)(
 				for (int ix0 = 0; ix0 < x0; ix0++, dyw0 += ystride0, dxw0 += xstride0)
 				{
 					const int ix1 = (iy1 * kstride1) - kpadding1;
-					const int kb1 = max(ix1, 0);
-					const int ke1 = min(ix1 + ksize1, x1);
+					const int kb1 = __max(ix1, 0);
+					const int ke1 = __min(ix1 + ksize1, x1);
 					float* dxw2 = dxw0 + (ptrdiff_t(kb1) * xstride1);
 					const float* dyw2 = dyw0;
 
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2, dyw2 += ystride2)
 					{
-						const int kb2 = max(ix2, 0);
-						const int ke2 = min(ix2 + ksize2, x2);
+						const int kb2 = __max(ix2, 0);
+						const int ke2 = __min(ix2 + ksize2, x2);
 						float* dkxw1 = dxw2 + (ptrdiff_t(kb2) * xstride2);
 
 						// cycle by the kernel
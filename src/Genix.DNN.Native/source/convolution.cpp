@@ -1,11 +1,25 @@
 #include "stdafx.h"
-#include "mkl.h"
+#include "backend.h"
 
-#include <ppl.h>
-using namespace concurrency;
+#include "scratch.h"
+#include "simdkernels.h"
+#include "threadpool.h"
+#include "winograd.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #define MT
 
+// convolution algorithms, see ConvolutionAlgorithm in Genix.DNN
+#define CONVOLUTION_AUTO		0
+#define CONVOLUTION_GEMM		1
+#define CONVOLUTION_DIRECT		2
+#define CONVOLUTION_WINOGRAD2	3
+#define CONVOLUTION_WINOGRAD4	4
+#define CONVOLUTION_GEMM_BATCH	5
+
 void __forceinline tile(const int count, const int length, const float* src, float* dst, const int dststep)
 {
 	for (int i = 0; i < count; i++, dst += dststep)
@@ -14,18 +28,230 @@ void __forceinline tile(const int count, const int length, const float* src, flo
 	}
 }
 
-#ifdef MT
-template <typename _Index_type, typename _Function>
-void _parallel_for(_Index_type _First0, _Index_type _Last0, _Index_type _First1, _Index_type _Last1, const _Function& _Func, const auto_partitioner& _Part = auto_partitioner())
+// The matrix products of the forward pass of one layer shape, grouped for cblas_sgemm_batch.
+// The products are the same as in the GEMM algorithm: for every kernel column, image and output row
+// the kernel rows that overlap x times the columns of x they cover.
+// The plan is built once and executed by every call with the same shapes;
+// it keeps the offsets of the matrices and rebases them onto the tensors of the call.
+struct convolution_plan
 {
-	_Index_type count = (_Last0 - _First0) * (_Last1 - _First1);
-	parallel_for(0, count, [&](_Index_type i) {
-		const _Index_type i0 = (i / (_Last1 - _First1)) + _First0;
-		const _Index_type i1 = (i % (_Last1 - _First1)) + _First1;
-		_Func(i0, i1);
-	}, _Part);
+	std::mutex lock;
+
+	// the shapes the plan was built for
+	std::vector<int> key;
+
+	// the number of groups in each batch; there is a batch per kernel column,
+	// its products write to different outputs and the batches add to the same ones
+	std::vector<int> batches;
+
+	// the parameters of the groups of all batches
+	std::vector<CBLAS_TRANSPOSE> trans;
+	std::vector<int> m;
+	std::vector<int> n;
+	std::vector<int> k;
+	std::vector<int> lda;
+	std::vector<int> ldb;
+	std::vector<int> ldc;
+	std::vector<int> sizes;
+	std::vector<float> ones;
+
+	// the offsets of the matrices of all products from w, x and y and their addresses in the current call
+	std::vector<ptrdiff_t> aoffsets;
+	std::vector<ptrdiff_t> boffsets;
+	std::vector<ptrdiff_t> coffsets;
+	std::vector<const float*> a;
+	std::vector<const float*> b;
+	std::vector<float*> c;
+};
+
+namespace
+{
+	void convolution_plan_build(
+		convolution_plan& plan,
+		const int ksize1,
+		const int kstride1,
+		const int kpadding1,
+		const int ksize2,
+		const int kstride2,
+		const int kpadding2,
+		const int x1,
+		const int x2,
+		const int xstride0,
+		const int xstride1,
+		const int xstride2,
+		const int y0,
+		const int y1,
+		const int y2,
+		const int y3,
+		const int ystride0,
+		const int ystride1,
+		const int ystride2)
+	{
+		const int ldw = y3;
+		const int ldx = kstride1 * xstride1;
+		const int ldy = ystride1;
+		const int kstep = ksize2 * xstride2 * ldw;
+
+		plan.batches.clear();
+		plan.trans.clear();
+		plan.m.clear();
+		plan.n.clear();
+		plan.k.clear();
+		plan.lda.clear();
+		plan.ldb.clear();
+		plan.ldc.clear();
+		plan.sizes.clear();
+		plan.aoffsets.clear();
+		plan.boffsets.clear();
+		plan.coffsets.clear();
+
+		// the number of kernel rows that overlap x for every output row
+		std::vector<int> ks(y2);
+		for (int iy2 = 0; iy2 < y2; iy2++)
+		{
+			const int ix2 = (iy2 * kstride2) - kpadding2;
+			ks[iy2] = __min(ix2 + ksize2, x2) - __max(ix2, 0);
+		}
+
+		for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
+		{
+			const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
+			const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
+			const int n = __min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+
+			if (n <= 0)
+			{
+				continue;
+			}
+
+			// the output rows are grouped by the number of kernel rows,
+			// the rows near the borders have fewer of them
+			int groups = 0;
+			for (int kk = 1; kk <= ksize2; kk++)
+			{
+				const size_t first = plan.aoffsets.size();
+
+				for (int iy2 = 0; iy2 < y2; iy2++)
+				{
+					if (ks[iy2] == kk)
+					{
+						const int ix2 = (iy2 * kstride2) - kpadding2;
+
+						for (int ixy0 = 0; ixy0 < y0; ixy0++)
+						{
+							plan.aoffsets.push_back((ptrdiff_t(ixy1) * kstep) + (ptrdiff_t(__max(-ix2, 0)) * xstride2 * ldw));
+							plan.boffsets.push_back((ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(ix1) * xstride1) + (ptrdiff_t(__max(ix2, 0)) * xstride2));
+							plan.coffsets.push_back((ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(iy1) * ystride1));
+						}
+					}
+				}
+
+				if (plan.aoffsets.size() > first)
+				{
+					plan.trans.push_back(CblasNoTrans);
+					plan.m.push_back(y3);
+					plan.n.push_back(n);
+					plan.k.push_back(kk * xstride2);
+					plan.lda.push_back(ldw);
+					plan.ldb.push_back(ldx);
+					plan.ldc.push_back(ldy);
+					plan.sizes.push_back(int(plan.aoffsets.size() - first));
+					groups++;
+				}
+			}
+
+			if (groups > 0)
+			{
+				plan.batches.push_back(groups);
+			}
+		}
+
+		plan.ones.assign(plan.sizes.size(), 1.0f);
+		plan.a.resize(plan.aoffsets.size());
+		plan.b.resize(plan.boffsets.size());
+		plan.c.resize(plan.coffsets.size());
+	}
+
+	void convolution_plan_execute(
+		convolution_plan& plan,
+		const float* ww,
+		const float* xw,
+		float* yw)
+	{
+		for (size_t i = 0, ii = plan.a.size(); i < ii; i++)
+		{
+			plan.a[i] = ww + plan.aoffsets[i];
+			plan.b[i] = xw + plan.boffsets[i];
+			plan.c[i] = yw + plan.coffsets[i];
+		}
+
+		for (size_t ibatch = 0, g = 0, i = 0; ibatch < plan.batches.size(); ibatch++)
+		{
+			const int groups = plan.batches[ibatch];
+
+			::cblas_sgemm_batch(
+				CblasColMajor, &plan.trans[g], &plan.trans[g],
+				&plan.m[g], &plan.n[g], &plan.k[g],
+				&plan.ones[g],
+				&plan.a[i], &plan.lda[g],
+				&plan.b[i], &plan.ldb[g],
+				&plan.ones[g],
+				&plan.c[i], &plan.ldc[g],
+				groups, &plan.sizes[g]);
+
+			for (int ig = 0; ig < groups; ig++, g++)
+			{
+				i += plan.sizes[g];
+			}
+		}
+	}
+}
+
+// Chooses the algorithm for the forward pass; the input gradient follows it when the choice is Winograd.
+// The direct kernels keep the sums of a block of output columns in registers for the whole kernel,
+// so they win over the small matrix products the layers with few filters are split into.
+// The wide layers, where each block of filters streams the input again, are left to BLAS.
+// Winograd transforms apply only to 3x3 kernels with stride 1; they pay off when there are enough channels
+// to amortize the transforms of the tiles, which on AVX2 starts at about 16 input channels and 32 filters.
+int __forceinline convolution_algorithm(
+	const int algorithm,
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	const int channels,
+	const int filters)
+{
+	const int floats = SIMDKernels::Current().floats;
+	const bool winograd = ksize1 == 3 && ksize2 == 3 && kstride1 == 1 && kstride2 == 1;
+
+	switch (algorithm)
+	{
+	case CONVOLUTION_GEMM:
+	case CONVOLUTION_DIRECT:
+	case CONVOLUTION_GEMM_BATCH:
+		return algorithm;
+
+	case CONVOLUTION_WINOGRAD2:
+	case CONVOLUTION_WINOGRAD4:
+		if (winograd)
+		{
+			return algorithm;
+		}
+
+		break;
+
+	default:
+		if (winograd && floats >= 8 && channels >= 16 && filters >= 32 && channels * filters >= 2048)
+		{
+			return CONVOLUTION_WINOGRAD2;
+		}
+
+		break;
+	}
+
+	return floats >= 8 && filters <= 8 * floats ? CONVOLUTION_DIRECT : CONVOLUTION_GEMM;
 }
-#endif
 
 GENIXAPI(void, convolution)(
 	const int ksize1,
@@ -43,7 +269,10 @@ GENIXAPI(void, convolution)(
 	const int* xstrides,
 	float* yw,
 	const int* yaxes,
-	const int* ystrides)
+	const int* ystrides,
+	int algorithm,
+	winograd_filters* filters,
+	convolution_plan* plan)
 {
 	const int w0 = waxes[0];
 	const int w1 = waxes[1];
@@ -70,53 +299,8 @@ GENIXAPI(void, convolution)(
 	const int ldy = ystride1;
 	const int kstep = ksize2 * xstride2 * ldw;
 
-	/*if (kstride1 == 1 && kstride2 == 1 && kpadding1 == 0 && kpadding2 == 0)
-	{
-		// 1. initialize destination tensor with biases
-		tile(y0 * y1 * y2, y3, bw, yw, y3);
-
-		const int k = ksize2 * xstride2;
-		const int n = y1;
-
-		const int group_size = y2 * y0;
-		const float** A_Array = (const float**)::alloca(group_size * sizeof(const float*));
-		const float** B_Array = (const float**)::alloca(group_size * sizeof(const float*));
-		float** C_Array = (float**)::alloca(group_size * sizeof(const float*));
+	algorithm = convolution_algorithm(algorithm, ksize1, ksize2, kstride1, kstride2, xaxes[3], y3);
 
-		for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
-		{
-			for (int iy2 = 0, i = 0; iy2 < y2; iy2++)
-			{
-				const int ix2 = iy2 * kstride2;
-
-				const float* www = ww + (ptrdiff_t(ixy1) * kstep);
-				const float* xww = xw + (ptrdiff_t(ixy1) * xstride1) + (ptrdiff_t(ix2) * xstride2);
-				float* yww = yw + (ptrdiff_t(iy2) * ystride2);
-
-				for (int ixy0 = 0; ixy0 < x0; ixy0++, xww += xstride0, yww += ystride0)
-				{
-					A_Array[i] = www;
-					B_Array[i] = xww;
-					C_Array[i] = yww;
-					i++;
-				}
-			}
-
-			CBLAS_TRANSPOSE trans = CblasNoTrans;
-			const float alpha_beta = 1.0f;
-
-			::cblas_sgemm_batch(
-				CblasColMajor, &trans, &trans,
-				&y3, &n, &k,
-				&alpha_beta,
-				A_Array, &ldw,
-				B_Array, &ldx,
-				&alpha_beta,
-				C_Array, &ldy,
-				1, &group_size);
-		}
-	}
-	else*/
 	{
 		// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
 		if (kpadding1 < 0)
@@ -133,8 +317,97 @@ GENIXAPI(void, convolution)(
 			kpadding2 = 0;
 		}
 
+		if (algorithm == CONVOLUTION_WINOGRAD2 || algorithm == CONVOLUTION_WINOGRAD4)
+		{
+			const int m = algorithm == CONVOLUTION_WINOGRAD2 ? 2 : 4;
+
+			std::vector<float> buffer;
+			const float* u = winograd_transform_filters(filters, m, xaxes[3], y3, ww, false, buffer);
+
+			for (int ixy0 = 0; ixy0 < y0; ixy0++)
+			{
+				for (int iy2 = 0; iy2 < y2; iy2++)
+				{
+					tile(y1, y3, bw, yw + (ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy2) * ystride2), ldy);
+				}
+			}
+
+			winograd_convolution(
+				m,
+				u,
+				y0,
+				xaxes[3],
+				y3,
+				xw,
+				x1,
+				x2,
+				xstride0,
+				xstride1,
+				xstride2,
+				yw,
+				y1,
+				y2,
+				ystride0,
+				ystride1,
+				ystride2,
+				kpadding1,
+				kpadding2);
+
+			return;
+		}
+
+		if (algorithm == CONVOLUTION_GEMM_BATCH)
+		{
+			// 1. initialize destination tensor with biases
+			for (int ixy0 = 0; ixy0 < y0; ixy0++)
+			{
+				for (int iy2 = 0; iy2 < y2; iy2++)
+				{
+					tile(y1, y3, bw, yw + (ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy2) * ystride2), ldy);
+				}
+			}
+
+			// 2. add matrix products to destination
+			// the plan is shared by the calls of one layer, a concurrent call builds its own
+			const std::vector<int> key =
+			{
+				ksize1, ksize2, kstride1, kstride2, kpadding1, kpadding2,
+				x1, x2, xstride0, xstride1, xstride2,
+				y0, y1, y2, y3, ystride0, ystride1, ystride2,
+			};
+
+			std::unique_lock<std::mutex> lock;
+			std::unique_ptr<convolution_plan> local;
+
+			if (plan != NULL)
+			{
+				lock = std::unique_lock<std::mutex>(plan->lock, std::try_to_lock);
+			}
+
+			if (!lock.owns_lock())
+			{
+				local.reset(new convolution_plan());
+				plan = local.get();
+			}
+
+			if (plan->key != key)
+			{
+				plan->key = key;
+
+				convolution_plan_build(
+					*plan,
+					ksize1, kstride1, kpadding1,
+					ksize2, kstride2, kpadding2,
+					x1, x2, xstride0, xstride1, xstride2,
+					y0, y1, y2, y3, ystride0, ystride1, ystride2);
+			}
+
+			convolution_plan_execute(*plan, ww, xw, yw);
+			return;
+		}
+
 #ifdef MT
-		_parallel_for(0, y0, 0, y2, [&](int ixy0, int iy2)
+		parallel_for(0, y0, 0, y2, [&](int ixy0, int iy2)
 		{
 #else
 		for (int ixy0 = 0; ixy0 < y0; ixy0++)
@@ -151,32 +424,70 @@ GENIXAPI(void, convolution)(
 
 				// 2. add matrix product to destination
 				const int ix2 = (iy2 * kstride2) - kpadding2;
-				const int ix2e = min(ix2 + ksize2, x2);
-				const int k = (ix2e - max(ix2, 0)) * xstride2;
+				const int ix2e = __min(ix2 + ksize2, x2);
+				const int k = (ix2e - __max(ix2, 0)) * xstride2;
 
 				// k may be zero if the current portion of input tensor
 				// is completely in the padding area
 				if (k > 0)
 				{
-					xww += ptrdiff_t(max(ix2, 0)) * xstride2;
-					www += ptrdiff_t(max(-ix2, 0)) * xstride2 * ldw;
+					xww += ptrdiff_t(__max(ix2, 0)) * xstride2;
+					www += ptrdiff_t(__max(-ix2, 0)) * xstride2 * ldw;
 
-					for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
+					if (algorithm == CONVOLUTION_DIRECT)
 					{
-						const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
-						const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
-						const int n = min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+						const SIMDKernels& kernels = SIMDKernels::Current();
+
+						// the output columns whose kernel lies entirely inside x are computed in one pass,
+						// the columns near the borders use only the kernel columns that overlap x
+						const int iy1first = (kpadding1 + kstride1 - 1) / kstride1;
+						const int iy1last = x1 + kpadding1 >= ksize1 ? __min(y1 - 1, (x1 + kpadding1 - ksize1) / kstride1) : -1;
 
-						if (n > 0)
+						for (int iy1 = 0; iy1 < y1; iy1++)
 						{
-							::cblas_sgemm(
-								CblasColMajor, CblasNoTrans, CblasNoTrans,
-								y3, n, k,
-								1.0f,
-								www + (ptrdiff_t(ixy1) * kstep), ldw,
-								xww + (ptrdiff_t(ix1) * xstride1), ldx,
-								1.0f,
-								yww + (ptrdiff_t(iy1) * ystride1), ldy);
+							if (iy1 == iy1first && iy1first <= iy1last)
+							{
+								kernels.conv_direct(
+									iy1last - iy1first + 1, y3, ksize1, k,
+									www, kstep,
+									xww + (ptrdiff_t((iy1 * kstride1) - kpadding1) * xstride1), ldx, xstride1,
+									yww + (ptrdiff_t(iy1) * ystride1), ldy);
+
+								iy1 = iy1last;
+								continue;
+							}
+
+							const int ixy1 = __max(kpadding1 - (iy1 * kstride1), 0);
+							const int ixy1e = __min(ksize1, x1 + kpadding1 - (iy1 * kstride1));
+							if (ixy1 < ixy1e)
+							{
+								kernels.conv_direct(
+									1, y3, ixy1e - ixy1, k,
+									www + (ptrdiff_t(ixy1) * kstep), kstep,
+									xww + (ptrdiff_t((iy1 * kstride1) - kpadding1 + ixy1) * xstride1), ldx, xstride1,
+									yww + (ptrdiff_t(iy1) * ystride1), ldy);
+							}
+						}
+					}
+					else
+					{
+						for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
+						{
+							const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
+							const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
+							const int n = __min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+
+							if (n > 0)
+							{
+								::cblas_sgemm(
+									CblasColMajor, CblasNoTrans, CblasNoTrans,
+									y3, n, k,
+									1.0f,
+									www + (ptrdiff_t(ixy1) * kstep), ldw,
+									xww + (ptrdiff_t(ix1) * xstride1), ldx,
+									1.0f,
+									yww + (ptrdiff_t(iy1) * ystride1), ldy);
+							}
 						}
 					}
 				}
@@ -207,7 +518,9 @@ GENIXAPI(void, convolution_gradient)(
 	const int* xstrides,
 	const float* dyw,
 	const int* yaxes,
-	const int* ystrides)
+	const int* ystrides,
+	int algorithm,
+	winograd_filters* filters)
 {
 	const int w0 = waxes[0];
 	const int w1 = waxes[1];
@@ -234,6 +547,8 @@ GENIXAPI(void, convolution_gradient)(
 	const int ldy = ystride1;
 	const int kstep = ksize2 * xstride2 * ldw;
 
+	algorithm = convolution_algorithm(algorithm, ksize1, ksize2, kstride1, kstride2, xaxes[3], y3);
+
 	// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
 	if (kpadding1 < 0)
 	{
@@ -266,53 +581,74 @@ GENIXAPI(void, convolution_gradient)(
 		[&]
 #endif
 		{
-			// 1. Calculate biases gradient
-			const int n = y0 * y1 * y2;
-			float* ones = new float[n];
-			for (int i = 0; i < n; i++) { ones[i] = 1.0f; }
-
-			::cblas_sgemv(
-				CblasColMajor, CblasNoTrans,
-				y3, n,
-				1.0f,
-				dyw, y3,
-				ones, 1,
-				1.0f,
-				dbw, 1);
-
-			delete[] ones;
-		}
-#ifdef MT
-		, [&]
-#endif
-		{
-			// 2. Calculate weights gradient
+			// 1. Calculate weights and biases gradients
+			// the images and output rows are split into parts, one per thread, that add their gradients into separate buffers;
+			// the first part adds into dw and db, and the buffers of the other parts are then added up in pairs
+			const int items = y0 * y2;
+			const int parts = __max(1, __min(items, ::threadpool_get_threads()));
+			const ptrdiff_t wsize = ptrdiff_t(ksize1) * kstep;
+			const ptrdiff_t partsize = wsize + y3;
+
+			scratch_buffer<float> buffer(size_t(parts - 1) * partsize);
+			float* partials = buffer.data();
+			::memset(partials, 0, size_t(parts - 1) * partsize * sizeof(float));
+
+			auto partial = [&](int part, float*& dwpart, float*& dbpart)
+			{
+				if (part == 0)
+				{
+					dwpart = dww;
+					dbpart = dbw;
+				}
+				else
+				{
+					dwpart = partials + (ptrdiff_t(part - 1) * partsize);
+					dbpart = dwpart + wsize;
+				}
+			};
+
 #ifdef MT
-			parallel_for(0, ksize1, [&](int ixy1)
+			parallel_for(0, parts, [&](int part)
 #else
-			for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
+			for (int part = 0; part < parts; part++)
 #endif
 			{
-				float* dwww = dww + (ptrdiff_t(ixy1) * kstep);
-				const float* xww = xw;
+				float* dwpart;
+				float* dbpart;
+				partial(part, dwpart, dbpart);
 
-				for (int ixy0 = 0; ixy0 < y0; ixy0++, xww += xstride0)
+				for (int item = int((ptrdiff_t(part) * items) / parts), end = int((ptrdiff_t(part + 1) * items) / parts); item < end; item++)
 				{
-					for (int iy2 = 0; iy2 < y2; iy2++)
+					const int ixy0 = item / y2;
+					const int iy2 = item % y2;
+
+					const float* xww = xw + (ptrdiff_t(ixy0) * xstride0);
+					const float* dyww = dyw + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(ixy0) * ystride0);
+
+					// biases gradient
+					for (int iy1 = 0; iy1 < y1; iy1++)
 					{
-						const float* dyww = dyw + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(ixy0) * ystride0);
+						const float* dyy = dyww + (ptrdiff_t(iy1) * ystride1);
+						for (int i = 0; i < y3; i++)
+						{
+							dbpart[i] += dyy[i];
+						}
+					}
 
-						const int ix2 = (iy2 * kstride2) - kpadding2;
-						const int ix2e = min(ix2 + ksize2, x2);
-						const int k = (ix2e - max(ix2, 0)) * xstride2;
+					// weights gradient
+					const int ix2 = (iy2 * kstride2) - kpadding2;
+					const int ix2e = __min(ix2 + ksize2, x2);
+					const int k = (ix2e - __max(ix2, 0)) * xstride2;
 
-						// k may be zero if the current portion of input tensor
-						// is completely in the padding area
-						if (k > 0)
+					// k may be zero if the current portion of input tensor
+					// is completely in the padding area
+					if (k > 0)
+					{
+						for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
 						{
 							const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
 							const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
-							const int n = min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+							const int n = __min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
 
 							if (n > 0)
 							{
@@ -321,9 +657,9 @@ GENIXAPI(void, convolution_gradient)(
 									y3, k, n,
 									1.0f,
 									dyww + (ptrdiff_t(iy1) * ystride1), ldy,
-									xww + (ptrdiff_t(ix1) * xstride1) + (ptrdiff_t(max(ix2, 0)) * xstride2), ldx,
+									xww + (ptrdiff_t(ix1) * xstride1) + (ptrdiff_t(__max(ix2, 0)) * xstride2), ldx,
 									1.0f,
-									dwww + (ptrdiff_t(max(-ix2, 0)) * xstride2 * ldw), ldw);
+									dwpart + (ptrdiff_t(ixy1) * kstep) + (ptrdiff_t(__max(-ix2, 0)) * xstride2 * ldw), ldw);
 							}
 						}
 					}
@@ -333,13 +669,67 @@ GENIXAPI(void, convolution_gradient)(
 #else
 			}
 #endif
+
+			// add up the parts, the sums of the pairs at distance step go to the first part of each pair
+			for (int step = 1; step < parts; step *= 2)
+			{
+#ifdef MT
+				parallel_for(0, parts - step, 2 * step, [&](int part)
+#else
+				for (int part = 0; part < parts - step; part += 2 * step)
+#endif
+				{
+					float* dwpart;
+					float* dbpart;
+					partial(part, dwpart, dbpart);
+
+					float* dwnext;
+					float* dbnext;
+					partial(part + step, dwnext, dbnext);
+
+					::cblas_saxpy(int(wsize), 1.0f, dwnext, 1, dwpart, 1);
+					::cblas_saxpy(y3, 1.0f, dbnext, 1, dbpart, 1);
+				}
+#ifdef MT
+				);
+#endif
+			}
 		}
 #ifdef MT
-			, [&]
+		, [&]
 #endif
 		{
-			// 3. Calculate x gradient
-			if (dxw != NULL)
+			// 2. Calculate x gradient
+			if (dxw != NULL && (algorithm == CONVOLUTION_WINOGRAD2 || algorithm == CONVOLUTION_WINOGRAD4))
+			{
+				// the gradient is the convolution of dy with the rotated kernels
+				const int m = algorithm == CONVOLUTION_WINOGRAD2 ? 2 : 4;
+
+				std::vector<float> buffer;
+				const float* u = winograd_transform_filters(filters, m, xaxes[3], y3, ww, true, buffer);
+
+				winograd_convolution(
+					m,
+					u,
+					y0,
+					y3,
+					xaxes[3],
+					dyw,
+					y1,
+					y2,
+					ystride0,
+					ystride1,
+					ystride2,
+					dxw,
+					x1,
+					x2,
+					xstride0,
+					xstride1,
+					xstride2,
+					2 - kpadding1,
+					2 - kpadding2);
+			}
+			else if (dxw != NULL)
 			{
 				const int iy2step = (ksize2 + kstride2 - 1) / kstride2;
 				for (int iy2start = 0; iy2start < iy2step; iy2start++)
@@ -357,21 +747,21 @@ GENIXAPI(void, convolution_gradient)(
 							const float* dyww = dyw + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(ixy0) * ystride0);
 
 							const int ix2 = (iy2 * kstride2) - kpadding2;
-							const int ix2e = min(ix2 + ksize2, x2);
-							const int k = (ix2e - max(ix2, 0)) * xstride2;
+							const int ix2e = __min(ix2 + ksize2, x2);
+							const int k = (ix2e - __max(ix2, 0)) * xstride2;
 
 							// k may be zero if the current portion of input tensor
 							// is completely in the padding area
 							if (k > 0)
 							{
-								dxww += ptrdiff_t(max(ix2, 0)) * xstride2;
-								www += ptrdiff_t(max(-ix2, 0)) * xstride2 * ldw;
+								dxww += ptrdiff_t(__max(ix2, 0)) * xstride2;
+								www += ptrdiff_t(__max(-ix2, 0)) * xstride2 * ldw;
 
 								for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
 								{
 									const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
 									const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
-									const int n = min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+									const int n = __min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
 
 									if (n > 0)
 									{
@@ -400,3 +790,14 @@ GENIXAPI(void, convolution_gradient)(
 #endif
 }
 
+// Creates an empty plan of the forward pass of a convolution layer, the first call that uses it builds it.
+GENIXAPI(convolution_plan*, convolution_plan_create)()
+{
+	return new convolution_plan();
+}
+
+GENIXAPI(void, convolution_plan_free)(
+	convolution_plan* plan)
+{
+	delete plan;
+}
@@ -0,0 +1,482 @@
+#include "stdafx.h"
+#include "backend.h"
+
+#include "scratch.h"
+#include "simdkernels.h"
+#include "threadpool.h"
+
+#include <vector>
+
+#define MT
+
+// Grouped convolution: the channels and the filters are split into groups,
+// and the filters of a group see only the channels of the same group.
+// The weights of filter f in group g = f / (F / groups) are the weights of a dense convolution with C / groups channels,
+// element (kx, ky, c, f) is at ((kx * ksize2 + ky) * (C / groups) + c) * F + f.
+//
+// Depthwise convolution is the grouped convolution with one channel and one filter in each group.
+// Its weights are a kernel per channel, element (kx, ky, c) is at (kx * ksize2 + ky) * C + c,
+// and it is computed by the vectorized per-channel kernels. The forward pass of the other groups uses the direct convolution kernels,
+// the gradients are computed by matrix products.
+
+namespace
+{
+	void __forceinline tile(const int count, const int length, const float* src, float* dst, const int dststep)
+	{
+		for (int i = 0; i < count; i++, dst += dststep)
+		{
+			memcpy(dst, src, length * sizeof(float));
+		}
+	}
+}
+
+GENIXAPI(void, group_convolution)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	const int groups,
+	const float* ww,
+	const float* bw,
+	const int* waxes,
+	const int* wstrides,
+	const float* xw,
+	const int* xaxes,
+	const int* xstrides,
+	float* yw,
+	const int* yaxes,
+	const int* ystrides)
+{
+	int x1 = xaxes[1];
+	int x2 = xaxes[2];
+	const int x3 = xaxes[3];	// number of channels
+	const int xstride0 = xstrides[0];
+	const int xstride1 = xstrides[1];
+	const int xstride2 = xstrides[2];
+
+	const int y0 = yaxes[0];
+	const int y1 = yaxes[1];
+	const int y2 = yaxes[2];
+	const int y3 = yaxes[3];	// number of filters
+	const int ystride0 = ystrides[0];
+	const int ystride1 = ystrides[1];
+	const int ystride2 = ystrides[2];
+
+	const int cg = x3 / groups;
+	const int fg = y3 / groups;
+	const bool depthwise = cg == 1 && fg == 1;
+
+	const int ldw = y3;
+	const int ldx = kstride1 * xstride1;
+	const int ldy = ystride1;
+	const int kstep = ksize2 * cg * ldw;
+
+	// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
+	if (kpadding1 < 0)
+	{
+		xw += -ptrdiff_t(kpadding1) * xstride1;
+		x1 += 2 * kpadding1;
+		kpadding1 = 0;
+	}
+
+	if (kpadding2 < 0)
+	{
+		xw += -ptrdiff_t(kpadding2) * xstride2;
+		x2 += 2 * kpadding2;
+		kpadding2 = 0;
+	}
+
+	// the weights of each group are packed into a dense convolution with cg channels and fg filters
+	// element (kx, ky, c, f) of group g is at (((g * ksize1 + kx) * ksize2 + ky) * cg + c) * fg + f
+	const int gkstep = ksize2 * cg * fg;
+	const ptrdiff_t gsize = ptrdiff_t(ksize1) * gkstep;
+
+	thread_local std::vector<float> packed;
+	if (!depthwise)
+	{
+		packed.resize(size_t(groups) * gsize);
+		for (int g = 0; g < groups; g++)
+		{
+			for (int i = 0, ii = ksize1 * ksize2 * cg; i < ii; i++)
+			{
+				memcpy(packed.data() + (g * gsize) + (ptrdiff_t(i) * fg), ww + (ptrdiff_t(i) * ldw) + (ptrdiff_t(g) * fg), fg * sizeof(float));
+			}
+		}
+	}
+
+	const float* pw = packed.data();
+
+#ifdef MT
+	parallel_for(0, y0, 0, y2, [&](int ixy0, int iy2)
+	{
+#else
+	for (int ixy0 = 0; ixy0 < y0; ixy0++)
+	{
+		for (int iy2 = 0; iy2 < y2; iy2++)
+		{
+#endif
+			const SIMDKernels& kernels = SIMDKernels::Current();
+
+			float* yww = yw + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(ixy0) * ystride0);
+
+			// 1. initialize destination tensor with biases
+			tile(y1, y3, bw, yww, ldy);
+
+			// 2. add the convolution of the kernel rows that overlap x
+			const int ix2 = (iy2 * kstride2) - kpadding2;
+			const int ly = __max(-ix2, 0);
+			const int ky = __min(ix2 + ksize2, x2) - __max(ix2, 0);
+
+			if (ky > 0)
+			{
+				const float* xww = xw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(__max(ix2, 0)) * xstride2);
+
+				// n output columns starting at iy1 with the kernel columns [ixy1, ixy1 + kx)
+				auto convolve = [&](int n, int iy1, int ixy1, int kx)
+				{
+					const float* xcol = xww + (ptrdiff_t((iy1 * kstride1) - kpadding1 + ixy1) * xstride1);
+					float* ycol = yww + (ptrdiff_t(iy1) * ystride1);
+
+					if (depthwise)
+					{
+						kernels.conv_depthwise(
+							n, y3, kx, ky,
+							ww + (ptrdiff_t(ixy1) * kstep) + (ptrdiff_t(ly) * ldw), kstep,
+							xcol, ldx, xstride1, xstride2,
+							ycol, ldy);
+					}
+					else
+					{
+						for (int g = 0; g < groups; g++)
+						{
+							for (int l = 0; l < ky; l++)
+							{
+								kernels.conv_direct(
+									n, fg, kx, cg,
+									pw + (g * gsize) + (ptrdiff_t(ixy1) * gkstep) + (ptrdiff_t(ly + l) * cg * fg), gkstep,
+									xcol + (ptrdiff_t(l) * xstride2) + (ptrdiff_t(g) * cg), ldx, xstride1,
+									ycol + (ptrdiff_t(g) * fg), ldy);
+							}
+						}
+					}
+				};
+
+				// the output columns whose kernel lies entirely inside x are computed in one pass,
+				// the columns near the borders use only the kernel columns that overlap x
+				const int iy1first = (kpadding1 + kstride1 - 1) / kstride1;
+				const int iy1last = x1 + kpadding1 >= ksize1 ? __min(y1 - 1, (x1 + kpadding1 - ksize1) / kstride1) : -1;
+
+				for (int iy1 = 0; iy1 < y1; iy1++)
+				{
+					if (iy1 == iy1first && iy1first <= iy1last)
+					{
+						convolve(iy1last - iy1first + 1, iy1, 0, ksize1);
+						iy1 = iy1last;
+						continue;
+					}
+
+					const int ixy1 = __max(kpadding1 - (iy1 * kstride1), 0);
+					const int ixy1e = __min(ksize1, x1 + kpadding1 - (iy1 * kstride1));
+					if (ixy1 < ixy1e)
+					{
+						convolve(1, iy1, ixy1, ixy1e - ixy1);
+					}
+				}
+			}
+#ifdef MT
+	});
+#else
+		}
+	}
+#endif
+}
+
+GENIXAPI(void, group_convolution_gradient)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	const int groups,
+	const float* ww,
+	float* dww,
+	float* dbw,
+	const int* waxes,
+	const int* wstrides,
+	const float* xw,
+	float* dxw,
+	const int* xaxes,
+	const int* xstrides,
+	const float* dyw,
+	const int* yaxes,
+	const int* ystrides)
+{
+	int x1 = xaxes[1];
+	int x2 = xaxes[2];
+	const int x3 = xaxes[3];	// number of channels
+	const int xstride0 = xstrides[0];
+	const int xstride1 = xstrides[1];
+	const int xstride2 = xstrides[2];
+
+	const int y0 = yaxes[0];
+	const int y1 = yaxes[1];
+	const int y2 = yaxes[2];
+	const int y3 = yaxes[3];	// number of filters
+	const int ystride0 = ystrides[0];
+	const int ystride1 = ystrides[1];
+	const int ystride2 = ystrides[2];
+
+	const int cg = x3 / groups;
+	const int fg = y3 / groups;
+	const bool depthwise = cg == 1 && fg == 1;
+
+	const int ldw = y3;
+	const int ldx = kstride1 * xstride1;
+	const int ldy = ystride1;
+	const int kstep = ksize2 * cg * ldw;
+
+	// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
+	if (kpadding1 < 0)
+	{
+		const int off = -ptrdiff_t(kpadding1) * xstride1;
+		xw += off;
+		if (dxw != NULL)
+		{
+			dxw += off;
+		}
+
+		x1 += 2 * kpadding1;
+		kpadding1 = 0;
+	}
+
+	if (kpadding2 < 0)
+	{
+		const int off = -ptrdiff_t(kpadding2) * xstride2;
+		xw += off;
+		if (dxw != NULL)
+		{
+			dxw += off;
+		}
+
+		x2 += 2 * kpadding2;
+		kpadding2 = 0;
+	}
+
+#ifdef MT
+	parallel_invoke(
+		[&]
+#endif
+		{
+			// 1. Calculate weights and biases gradients
+			// the images and output rows are split into parts, one per thread, that add their gradients into separate buffers;
+			// the first part adds into dw and db, and the buffers of the other parts are then added up in pairs
+			const int items = y0 * y2;
+			const int parts = __max(1, __min(items, ::threadpool_get_threads()));
+			const ptrdiff_t wsize = ptrdiff_t(ksize1) * kstep;
+			const ptrdiff_t partsize = wsize + y3;
+
+			scratch_buffer<float> buffer(size_t(parts - 1) * partsize);
+			float* partials = buffer.data();
+			::memset(partials, 0, size_t(parts - 1) * partsize * sizeof(float));
+
+			auto partial = [&](int part, float*& dwpart, float*& dbpart)
+			{
+				if (part == 0)
+				{
+					dwpart = dww;
+					dbpart = dbw;
+				}
+				else
+				{
+					dwpart = partials + (ptrdiff_t(part - 1) * partsize);
+					dbpart = dwpart + wsize;
+				}
+			};
+
+#ifdef MT
+			parallel_for(0, parts, [&](int part)
+#else
+			for (int part = 0; part < parts; part++)
+#endif
+			{
+				const SIMDKernels& kernels = SIMDKernels::Current();
+
+				float* dwpart;
+				float* dbpart;
+				partial(part, dwpart, dbpart);
+
+				for (int item = int((ptrdiff_t(part) * items) / parts), end = int((ptrdiff_t(part + 1) * items) / parts); item < end; item++)
+				{
+					const int ixy0 = item / y2;
+					const int iy2 = item % y2;
+
+					const float* dyww = dyw + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(ixy0) * ystride0);
+
+					// biases gradient
+					for (int iy1 = 0; iy1 < y1; iy1++)
+					{
+						const float* dyy = dyww + (ptrdiff_t(iy1) * ystride1);
+						for (int i = 0; i < y3; i++)
+						{
+							dbpart[i] += dyy[i];
+						}
+					}
+
+					// weights gradient of the kernel rows that overlap x
+					const int ix2 = (iy2 * kstride2) - kpadding2;
+					const int ky = __min(ix2 + ksize2, x2) - __max(ix2, 0);
+
+					if (ky > 0)
+					{
+						float* dwww = dwpart + (ptrdiff_t(__max(-ix2, 0)) * cg * ldw);
+						const float* xww = xw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(__max(ix2, 0)) * xstride2);
+
+						for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
+						{
+							const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
+							const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
+							const int n = __min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+
+							if (n > 0)
+							{
+								if (depthwise)
+								{
+									kernels.conv_depthwise_dw(
+										n, y3, 1, ky,
+										dwww + (ptrdiff_t(ixy1) * kstep), kstep,
+										xww + (ptrdiff_t(ix1) * xstride1), ldx, xstride1, xstride2,
+										dyww + (ptrdiff_t(iy1) * ystride1), ldy);
+								}
+								else
+								{
+									for (int g = 0; g < groups; g++)
+									{
+										for (int l = 0; l < ky; l++)
+										{
+											::cblas_sgemm(
+												CblasColMajor, CblasNoTrans, CblasTrans,
+												fg, cg, n,
+												1.0f,
+												dyww + (ptrdiff_t(iy1) * ystride1) + (ptrdiff_t(g) * fg), ldy,
+												xww + (ptrdiff_t(ix1) * xstride1) + (ptrdiff_t(l) * xstride2) + (ptrdiff_t(g) * cg), ldx,
+												1.0f,
+												dwww + (ptrdiff_t(ixy1) * kstep) + (ptrdiff_t(l) * cg * ldw) + (ptrdiff_t(g) * fg), ldw);
+										}
+									}
+								}
+							}
+						}
+					}
+				}
+#ifdef MT
+			});
+#else
+			}
+#endif
+
+			// add up the parts, the sums of the pairs at distance step go to the first part of each pair
+			for (int step = 1; step < parts; step *= 2)
+			{
+#ifdef MT
+				parallel_for(0, parts - step, 2 * step, [&](int part)
+#else
+				for (int part = 0; part < parts - step; part += 2 * step)
+#endif
+				{
+					float* dwpart;
+					float* dbpart;
+					partial(part, dwpart, dbpart);
+
+					float* dwnext;
+					float* dbnext;
+					partial(part + step, dwnext, dbnext);
+
+					::cblas_saxpy(int(wsize), 1.0f, dwnext, 1, dwpart, 1);
+					::cblas_saxpy(y3, 1.0f, dbnext, 1, dbpart, 1);
+				}
+#ifdef MT
+				);
+#endif
+			}
+		}
+#ifdef MT
+		, [&]
+#endif
+		{
+			// 2. Calculate x gradient
+			// the output rows whose kernels overlap are processed one after another
+			if (dxw != NULL)
+			{
+				const int iy2step = (ksize2 + kstride2 - 1) / kstride2;
+				for (int iy2start = 0; iy2start < iy2step; iy2start++)
+				{
+#ifdef MT
+					parallel_for(iy2start, y2, iy2step, [&](int iy2)
+#else
+					for (int iy2 = iy2start; iy2 < y2; iy2 += iy2step)
+#endif
+					{
+						const SIMDKernels& kernels = SIMDKernels::Current();
+
+						const int ix2 = (iy2 * kstride2) - kpadding2;
+						const int ky = __min(ix2 + ksize2, x2) - __max(ix2, 0);
+
+						if (ky > 0)
+						{
+							for (int ixy0 = 0; ixy0 < y0; ixy0++)
+							{
+								const float* www = ww + (ptrdiff_t(__max(-ix2, 0)) * cg * ldw);
+								float* dxww = dxw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(__max(ix2, 0)) * xstride2);
+								const float* dyww = dyw + (ptrdiff_t(iy2) * ystride2) + (ptrdiff_t(ixy0) * ystride0);
+
+								for (int ixy1 = 0; ixy1 < ksize1; ixy1++)
+								{
+									const int iy1 = ixy1 < kpadding1 ? (kpadding1 - ixy1 + kstride1 - 1) / kstride1 : 0;
+									const int ix1 = ixy1 - kpadding1 + (iy1 * kstride1);
+									const int n = __min(y1, ((x1 - (ixy1 - kpadding1) - 1) / kstride1 + 1)) - iy1;
+
+									if (n > 0)
+									{
+										if (depthwise)
+										{
+											kernels.conv_depthwise_dx(
+												n, y3, 1, ky,
+												www + (ptrdiff_t(ixy1) * kstep), kstep,
+												dxww + (ptrdiff_t(ix1) * xstride1), ldx, xstride1, xstride2,
+												dyww + (ptrdiff_t(iy1) * ystride1), ldy);
+										}
+										else
+										{
+											for (int g = 0; g < groups; g++)
+											{
+												for (int l = 0; l < ky; l++)
+												{
+													::cblas_sgemm(
+														CblasColMajor, CblasTrans, CblasNoTrans,
+														cg, n, fg,
+														1.0f,
+														www + (ptrdiff_t(ixy1) * kstep) + (ptrdiff_t(l) * cg * ldw) + (ptrdiff_t(g) * fg), ldw,
+														dyww + (ptrdiff_t(iy1) * ystride1) + (ptrdiff_t(g) * fg), ldy,
+														1.0f,
+														dxww + (ptrdiff_t(ix1) * xstride1) + (ptrdiff_t(l) * xstride2) + (ptrdiff_t(g) * cg), ldx);
+												}
+											}
+										}
+									}
+								}
+							}
+						}
+					}
+#ifdef MT
+					);
+#endif
+				}
+			}
+		}
+#ifdef MT
+		);
+#endif
+}
@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "halfprecision.h"
+
+#include <string.h>
+#include <vector>
+
+// Inference of the fully connected layer with the weights stored in 16 bits (see halfprecision.h).
+// The weights are converted back to single precision by the matrix product, so the result differs
+// from the single precision layer only by the rounding of the weights. Gradients are not computed.
+
+// The weights of one layer packed in 16 bits by half_weights_pack.
+// The packed weights do not follow the changes in the source weights, the caller packs them again after training.
+struct half_weights
+{
+	int K;
+	int N;
+	WEIGHTS_PRECISION precision;
+
+	// N-by-K matrix packed by matrix_pack_f16 or matrix_pack_bf16
+	std::vector<unsigned __int16> packed;
+};
+
+// Packs the weights of n neurons with k weights each in the specified precision.
+// Element (i, j) of the weight matrix is at j * n + i when transposed is TRUE and at i * k + j otherwise.
+GENIXAPI(half_weights*, half_weights_pack)(
+	const int k,
+	const int n,
+	const float* w,
+	const BOOL transposed,
+	const WEIGHTS_PRECISION precision)
+{
+	half_weights* weights = new half_weights();
+	weights->K = k;
+	weights->N = n;
+	weights->precision = precision;
+	weights->packed.resize(halfprecision_packed_size(n, k));
+
+	if (precision == PrecisionHalf)
+	{
+		::matrix_pack_f16(n, k, w, 0, transposed ? n : k, transposed, weights->packed.data());
+	}
+	else
+	{
+		::matrix_pack_bf16(n, k, w, 0, transposed ? n : k, transposed, weights->packed.data());
+	}
+
+	return weights;
+}
+
+GENIXAPI(void, half_weights_free)(
+	half_weights* weights)
+{
+	delete weights;
+}
+
+// y := W * x + b for m input vectors of k elements each and n neurons, W is packed by half_weights_pack.
+GENIXAPI(void, half_fully_connected)(
+	const int m,
+	const int k,
+	const int n,
+	const half_weights* weights,
+	const float* bw,
+	const float* xw,
+	float* yw)
+{
+	for (int i = 0; i < m; i++)
+	{
+		memcpy(yw + (ptrdiff_t(i) * n), bw, n * sizeof(float));
+	}
+
+	if (weights->precision == PrecisionHalf)
+	{
+		::matrix_mm_f16(m, k, n, xw, 0, weights->packed.data(), yw, 0, FALSE);
+	}
+	else
+	{
+		::matrix_mm_bf16(m, k, n, xw, 0, weights->packed.data(), yw, 0, FALSE);
+	}
+}
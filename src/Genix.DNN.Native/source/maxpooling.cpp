@@ -1,8 +1,9 @@
 #include "stdafx.h"
 #include <stdlib.h>
+#include <algorithm>
 
-#include <ppl.h>
-using namespace concurrency;
+#include "scratch.h"
+#include "threadpool.h"
 
 #define MT
 
@@ -10,7 +11,7 @@ void __forceinline _max(const int n, const float* a, const float* b, float* y)
 {
 	for (int i = 0; i < n; i++)
 	{
-		y[i] = max(a[i], b[i]);
+		y[i] = __max(a[i], b[i]);
 	}
 }
 
@@ -18,8 +19,8 @@ void __forceinline _max(const int n, const float* a, const float* b, const float
 {
 	for (int i = 0; i < n; i++)
 	{
-		const float ab = max(a[i], b[i]);
-		y[i] = max(ab, c[i]);
+		const float ab = __max(a[i], b[i]);
+		y[i] = __max(ab, c[i]);
 	}
 }
 
@@ -27,9 +28,9 @@ void __forceinline _max(const int n, const float* a, const float* b, const float
 {
 	for (int i = 0; i < n; i++)
 	{
-		const float ab = max(a[i], b[i]);
-		const float cd = max(c[i], d[i]);
-		y[i] = max(ab, cd);
+		const float ab = __max(a[i], b[i]);
+		const float cd = __max(c[i], d[i]);
+		y[i] = __max(ab, cd);
 	}
 }
 
@@ -41,17 +42,6 @@ void __forceinline matchandadd(const int n, const float* x, const float* xmask,
 	}
 }
 
-template <typename _Index_type, typename _Function>
-void _parallel_for(_Index_type _First0, _Index_type _Last0, _Index_type _First1, _Index_type _Last1, const _Function& _Func, const auto_partitioner& _Part = auto_partitioner())
-{
-	_Index_type count = (_Last0 - _First0) * (_Last1 - _First1);
-	parallel_for(0, count, [&](_Index_type i) {
-		const _Index_type i0 = (i / (_Last1 - _First1)) + _First0;
-		const _Index_type i1 = (i % (_Last1 - _First1)) + _First1;
-		_Func(i0, i1);
-	}, _Part);
-}
-
 GENIXAPI(void, maxpooling)(
 	const int ksize1,
 	const int ksize2,
@@ -99,7 +89,7 @@ GENIXAPI(void, maxpooling)(
 	if (ksize1 == 2 && ksize2 == 2)
 	{
 #ifdef MT
-		_parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
+		parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
 		{
 #else
 		for (int ixy0 = 0; ixy0 < y0; ixy0++)
@@ -108,8 +98,8 @@ GENIXAPI(void, maxpooling)(
 			{
 #endif
 				const int ix1 = (iy1 * kstride1) - kpadding1;
-				const int ix1b = max(ix1, 0);
-				const int ix1e = min(ix1 + ksize1, x1);
+				const int ix1b = __max(ix1, 0);
+				const int ix1e = __min(ix1 + ksize1, x1);
 
 				const float* xww = xw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(ix1b) * xstride1);
 				float* yww = yw + (ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
@@ -118,18 +108,20 @@ GENIXAPI(void, maxpooling)(
 				int size1 = ix1e - ix1b;
 				if (size1 > 0)
 				{
+					// the rows of the window combined along the horizontal axis
+					scratch_buffer<float> buffer(size1 > 1 ? xstride1 : 0);
 					float* xww1 = NULL;
 					if (size1 > 1)
 					{
-						xww1 = new float[xstride1];
+						xww1 = buffer.data();
 						_max(xstride1, xww, xww + xstride1, xww1);
 					}
 
 					// add along vertical axis
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2, yww += ystride2)
 					{
-						const int ix2b = max(ix2, 0);
-						const int ix2e = min(ix2 + ksize2, x2);
+						const int ix2b = __max(ix2, 0);
+						const int ix2e = __min(ix2 + ksize2, x2);
 						const float* xww2 = (xww1 != NULL ? xww1 : xww) + (ptrdiff_t(ix2b) * xstride2);
 
 						switch (ix2e - ix2b)
@@ -145,11 +137,6 @@ GENIXAPI(void, maxpooling)(
 							break;
 						}
 					}
-
-					if (xww1 != NULL)
-					{
-						delete[] xww1;
-					}
 				}
 				else
 				{
@@ -165,7 +152,7 @@ GENIXAPI(void, maxpooling)(
 	else
 	{
 #ifdef MT
-		_parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
+		parallel_for(0, y0, 0, y1, [&](int ixy0, int iy1)
 		{
 #else
 		for (int ixy0 = 0; ixy0 < y0; ixy0++)
@@ -174,8 +161,8 @@ GENIXAPI(void, maxpooling)(
 			{
 #endif
 				const int ix1 = (iy1 * kstride1) - kpadding1;
-				const int ix1b = max(ix1, 0);
-				const int ix1e = min(ix1 + ksize1, x1);
+				const int ix1b = __max(ix1, 0);
+				const int ix1e = __min(ix1 + ksize1, x1);
 
 				const float* xww = xw + (ptrdiff_t(ixy0) * xstride0) + (ptrdiff_t(ix1b) * xstride1);
 				float* yww = yw + (ptrdiff_t(ixy0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
@@ -184,10 +171,12 @@ GENIXAPI(void, maxpooling)(
 				int size1 = ix1e - ix1b;
 				if (size1 > 0)
 				{
+					// the rows of the window combined along the horizontal axis
+					scratch_buffer<float> buffer(size1 > 1 ? xstride1 : 0);
 					float* xww1 = NULL;
 					if (size1 > 1)
 					{
-						xww1 = new float[xstride1];
+						xww1 = buffer.data();
 
 						switch (size1)
 						{
@@ -221,8 +210,8 @@ GENIXAPI(void, maxpooling)(
 					// add along vertical axis
 					for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2, yww += ystride2)
 					{
-						const int ix2b = max(ix2, 0);
-						const int ix2e = min(ix2 + ksize2, x2);
+						const int ix2b = __max(ix2, 0);
+						const int ix2e = __min(ix2 + ksize2, x2);
 
 						int size2 = ix2e - ix2b;
 						if (size2 > 0)
@@ -266,11 +255,6 @@ GENIXAPI(void, maxpooling)(
 							::memset(yww, 0, ystride2 * sizeof(float));
 						}
 					}
-
-					if (xww1 != NULL)
-					{
-						delete[] xww1;
-					}
 				}
 				else
 				{
@@ -347,15 +331,15 @@ GENIXAPI(void, maxpooling_gradient)(
 #endif
 		{
 			const int ix1 = (iy1 * kstride1) - kpadding1;
-			const int kb1 = max(ix1, 0);
-			const int ke1 = min(ix1 + ksize1, x1);
+			const int kb1 = __max(ix1, 0);
+			const int ke1 = __min(ix1 + ksize1, x1);
 
 			for (int ix0 = 0, yoff1 = iy1 * ystride1, xoff1 = kb1 * xstride1; ix0 < x0; ix0++, yoff1 += ystride0, xoff1 += xstride0)
 			{
 				for (int iy2 = 0, ix2 = -kpadding2, yoff2 = yoff1; iy2 < y2; iy2++, ix2 += kstride2, yoff2 += ystride2)
 				{
-					const int kb2 = max(ix2, 0);
-					const int ke2 = min(ix2 + ksize2, x2);
+					const int kb2 = __max(ix2, 0);
+					const int ke2 = __min(ix2 + ksize2, x2);
 
 					// cycle by the kernel
 					for (int ik1 = kb1, kxoff1 = xoff1 + (kb2 * xstride2); ik1 < ke1; ik1++, kxoff1 += xstride1)
@@ -373,3 +357,320 @@ GENIXAPI(void, maxpooling_gradient)(
 #endif
 	}
 }
+
+// Max pooling that also records where every maximum came from, so the gradient is routed
+// through the recorded positions instead of comparing the inputs with the outputs again.
+//
+// The index of an output element is the position of its maximum in the kernel window, (k1 * ksize2) + k2,
+// and the indices have the same layout as the output. The first of equal maxima wins.
+// A window that lies entirely in the padding produces zero and the index -1 (255 for bytes) that receives no gradient.
+namespace
+{
+	// y, index := x at position k, when x > y
+	template<typename T> void __forceinline __max_index(const int n, const float* __restrict x, const T k, float* __restrict y, T* __restrict index)
+	{
+		// the index is selected with a mask, the compiler does not vectorize a conditional select of it when NaNs are honored
+		for (int i = 0; i < n; i++)
+		{
+			const float value = x[i];
+			const float max = y[i];
+			const bool greater = value > max;
+			y[i] = greater ? value : max;
+			index[i] = T(index[i] + ((k - index[i]) & -int(greater)));
+		}
+	}
+
+	// the full K1-by-K2 window, the maximum of every channel stays in a register
+	template<int K1, int K2, typename T> void __forceinline __max_index_window(
+		const int n,
+		const float* __restrict x,
+		const int xstride1,
+		const int xstride2,
+		float* __restrict y,
+		T* __restrict index)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			float max = x[i];
+			int k = 0;
+
+			// a single loop over the window is unrolled by the compiler
+			for (int kk = 1; kk < K1 * K2; kk++)
+			{
+				const float value = x[(ptrdiff_t(kk / K2) * xstride1) + (ptrdiff_t(kk % K2) * xstride2) + i];
+				const bool greater = value > max;
+				max = greater ? value : max;
+				k += (kk - k) & -int(greater);
+			}
+
+			y[i] = max;
+			index[i] = T(k);
+		}
+	}
+
+	template<typename T> void __maxpooling_indices(
+		const int ksize1,
+		const int ksize2,
+		const int kstride1,
+		const int kstride2,
+		int kpadding1,
+		int kpadding2,
+		const float* xw,
+		const int* xaxes,
+		const int* xstrides,
+		float* yw,
+		const int* yaxes,
+		const int* ystrides,
+		T* indices)
+	{
+		const int x0 = xaxes[0];
+		int x1 = xaxes[1];
+		int x2 = xaxes[2];
+		const int xstride0 = xstrides[0];
+		const int xstride1 = xstrides[1];
+		const int xstride2 = xstrides[2];
+
+		const int y1 = yaxes[1];
+		const int y2 = yaxes[2];
+		const int ystride0 = ystrides[0];
+		const int ystride1 = ystrides[1];
+		const int ystride2 = ystrides[2];
+
+		// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
+		if (kpadding1 < 0)
+		{
+			xw += -ptrdiff_t(kpadding1) * xstride1;
+			x1 += 2 * kpadding1;
+			kpadding1 = 0;
+		}
+
+		if (kpadding2 < 0)
+		{
+			xw += -ptrdiff_t(kpadding2) * xstride2;
+			x2 += 2 * kpadding2;
+			kpadding2 = 0;
+		}
+
+		const bool k2x2 = ksize1 == 2 && ksize2 == 2;
+		const bool k3x3 = ksize1 == 3 && ksize2 == 3;
+
+		parallel_for(0, x0, 0, y1, [&](int ix0, int iy1)
+		{
+			const int ix1 = (iy1 * kstride1) - kpadding1;
+			const int kb1 = __max(ix1, 0);
+			const int ke1 = __min(ix1 + ksize1, x1);
+
+			const float* xww = xw + (ptrdiff_t(ix0) * xstride0);
+			const ptrdiff_t yoff1 = (ptrdiff_t(ix0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
+
+			for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2)
+			{
+				const int kb2 = __max(ix2, 0);
+				const int ke2 = __min(ix2 + ksize2, x2);
+
+				float* yww = yw + yoff1 + (ptrdiff_t(iy2) * ystride2);
+				T* index = indices + yoff1 + (ptrdiff_t(iy2) * ystride2);
+
+				if (kb1 >= ke1 || kb2 >= ke2)
+				{
+					::memset(yww, 0, xstride2 * sizeof(float));
+					std::fill(index, index + xstride2, T(-1));
+					continue;
+				}
+
+				const float* xwww = xww + (ptrdiff_t(kb1) * xstride1) + (ptrdiff_t(kb2) * xstride2);
+				const bool full = kb1 == ix1 && ke1 == ix1 + ksize1 && kb2 == ix2 && ke2 == ix2 + ksize2;
+
+				if (full && k2x2)
+				{
+					__max_index_window<2, 2>(xstride2, xwww, xstride1, xstride2, yww, index);
+				}
+				else if (full && k3x3)
+				{
+					__max_index_window<3, 3>(xstride2, xwww, xstride1, xstride2, yww, index);
+				}
+				else
+				{
+					::memcpy(yww, xwww, xstride2 * sizeof(float));
+					std::fill(index, index + xstride2, T(((kb1 - ix1) * ksize2) + (kb2 - ix2)));
+
+					for (int ik1 = kb1; ik1 < ke1; ik1++)
+					{
+						for (int ik2 = ik1 == kb1 ? kb2 + 1 : kb2; ik2 < ke2; ik2++)
+						{
+							__max_index(
+								xstride2,
+								xww + (ptrdiff_t(ik1) * xstride1) + (ptrdiff_t(ik2) * xstride2),
+								T(((ik1 - ix1) * ksize2) + (ik2 - ix2)),
+								yww,
+								index);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	template<typename T> void __maxpooling_gradient_indices(
+		const int ksize1,
+		const int ksize2,
+		const int kstride1,
+		const int kstride2,
+		int kpadding1,
+		int kpadding2,
+		float* dxw,
+		const int* xaxes,
+		const int* xstrides,
+		const float* dyw,
+		const int* yaxes,
+		const int* ystrides,
+		const T* indices)
+	{
+		const int x0 = xaxes[0];
+		const int xstride0 = xstrides[0];
+		const int xstride1 = xstrides[1];
+		const int xstride2 = xstrides[2];
+
+		const int y1 = yaxes[1];
+		const int y2 = yaxes[2];
+		const int ystride0 = ystrides[0];
+		const int ystride1 = ystrides[1];
+		const int ystride2 = ystrides[2];
+
+		// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
+		if (kpadding1 < 0)
+		{
+			dxw += -ptrdiff_t(kpadding1) * xstride1;
+			kpadding1 = 0;
+		}
+
+		if (kpadding2 < 0)
+		{
+			dxw += -ptrdiff_t(kpadding2) * xstride2;
+			kpadding2 = 0;
+		}
+
+		// offsets of the window positions, the larger windows divide instead
+		const int ksize = ksize1 * ksize2;
+		const int MaxTable = 256;
+		ptrdiff_t offsets[MaxTable];
+		for (int k = 0; k < __min(ksize, MaxTable); k++)
+		{
+			offsets[k] = (ptrdiff_t(k / ksize2) * xstride1) + (ptrdiff_t(k % ksize2) * xstride2);
+		}
+
+		// the windows of the rows that are iy1step apart do not overlap, so they can be processed concurrently
+		const int iy1step = (ksize1 + kstride1 - 1) / kstride1;
+		for (int iy1start = 0; iy1start < __min(iy1step, y1); iy1start++)
+		{
+			const int rows = (y1 - iy1start + iy1step - 1) / iy1step;
+
+			parallel_for(0, x0, 0, rows, [&](int ix0, int row)
+			{
+				const int iy1 = iy1start + (row * iy1step);
+				const int ix1 = (iy1 * kstride1) - kpadding1;
+				const ptrdiff_t yoff1 = (ptrdiff_t(ix0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
+
+				for (int iy2 = 0, ix2 = -kpadding2; iy2 < y2; iy2++, ix2 += kstride2)
+				{
+					const ptrdiff_t yoff2 = yoff1 + (ptrdiff_t(iy2) * ystride2);
+					const float* dyww = dyw + yoff2;
+					const T* index = indices + yoff2;
+
+					// the window origin can lie in the padding, the recorded positions never do
+					const ptrdiff_t xoff = (ptrdiff_t(ix0) * xstride0) + (ptrdiff_t(ix1) * xstride1) + (ptrdiff_t(ix2) * xstride2);
+
+					for (int i = 0; i < xstride2; i++)
+					{
+						const int k = int(index[i]);
+						if (k >= 0 && k < ksize)
+						{
+							const ptrdiff_t offset = k < MaxTable ?
+								offsets[k] :
+								(ptrdiff_t(k / ksize2) * xstride1) + (ptrdiff_t(k % ksize2) * xstride2);
+
+							dxw[xoff + offset + i] += dyww[i];
+						}
+					}
+				}
+			});
+		}
+	}
+}
+
+// Max pooling that writes the position of every maximum in its window, one byte each;
+// the kernel window must have fewer than 255 elements.
+GENIXAPI(void, maxpooling_indices_u8)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	const float* xw,
+	const int* xaxes,
+	const int* xstrides,
+	float* yw,
+	const int* yaxes,
+	const int* ystrides,
+	unsigned __int8* indices)
+{
+	__maxpooling_indices(ksize1, ksize2, kstride1, kstride2, kpadding1, kpadding2, xw, xaxes, xstrides, yw, yaxes, ystrides, indices);
+}
+
+// Max pooling that writes the position of every maximum in its window, four bytes each.
+GENIXAPI(void, maxpooling_indices_s32)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	const float* xw,
+	const int* xaxes,
+	const int* xstrides,
+	float* yw,
+	const int* yaxes,
+	const int* ystrides,
+	__int32* indices)
+{
+	__maxpooling_indices(ksize1, ksize2, kstride1, kstride2, kpadding1, kpadding2, xw, xaxes, xstrides, yw, yaxes, ystrides, indices);
+}
+
+// dx += dy routed through the positions written by maxpooling_indices_u8.
+GENIXAPI(void, maxpooling_gradient_indices_u8)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	float* dxw,
+	const int* xaxes,
+	const int* xstrides,
+	const float* dyw,
+	const int* yaxes,
+	const int* ystrides,
+	const unsigned __int8* indices)
+{
+	__maxpooling_gradient_indices(ksize1, ksize2, kstride1, kstride2, kpadding1, kpadding2, dxw, xaxes, xstrides, dyw, yaxes, ystrides, indices);
+}
+
+// dx += dy routed through the positions written by maxpooling_indices_s32.
+GENIXAPI(void, maxpooling_gradient_indices_s32)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	float* dxw,
+	const int* xaxes,
+	const int* xstrides,
+	const float* dyw,
+	const int* yaxes,
+	const int* ystrides,
+	const __int32* indices)
+{
+	__maxpooling_gradient_indices(ksize1, ksize2, kstride1, kstride2, kpadding1, kpadding2, dxw, xaxes, xstrides, dyw, yaxes, ystrides, indices);
+}
@@ -0,0 +1,210 @@
+#include "stdafx.h"
+#include "quantization.h"
+#include "scratch.h"
+#include "threadpool.h"
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// 8-bit inference of the convolution and fully connected layers.
+//
+// The input is quantized to unsigned bytes with the scale and the zero point found by calibration,
+// the weights are quantized to signed bytes with one scale per filter, and the products are
+// computed in 32-bit integers by cblas_gemm_s8u8s32 of the current backend (see quantization.h).
+// The output and the biases stay in single precision. Gradients are not computed.
+
+// The weights of one layer quantized per filter by quantized_weights_pack.
+// The quantized weights do not follow the changes in the source weights, the caller quantizes them again after training.
+struct quantized_weights
+{
+	int K;
+	int F;
+
+	// F filters of K weights, their scales and the sums of their quantized weights
+	std::vector<__int8> q;
+	std::vector<float> scales;
+	std::vector<__int32> sums;
+};
+
+namespace
+{
+	void __forceinline tile(const int count, const int length, const float* src, float* dst, const int dststep)
+	{
+		for (int i = 0; i < count; i++, dst += dststep)
+		{
+			memcpy(dst, src, length * sizeof(float));
+		}
+	}
+}
+
+// Quantizes the weights of F filters with K weights each.
+// Element (k, f) is at k * F + f when transposed is TRUE and at f * K + k otherwise.
+GENIXAPI(quantized_weights*, quantized_weights_pack)(
+	const int K,
+	const int F,
+	const float* w,
+	const BOOL transposed)
+{
+	quantized_weights* weights = new quantized_weights();
+	weights->K = K;
+	weights->F = F;
+	weights->q.resize(size_t(K) * F);
+	weights->scales.resize(F);
+	weights->sums.resize(F);
+
+	::quantize_channels_s8(F, K, w, 0, transposed, weights->q.data(), 0, weights->scales.data(), 0, weights->sums.data(), 0);
+
+	return weights;
+}
+
+GENIXAPI(void, quantized_weights_free)(
+	quantized_weights* weights)
+{
+	delete weights;
+}
+
+// The convolution is computed as a matrix product: every output position gathers its kernel patch of quantized inputs into a row,
+// and the rows of a block of output lines are multiplied by the quantized filters at once.
+// The positions of the patch that fall into the padding get the zero point, which stands for zero.
+GENIXAPI(void, quantized_convolution)(
+	const int ksize1,
+	const int ksize2,
+	const int kstride1,
+	const int kstride2,
+	int kpadding1,
+	int kpadding2,
+	const quantized_weights* weights,
+	const float* bw,
+	const float* xw,
+	const int* xaxes,
+	const int* xstrides,
+	float* yw,
+	const int* yaxes,
+	const int* ystrides,
+	const float xscale,
+	const int xzero)
+{
+	const int x0 = xaxes[0];
+	int x1 = xaxes[1];
+	int x2 = xaxes[2];
+	const int x3 = xaxes[3];	// number of channels
+	const int xstride0 = xstrides[0];
+	const int xstride1 = xstrides[1];
+	const int xstride2 = xstrides[2];
+
+	const int y1 = yaxes[1];
+	const int y2 = yaxes[2];
+	const int y3 = yaxes[3];	// number of filters
+	const int ystride0 = ystrides[0];
+	const int ystride1 = ystrides[1];
+	const int ystride2 = ystrides[2];
+
+	// weights element (kx, ky, c, f) is at ((kx * ksize2 + ky) * C + c) * F + f, see quantized_weights_pack
+	const quantized_weights& q = *weights;
+	const int K = q.K;
+
+	// if kpadding1 or kpadding2 are negative we need to shrink working area of x tensor
+	if (kpadding1 < 0)
+	{
+		xw += -ptrdiff_t(kpadding1) * xstride1;
+		x1 += 2 * kpadding1;
+		kpadding1 = 0;
+	}
+
+	if (kpadding2 < 0)
+	{
+		xw += -ptrdiff_t(kpadding2) * xstride2;
+		x2 += 2 * kpadding2;
+		kpadding2 = 0;
+	}
+
+	// 1. quantize the input
+	scratch_buffer<unsigned __int8> xq(size_t(x0) * x1 * x2 * x3);
+	parallel_for(0, x0, 0, x1, [&](int ix0, int ix1)
+	{
+		const float* xww = xw + (ptrdiff_t(ix0) * xstride0) + (ptrdiff_t(ix1) * xstride1);
+		unsigned __int8* xqq = xq.data() + (((ptrdiff_t(ix0) * x1) + ix1) * x2 * x3);
+
+		for (int ix2 = 0; ix2 < x2; ix2++, xww += xstride2, xqq += x3)
+		{
+			::quantize_u8(x3, xww, 0, xscale, xzero, xqq, 0);
+		}
+	});
+
+	// 2. multiply the patches of blocks of output lines by the filters, about 1 MB of patches per block
+	const size_t linesize = __max(size_t(1), size_t(y2) * K);
+	const int lines = int(__max(size_t(1), __min(size_t(y1), (size_t(1) << 20) / linesize)));
+	scratch_buffer<unsigned __int8> patches(size_t(lines) * y2 * K);
+
+	for (int iy0 = 0; iy0 < x0; iy0++)
+	{
+		const unsigned __int8* xqq = xq.data() + (ptrdiff_t(iy0) * x1 * x2 * x3);
+
+		for (int iy1 = 0; iy1 < y1; iy1 += lines)
+		{
+			const int count = __min(lines, y1 - iy1);
+
+			parallel_for(0, count, 0, y2, [&](int line, int iy2)
+			{
+				unsigned __int8* patch = patches.data() + ((ptrdiff_t(line) * y2) + iy2) * K;
+
+				for (int kx = 0; kx < ksize1; kx++)
+				{
+					const int ix1 = ((iy1 + line) * kstride1) - kpadding1 + kx;
+					for (int ky = 0; ky < ksize2; ky++, patch += x3)
+					{
+						const int ix2 = (iy2 * kstride2) - kpadding2 + ky;
+						if (ix1 >= 0 && ix1 < x1 && ix2 >= 0 && ix2 < x2)
+						{
+							memcpy(patch, xqq + (((ptrdiff_t(ix1) * x2) + ix2) * x3), x3);
+						}
+						else
+						{
+							memset(patch, xzero, x3);
+						}
+					}
+				}
+			});
+
+			// the lines of the output are dense, so the rows of the block are its positions one after another
+			float* yww = yw + (ptrdiff_t(iy0) * ystride0) + (ptrdiff_t(iy1) * ystride1);
+			for (int line = 0; line < count; line++)
+			{
+				tile(y2, y3, bw, yww + (ptrdiff_t(line) * ystride1), ystride2);
+			}
+
+			::matrix_mm_u8s8(
+				count * y2, K, y3,
+				patches.data(), 0, xzero, xscale,
+				q.q.data(), 0, q.scales.data(), q.sums.data(),
+				yww, 0, FALSE);
+		}
+	}
+}
+
+// y := W * x + b for m input vectors of k elements each and n neurons, W is quantized by quantized_weights_pack.
+GENIXAPI(void, quantized_fully_connected)(
+	const int m,
+	const int k,
+	const int n,
+	const quantized_weights* weights,
+	const float* bw,
+	const float* xw,
+	float* yw,
+	const float xscale,
+	const int xzero)
+{
+	const quantized_weights& q = *weights;
+
+	scratch_buffer<unsigned __int8> xq(size_t(m) * k);
+	::quantize_u8(m * k, xw, 0, xscale, xzero, xq.data(), 0);
+
+	tile(m, n, bw, yw, n);
+
+	::matrix_mm_u8s8(
+		m, k, n,
+		xq.data(), 0, xzero, xscale,
+		q.q.data(), 0, q.scales.data(), q.sums.data(),
+		yw, 0, FALSE);
+}
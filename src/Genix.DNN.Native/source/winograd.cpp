@@ -0,0 +1,487 @@
+#include "stdafx.h"
+#include "backend.h"
+#include "scratch.h"
+#include "simdkernels.h"
+#include "threadpool.h"
+#include "winograd.h"
+
+#include <string.h>
+#include <mutex>
+
+struct winograd_filters
+{
+	std::mutex lock;
+
+	// the weights the filters were transformed from
+	int m = 0;
+	int C = 0;
+	int F = 0;
+	std::vector<float> weights;
+
+	std::vector<float> forward;
+	std::vector<float> backward;
+};
+
+namespace
+{
+	// 1-D transforms of F(m, 3): t := B' d for the input, o := A' s for the output and G for the filters.
+	// The 2-D transforms apply them along the rows of a tile and then along its columns;
+	// the input and output transforms process n channels at once.
+	template<int M> struct winograd_transform;
+
+	template<> struct winograd_transform<2>
+	{
+		static const int alpha = 4;
+
+		static __forceinline float g(int i, int j)
+		{
+			static const float G[4][3] =
+			{
+				{ 1.0f, 0.0f, 0.0f },
+				{ 0.5f, 0.5f, 0.5f },
+				{ 0.5f, -0.5f, 0.5f },
+				{ 0.0f, 0.0f, 1.0f },
+			};
+
+			return G[i][j];
+		}
+
+		static __forceinline void input(int n, const float* const* d, float* const* t)
+		{
+			const float* __restrict d0 = d[0];
+			const float* __restrict d1 = d[1];
+			const float* __restrict d2 = d[2];
+			const float* __restrict d3 = d[3];
+			float* __restrict t0 = t[0];
+			float* __restrict t1 = t[1];
+			float* __restrict t2 = t[2];
+			float* __restrict t3 = t[3];
+
+			for (int i = 0; i < n; i++)
+			{
+				t0[i] = d0[i] - d2[i];
+				t1[i] = d1[i] + d2[i];
+				t2[i] = d2[i] - d1[i];
+				t3[i] = d1[i] - d3[i];
+			}
+		}
+
+		template<bool Accumulate> static __forceinline void output(int n, const float* const* s, float* const* o)
+		{
+			const float* __restrict s0 = s[0];
+			const float* __restrict s1 = s[1];
+			const float* __restrict s2 = s[2];
+			const float* __restrict s3 = s[3];
+			float* __restrict o0 = o[0];
+			float* __restrict o1 = o[1];
+
+			for (int i = 0; i < n; i++)
+			{
+				const float a = s0[i] + s1[i] + s2[i];
+				const float b = s1[i] - s2[i] - s3[i];
+
+				o0[i] = Accumulate ? o0[i] + a : a;
+				o1[i] = Accumulate ? o1[i] + b : b;
+			}
+		}
+	};
+
+	template<> struct winograd_transform<4>
+	{
+		static const int alpha = 6;
+
+		static __forceinline float g(int i, int j)
+		{
+			static const float G[6][3] =
+			{
+				{ 1.0f / 4.0f, 0.0f, 0.0f },
+				{ -1.0f / 6.0f, -1.0f / 6.0f, -1.0f / 6.0f },
+				{ -1.0f / 6.0f, 1.0f / 6.0f, -1.0f / 6.0f },
+				{ 1.0f / 24.0f, 1.0f / 12.0f, 1.0f / 6.0f },
+				{ 1.0f / 24.0f, -1.0f / 12.0f, 1.0f / 6.0f },
+				{ 0.0f, 0.0f, 1.0f },
+			};
+
+			return G[i][j];
+		}
+
+		static __forceinline void input(int n, const float* const* d, float* const* t)
+		{
+			const float* __restrict d0 = d[0];
+			const float* __restrict d1 = d[1];
+			const float* __restrict d2 = d[2];
+			const float* __restrict d3 = d[3];
+			const float* __restrict d4 = d[4];
+			const float* __restrict d5 = d[5];
+			float* __restrict t0 = t[0];
+			float* __restrict t1 = t[1];
+			float* __restrict t2 = t[2];
+			float* __restrict t3 = t[3];
+			float* __restrict t4 = t[4];
+			float* __restrict t5 = t[5];
+
+			for (int i = 0; i < n; i++)
+			{
+				const float a = d4[i] - (4.0f * d2[i]);
+				const float b = d3[i] - (4.0f * d1[i]);
+				const float c = d4[i] - d2[i];
+				const float e = 2.0f * (d3[i] - d1[i]);
+
+				t0[i] = (4.0f * d0[i]) - (5.0f * d2[i]) + d4[i];
+				t1[i] = a + b;
+				t2[i] = a - b;
+				t3[i] = c + e;
+				t4[i] = c - e;
+				t5[i] = (4.0f * d1[i]) - (5.0f * d3[i]) + d5[i];
+			}
+		}
+
+		template<bool Accumulate> static __forceinline void output(int n, const float* const* s, float* const* o)
+		{
+			const float* __restrict s0 = s[0];
+			const float* __restrict s1 = s[1];
+			const float* __restrict s2 = s[2];
+			const float* __restrict s3 = s[3];
+			const float* __restrict s4 = s[4];
+			const float* __restrict s5 = s[5];
+			float* __restrict o0 = o[0];
+			float* __restrict o1 = o[1];
+			float* __restrict o2 = o[2];
+			float* __restrict o3 = o[3];
+
+			for (int i = 0; i < n; i++)
+			{
+				const float a = s1[i] + s2[i];
+				const float b = s1[i] - s2[i];
+				const float c = s3[i] + s4[i];
+				const float d = s3[i] - s4[i];
+
+				const float r0 = s0[i] + a + c;
+				const float r1 = b + (2.0f * d);
+				const float r2 = a + (4.0f * c);
+				const float r3 = b + (8.0f * d) + s5[i];
+
+				o0[i] = Accumulate ? o0[i] + r0 : r0;
+				o1[i] = Accumulate ? o1[i] + r1 : r1;
+				o2[i] = Accumulate ? o2[i] + r2 : r2;
+				o3[i] = Accumulate ? o3[i] + r3 : r3;
+			}
+		}
+	};
+
+	// u(a, b) := G g G' for every pair of channels.
+	// The forward filters are C x F matrices, element (c, f) of matrix (a, b) is at ((a * alpha + b) * C + c) * F + f.
+	// The backward filters convolve the output gradient with the kernels rotated by 180 degrees,
+	// so they are F x C matrices with element (f, c) at ((a * alpha + b) * F + f) * C + c.
+	template<int M> void transform_filters(int C, int F, const float* w, bool backward, float* u)
+	{
+		const int alpha = winograd_transform<M>::alpha;
+		const int size = C * F;
+
+		parallel_for(0, C, [&](int c)
+		{
+			for (int f = 0; f < F; f++)
+			{
+				float g[3][3];
+				for (int kx = 0; kx < 3; kx++)
+				{
+					for (int ky = 0; ky < 3; ky++)
+					{
+						g[kx][ky] = backward ?
+							w[((((2 - kx) * 3) + (2 - ky)) * size) + (c * F) + f] :
+							w[(((kx * 3) + ky) * size) + (c * F) + f];
+					}
+				}
+
+				// t := G g
+				float t[alpha][3];
+				for (int a = 0; a < alpha; a++)
+				{
+					for (int ky = 0; ky < 3; ky++)
+					{
+						t[a][ky] =
+							(winograd_transform<M>::g(a, 0) * g[0][ky]) +
+							(winograd_transform<M>::g(a, 1) * g[1][ky]) +
+							(winograd_transform<M>::g(a, 2) * g[2][ky]);
+					}
+				}
+
+				// u := t G'
+				const int pos = backward ? (f * C) + c : (c * F) + f;
+				for (int a = 0; a < alpha; a++)
+				{
+					for (int b = 0; b < alpha; b++)
+					{
+						u[(((a * alpha) + b) * size) + pos] =
+							(t[a][0] * winograd_transform<M>::g(b, 0)) +
+							(t[a][1] * winograd_transform<M>::g(b, 1)) +
+							(t[a][2] * winograd_transform<M>::g(b, 2));
+					}
+				}
+			}
+		});
+	}
+
+	template<int M> void convolution(
+		const float* u,
+		int B,
+		int C,
+		int F,
+		const float* x,
+		int x1,
+		int x2,
+		int xstride0,
+		int xstride1,
+		int xstride2,
+		float* y,
+		int y1,
+		int y2,
+		int ystride0,
+		int ystride1,
+		int ystride2,
+		int p1,
+		int p2)
+	{
+		typedef winograd_transform<M> transform;
+		const int alpha = transform::alpha;
+
+		const int tiles1 = (y1 + M - 1) / M;
+		const int tiles2 = (y2 + M - 1) / M;
+		const int tiles = B * tiles1 * tiles2;
+
+		// the tiles are processed in blocks, so the transformed tiles and their products stay in cache
+		const int block = __max(8, __min(128, 65536 / (alpha * alpha * (C + F))));
+		const int blocks = (tiles + block - 1) / block;
+
+		const SIMDKernels& kernels = SIMDKernels::Current();
+
+		parallel_for(0, blocks, [&](int iblock)
+		{
+			// V (alpha^2 x block x C), M (alpha^2 x block x F), the intermediate results of the 2-D transforms
+			// and the zeros and the sink that stand for the elements outside of x and y
+			const int vsize = alpha * alpha * block * C;
+			const int msize = alpha * alpha * block * F;
+			const int tsize = alpha * alpha * __max(C, F);
+			scratch_buffer<float> buffer(vsize + msize + tsize + __max(C, F) + F);
+
+			float* vw = buffer.data();
+			float* mw = vw + vsize;
+			float* tw = mw + msize;
+			float* zeros = tw + tsize;
+			float* sink = zeros + __max(C, F);
+			memset(zeros, 0, C * sizeof(float));
+
+			const int first = iblock * block;
+			const int count = __min(block, tiles - first);
+
+			// 1. transform the input tiles
+			for (int it = 0; it < count; it++)
+			{
+				const int tile = first + it;
+				const int ib = tile / (tiles1 * tiles2);
+				const int ix1 = (((tile / tiles2) % tiles1) * M) - p1;
+				const int ix2 = ((tile % tiles2) * M) - p2;
+
+				const float* xb = x + (ptrdiff_t(ib) * xstride0);
+
+				for (int a = 0; a < alpha; a++)
+				{
+					const float* d[alpha];
+					float* t[alpha];
+					for (int b = 0; b < alpha; b++)
+					{
+						const bool inside = ix1 + a >= 0 && ix1 + a < x1 && ix2 + b >= 0 && ix2 + b < x2;
+						d[b] = inside ? xb + (ptrdiff_t(ix1 + a) * xstride1) + (ptrdiff_t(ix2 + b) * xstride2) : zeros;
+						t[b] = tw + (((a * alpha) + b) * C);
+					}
+
+					transform::input(C, d, t);
+				}
+
+				for (int b = 0; b < alpha; b++)
+				{
+					const float* d[alpha];
+					float* t[alpha];
+					for (int a = 0; a < alpha; a++)
+					{
+						d[a] = tw + (((a * alpha) + b) * C);
+						t[a] = vw + ((((ptrdiff_t(a) * alpha) + b) * block) + it) * C;
+					}
+
+					transform::input(C, d, t);
+				}
+			}
+
+			// 2. multiply the transformed tiles by the transformed filters;
+			// the products are too small for BLAS to run efficiently, the direct convolution kernels do them in registers
+			if (kernels.floats >= 8)
+			{
+				memset(mw, 0, msize * sizeof(float));
+				for (int e = 0; e < alpha * alpha; e++)
+				{
+					kernels.conv_direct(
+						count, F, 1, C,
+						u + (ptrdiff_t(e) * C * F), 0,
+						vw + (ptrdiff_t(e) * block * C), C, 0,
+						mw + (ptrdiff_t(e) * block * F), F);
+				}
+			}
+			else
+			{
+				for (int e = 0; e < alpha * alpha; e++)
+				{
+					::cblas_sgemm(
+						CblasColMajor, CblasNoTrans, CblasNoTrans,
+						F, count, C,
+						1.0f,
+						u + (ptrdiff_t(e) * C * F), F,
+						vw + (ptrdiff_t(e) * block * C), C,
+						0.0f,
+						mw + (ptrdiff_t(e) * block * F), F);
+				}
+			}
+
+			// 3. transform the products back and add them to the output
+			for (int it = 0; it < count; it++)
+			{
+				const int tile = first + it;
+				const int ib = tile / (tiles1 * tiles2);
+				const int iy1 = ((tile / tiles2) % tiles1) * M;
+				const int iy2 = (tile % tiles2) * M;
+
+				float* yb = y + (ptrdiff_t(ib) * ystride0);
+
+				for (int a = 0; a < alpha; a++)
+				{
+					const float* s[alpha];
+					float* o[M];
+					for (int b = 0; b < alpha; b++)
+					{
+						s[b] = mw + ((((ptrdiff_t(a) * alpha) + b) * block) + it) * F;
+					}
+
+					for (int j = 0; j < M; j++)
+					{
+						o[j] = tw + (((j * alpha) + a) * F);
+					}
+
+					transform::template output<false>(F, s, o);
+				}
+
+				for (int j = 0; j < M; j++)
+				{
+					const float* s[alpha];
+					float* o[M];
+					for (int a = 0; a < alpha; a++)
+					{
+						s[a] = tw + (((j * alpha) + a) * F);
+					}
+
+					for (int i = 0; i < M; i++)
+					{
+						const bool inside = iy1 + i < y1 && iy2 + j < y2;
+						o[i] = inside ? yb + (ptrdiff_t(iy1 + i) * ystride1) + (ptrdiff_t(iy2 + j) * ystride2) : sink;
+					}
+
+					transform::template output<true>(F, s, o);
+				}
+			}
+		});
+	}
+}
+
+const float* winograd_transform_filters(
+	winograd_filters* filters,
+	int m,
+	int C,
+	int F,
+	const float* w,
+	bool backward,
+	std::vector<float>& buffer)
+{
+	const int alpha = m + 2;
+	const size_t size = size_t(9) * C * F;
+
+	std::vector<float>* u = &buffer;
+	std::unique_lock<std::mutex> lock;
+
+	if (filters != NULL)
+	{
+		lock = std::unique_lock<std::mutex>(filters->lock);
+
+		// new weights, transform them again
+		if (filters->m != m ||
+			filters->C != C ||
+			filters->F != F ||
+			::memcmp(filters->weights.data(), w, size * sizeof(float)) != 0)
+		{
+			filters->m = m;
+			filters->C = C;
+			filters->F = F;
+			filters->weights.assign(w, w + size);
+			filters->forward.clear();
+			filters->backward.clear();
+		}
+
+		u = backward ? &filters->backward : &filters->forward;
+		if (!u->empty())
+		{
+			return u->data();
+		}
+	}
+
+	u->resize(size_t(alpha) * alpha * C * F);
+	if (m == 2)
+	{
+		transform_filters<2>(C, F, w, backward, u->data());
+	}
+	else
+	{
+		transform_filters<4>(C, F, w, backward, u->data());
+	}
+
+	return u->data();
+}
+
+void winograd_convolution(
+	int m,
+	const float* u,
+	int B,
+	int C,
+	int F,
+	const float* x,
+	int x1,
+	int x2,
+	int xstride0,
+	int xstride1,
+	int xstride2,
+	float* y,
+	int y1,
+	int y2,
+	int ystride0,
+	int ystride1,
+	int ystride2,
+	int p1,
+	int p2)
+{
+	if (m == 2)
+	{
+		convolution<2>(u, B, C, F, x, x1, x2, xstride0, xstride1, xstride2, y, y1, y2, ystride0, ystride1, ystride2, p1, p2);
+	}
+	else
+	{
+		convolution<4>(u, B, C, F, x, x1, x2, xstride0, xstride1, xstride2, y, y1, y2, ystride0, ystride1, ystride2, p1, p2);
+	}
+}
+
+// Creates an empty cache of the transformed filters of a convolution layer, see winograd_transform_filters.
+GENIXAPI(winograd_filters*, winograd_filters_create)()
+{
+	return new winograd_filters();
+}
+
+GENIXAPI(void, winograd_filters_free)(
+	winograd_filters* filters)
+{
+	delete filters;
+}
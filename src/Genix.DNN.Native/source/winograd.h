@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+// Winograd convolution F(m x m, 3 x 3) used by convolution.cpp for 3x3 kernels with stride 1.
+//
+// The input is split into tiles of (m + 2) x (m + 2) elements that overlap by two.
+// Each tile and each filter is transformed once, the transformed tiles are multiplied by the transformed filters
+// with (m + 2)^2 matrix products over the channels, and the products are transformed back into m x m outputs.
+// F(2x2, 3x3) needs 2.25 times fewer multiplications than the direct convolution, F(4x4, 3x3) needs 4 times fewer,
+// but its rounding error is several times larger.
+
+// The filters of one layer transformed for the forward pass and for the input gradient.
+// The object keeps a copy of the weights it was built from and transforms them again when they change.
+struct winograd_filters;
+
+// Returns the filters transformed for tile size m (2 or 4).
+// w contains the 3x3 filters of the convolution with C input channels and F output channels,
+// element (kx, ky, c, f) is at ((kx * 3 + ky) * C + c) * F + f.
+// The forward filters are (m + 2)^2 matrices C x F, the backward ones are their rotated and transposed counterparts F x C.
+// filters can be NULL, the transformation is then written into buffer.
+const float* winograd_transform_filters(
+	winograd_filters* filters,
+	int m,
+	int C,
+	int F,
+	const float* w,
+	bool backward,
+	std::vector<float>& buffer);
+
+// y += the convolution of x with the transformed filters u.
+// x has C channels with stride 1, x1 columns and x2 rows; y has F channels with stride 1, y1 columns and y2 rows.
+// The kernel of output (i, j) starts at x(i - p1, j - p2), the elements outside of x are zeros.
+void winograd_convolution(
+	int m,
+	const float* u,
+	int B,
+	int C,
+	int F,
+	const float* x,
+	int x1,
+	int x2,
+	int xstride0,
+	int xstride1,
+	int xstride2,
+	float* y,
+	int y1,
+	int y2,
+	int ystride0,
+	int ystride1,
+	int ystride2,
+	int p1,
+	int p2);
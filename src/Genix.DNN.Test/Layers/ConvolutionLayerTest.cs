@@ -97,6 +97,33 @@
             Assert.IsTrue(layer.B.Weights.Take(layer.B.Length).All(x => x == 0.0f));
         }
 
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        public void ArchitectureConstructorTest5()
+        {
+            Shape shape = new Shape(Shape.BWHC, 2, 10, 12, 8);
+            const string Architecture = "8C3+1(P)+8(G)";
+
+            ConvolutionLayer layer = new ConvolutionLayer(shape, Architecture, null);
+
+            Assert.AreEqual(8, layer.NumberOfNeurons);
+            Assert.AreEqual(8, layer.Groups);
+            Assert.AreEqual(Architecture, layer.Architecture);
+
+            CollectionAssert.AreEqual(new[] { 2, 10, 12, 8 }, layer.OutputShape.Axes);
+            CollectionAssert.AreEqual(new[] { 8, 9 }, layer.W.Axes);
+            CollectionAssert.AreEqual(new[] { 8 }, layer.B.Axes);
+        }
+
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        [ExpectedException(typeof(ArgumentException))]
+        public void ArchitectureConstructorTest6()
+        {
+            // 3 channels cannot be split into 2 groups
+            Assert.IsNotNull(new ConvolutionLayer(new Shape(Shape.BWHC, -1, 10, 12, 3), "16C3+2(G)", null));
+        }
+
         [TestMethod]
         [TestCategory("ConvolutionLayer")]
         [ExpectedException(typeof(ArgumentException))]
@@ -249,6 +276,278 @@
             }
         }
 
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        public void WinogradTest()
+        {
+            // the reference implementation needs as many filters as there are channels
+            const int numberOfFilters = 4;
+            Shape shape = new Shape(Shape.BWHC, -1, 13, 11, numberOfFilters);
+
+            foreach (ConvolutionAlgorithm algorithm in new[] { ConvolutionAlgorithm.Winograd2x2, ConvolutionAlgorithm.Winograd4x4 })
+            {
+                foreach (int kpaddingx in new[] { 0, 1, 2, -1 })
+                {
+                    foreach (int kpaddingy in new[] { 0, 1, 2, -1 })
+                    {
+                        Kernel kernel = new Kernel(3, 3, 1, 1, kpaddingx, kpaddingy);
+                        ConvolutionLayer layer = new ConvolutionLayer(shape, numberOfFilters, kernel, MatrixLayout.ColumnMajor, null)
+                        {
+                            Algorithm = algorithm,
+                        };
+
+                        for (int mb = 1; mb <= 2; mb++)
+                        {
+                            // new weights on every pass, so the transformed filters are updated
+                            layer.W.Randomize(this.random);
+                            layer.B.Randomize(this.random);
+
+                            Session session = new Session(true);
+
+                            layer.W.ClearGradient();
+                            layer.B.ClearGradient();
+
+                            Tensor x = new Tensor(null, shape.Reshape(Axis.B, mb));
+                            x.Randomize(this.random);
+
+                            Tensor y = layer.Forward(session, new[] { x })[0];
+
+                            Tensor expected = ConvolutionLayerTest.CalculateY(layer.W, x, layer.B, kernel, numberOfFilters, MatrixLayout.ColumnMajor);
+                            Helpers.AreTensorsEqual(expected, y);
+
+                            y.RandomizeGradient(this.random);
+                            session.Unroll();
+
+                            Tensor expectedDX = ConvolutionLayerTest.CalculateDX(layer.W, x, y, kernel, numberOfFilters, MatrixLayout.ColumnMajor);
+                            Helpers.AreGradientsEqual(expectedDX, x);
+                        }
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        public void GroupConvolutionTest()
+        {
+            // less than one vector of channels, whole vectors and blocks of several vectors in the depthwise kernels
+            foreach (int channels in new[] { 4, 6, 8, 16 + 1, 70 })
+            {
+                // depthwise convolution, depthwise convolution with two filters per channel,
+                // and, when the channels can be split, two groups with one and two filters per channel
+                List<(int, int)> configurations = new List<(int, int)>() { (channels, channels), (channels, 2 * channels) };
+                if ((channels % 2) == 0)
+                {
+                    configurations.Add((2, channels));
+                    configurations.Add((2, 2 * channels));
+                }
+
+                foreach ((int groups, int numberOfFilters) in configurations)
+                {
+                    Shape shape = new Shape(Shape.BWHC, -1, 13, 11, channels);
+
+                    foreach (int ksize in new[] { 1, 2, 3 })
+                    {
+                        foreach (int kstride in new[] { 1, 2 })
+                        {
+                            foreach (int kpadding in new[] { 0, 1, -1 })
+                            {
+                                Kernel kernel = new Kernel(ksize, ksize, kstride, kstride, kpadding, kpadding);
+                                ConvolutionLayer layer = new ConvolutionLayer(shape, numberOfFilters, kernel, groups, MatrixLayout.ColumnMajor, null);
+                                layer.W.Randomize(this.random);
+                                layer.B.Randomize(this.random);
+
+                                for (int mb = 1; mb <= 2; mb++)
+                                {
+                                    Session session = new Session(true);
+
+                                    layer.W.ClearGradient();
+                                    layer.B.ClearGradient();
+
+                                    Tensor x = new Tensor(null, shape.Reshape(Axis.B, mb));
+                                    x.Randomize(this.random);
+
+                                    Tensor y = layer.Forward(session, new[] { x })[0];
+
+                                    y.RandomizeGradient(this.random);
+                                    session.Unroll();
+
+                                    ConvolutionLayerTest.CalculateGroupConvolution(
+                                        layer.W,
+                                        x,
+                                        layer.B,
+                                        y,
+                                        kernel,
+                                        groups,
+                                        out Tensor expected,
+                                        out Tensor expectedDW,
+                                        out Tensor expectedDB,
+                                        out Tensor expectedDX);
+
+                                    Helpers.AreTensorsEqual(expected, y);
+                                    Helpers.AreGradientsEqual(expectedDB, layer.B);
+                                    Helpers.AreGradientsEqual(expectedDW, layer.W);
+                                    Helpers.AreGradientsEqual(expectedDX, x);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        public void QuantizedForwardTest()
+        {
+            const int numberOfFilters = 5;
+            Shape shape = new Shape(Shape.BWHC, -1, 13, 11, 3);
+
+            foreach (int ksize in new[] { 1, 3 })
+            {
+                foreach (int kstride in new[] { 1, 2 })
+                {
+                    foreach (int kpadding in new[] { 0, 1, -1 })
+                    {
+                        Kernel kernel = new Kernel(ksize, ksize, kstride, kstride, kpadding, kpadding);
+                        ConvolutionLayer layer = new ConvolutionLayer(shape, numberOfFilters, kernel, MatrixLayout.ColumnMajor, null);
+                        layer.W.Randomize(this.random);
+                        layer.B.Randomize(this.random);
+
+                        Tensor x = new Tensor(null, shape.Reshape(Axis.B, 2));
+                        x.Randomize(this.random);
+
+                        Tensor expected = layer.Forward(new Session(false), new[] { x })[0];
+
+                        layer.InputQuantization = QuantizationParameters.FromRange(x.Min(), x.Max());
+                        Assert.AreEqual(layer.InputQuantization, (layer.Clone() as ConvolutionLayer).InputQuantization);
+
+                        // 8-bit products stay within a few percent of the largest output
+                        Tensor y = layer.Forward(new Session(false), new[] { x })[0];
+                        CollectionAssert.AreEqual(expected.Axes, y.Axes);
+
+                        float tolerance = 0.03f * Math.Max(Math.Abs(expected.Min()), Math.Abs(expected.Max()));
+                        for (int i = 0; i < expected.Length; i++)
+                        {
+                            Assert.AreEqual(expected.Weights[i], y.Weights[i], tolerance);
+                        }
+
+                        // training computes in single precision
+                        Helpers.AreTensorsEqual(expected, layer.Forward(new Session(true), new[] { x })[0]);
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        public void GemmBatchTest()
+        {
+            // the reference implementation needs as many filters as there are channels
+            const int numberOfFilters = 3;
+            Shape shape = new Shape(Shape.BWHC, -1, 13, 11, numberOfFilters);
+
+            foreach (int ksize in new[] { 1, 2, 3, 5 })
+            {
+                foreach (int kstride in new[] { 1, 2, 3 })
+                {
+                    foreach (int kpadding in new[] { 0, 1, 2, -1 })
+                    {
+                        Kernel kernel = new Kernel(ksize, ksize, kstride, kstride, kpadding, kpadding);
+                        ConvolutionLayer layer = new ConvolutionLayer(shape, numberOfFilters, kernel, MatrixLayout.ColumnMajor, null)
+                        {
+                            Algorithm = ConvolutionAlgorithm.GemmBatch,
+                        };
+
+                        layer.W.Randomize(this.random);
+                        layer.B.Randomize(this.random);
+
+                        // the plan is built again when the mini-batch size changes
+                        foreach (int mb in new[] { 1, 2, 1 })
+                        {
+                            Session session = new Session(false);
+
+                            Tensor x = new Tensor(null, shape.Reshape(Axis.B, mb));
+                            x.Randomize(this.random);
+
+                            Tensor y = layer.Forward(session, new[] { x })[0];
+
+                            Tensor expected = ConvolutionLayerTest.CalculateY(layer.W, x, layer.B, kernel, numberOfFilters, MatrixLayout.ColumnMajor);
+                            Helpers.AreTensorsEqual(expected, y);
+                        }
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        [TestCategory("ConvolutionLayer")]
+        public void AlgorithmsTest()
+        {
+            // sweeps the common shapes and prints the time of each algorithm
+            const int Count = 5;
+            Stopwatch stopwatch = new Stopwatch();
+
+            foreach (int channels in new[] { 1, 3, 16, 32 })
+            {
+                foreach (int numberOfFilters in new[] { 8, 16, 32, 64, 128 })
+                {
+                    foreach (int size in new[] { 1, 3, 5 })
+                    {
+                        foreach (int stride in new[] { 1, 2 })
+                        {
+                            Shape shape = new Shape(Shape.BWHC, 8, 64, 64, channels);
+                            Kernel kernel = new Kernel(size, size, stride, stride, size / 2, size / 2);
+                            ConvolutionLayer layer = new ConvolutionLayer(shape, numberOfFilters, kernel, MatrixLayout.ColumnMajor, null);
+                            layer.W.Randomize(this.random);
+                            layer.B.Randomize(this.random);
+
+                            Tensor x = new Tensor(null, shape);
+                            x.Randomize(this.random);
+
+                            ConvolutionAlgorithm[] algorithms = size == 3 && stride == 1 ?
+                                new[] { ConvolutionAlgorithm.Gemm, ConvolutionAlgorithm.GemmBatch, ConvolutionAlgorithm.Direct, ConvolutionAlgorithm.Winograd2x2, ConvolutionAlgorithm.Winograd4x4 } :
+                                new[] { ConvolutionAlgorithm.Gemm, ConvolutionAlgorithm.GemmBatch, ConvolutionAlgorithm.Direct };
+                            Tensor[] ys = new Tensor[algorithms.Length];
+                            double[] times = new double[algorithms.Length];
+                            for (int i = 0; i < algorithms.Length; i++)
+                            {
+                                Session session = new Session(false);
+                                ys[i] = session.Convolution(x, layer.W, layer.B, kernel, numberOfFilters, MatrixLayout.ColumnMajor, algorithms[i]);
+
+                                stopwatch.Restart();
+                                for (int n = 0; n < Count; n++)
+                                {
+                                    session.Convolution(x, layer.W, layer.B, kernel, numberOfFilters, MatrixLayout.ColumnMajor, algorithms[i]);
+                                }
+
+                                stopwatch.Stop();
+                                times[i] = stopwatch.Elapsed.TotalMilliseconds / Count;
+                            }
+
+                            for (int n = 1; n < ys.Length; n++)
+                            {
+                                for (int i = 0; i < ys[0].Length; i++)
+                                {
+                                    float expected = ys[0].Weights[i];
+                                    Assert.AreEqual(expected, ys[n].Weights[i], 1e-4f * Math.Max(1.0f, Math.Abs(expected)));
+                                }
+                            }
+
+                            Console.WriteLine(
+                                "C={0} F={1} {2}x{2}/{3}: {4}, {5} wins",
+                                channels,
+                                numberOfFilters,
+                                size,
+                                stride,
+                                string.Join(", ", algorithms.Select((a, i) => string.Format(CultureInfo.InvariantCulture, "{0} {1:F3} ms", a, times[i]))),
+                                algorithms[Array.IndexOf(times, times.Min())]);
+                        }
+                    }
+                }
+            }
+        }
+
         private static Tensor CalculateY(Tensor w, Tensor x, Tensor b, Kernel kernel, int numberOfFilters, MatrixLayout matrixLayout)
         {
             Tensor y = new Tensor(null,
@@ -319,6 +618,75 @@
             return dx;
         }
 
+        private static void CalculateGroupConvolution(
+            Tensor w,
+            Tensor x,
+            Tensor b,
+            Tensor y,
+            Kernel kernel,
+            int groups,
+            out Tensor expected,
+            out Tensor dw,
+            out Tensor db,
+            out Tensor dx)
+        {
+            int channels = x.Shape.GetAxis(Axis.C);
+            int numberOfFilters = y.Shape.GetAxis(Axis.C);
+            int cg = channels / groups;
+            int fg = numberOfFilters / groups;
+
+            expected = new Tensor(null, y.Axes);
+            dw = new Tensor(null, w.Axes);
+            db = new Tensor(null, b.Axes);
+            dx = new Tensor(null, x.Axes);
+
+            // negative padding crops the input
+            int xb = Math.Max(-kernel.PaddingX, 0);
+            int xe = x.Shape.GetAxis(Axis.X) - 1 - xb;
+            int yb = Math.Max(-kernel.PaddingY, 0);
+            int ye = x.Shape.GetAxis(Axis.Y) - 1 - yb;
+
+            for (int ib = 0, iib = y.Shape.GetAxis(Axis.B); ib < iib; ib++)
+            {
+                for (int ix = 0, xpos = -kernel.PaddingX, iix = y.Shape.GetAxis(Axis.X); ix < iix; ix++, xpos += kernel.StrideX)
+                {
+                    for (int iy = 0, ypos = -kernel.PaddingY, iiy = y.Shape.GetAxis(Axis.Y); iy < iiy; iy++, ypos += kernel.StrideY)
+                    {
+                        for (int f = 0; f < numberOfFilters; f++)
+                        {
+                            int g = f / fg;
+                            int ypositon = y.Shape.Position(ib, ix, iy, f);
+                            float dy = y.Gradient[ypositon];
+
+                            float sum = b.Weights[f];
+                            db.Gradient[f] += dy;
+
+                            for (int kx = 0; kx < kernel.Width; kx++)
+                            {
+                                for (int ky = 0; ky < kernel.Height; ky++)
+                                {
+                                    if ((xpos + kx).Between(xb, xe) && (ypos + ky).Between(yb, ye))
+                                    {
+                                        for (int c = 0; c < cg; c++)
+                                        {
+                                            int wposition = ((((kx * kernel.Height) + ky) * cg) + c) * numberOfFilters + f;
+                                            int xposition = x.Shape.Position(ib, xpos + kx, ypos + ky, (g * cg) + c);
+
+                                            sum += w.Weights[wposition] * x.Weights[xposition];
+                                            dw.Gradient[wposition] += dy * x.Weights[xposition];
+                                            dx.Gradient[xposition] += dy * w.Weights[wposition];
+                                        }
+                                    }
+                                }
+                            }
+
+                            expected.Weights[ypositon] = sum;
+                        }
+                    }
+                }
+            }
+        }
+
         private static Tensor CalculateDB(Tensor y)
         {
             int y0 = y.Shape.GetAxis(Axis.B);
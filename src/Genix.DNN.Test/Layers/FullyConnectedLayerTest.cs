@@ -207,6 +207,77 @@
             }
         }
 
+        [TestMethod]
+        public void QuantizedForwardTest()
+        {
+            Shape shape = new Shape(new[] { -1, 4, 5, 3 });
+            const int NumberOfNeurons = 10;
+            RandomNumberGenerator<float> random = new RandomGeneratorF();
+
+            foreach (MatrixLayout matrixLayout in Enum.GetValues(typeof(MatrixLayout)).OfType<MatrixLayout>())
+            {
+                FullyConnectedLayer layer = new FullyConnectedLayer(shape, NumberOfNeurons, matrixLayout, null);
+                layer.W.Randomize(random);
+                layer.B.Randomize(random);
+
+                for (int mb = 1; mb <= 3; mb++)
+                {
+                    Tensor x = new Tensor(null, shape.Reshape(0, mb));
+                    x.Randomize(random);
+
+                    layer.InputQuantization = null;
+                    Tensor expected = layer.Forward(new Session(false), new[] { x })[0];
+
+                    layer.InputQuantization = QuantizationParameters.FromRange(x.Min(), x.Max());
+                    Tensor y = layer.Forward(new Session(false), new[] { x })[0];
+                    CollectionAssert.AreEqual(expected.Axes, y.Axes);
+
+                    float tolerance = 0.03f * Math.Max(Math.Abs(expected.Min()), Math.Abs(expected.Max()));
+                    for (int i = 0; i < expected.Length; i++)
+                    {
+                        Assert.AreEqual(expected.Weights[i], y.Weights[i], tolerance);
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        public void HalfPrecisionForwardTest()
+        {
+            Shape shape = new Shape(new[] { -1, 4, 5, 3 });
+            const int NumberOfNeurons = 21;
+            RandomNumberGenerator<float> random = new RandomGeneratorF();
+
+            foreach (MatrixLayout matrixLayout in Enum.GetValues(typeof(MatrixLayout)).OfType<MatrixLayout>())
+            {
+                FullyConnectedLayer layer = new FullyConnectedLayer(shape, NumberOfNeurons, matrixLayout, null);
+                layer.W.Randomize(random);
+                layer.B.Randomize(random);
+
+                for (int mb = 1; mb <= 5; mb++)
+                {
+                    Tensor x = new Tensor(null, shape.Reshape(0, mb));
+                    x.Randomize(random);
+
+                    layer.WeightsPrecision = WeightsPrecision.Single;
+                    Tensor expected = layer.Forward(new Session(false), new[] { x })[0];
+
+                    foreach (WeightsPrecision precision in new[] { WeightsPrecision.Half, WeightsPrecision.BFloat16 })
+                    {
+                        layer.WeightsPrecision = precision;
+                        Tensor y = layer.Forward(new Session(false), new[] { x })[0];
+                        CollectionAssert.AreEqual(expected.Axes, y.Axes);
+
+                        float tolerance = 0.01f * Math.Max(Math.Abs(expected.Min()), Math.Abs(expected.Max()));
+                        for (int i = 0; i < expected.Length; i++)
+                        {
+                            Assert.AreEqual(expected.Weights[i], y.Weights[i], tolerance);
+                        }
+                    }
+                }
+            }
+        }
+
         internal static float[] CalculateNeurons(Tensor w, Tensor x, Tensor b, int numberOfNeurons, MatrixLayout matrixLayout)
         {
             int count = x.Length;
@@ -13,6 +13,8 @@
     [TestClass]
     public class GRUCellTest
     {
+        private readonly RandomNumberGenerator<float> random = new RandomGeneratorF();
+
         [TestMethod, TestCategory("GRU")]
         public void ConstructorTest1()
         {
@@ -420,5 +422,49 @@
                 },
                 x.Gradient);
         }
+
+        [TestMethod, TestCategory("GRU")]
+        public void ForwardPackedTest()
+        {
+            const int inputSize = 5;
+            const int numberOfNeurons = 22;
+
+            foreach (RNNDirection direction in new[] { RNNDirection.ForwardOnly, RNNDirection.BiDirectional })
+            {
+                foreach (MatrixLayout matrixLayout in new[] { MatrixLayout.ColumnMajor, MatrixLayout.RowMajor })
+                {
+                    GRUCell layer = new GRUCell(new Shape(new int[] { 1, inputSize }), direction, numberOfNeurons, matrixLayout, null);
+                    layer.W.Randomize(this.random);
+                    layer.U.Randomize(this.random);
+                    layer.B.Randomize(this.random);
+
+                    Tensor x = new Tensor(null, new[] { 9, inputSize });
+                    x.Randomize(this.random);
+
+                    Session session = new Session(false);
+                    Tensor expected = layer.Forward(session, new[] { x })[0];
+
+                    using (PackedRNNWeights u = PackedRNNWeights.PackGRU(layer.U, direction, numberOfNeurons, matrixLayout))
+                    {
+                        Tensor y = session.GRU(x, layer.W, u, layer.B, direction, numberOfNeurons, matrixLayout);
+                        Helpers.AreTensorsEqual(expected, y);
+                    }
+
+                    // the hidden weights stored in 16 bits
+                    foreach (WeightsPrecision precision in new[] { WeightsPrecision.Half, WeightsPrecision.BFloat16 })
+                    {
+                        using (PackedRNNWeights u = PackedRNNWeights.PackGRU(layer.U, direction, numberOfNeurons, matrixLayout, precision))
+                        {
+                            Tensor y = session.GRU(x, layer.W, u, layer.B, direction, numberOfNeurons, matrixLayout);
+                            CollectionAssert.AreEqual(expected.Axes, y.Axes);
+                            for (int i = 0; i < expected.Length; i++)
+                            {
+                                Assert.AreEqual(expected.Weights[i], y.Weights[i], 1e-2f);
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 }
@@ -239,6 +239,69 @@
             }
         }
 
+        [TestMethod]
+        public void ForwardBackwardTest2()
+        {
+            // the same data as in ForwardBackwardTest, the channels are the outer axis
+            Shape shape = new Shape(Shape.BCHW, -1, 1, 2, 5);
+            LRNLayer layer = new LRNLayer(shape, 3);
+
+            Tensor xTemp = new Tensor(null, shape.Reshape(Axis.B, 1));
+            xTemp.Set(new float[]
+            {
+                1, 2,   11, 12,   21, 22,   31, 32,   41, 42
+            });
+
+            Tensor expectedTemp = new Tensor(null, layer.OutputShape.Reshape(Axis.B, 1));
+            expectedTemp.Set(new float[]
+            {
+                LRNLayerTest.Forward(layer, 1, 11),
+                LRNLayerTest.Forward(layer, 2, 12),
+
+                LRNLayerTest.Forward(layer, 11, 1, 21),
+                LRNLayerTest.Forward(layer, 12, 2, 22),
+
+                LRNLayerTest.Forward(layer, 21, 11, 31),
+                LRNLayerTest.Forward(layer, 22, 12, 32),
+
+                LRNLayerTest.Forward(layer, 31, 21, 41),
+                LRNLayerTest.Forward(layer, 32, 22, 42),
+
+                LRNLayerTest.Forward(layer, 41, 31),
+                LRNLayerTest.Forward(layer, 42, 32),
+            });
+
+            Tensor dyTemp = new Tensor(null, expectedTemp.Shape);
+            dyTemp.Set(new float[]
+            {
+                1, 2,   11, 12,   21, 22,   31, 32,   41, 42
+            });
+
+            Tensor expectedDxTemp = new Tensor(null, xTemp.Shape);
+            expectedDxTemp.Set(new float[]
+            {
+                0.591914058f, 1.18269f,   6.406341f, 6.97113f,   11.8103943f, 12.3151608f,   16.4343262f, 16.8460541f,   22.1168289f, 22.5372047f
+            });
+
+            for (int i = 1; i <= 3; i++)
+            {
+                Session session = new Session();
+
+                Tensor x = session.Tile(xTemp, (int)Axis.B, i);
+                Tensor y = layer.Forward(session, new[] { x })[0];
+
+                Tensor expected = session.Tile(expectedTemp, (int)Axis.B, i);
+                Helpers.AreTensorsEqual(expected, y);
+
+                // unroll the graph
+                y.SetGradient(session.Tile(dyTemp, (int)Axis.B, i).Weights);
+                session.Unroll();
+
+                Tensor expectedDx = session.Tile(expectedDxTemp, (int)Axis.B, i);
+                Helpers.AreArraysEqual(expectedDx.Length, expectedDx.Weights, x.Gradient);
+            }
+        }
+
         private static float Forward(LRNLayer layer, params float[] xs)
         {
             float scale = layer.K + (layer.Alpha * xs.Sum(x => x * x) / layer.KernelSize);
@@ -13,6 +13,8 @@
     [TestClass]
     public class LSTMCellTest
     {
+        private readonly RandomNumberGenerator<float> random = new RandomGeneratorF();
+
         [TestMethod, TestCategory("LSTM")]
         public void ConstructorTest1()
         {
@@ -105,7 +107,7 @@
             Assert.IsFalse(layer.W.Weights.Take(layer.W.Length).All(x => x == 0.0f));
             Assert.AreEqual(0.0, layer.W.Weights.Take(layer.W.Length).Average(), 0.01f);
 
-            CollectionAssert.AreEqual(new[] { 4 * 100, 100 }, layer.U.Axes);
+            CollectionAssert.AreEqual(new[] { 4 * 100, 50 }, layer.U.Axes);
             Assert.IsFalse(layer.U.Weights.Take(layer.U.Length).All(x => x == 0.0f));
             Assert.AreEqual(0.0, layer.U.Weights.Take(layer.U.Length).Average(), 0.01f);
 
@@ -189,6 +191,31 @@
             Assert.AreEqual(s1, s2);
         }
 
+        [TestMethod, TestCategory("LSTM")]
+        public void DeserializeOldBidirectionalTest()
+        {
+            // bi-directional cells saved before the bi-directional LSTM have hidden weights of full width and were computed as forward-only
+            foreach (MatrixLayout matrixLayout in new[] { MatrixLayout.ColumnMajor, MatrixLayout.RowMajor })
+            {
+                LSTMCell layer1 = new LSTMCell(new Shape(new int[] { 1, 5 }), RNNDirection.ForwardOnly, 8, LSTMCell.DefaultForgetBias, matrixLayout, null);
+                string s1 = JsonConvert.SerializeObject(layer1);
+                string old = s1.Replace(
+                    string.Format(CultureInfo.InvariantCulture, "\"direction\":{0}", (int)RNNDirection.ForwardOnly),
+                    string.Format(CultureInfo.InvariantCulture, "\"direction\":{0}", (int)RNNDirection.BiDirectional));
+                Assert.AreNotEqual(s1, old);
+
+                LSTMCell layer2 = JsonConvert.DeserializeObject<LSTMCell>(old);
+                Assert.AreEqual(RNNDirection.ForwardOnly, layer2.Direction);
+                Assert.AreEqual(s1, JsonConvert.SerializeObject(layer2));
+
+                Tensor x = new Tensor(null, new[] { 7, 5 });
+                x.Randomize(this.random);
+
+                Session session = new Session(false);
+                Helpers.AreTensorsEqual(layer1.Forward(session, new[] { x })[0], layer2.Forward(session, new[] { x })[0]);
+            }
+        }
+
         /// <summary>
         /// MatrixLayout = MatrixLayout.ColumnMajor, forgetBias = 0
         /// </summary>
@@ -496,5 +523,259 @@
                 },
                 x.Gradient);
         }
+
+        /// <summary>
+        /// Bidirectional, MatrixLayout = MatrixLayout.ColumnMajor, forgetBias = LSTMCell.DefaultForgetBias
+        /// </summary>
+        [TestMethod, TestCategory("LSTM")]
+        public void ForwardTest5()
+        {
+            const int batchSize = 3;
+            const int inputSize = 3;
+            const int numberOfNeurons = 4;
+
+            LSTMCell layer = new LSTMCell(new Shape(new int[] { batchSize, inputSize }), RNNDirection.BiDirectional, numberOfNeurons, LSTMCell.DefaultForgetBias, MatrixLayout.ColumnMajor, null);
+
+            layer.W.Set(new float[]
+            {
+                -0.5932f, 0.3919f, -0.0862f, 0.3129f, 0.6692f, 0.0539f, 0.0016f, -0.5991f, -0.3242f, -0.0002f, 0.2509f, 0.4252f, -0.1667f, -0.6077f, -0.2966f, 0.5734f,
+                -0.4013f, -0.067f, 0.6037f, -0.6651f, 0.1408f, 0.6302f, -0.3776f, 0.0679f, 0.5728f, -0.5136f, 0.0328f, 0.3506f, 0.2366f, -0.0451f, -0.4132f, -0.0129f,
+                -0.1787f, -0.0316f, -0.1878f, 0.4731f, 0.3761f, -0.2604f, 0.1017f, -0.3135f, -0.066f, -0.2058f, 0.2204f, -0.1815f, -0.0573f, 0.3071f, -0.1218f, 0.569f,
+            });
+
+            layer.U.Set(new float[]
+            {
+                -0.4474f, 0.3376f, -0.1087f, -0.103f, 0.1881f, 0.0321f, -0.1192f, -0.698f, -0.5708f, 0.2932f, 0.0341f, 0.2746f, 0.6377f, 0.2561f, -0.6256f, -0.2676f,
+                0.1296f, -0.3708f, 0.651f, 0.6231f, 0.4878f, -0.0387f, 0.4781f, -0.5164f, -0.2678f, -0.0518f, 0.3386f, -0.0198f, -0.5084f, -0.219f, -0.2458f, -0.2794f,
+            });
+
+            layer.B.Set(new float[]
+            {
+                -0.4683f, -0.1191f, -0.0726f, 0.3849f, 0.4149f, 0.0313f, -0.0551f, 0.3895f,
+                0.5422f, 0.2449f, 0.4207f, 0.6148f, -0.6431f, 0.5259f, -0.3128f, -0.0339f,
+            });
+
+            Tensor x = new Tensor(null, new[] { batchSize, inputSize });
+            x.Set(new float[] { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f });
+
+            // set expectations
+            Tensor expected = new Tensor(null, new[] { batchSize, numberOfNeurons });
+            expected.Set(new float[]
+            {
+                -0.00271957f, 0.1056727f, 0.2120367f, 0.343805f,
+                0.01650119f, 0.1768684f, 0.1754562f, 0.3224904f,
+                0.04142577f, 0.2130591f, 0.1175632f, 0.2178195f,
+            });
+
+            // calculate
+            Session session = new Session();
+            Tensor y = layer.Forward(session, new[] { x })[0];
+            Helpers.AreTensorsEqual(expected, y);
+
+            y.SetGradient(new float[] { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f });
+            session.Unroll();
+
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.01968242f, 0.05904529f, 0.1297918f, 0.1744492f, 0.0006191169f, 0.02014188f, 0.01562258f, 0.1131506f, 0.04698937f, 0.1733225f, 0.1166628f, 0.1692992f, 0.008610242f, 0.009541277f, 0.1014467f, 0.09725635f,
+                    0.02303467f, 0.07518905f, 0.1695175f, 0.2276752f, 0.0006935138f, 0.02375761f, 0.01799933f, 0.1332867f, 0.05552099f, 0.2028022f, 0.1383614f, 0.2010379f, 0.01153403f, 0.01266547f, 0.1230728f, 0.1210497f,
+                    0.02638693f, 0.09133281f, 0.2092433f, 0.2809013f, 0.0007679106f, 0.02737334f, 0.02037608f, 0.1534227f, 0.06405261f, 0.232282f, 0.1600601f, 0.2327765f, 0.01445782f, 0.01578967f, 0.144699f, 0.144843f,
+                },
+                layer.W.Gradient);
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.0002684656f, 0.0005029337f, 0.000866497f, 0.001245359f, 1.857681E-05f, 0.0002655154f, 0.00032603f, 0.001910947f, 0.004480837f, 0.01191122f, 0.01223772f, 0.01848857f, 0.004032614f, 0.00424325f, 0.01707455f, 0.02316474f,
+                    0.005097686f, 0.01371029f, 0.02908048f, 0.03901613f, 0.0001549222f, 0.005168566f, 0.003964731f, 0.02843579f, 0.00827994f, 0.022024f, 0.02260579f, 0.03415847f, 0.007444915f, 0.007836296f, 0.03152713f, 0.04274592f,
+                },
+                layer.U.Gradient);
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.03352253f, 0.1614376f, 0.3972572f, 0.5322606f, 0.000743969f, 0.03615726f, 0.0237675f, 0.2013607f,
+                    0.08531621f, 0.2947972f, 0.2169861f, 0.3173862f, 0.02923788f, 0.03124197f, 0.2162615f, 0.2379334f,
+                },
+                layer.B.Gradient);
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.1107426f, -0.05965618f, 0.1020336f,
+                    0.09289936f, -0.05369844f, 0.06424916f,
+                    0.06399436f, -0.06857369f, -0.02913153f,
+                },
+                x.Gradient);
+        }
+
+        /// <summary>
+        /// Bidirectional, MatrixLayout = MatrixLayout.RowMajor, forgetBias = LSTMCell.DefaultForgetBias
+        /// </summary>
+        [TestMethod, TestCategory("LSTM")]
+        public void ForwardTest6()
+        {
+            const int batchSize = 3;
+            const int inputSize = 3;
+            const int numberOfNeurons = 4;
+
+            LSTMCell layer = new LSTMCell(new Shape(new int[] { batchSize, inputSize }), RNNDirection.BiDirectional, numberOfNeurons, LSTMCell.DefaultForgetBias, MatrixLayout.RowMajor, null);
+
+            layer.W.Set(new float[]
+            {
+                -0.5932f, -0.4013f, -0.1787f, 0.3919f, -0.067f, -0.0316f,
+                -0.0862f, 0.6037f, -0.1878f, 0.3129f, -0.6651f, 0.4731f,
+                0.6692f, 0.1408f, 0.3761f, 0.0539f, 0.6302f, -0.2604f,
+                0.0016f, -0.3776f, 0.1017f, -0.5991f, 0.0679f, -0.3135f,
+                -0.3242f, 0.5728f, -0.066f, -0.0002f, -0.5136f, -0.2058f,
+                0.2509f, 0.0328f, 0.2204f, 0.4252f, 0.3506f, -0.1815f,
+                -0.1667f, 0.2366f, -0.0573f, -0.6077f, -0.0451f, 0.3071f,
+                -0.2966f, -0.4132f, -0.1218f, 0.5734f, -0.0129f, 0.569f,
+            });
+
+            layer.U.Set(new float[]
+            {
+                -0.4474f, 0.1296f, 0.3376f, -0.3708f, -0.1087f, 0.651f, -0.103f, 0.6231f,
+                0.1881f, 0.4878f, 0.0321f, -0.0387f, -0.1192f, 0.4781f, -0.698f, -0.5164f,
+                -0.5708f, -0.2678f, 0.2932f, -0.0518f, 0.0341f, 0.3386f, 0.2746f, -0.0198f,
+                0.6377f, -0.5084f, 0.2561f, -0.219f, -0.6256f, -0.2458f, -0.2676f, -0.2794f,
+            });
+
+            layer.B.Set(new float[]
+            {
+                -0.4683f, -0.1191f, -0.0726f, 0.3849f, 0.4149f, 0.0313f, -0.0551f, 0.3895f,
+                0.5422f, 0.2449f, 0.4207f, 0.6148f, -0.6431f, 0.5259f, -0.3128f, -0.0339f,
+            });
+
+            Tensor x = new Tensor(null, new[] { batchSize, inputSize });
+            x.Set(new float[] { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f });
+
+            // set expectations
+            Tensor expected = new Tensor(null, new[] { batchSize, numberOfNeurons });
+            expected.Set(new float[]
+            {
+                -0.00271957f, 0.1056727f, 0.2120367f, 0.343805f,
+                0.01650119f, 0.1768684f, 0.1754562f, 0.3224904f,
+                0.04142577f, 0.2130591f, 0.1175632f, 0.2178195f,
+            });
+
+            // calculate
+            Session session = new Session();
+            Tensor y = layer.Forward(session, new[] { x })[0];
+            Helpers.AreTensorsEqual(expected, y);
+
+            y.SetGradient(new float[] { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f });
+            session.Unroll();
+
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.01968242f, 0.02303467f, 0.02638693f, 0.05904529f, 0.07518905f, 0.09133281f,
+                    0.1297918f, 0.1695175f, 0.2092433f, 0.1744492f, 0.2276752f, 0.2809013f,
+                    0.0006191169f, 0.0006935138f, 0.0007679106f, 0.02014188f, 0.02375761f, 0.02737334f,
+                    0.01562258f, 0.01799933f, 0.02037608f, 0.1131506f, 0.1332867f, 0.1534227f,
+                    0.04698937f, 0.05552099f, 0.06405261f, 0.1733225f, 0.2028022f, 0.232282f,
+                    0.1166628f, 0.1383614f, 0.1600601f, 0.1692992f, 0.2010379f, 0.2327765f,
+                    0.008610242f, 0.01153403f, 0.01445782f, 0.009541277f, 0.01266547f, 0.01578967f,
+                    0.1014467f, 0.1230728f, 0.144699f, 0.09725635f, 0.1210497f, 0.144843f,
+                },
+                layer.W.Gradient);
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.0002684656f, 0.005097686f, 0.0005029337f, 0.01371029f, 0.000866497f, 0.02908048f, 0.001245359f, 0.03901613f,
+                    1.857681E-05f, 0.0001549222f, 0.0002655154f, 0.005168566f, 0.00032603f, 0.003964731f, 0.001910947f, 0.02843579f,
+                    0.004480837f, 0.00827994f, 0.01191122f, 0.022024f, 0.01223772f, 0.02260579f, 0.01848857f, 0.03415847f,
+                    0.004032614f, 0.007444915f, 0.00424325f, 0.007836296f, 0.01707455f, 0.03152713f, 0.02316474f, 0.04274592f,
+                },
+                layer.U.Gradient);
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.03352253f, 0.1614376f, 0.3972572f, 0.5322606f, 0.000743969f, 0.03615726f, 0.0237675f, 0.2013607f,
+                    0.08531621f, 0.2947972f, 0.2169861f, 0.3173862f, 0.02923788f, 0.03124197f, 0.2162615f, 0.2379334f,
+                },
+                layer.B.Gradient);
+            Helpers.AreArraysEqual(
+                new float[]
+                {
+                    0.1107426f, -0.05965618f, 0.1020336f,
+                    0.09289936f, -0.05369844f, 0.06424916f,
+                    0.06399436f, -0.06857369f, -0.02913153f,
+                },
+                x.Gradient);
+        }
+
+        [TestMethod, TestCategory("LSTM")]
+        public void ForwardBatchTest()
+        {
+            const int inputSize = 5;
+            const int numberOfNeurons = 11;
+
+            foreach (MatrixLayout matrixLayout in new[] { MatrixLayout.ColumnMajor, MatrixLayout.RowMajor })
+            {
+                LSTMCell layer = new LSTMCell(new Shape(new int[] { 1, inputSize }), RNNDirection.ForwardOnly, numberOfNeurons, LSTMCell.DefaultForgetBias, matrixLayout, null);
+                layer.W.Randomize(this.random);
+                layer.U.Randomize(this.random);
+                layer.B.Randomize(this.random);
+
+                // sequences of different lengths
+                Tensor[] xs = new[] { 7, 3, 5, 1 }.Select(length =>
+                {
+                    Tensor x = new Tensor(null, new[] { length, inputSize });
+                    x.Randomize(this.random);
+                    return x;
+                }).ToArray();
+
+                Session session = new Session(false);
+                Tensor[] ys = session.LSTM(xs, layer.W, layer.U, layer.B, layer.Direction, numberOfNeurons, layer.ForgetBias, matrixLayout);
+
+                Assert.AreEqual(xs.Length, ys.Length);
+                for (int i = 0; i < xs.Length; i++)
+                {
+                    Tensor expected = layer.Forward(session, new[] { xs[i] })[0];
+                    Helpers.AreTensorsEqual(expected, ys[i]);
+                }
+            }
+        }
+
+        [TestMethod, TestCategory("LSTM")]
+        public void ForwardPackedTest()
+        {
+            const int inputSize = 5;
+            const int numberOfNeurons = 21;
+
+            foreach (MatrixLayout matrixLayout in new[] { MatrixLayout.ColumnMajor, MatrixLayout.RowMajor })
+            {
+                LSTMCell layer = new LSTMCell(new Shape(new int[] { 1, inputSize }), RNNDirection.ForwardOnly, numberOfNeurons, LSTMCell.DefaultForgetBias, matrixLayout, null);
+                layer.W.Randomize(this.random);
+                layer.U.Randomize(this.random);
+                layer.B.Randomize(this.random);
+
+                Tensor x = new Tensor(null, new[] { 9, inputSize });
+                x.Randomize(this.random);
+
+                Session session = new Session(false);
+                Tensor expected = layer.Forward(session, new[] { x })[0];
+
+                using (PackedRNNWeights u = PackedRNNWeights.PackLSTM(layer.U, numberOfNeurons, matrixLayout))
+                {
+                    Tensor y = session.LSTM(x, layer.W, u, layer.B, layer.Direction, numberOfNeurons, layer.ForgetBias, matrixLayout);
+                    Helpers.AreTensorsEqual(expected, y);
+                }
+
+                // the hidden weights stored in 16 bits
+                foreach (WeightsPrecision precision in new[] { WeightsPrecision.Half, WeightsPrecision.BFloat16 })
+                {
+                    using (PackedRNNWeights u = PackedRNNWeights.PackLSTM(layer.U, numberOfNeurons, matrixLayout, precision))
+                    {
+                        Tensor y = session.LSTM(x, layer.W, u, layer.B, layer.Direction, numberOfNeurons, layer.ForgetBias, matrixLayout);
+                        CollectionAssert.AreEqual(expected.Axes, y.Axes);
+                        for (int i = 0; i < expected.Length; i++)
+                        {
+                            Assert.AreEqual(expected.Weights[i], y.Weights[i], 1e-2f);
+                        }
+                    }
+                }
+            }
+        }
     }
 }
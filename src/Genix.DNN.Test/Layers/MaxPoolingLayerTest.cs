@@ -238,6 +238,57 @@
             }
         }
 
+        [TestMethod]
+        [TestCategory("MaxPoolingLayer")]
+        public void ForwardBackwardTiesTest()
+        {
+            // the kernels cover the byte indices, the fast 2x2 and 3x3 windows,
+            // negative padding, windows that lie entirely in the padding,
+            // and the 32-bit indices of the windows that have 255 elements and more
+            Kernel[] kernels = new[]
+            {
+                new Kernel(2, 2, 2, 2),
+                new Kernel(3, 3, 1, 1),
+                new Kernel(3, 2, 2, 1, -2, -1),
+                new Kernel(2, 2, 3, 3, 2, 2),
+                new Kernel(16, 16, 2, 3),
+                new Kernel(15, 17, 3, 2, 1, 0),
+                new Kernel(16, 16, 17, 17, 16, 16),
+            };
+
+            Random random = new Random(0);
+
+            foreach (string format in new[] { Shape.BWHC, Shape.BHWC, Shape.BCHW })
+            {
+                Shape shape = new Shape(format, -1, 20, 18, 3);
+                foreach (Kernel kernel in kernels)
+                {
+                    MaxPoolingLayer layer = new MaxPoolingLayer(shape, kernel);
+
+                    Session session = new Session(true);
+
+                    // few distinct values, so most windows have several maximums
+                    Tensor x = new Tensor(null, shape.Reshape(Axis.B, 2));
+                    for (int i = 0; i < x.Length; i++)
+                    {
+                        x.Weights[i] = random.Next(3);
+                    }
+
+                    Tensor y = layer.Forward(session, new[] { x })[0];
+
+                    y.RandomizeGradient(this.random);
+                    session.Unroll();
+
+                    Tensor expected = new Tensor(null, y.Shape);
+                    Tensor expectedDX = new Tensor(null, x.Shape);
+                    MaxPoolingLayerTest.CalculateFirstMaximums(x, y, kernel, expected, expectedDX);
+
+                    Helpers.AreTensorsEqual(expected, y);
+                    Helpers.AreGradientsEqual(expectedDX, x);
+                }
+            }
+        }
+
         private static Tensor CalculateY(Tensor x, Kernel kernel)
         {
             Tensor y = new Tensor(null,
@@ -281,6 +332,64 @@
             return y;
         }
 
+        // y receives the maximums, and the gradient of every output goes to the first of the maximums of its window only.
+        // The windows are clipped to the image, the window that lies entirely in the padding produces zero.
+        private static void CalculateFirstMaximums(Tensor x, Tensor y, Kernel kernel, Tensor expectedY, Tensor expectedDX)
+        {
+            int width = x.Shape.GetAxis(Axis.X);
+            int height = x.Shape.GetAxis(Axis.Y);
+
+            // negative padding crops the image
+            int xb = Math.Max(0, -kernel.PaddingX);
+            int xe = Math.Min(width, width + kernel.PaddingX);
+            int yb = Math.Max(0, -kernel.PaddingY);
+            int ye = Math.Min(height, height + kernel.PaddingY);
+
+            for (int ib = 0; ib < y.Shape.GetAxis(Axis.B); ib++)
+            {
+                for (int dstx = 0; dstx < y.Shape.GetAxis(Axis.X); dstx++)
+                {
+                    int ix = -kernel.PaddingX + (dstx * kernel.StrideX);
+                    int kxb = Math.Max(ix, xb);
+                    int kxe = Math.Min(ix + kernel.Width, xe);
+
+                    for (int dsty = 0; dsty < y.Shape.GetAxis(Axis.Y); dsty++)
+                    {
+                        int iy = -kernel.PaddingY + (dsty * kernel.StrideY);
+                        int kyb = Math.Max(iy, yb);
+                        int kye = Math.Min(iy + kernel.Height, ye);
+
+                        for (int ic = 0; ic < y.Shape.GetAxis(Axis.C); ic++)
+                        {
+                            int ypos = y.Shape.Position(ib, dstx, dsty, ic);
+
+                            // the first maximum is the one with the lowest position in memory
+                            int first = -1;
+                            for (int ikx = kxb; ikx < kxe; ikx++)
+                            {
+                                for (int iky = kyb; iky < kye; iky++)
+                                {
+                                    int xpos = x.Shape.Position(ib, ikx, iky, ic);
+                                    if (first == -1 ||
+                                        x.Weights[xpos] > x.Weights[first] ||
+                                        (x.Weights[xpos] == x.Weights[first] && xpos < first))
+                                    {
+                                        first = xpos;
+                                    }
+                                }
+                            }
+
+                            if (first != -1)
+                            {
+                                expectedY.Weights[ypos] = x.Weights[first];
+                                expectedDX.Gradient[first] += y.Gradient[ypos];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
         private static Tensor CalculateDX(Tensor x, Tensor y, Kernel kernel)
         {
             Tensor dx = new Tensor(null, x.Shape);
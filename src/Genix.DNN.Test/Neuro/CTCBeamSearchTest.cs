@@ -2,6 +2,7 @@
 {
     using System;
     using System.Collections.Generic;
+    using System.Linq;
     using Genix.MachineLearning;
     using Genix.MachineLearning.LanguageModel;
     using Microsoft.VisualStudio.TestTools.UnitTesting;
@@ -132,5 +133,46 @@
             CTCBeamSearch loss = new CTCBeamSearch(classes, charset);
             IList<(string[], float)> results = loss.BeamSearch(a);
         }
+
+        [TestMethod]
+        public void BatchTest()
+        {
+            string[] classes = new string[] { "@", "A", "B" };
+
+            Tensor a = new Tensor(null, new[] { 3, 3 });
+            a.Set(new float[]
+            {
+                0.2f, 0.5f, 0.3f,
+                0.1f, 0.7f, 0.2f,
+                0.1f, 0.3f, 0.6f
+            });
+
+            Tensor b = new Tensor(null, new[] { 2, 3 });
+            b.Set(new float[]
+            {
+                0.1f, 0.1f, 0.8f,
+                0.8f, 0.1f, 0.1f,
+            });
+
+            CTCBeamSearch search = new CTCBeamSearch(classes);
+            IList<IList<(string[] Classes, float Probability)>> results = search.BeamSearch(new[] { a, b });
+
+            Assert.AreEqual(2, results.Count);
+            CollectionAssert.AreEqual(new[] { "A", "B" }, results[0][0].Classes);
+            CollectionAssert.AreEqual(new[] { "B" }, results[1][0].Classes);
+
+            // with all classes tried at each step the probabilities of the prefixes are exact
+            float ab = path(a, 1, 1, 2) + path(a, 1, 2, 2) + path(a, 1, 2, 0) + path(a, 1, 0, 2) + path(a, 0, 1, 2);
+            float aa = path(a, 1, 0, 1);
+            int index = results[0].ToList().FindIndex(x => x.Classes.SequenceEqual(new[] { "A", "A" }));
+            Assert.AreEqual(ab / aa, results[0][0].Probability / results[0][index].Probability, 1e-4f);
+
+            float path(Tensor y, int v1, int v2, int v3)
+            {
+                return y[(0 * 3) + v1] *
+                       y[(1 * 3) + v2] *
+                       y[(2 * 3) + v3];
+            }
+        }
     }
 }
@@ -4,7 +4,9 @@
     using System.IO;
     using System.Linq;
     using System.Threading;
+    using Genix.Core;
     using Genix.DNN;
+    using Genix.DNN.Layers;
     using Genix.DNN.Learning;
     using Genix.MachineLearning;
     using Genix.MachineLearning.Learning;
@@ -91,6 +93,31 @@
             Assert.AreEqual(1.0, probability.Weights[0] + probability.Weights[1] + probability.Weights[2], 1e-6);
         }
 
+        [TestMethod]
+        [Description("should quantize the layers it has seen input for")]
+        public void QuantizationCalibratorTest()
+        {
+            ClassificationNetwork network = ClassificationNetwork.FromArchitecture("10x10x2~5N~5N~3N", this.classes);
+
+            Tensor x = new Tensor(null, new Shape(Shape.BWHC, 4, 10, 10, 2));
+            x.Randomize(new RandomGeneratorF());
+
+            Tensor expected = network.Forward(null, x).Clone() as Tensor;
+
+            QuantizationCalibrator calibrator = new QuantizationCalibrator(network);
+            calibrator.Add(x);
+            Assert.AreEqual(3, calibrator.Count);
+
+            calibrator.Apply();
+            Assert.IsTrue(network.Graph.Vertices.OfType<FullyConnectedLayer>().All(layer => layer.InputQuantization != null));
+
+            Tensor y = network.Forward(null, x);
+            for (int i = 0; i < expected.Length; i++)
+            {
+                Assert.AreEqual(expected.Weights[i], y.Weights[i], 0.02f);
+            }
+        }
+
         [TestMethod]
         [Description("should forward prop volumes to probabilities")]
         public void ForwardVolumes()
@@ -1,6 +1,7 @@
 ﻿namespace Genix.DNN.Test
 {
     using System;
+    using System.Collections.Generic;
     using System.Linq;
     using Genix.Core;
     using Genix.MachineLearning;
@@ -117,6 +118,138 @@
         }
 #endif
 
+        [TestMethod]
+        public void AdaptiveAveragePoolingTest()
+        {
+            foreach (string format in new[] { Shape.BWHC, Shape.BHWC, Shape.BCHW })
+            {
+                foreach ((int width, int height) in new[] { (1, 1), (3, 2), (5, 4) })
+                {
+                    Session session = new Session();
+
+                    Tensor x = new Tensor(null, new Shape(format, 2, 7, 5, 3));
+                    x.Randomize(this.random);
+
+                    Tensor y = NeuralOperations.AdaptiveAveragePooling(session, x, width, height);
+
+                    Tensor expected = new Tensor(null, new Shape(format, 2, width, height, 3));
+                    NeuralOperationsTest.AdaptivePooling(x, expected, window => window.Average());
+                    Helpers.AreTensorsEqual(expected, y);
+
+                    y.RandomizeGradient(this.random);
+                    session.Unroll();
+
+                    float[] expectedDX = new float[x.Length];
+                    NeuralOperationsTest.AdaptivePoolingWindows(x.Shape, y.Shape, (ypos, xpos, count) =>
+                    {
+                        foreach (int pos in xpos)
+                        {
+                            expectedDX[pos] += y.Gradient[ypos] / count;
+                        }
+                    });
+
+                    Helpers.AreArraysEqual(x.Length, expectedDX, x.Gradient);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void AdaptiveMaxPoolingTest()
+        {
+            foreach (string format in new[] { Shape.BWHC, Shape.BHWC, Shape.BCHW })
+            {
+                foreach ((int width, int height) in new[] { (1, 1), (3, 2), (5, 4) })
+                {
+                    Session session = new Session();
+
+                    Tensor x = new Tensor(null, new Shape(format, 2, 7, 5, 3));
+                    x.Randomize(this.random);
+
+                    Tensor y = NeuralOperations.AdaptiveMaxPooling(session, x, width, height);
+
+                    Tensor expected = new Tensor(null, new Shape(format, 2, width, height, 3));
+                    NeuralOperationsTest.AdaptivePooling(x, expected, window => window.Max());
+                    Helpers.AreTensorsEqual(expected, y);
+
+                    y.RandomizeGradient(this.random);
+                    session.Unroll();
+
+                    float[] expectedDX = new float[x.Length];
+                    NeuralOperationsTest.AdaptivePoolingWindows(x.Shape, y.Shape, (ypos, xpos, count) =>
+                    {
+                        int argmax = xpos.OrderByDescending(pos => x.Weights[pos]).First();
+                        expectedDX[argmax] += y.Gradient[ypos];
+                    });
+
+                    Helpers.AreArraysEqual(x.Length, expectedDX, x.Gradient);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void GlobalPoolingTest()
+        {
+            // a kernel that covers the whole image takes the global pooling path, checked against a scalar loop
+            foreach (string format in new[] { Shape.BWHC, Shape.BHWC, Shape.BCHW })
+            {
+                Kernel kernel = new Kernel(7, 5, 7, 5);
+
+                // average pooling
+                {
+                    Session session = new Session();
+
+                    Tensor x = new Tensor(null, new Shape(format, 2, 7, 5, 3));
+                    x.Randomize(this.random);
+
+                    Tensor y = NeuralOperations.AveragePooling(session, x, kernel);
+
+                    Tensor expected = new Tensor(null, new Shape(format, 2, 1, 1, 3));
+                    NeuralOperationsTest.AdaptivePooling(x, expected, window => window.Average());
+                    Helpers.AreTensorsEqual(expected, y);
+
+                    y.RandomizeGradient(this.random);
+                    session.Unroll();
+
+                    float[] expectedDX = new float[x.Length];
+                    NeuralOperationsTest.AdaptivePoolingWindows(x.Shape, y.Shape, (ypos, xpos, count) =>
+                    {
+                        foreach (int pos in xpos)
+                        {
+                            expectedDX[pos] += y.Gradient[ypos] / count;
+                        }
+                    });
+
+                    Helpers.AreArraysEqual(x.Length, expectedDX, x.Gradient);
+                }
+
+                // max pooling
+                {
+                    Session session = new Session();
+
+                    Tensor x = new Tensor(null, new Shape(format, 2, 7, 5, 3));
+                    x.Randomize(this.random);
+
+                    Tensor y = NeuralOperations.MaxPooling(session, x, kernel);
+
+                    Tensor expected = new Tensor(null, new Shape(format, 2, 1, 1, 3));
+                    NeuralOperationsTest.AdaptivePooling(x, expected, window => window.Max());
+                    Helpers.AreTensorsEqual(expected, y);
+
+                    y.RandomizeGradient(this.random);
+                    session.Unroll();
+
+                    float[] expectedDX = new float[x.Length];
+                    NeuralOperationsTest.AdaptivePoolingWindows(x.Shape, y.Shape, (ypos, xpos, count) =>
+                    {
+                        int argmax = xpos.OrderByDescending(pos => x.Weights[pos]).First();
+                        expectedDX[argmax] += y.Gradient[ypos];
+                    });
+
+                    Helpers.AreArraysEqual(x.Length, expectedDX, x.Gradient);
+                }
+            }
+        }
+
         [TestMethod]
         public void DropoutTest2()
         {
@@ -146,5 +279,45 @@
                           .ToArray(),
                 x.Gradient);
         }
+
+        private static void AdaptivePoolingWindows(Shape xshape, Shape yshape, Action<int, int[], int> action)
+        {
+            int xwidth = xshape.GetAxis(Axis.X);
+            int xheight = xshape.GetAxis(Axis.Y);
+            int ywidth = yshape.GetAxis(Axis.X);
+            int yheight = yshape.GetAxis(Axis.Y);
+
+            for (int b = 0; b < yshape.GetAxis(Axis.B); b++)
+            {
+                for (int ix = 0; ix < ywidth; ix++)
+                {
+                    int x0 = ix * xwidth / ywidth;
+                    int x1 = (((ix + 1) * xwidth) + ywidth - 1) / ywidth;
+
+                    for (int iy = 0; iy < yheight; iy++)
+                    {
+                        int y0 = iy * xheight / yheight;
+                        int y1 = (((iy + 1) * xheight) + yheight - 1) / yheight;
+
+                        for (int c = 0; c < yshape.GetAxis(Axis.C); c++)
+                        {
+                            int[] xpos = (from wx in Enumerable.Range(x0, x1 - x0)
+                                          from wy in Enumerable.Range(y0, y1 - y0)
+                                          select xshape.Position(b, wx, wy, c)).ToArray();
+
+                            action(yshape.Position(b, ix, iy, c), xpos, xpos.Length);
+                        }
+                    }
+                }
+            }
+        }
+
+        private static void AdaptivePooling(Tensor x, Tensor y, Func<IEnumerable<float>, float> func)
+        {
+            NeuralOperationsTest.AdaptivePoolingWindows(x.Shape, y.Shape, (ypos, xpos, count) =>
+            {
+                y.Weights[ypos] = func(xpos.Select(pos => x.Weights[pos]));
+            });
+        }
     }
 }
@@ -12,6 +12,8 @@ namespace Genix.DNN
     using System.Globalization;
     using System.Linq;
     using System.Runtime.CompilerServices;
+    using System.Runtime.InteropServices;
+    using System.Security;
     using Genix.Core;
     using Genix.MachineLearning;
     using Genix.MachineLearning.LanguageModel;
@@ -118,6 +120,18 @@ namespace Genix.DNN
         /// </value>
         public int ResultCount { get; set; } = 10;
 
+        /// <summary>
+        /// Gets or sets the number of most probable classes the hypotheses are extended with at each input step.
+        /// </summary>
+        /// <value>
+        /// The number of classes tried at each input step. Default is 3.
+        /// </value>
+        /// <remarks>
+        /// The value is used only by <see cref="BeamSearch(IList{Tensor})"/> when there is no language model;
+        /// with language model the hypotheses are extended with all characters the model allows.
+        /// </remarks>
+        public int ClassCount { get; set; } = 3;
+
         /// <summary>
         /// Gets or sets a value indicating whether the character frequencies from the language model should be used.
         /// </summary>
@@ -166,6 +180,131 @@ namespace Genix.DNN
             return this.CreateFinalAnswer(flop);
         }
 
+        /// <summary>
+        /// Performs a beam search decoding the logits of many lines in parallel.
+        /// </summary>
+        /// <param name="ys">The logits that have been predicted for each line. The lines may have different length, but must have the same alphabet size.</param>
+        /// <returns>The collection of decoded class sequences along with their weights, for each line.</returns>
+        /// <remarks>
+        /// The decoding is done by the native prefix beam search that keeps <see cref="BufferCount"/> hypotheses at each input step
+        /// and shares their common prefixes.
+        /// </remarks>
+        public IList<IList<(string[] Classes, float Probability)>> BeamSearch(IList<Tensor> ys)
+        {
+            if (ys == null)
+            {
+                throw new ArgumentNullException(nameof(ys));
+            }
+
+#pragma warning disable SA1312 // Variable names must begin with lower-case letter
+            int N = ys.Count;                               // Number of lines
+            int T = N > 0 ? ys.Max(x => x.Shape.Axes[0]) : 0; // Maximum number of mini-batches (time)
+            int A = this.classes.Count;                     // Number of classes (alphabet size)
+#pragma warning restore SA1312 // Variable names must begin with lower-case letter
+
+            int[] lengths = new int[N];
+            float[] y = new float[N * T * A];
+            for (int n = 0; n < N; n++)
+            {
+                Tensor yn = ys[n];
+                if (yn.Shape.Strides[0] != A)
+                {
+                    throw new ArgumentException("The number of predicted classes does not match the number of classes.");
+                }
+
+                lengths[n] = yn.Shape.Axes[0];
+                Vectors.Copy(yn.Length, yn.Weights, 0, y, n * T * A);
+            }
+
+            // the space class cannot start a hypothesis or follow itself
+            int space = this.classes2Idx.TryGetValue(' ', out int spaceIndex) ? spaceIndex : -1;
+
+            int resultCount = this.ResultCount;
+            int[] results = new int[N * resultCount * T];
+            int[] resultLengths = new int[N * resultCount];
+            float[] scores = new float[N * resultCount];
+
+            if (this.languageModel != null)
+            {
+                using (NativeLanguageModel lm = new NativeLanguageModel(this))
+                {
+                    NativeMethods.CTCLanguageModel model = lm.Model;
+                    NativeMethods.CTCBeamSearch(
+                        N,
+                        T,
+                        A,
+                        y,
+                        lengths,
+                        this.BlankLabelIndex,
+                        space,
+                        this.BufferCount,
+                        this.ClassCount,
+                        ref model,
+                        this.missingProb,
+                        resultCount,
+                        results,
+                        resultLengths,
+                        scores);
+                }
+            }
+            else
+            {
+                NativeMethods.CTCBeamSearch(
+                    N,
+                    T,
+                    A,
+                    y,
+                    lengths,
+                    this.BlankLabelIndex,
+                    space,
+                    this.BufferCount,
+                    this.ClassCount,
+                    IntPtr.Zero,
+                    this.missingProb,
+                    resultCount,
+                    results,
+                    resultLengths,
+                    scores);
+            }
+
+            List<IList<(string[], float)>> answers = new List<IList<(string[], float)>>(N);
+            for (int n = 0; n < N; n++)
+            {
+                List<(string[] Classes, float Prob)> final = new List<(string[], float)>(resultCount);
+                float esum = float.NegativeInfinity;
+
+                for (int i = 0, off = n * resultCount; i < resultCount; i++, off++)
+                {
+                    float prob = scores[off];
+                    if (float.IsNegativeInfinity(prob) || (final.Count > 0 && final[0].Prob - prob > (float)Math.Log(100.0f)))
+                    {
+                        break;
+                    }
+
+                    esum = Mathematics.LogSumExp(esum, prob);
+
+                    string[] hypotheses = new string[resultLengths[off]];
+                    for (int j = 0, offr = off * T; j < hypotheses.Length; j++)
+                    {
+                        int idx = results[offr + j];
+                        hypotheses[j] = idx < 0 ? this.missingClasses[~idx] : this.classes[idx];
+                    }
+
+                    final.Add((hypotheses, prob));
+                }
+
+                // normalize probabilities
+                for (int i = 0; i < final.Count; i++)
+                {
+                    final[i] = (final[i].Classes, (float)Math.Exp(final[i].Prob - esum));
+                }
+
+                answers.Add(final);
+            }
+
+            return answers;
+        }
+
 #pragma warning disable SA1313 // Variable names must begin with lower-case letter
         private Buffers BeamSearch(Buffers flip, Buffers flop, int T, int A, float[] ylog)
 #pragma warning restore SA1313 // Variable names must begin with lower-case letter
@@ -448,6 +587,117 @@ namespace Genix.DNN
             return final;
         }
 
+        /// <summary>
+        /// Exposes the language model to the native beam search.
+        /// </summary>
+        /// <remarks>
+        /// The native code refers to the language model states by their indexes in the list of states seen so far.
+        /// It asks about every state once per call and never from two threads at once, so the callbacks need no lock.
+        /// </remarks>
+        private sealed class NativeLanguageModel : IDisposable
+        {
+            private readonly CTCBeamSearch owner;
+            private readonly List<State> states = new List<State>();
+            private readonly Dictionary<State, int> stateIndexes = new Dictionary<State, int>(new ReferenceComparer());
+            private readonly NativeMethods.ExpandCallback expand;
+            private readonly NativeMethods.FinalCallback final;
+
+            public NativeLanguageModel(CTCBeamSearch owner)
+            {
+                this.owner = owner;
+                this.expand = this.Expand;
+                this.final = this.Final;
+
+                this.Model = new NativeMethods.CTCLanguageModel()
+                {
+                    Context = IntPtr.Zero,
+                    InitialState = this.GetStateIndex(owner.languageModel.InitialState),
+                    Expand = Marshal.GetFunctionPointerForDelegate(this.expand),
+                    Final = Marshal.GetFunctionPointerForDelegate(this.final),
+                };
+            }
+
+            public NativeMethods.CTCLanguageModel Model { get; }
+
+            public void Dispose()
+            {
+                // the callbacks must stay alive until the native code returns
+                GC.KeepAlive(this.expand);
+                GC.KeepAlive(this.final);
+            }
+
+            private int Expand(IntPtr context, int state, int capacity, IntPtr labels, IntPtr scores, IntPtr nextStates)
+            {
+                IDictionary<char, State> nextstates = this.states[state].NextStates();
+                if (nextstates == null)
+                {
+                    return 0;
+                }
+
+                if (nextstates.Count <= capacity)
+                {
+                    int offset = 0;
+                    foreach (State nextstate in nextstates.Values)
+                    {
+                        SingleBits prob = new SingleBits() { Single = this.owner.UseStatistics ? nextstate.CharProbability : 0.0f };
+
+                        Marshal.WriteInt32(labels, offset, this.owner.TryGetClass(nextstate.Char));
+                        Marshal.WriteInt32(scores, offset, prob.Int32);
+                        Marshal.WriteInt32(nextStates, offset, this.GetStateIndex(nextstate));
+                        offset += sizeof(int);
+                    }
+                }
+
+                return nextstates.Count;
+            }
+
+            private float Final(IntPtr context, int state)
+            {
+                State s = this.states[state];
+                if (!s.WordEnd)
+                {
+                    return float.NegativeInfinity;
+                }
+
+                return this.owner.UseStatistics ? s.WordEndProbability : 0.0f;
+            }
+
+            private int GetStateIndex(State state)
+            {
+                if (!this.stateIndexes.TryGetValue(state, out int index))
+                {
+                    index = this.states.Count;
+                    this.states.Add(state);
+                    this.stateIndexes.Add(state, index);
+                }
+
+                return index;
+            }
+
+            /// <summary>
+            /// Reinterprets a single-precision number as an integer, so it is written to the native memory without an array.
+            /// </summary>
+            [StructLayout(LayoutKind.Explicit)]
+            private struct SingleBits
+            {
+                [FieldOffset(0)]
+                public float Single;
+
+                [FieldOffset(0)]
+                public int Int32;
+            }
+
+            /// <summary>
+            /// Compares the states by reference, <see cref="State.Equals(object)"/> compares their properties.
+            /// </summary>
+            private sealed class ReferenceComparer : IEqualityComparer<State>
+            {
+                public bool Equals(State x, State y) => object.ReferenceEquals(x, y);
+
+                public int GetHashCode(State obj) => RuntimeHelpers.GetHashCode(obj);
+            }
+        }
+
         /// <summary>
         /// Represents a sequence of hypotheses at input step.
         /// </summary>
@@ -742,5 +992,62 @@ namespace Genix.DNN
                 this.Push(buffer);
             }
         }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.DNN.Native.dll";
+
+            [UnmanagedFunctionPointer(CallingConvention.Winapi)]
+            public delegate int ExpandCallback(IntPtr context, int state, int capacity, IntPtr labels, IntPtr scores, IntPtr nextStates);
+
+            [UnmanagedFunctionPointer(CallingConvention.Winapi)]
+            public delegate float FinalCallback(IntPtr context, int state);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void CTCBeamSearch(
+                int N,
+                int T,
+                int A,
+                [In] float[] y,
+                [In] int[] lengths,
+                int blank,
+                int space,
+                int beamWidth,
+                int topk,
+                ref CTCLanguageModel lm,
+                float missingLogProb,
+                int resultCount,
+                [Out] int[] results,
+                [Out] int[] resultLengths,
+                [Out] float[] scores);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void CTCBeamSearch(
+                int N,
+                int T,
+                int A,
+                [In] float[] y,
+                [In] int[] lengths,
+                int blank,
+                int space,
+                int beamWidth,
+                int topk,
+                IntPtr lm,
+                float missingLogProb,
+                int resultCount,
+                [Out] int[] results,
+                [Out] int[] resultLengths,
+                [Out] float[] scores);
+
+            [StructLayout(LayoutKind.Sequential)]
+            public struct CTCLanguageModel
+            {
+                public IntPtr Context;
+                public int InitialState;
+                public IntPtr Expand;
+                public IntPtr Final;
+            }
+        }
     }
 }
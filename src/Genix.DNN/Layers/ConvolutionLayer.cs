@@ -24,7 +24,12 @@ namespace Genix.DNN.Layers
         /// <summary>
         /// The regular expression pattern that matches layer architecture.
         /// </summary>
-        public const string ArchitecturePattern = @"^(\d+)(C)(\d+)(?:x(\d+))?(?:\+(\d+)(?:x(\d+))?\(S\))?(?:\+(-?\d+)(?:x(-?\d+))?\(P\))?$";
+        public const string ArchitecturePattern = @"^(\d+)(C)(\d+)(?:x(\d+))?(?:\+(\d+)(?:x(\d+))?\(S\))?(?:\+(-?\d+)(?:x(-?\d+))?\(P\))?(?:\+(\d+)\(G\))?$";
+
+        /// <summary>
+        /// The filters quantized for <see cref="InputQuantization"/> on first use.
+        /// </summary>
+        private QuantizedWeights quantizedWeights;
 
         /// <summary>
         /// Initializes a new instance of the <see cref="ConvolutionLayer"/> class.
@@ -40,8 +45,28 @@ namespace Genix.DNN.Layers
             Kernel kernel,
             MatrixLayout matrixLayout,
             RandomNumberGenerator<float> random)
+            : this(shape, numberOfFilters, kernel, 1, matrixLayout, random)
         {
-            this.Initialize(shape, numberOfFilters, kernel, MatrixLayout.ColumnMajor /*matrixLayout*/, random);
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ConvolutionLayer"/> class that splits the channels and the filters into groups.
+        /// </summary>
+        /// <param name="shape">The shape of the layer's input tensor.</param>
+        /// <param name="numberOfFilters">The number of filters in the layer.</param>
+        /// <param name="kernel">The convolution kernel.</param>
+        /// <param name="groups">The number of groups. The filters of each group see only the channels of the same group.</param>
+        /// <param name="matrixLayout">Specifies whether the weight matrices are row-major or column-major.</param>
+        /// <param name="random">The random numbers generator.</param>
+        public ConvolutionLayer(
+            Shape shape,
+            int numberOfFilters,
+            Kernel kernel,
+            int groups,
+            MatrixLayout matrixLayout,
+            RandomNumberGenerator<float> random)
+        {
+            this.Initialize(shape, numberOfFilters, kernel, groups, MatrixLayout.ColumnMajor /*matrixLayout*/, random);
         }
 
         /// <summary>
@@ -55,8 +80,9 @@ namespace Genix.DNN.Layers
             GroupCollection groups = Layer.ParseArchitecture(architecture, ConvolutionLayer.ArchitecturePattern);
             int numberOfFilters = Convert.ToInt32(groups[1].Value, CultureInfo.InvariantCulture);
             Kernel kernel = Layer.ParseKernel(groups, 3, 1, true);
+            int numberOfGroups = !string.IsNullOrEmpty(groups[9].Value) ? Convert.ToInt32(groups[9].Value, CultureInfo.InvariantCulture) : 1;
 
-            this.Initialize(shape, numberOfFilters, kernel, MatrixLayout.RowMajor, random);
+            this.Initialize(shape, numberOfFilters, kernel, numberOfGroups, MatrixLayout.RowMajor, random);
         }
 
         /// <summary>
@@ -67,6 +93,9 @@ namespace Genix.DNN.Layers
             : base(other)
         {
             this.Kernel = other.Kernel;
+            this.Groups = other.Groups;
+            this.Algorithm = other.Algorithm;
+            this.InputQuantization = other.InputQuantization;
         }
 
         /// <summary>
@@ -80,9 +109,10 @@ namespace Genix.DNN.Layers
         /// <inheritdoc />
         public override string Architecture => string.Format(
             CultureInfo.InvariantCulture,
-            "{0}C{1}",
+            "{0}C{1}{2}",
             this.NumberOfNeurons,
-            this.Kernel.ToString(1, 1));
+            this.Kernel.ToString(1, 1),
+            this.Groups > 1 ? string.Format(CultureInfo.InvariantCulture, "+{0}(G)", this.Groups) : string.Empty);
 
         /// <summary>
         /// Gets the convolution kernel.
@@ -93,6 +123,49 @@ namespace Genix.DNN.Layers
         [JsonProperty("Kernel")]
         public Kernel Kernel { get; private set; }
 
+        /// <summary>
+        /// Gets the number of groups the channels and the filters are split into.
+        /// </summary>
+        /// <value>
+        /// The number of groups. Default is 1, every filter sees all the channels.
+        /// </value>
+        /// <remarks>
+        /// The filters of each group see only the channels of the same group.
+        /// A layer with as many groups as there are channels and filters is a depthwise convolution
+        /// that applies a separate kernel to every channel.
+        /// </remarks>
+        [JsonProperty("Groups")]
+        public int Groups { get; private set; } = 1;
+
+        /// <summary>
+        /// Gets or sets the algorithm that computes the convolution.
+        /// </summary>
+        /// <value>
+        /// The <see cref="ConvolutionAlgorithm"/> enumeration value. Default is <see cref="ConvolutionAlgorithm.Auto"/>.
+        /// </value>
+        /// <remarks>
+        /// Set this property to <see cref="ConvolutionAlgorithm.Gemm"/> or <see cref="ConvolutionAlgorithm.Direct"/>
+        /// to opt out of Winograd transforms when their rounding error is not acceptable.
+        /// The algorithm is not saved with the layer and does not apply to layers with several <see cref="Groups"/>.
+        /// </remarks>
+        public ConvolutionAlgorithm Algorithm { get; set; } = ConvolutionAlgorithm.Auto;
+
+        /// <summary>
+        /// Gets or sets the parameters that quantize the input of the layer for 8-bit inference.
+        /// </summary>
+        /// <value>
+        /// The <see cref="QuantizationParameters"/> object. Default is <b>null</b>, the layer computes in single precision.
+        /// </value>
+        /// <remarks>
+        /// Layers with several <see cref="Groups"/> always compute in single precision.
+        /// The parameters are usually found by <see cref="QuantizationCalibrator"/>.
+        /// The layer computes in 8-bit integers only when the session does not calculate gradients;
+        /// the weights are stored in single precision and quantized on first use;
+        /// the quantized weights are dropped when the layer is trained.
+        /// </remarks>
+        [JsonProperty("InputQuantization", DefaultValueHandling = DefaultValueHandling.Ignore)]
+        public QuantizationParameters InputQuantization { get; set; }
+
         /// <inheritdoc />
         internal override bool NeedsActivation => true;
 
@@ -118,7 +191,43 @@ namespace Genix.DNN.Layers
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         internal override IList<Tensor> Forward(Session session, IList<Tensor> xs)
         {
-            return new[] { session.Convolution(xs[0], this.W, this.B, this.Kernel, this.NumberOfNeurons, this.MatrixLayout) };
+            if (this.Groups > 1)
+            {
+                return new[] { session.GroupConvolution(xs[0], this.W, this.B, this.Kernel, this.NumberOfNeurons, this.Groups, this.MatrixLayout) };
+            }
+
+            // the weights are about to change
+            if (session.CalculateGradients)
+            {
+                this.ReleaseQuantizedWeights();
+            }
+            else if (this.InputQuantization != null)
+            {
+                QuantizedWeights w = this.quantizedWeights;
+                if (w == null)
+                {
+                    // matrices are always in column-major layout
+                    w = QuantizedWeights.Pack(this.W, this.NumberOfNeurons, MatrixLayout.ColumnMajor);
+                    this.quantizedWeights = w;
+                }
+
+                return new[] { session.QuantizedConvolution(xs[0], w, this.B, this.Kernel, this.NumberOfNeurons, this.InputQuantization) };
+            }
+
+            return new[] { session.Convolution(xs[0], this.W, this.B, this.Kernel, this.NumberOfNeurons, this.MatrixLayout, this.Algorithm) };
+        }
+
+        /// <summary>
+        /// Releases the quantized weights, so they are quantized again from <see cref="StochasticLayer.W"/> on next use.
+        /// </summary>
+        private void ReleaseQuantizedWeights()
+        {
+            QuantizedWeights w = this.quantizedWeights;
+            if (w != null)
+            {
+                this.quantizedWeights = null;
+                w.Dispose();
+            }
         }
 
         /// <summary>
@@ -127,12 +236,14 @@ namespace Genix.DNN.Layers
         /// <param name="shape">The shape of the layer's input tensor.</param>
         /// <param name="numberOfFilters">The number of filters in the layer.</param>
         /// <param name="kernel">The convolution kernel.</param>
+        /// <param name="groups">The number of groups the channels and the filters are split into.</param>
         /// <param name="matrixLayout">Specifies whether the weight matrices are row-major or column-major.</param>
         /// <param name="random">The random numbers generator.</param>
         private void Initialize(
             Shape shape,
             int numberOfFilters,
             Kernel kernel,
+            int groups,
             MatrixLayout matrixLayout,
             RandomNumberGenerator<float> random)
         {
@@ -146,9 +257,15 @@ namespace Genix.DNN.Layers
                 throw new ArgumentNullException(nameof(kernel));
             }
 
+            if (groups <= 0 || shape.GetAxis(Axis.C) % groups != 0 || numberOfFilters % groups != 0)
+            {
+                throw new ArgumentException(Properties.Resources.E_InvalidConvolutionGroups, nameof(groups));
+            }
+
             // column-major matrix organization - each row contains all weights for one neuron
             // row-major matrix organization - each column contains all weights for one neuron
-            int mbsize = kernel.Size * shape.GetAxis(Axis.C);
+            // a neuron sees the channels of its group only
+            int mbsize = kernel.Size * shape.GetAxis(Axis.C) / groups;
             int[] weightsShape = matrixLayout == MatrixLayout.ColumnMajor ?
                 new[] { mbsize, numberOfFilters } :
                 new[] { numberOfFilters, mbsize };
@@ -157,6 +274,7 @@ namespace Genix.DNN.Layers
 
             this.Initialize(numberOfFilters, matrixLayout, weightsShape, biasesShape, random);
             this.Kernel = kernel;
+            this.Groups = groups;
 
             this.OutputShape = new Shape(
                 shape.Format,
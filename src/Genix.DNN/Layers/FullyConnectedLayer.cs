@@ -26,6 +26,21 @@ namespace Genix.DNN.Layers
         /// </summary>
         public const string ArchitecturePattern = @"^(\d+)(N)$";
 
+        /// <summary>
+        /// The weights packed in <see cref="WeightsPrecision"/> on first use.
+        /// </summary>
+        private HalfPrecisionWeights packedWeights;
+
+        /// <summary>
+        /// The weights quantized for <see cref="InputQuantization"/> on first use.
+        /// </summary>
+        private QuantizedWeights quantizedWeights;
+
+        /// <summary>
+        /// The format the weights of the layer are stored in for inference.
+        /// </summary>
+        private WeightsPrecision weightsPrecision;
+
         /// <summary>
         /// Initializes a new instance of the <see cref="FullyConnectedLayer"/> class.
         /// </summary>
@@ -59,6 +74,8 @@ namespace Genix.DNN.Layers
         public FullyConnectedLayer(FullyConnectedLayer other)
             : base(other)
         {
+            this.InputQuantization = other.InputQuantization;
+            this.WeightsPrecision = other.WeightsPrecision;
         }
 
         /// <summary>
@@ -72,6 +89,47 @@ namespace Genix.DNN.Layers
         /// <inheritdoc />
         public override string Architecture => string.Format(CultureInfo.InvariantCulture, "{0}N", this.NumberOfNeurons);
 
+        /// <summary>
+        /// Gets or sets the parameters that quantize the input of the layer for 8-bit inference.
+        /// </summary>
+        /// <value>
+        /// The <see cref="QuantizationParameters"/> object. Default is <b>null</b>, the layer computes in single precision.
+        /// </value>
+        /// <remarks>
+        /// The parameters are usually found by <see cref="QuantizationCalibrator"/>.
+        /// The layer computes in 8-bit integers only when the session does not calculate gradients;
+        /// the weights are stored in single precision and quantized on first use;
+        /// the quantized weights are dropped when the layer is trained.
+        /// </remarks>
+        [JsonProperty("InputQuantization", DefaultValueHandling = DefaultValueHandling.Ignore)]
+        public QuantizationParameters InputQuantization { get; set; }
+
+        /// <summary>
+        /// Gets or sets the format the weights of the layer are stored in for inference.
+        /// </summary>
+        /// <value>
+        /// The <see cref="DNN.WeightsPrecision"/> enumeration. Default is <see cref="WeightsPrecision.Single"/>.
+        /// </value>
+        /// <remarks>
+        /// The weights stored in 16 bits take half the memory bandwidth of the single-precision weights;
+        /// the layer uses them only when the session does not calculate gradients and the input is not quantized
+        /// (see <see cref="InputQuantization"/>). The weights are trained in single precision and packed on first use;
+        /// the packed weights are dropped when the layer is trained and when this property changes.
+        /// </remarks>
+        [JsonProperty("WeightsPrecision", DefaultValueHandling = DefaultValueHandling.Ignore)]
+        public WeightsPrecision WeightsPrecision
+        {
+            get => this.weightsPrecision;
+            set
+            {
+                if (this.weightsPrecision != value)
+                {
+                    this.weightsPrecision = value;
+                    this.ReleasePackedWeights();
+                }
+            }
+        }
+
         /// <inheritdoc />
         internal override bool NeedsActivation => true;
 
@@ -79,6 +137,64 @@ namespace Genix.DNN.Layers
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override object Clone() => new FullyConnectedLayer(this);
 
+        /// <inheritdoc />
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal override IList<Tensor> Forward(Session session, IList<Tensor> xs)
+        {
+            // the weights are about to change
+            if (session.CalculateGradients)
+            {
+                this.ReleasePackedWeights();
+                return base.Forward(session, xs);
+            }
+
+            if (this.InputQuantization != null)
+            {
+                QuantizedWeights w = this.quantizedWeights;
+                if (w == null)
+                {
+                    w = QuantizedWeights.Pack(this.W, this.NumberOfNeurons, this.MatrixLayout);
+                    this.quantizedWeights = w;
+                }
+
+                return new[] { session.QuantizedFullyConnected(xs[0], w, this.B, this.InputQuantization) };
+            }
+
+            if (this.WeightsPrecision != WeightsPrecision.Single)
+            {
+                HalfPrecisionWeights w = this.packedWeights;
+                if (w == null)
+                {
+                    w = HalfPrecisionWeights.Pack(this.W, this.NumberOfNeurons, this.MatrixLayout, this.WeightsPrecision);
+                    this.packedWeights = w;
+                }
+
+                return new[] { session.HalfPrecisionFullyConnected(xs[0], w, this.B) };
+            }
+
+            return base.Forward(session, xs);
+        }
+
+        /// <summary>
+        /// Releases the packed and the quantized weights, so they are packed again from <see cref="StochasticLayer.W"/> on next use.
+        /// </summary>
+        private void ReleasePackedWeights()
+        {
+            HalfPrecisionWeights w = this.packedWeights;
+            if (w != null)
+            {
+                this.packedWeights = null;
+                w.Dispose();
+            }
+
+            QuantizedWeights q = this.quantizedWeights;
+            if (q != null)
+            {
+                this.quantizedWeights = null;
+                q.Dispose();
+            }
+        }
+
         /// <summary>
         /// Initializes the <see cref="FullyConnectedLayer"/>.
         /// </summary>
@@ -10,9 +10,11 @@ namespace Genix.DNN.Layers
 {
     using System;
     using System.Collections.Generic;
+    using System.Diagnostics.CodeAnalysis;
     using System.Globalization;
     using System.Linq;
     using System.Runtime.CompilerServices;
+    using System.Runtime.Serialization;
     using System.Text.RegularExpressions;
     using Genix.Core;
     using Genix.MachineLearning;
@@ -219,6 +221,19 @@ namespace Genix.DNN.Layers
 #endif
         }
 
+        [SuppressMessage("Microsoft.Usage", "CA2238:ImplementSerializationMethodsCorrectly", Justification = "This method has to be called by JsonSerializer.")]
+        [OnDeserialized]
+        private void OnDeserialized(StreamingContext context)
+        {
+            // bi-directional cells saved before the bi-directional LSTM was implemented have hidden weights of full width
+            // and were computed as forward-only cells; they are loaded as forward-only cells, so they produce the same output
+            if (this.Direction == RNNDirection.BiDirectional && this.U != null &&
+                this.U.Axes[this.MatrixLayout == MatrixLayout.ColumnMajor ? 0 : 1] == this.NumberOfNeurons)
+            {
+                this.Direction = RNNDirection.ForwardOnly;
+            }
+        }
+
         /// <summary>
         /// Initializes the <see cref="LSTMCell"/>.
         /// </summary>
@@ -250,9 +265,10 @@ namespace Genix.DNN.Layers
                 new[] { mbsize, 4 * numberOfNeurons } :
                 new[] { 4 * numberOfNeurons, mbsize };
 
+            int hlen = direction == RNNDirection.ForwardOnly ? numberOfNeurons : numberOfNeurons / 2;
             int[] hiddenShape = matrixLayout == MatrixLayout.ColumnMajor ?
-                new[] { numberOfNeurons, 4 * numberOfNeurons } :
-                new[] { 4 * numberOfNeurons, numberOfNeurons };
+                new[] { hlen, 4 * numberOfNeurons } :
+                new[] { 4 * numberOfNeurons, hlen };
 
             // keep all weights in single channel
             // allocate four matrices (one for each of three gates and one for the state)
@@ -59,7 +59,7 @@ namespace Genix.DNN.Layers
         /// The <see cref="RNNDirection"/> enumeration.
         /// </value>
         [JsonProperty("direction")]
-        public RNNDirection Direction { get; private set; } = RNNDirection.ForwardOnly;
+        public RNNDirection Direction { get; private protected set; } = RNNDirection.ForwardOnly;
 
         /// <summary>
         /// Gets the hidden weights for the layer.
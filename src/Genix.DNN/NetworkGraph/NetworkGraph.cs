@@ -216,7 +216,9 @@ namespace Genix.DNN
             return count;
         }
 
-        public Tensor Forward(Session session, Tensor x)
+        public Tensor Forward(Session session, Tensor x) => this.Forward(session, x, null);
+
+        public Tensor Forward(Session session, Tensor x, Action<Layer, IList<Tensor>> inputs)
         {
             Dictionary<Edge<Layer>, Tensor> tensorMap = new Dictionary<Edge<Layer>, Tensor>(this.Size);
             Tensor y = null;
@@ -246,6 +248,8 @@ namespace Genix.DNN
                         }
                     }
 
+                    inputs?.Invoke(layer, xs);
+
                     // execute layer
                     IList<Tensor> ys = layer.Forward(session, xs);
 
@@ -69,6 +69,15 @@ namespace Genix.DNN.Properties {
             }
         }
         
+        /// <summary>
+        ///   Looks up a localized string similar to The number of channels and the number of filters should be divisible by the number of groups..
+        /// </summary>
+        internal static string E_InvalidConvolutionGroups {
+            get {
+                return ResourceManager.GetString("E_InvalidConvolutionGroups", resourceCulture);
+            }
+        }
+        
         /// <summary>
         ///   Looks up a localized string similar to The network accepts only one input tensor..
         /// </summary>
@@ -0,0 +1,117 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="QuantizationCalibrator.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using System.Collections.Generic;
+    using Genix.Core;
+    using Genix.DNN.Layers;
+    using Genix.MachineLearning;
+
+    /// <summary>
+    /// Gathers the ranges of the inputs of the convolution and fully connected layers of a network
+    /// and sets the parameters that quantize them for 8-bit inference.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Run the calibrator over a few representative samples with <see cref="Add"/>, then call <see cref="Apply"/>
+    /// to set the <see cref="ConvolutionLayer.InputQuantization"/> and <see cref="FullyConnectedLayer.InputQuantization"/> properties.
+    /// </para>
+    /// <para>
+    /// The layers that already have quantization parameters compute in 8-bit integers while the samples are added,
+    /// so the network should be calibrated before its layers are quantized.
+    /// </para>
+    /// </remarks>
+    public class QuantizationCalibrator
+    {
+        /// <summary>
+        /// The network to calibrate.
+        /// </summary>
+        private readonly Network network;
+
+        /// <summary>
+        /// The smallest and the largest input value of each layer seen so far.
+        /// </summary>
+        private readonly Dictionary<Layer, (float min, float max)> ranges = new Dictionary<Layer, (float min, float max)>();
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="QuantizationCalibrator"/> class.
+        /// </summary>
+        /// <param name="network">The network to calibrate.</param>
+        public QuantizationCalibrator(Network network)
+        {
+            this.network = network ?? throw new ArgumentNullException(nameof(network));
+        }
+
+        /// <summary>
+        /// Gets the number of layers that received input so far.
+        /// </summary>
+        /// <value>
+        /// The number of convolution and fully connected layers the calibrator has seen input for.
+        /// </value>
+        public int Count => this.ranges.Count;
+
+        /// <summary>
+        /// Runs the network on the specified samples and records the ranges of the layer inputs.
+        /// </summary>
+        /// <param name="x">The tensor that contains the samples.</param>
+        public void Add(Tensor x)
+        {
+            if (x == null)
+            {
+                throw new ArgumentNullException(nameof(x));
+            }
+
+            Session session = new Session(false);
+            x.CalculateGradient = false;
+
+            this.network.Graph.Forward(
+                session,
+                x,
+                (layer, xs) =>
+                {
+                    if ((layer is ConvolutionLayer convolution && convolution.Groups == 1) || layer is FullyConnectedLayer)
+                    {
+                        Tensor input = xs[0];
+                        float min = Vectors.Min(input.Length, input.Weights, 0);
+                        float max = Vectors.Max(input.Length, input.Weights, 0);
+
+                        if (this.ranges.TryGetValue(layer, out (float min, float max) range))
+                        {
+                            min = MinMax.Min(min, range.min);
+                            max = MinMax.Max(max, range.max);
+                        }
+
+                        this.ranges[layer] = (min, max);
+                    }
+                });
+
+            session.EndSession();
+        }
+
+        /// <summary>
+        /// Sets the quantization parameters of the layers from the recorded ranges.
+        /// </summary>
+        public void Apply()
+        {
+            foreach (KeyValuePair<Layer, (float min, float max)> kvp in this.ranges)
+            {
+                QuantizationParameters quantization = QuantizationParameters.FromRange(kvp.Value.min, kvp.Value.max);
+                switch (kvp.Key)
+                {
+                    case ConvolutionLayer convolution:
+                        convolution.InputQuantization = quantization;
+                        break;
+
+                    case FullyConnectedLayer fullyConnected:
+                        fullyConnected.InputQuantization = quantization;
+                        break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="QuantizationParameters.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using Genix.Core;
+    using Newtonsoft.Json;
+
+    /// <summary>
+    /// Describes how the input of a layer is quantized to unsigned bytes for 8-bit inference.
+    /// </summary>
+    /// <remarks>
+    /// A value x is represented by the byte q = clamp(round(x / <see cref="Scale"/>) + <see cref="ZeroPoint"/>, 0, 255).
+    /// </remarks>
+    [JsonObject(MemberSerialization.OptIn)]
+    public class QuantizationParameters : IEquatable<QuantizationParameters>
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="QuantizationParameters"/> class.
+        /// </summary>
+        /// <param name="scale">The quantization step.</param>
+        /// <param name="zeroPoint">The byte that represents zero.</param>
+        public QuantizationParameters(float scale, int zeroPoint)
+        {
+            if (!(scale > 0.0f) || float.IsInfinity(scale))
+            {
+                throw new ArgumentOutOfRangeException(nameof(scale));
+            }
+
+            if (zeroPoint < 0 || zeroPoint > 255)
+            {
+                throw new ArgumentOutOfRangeException(nameof(zeroPoint));
+            }
+
+            this.Scale = scale;
+            this.ZeroPoint = zeroPoint;
+        }
+
+        /// <summary>
+        /// Prevents a default instance of the <see cref="QuantizationParameters"/> class from being created.
+        /// </summary>
+        [JsonConstructor]
+        private QuantizationParameters()
+        {
+        }
+
+        /// <summary>
+        /// Gets the quantization step.
+        /// </summary>
+        /// <value>
+        /// The difference between the values represented by two consecutive bytes.
+        /// </value>
+        [JsonProperty("Scale")]
+        public float Scale { get; private set; }
+
+        /// <summary>
+        /// Gets the byte that represents zero.
+        /// </summary>
+        /// <value>
+        /// The byte that represents zero, from 0 to 255.
+        /// </value>
+        [JsonProperty("ZeroPoint")]
+        public int ZeroPoint { get; private set; }
+
+        /// <summary>
+        /// Creates the parameters that cover the specified range of values.
+        /// </summary>
+        /// <param name="min">The smallest value.</param>
+        /// <param name="max">The largest value.</param>
+        /// <returns>
+        /// The <see cref="QuantizationParameters"/> object that maps the range extended to include zero onto the bytes.
+        /// </returns>
+        /// <remarks>
+        /// The range is extended to include zero, so that zero is represented exactly and padding adds no error.
+        /// </remarks>
+        public static QuantizationParameters FromRange(float min, float max)
+        {
+            if (float.IsNaN(min) || float.IsNaN(max) || min > max)
+            {
+                throw new ArgumentException("The range of values is invalid.");
+            }
+
+            min = MinMax.Min(min, 0.0f);
+            max = MinMax.Max(max, 0.0f);
+
+            float scale = (max - min) / 255.0f;
+            if (!(scale > 0.0f) || float.IsInfinity(scale))
+            {
+                scale = 1.0f;
+            }
+
+            int zeroPoint = (int)Math.Round(-min / scale, MidpointRounding.AwayFromZero);
+            return new QuantizationParameters(scale, MinMax.Max(0, MinMax.Min(zeroPoint, 255)));
+        }
+
+        /// <summary>
+        /// Determines whether this <see cref="QuantizationParameters"/> contains the same data as the specified <see cref="QuantizationParameters"/>.
+        /// </summary>
+        /// <param name="other">The <see cref="QuantizationParameters"/> to test.</param>
+        /// <returns><b>true</b> if <c>other</c> is a <see cref="QuantizationParameters"/> and has the same data as this <see cref="QuantizationParameters"/>.</returns>
+        public bool Equals(QuantizationParameters other)
+        {
+            if (other == null)
+            {
+                return false;
+            }
+
+            if (other == this)
+            {
+                return true;
+            }
+
+            return this.Scale == other.Scale && this.ZeroPoint == other.ZeroPoint;
+        }
+
+        /// <inheritdoc />
+        public override bool Equals(object obj) => this.Equals(obj as QuantizationParameters);
+
+        /// <inheritdoc />
+        public override int GetHashCode() => this.Scale.GetHashCode() ^ this.ZeroPoint;
+    }
+}
@@ -0,0 +1,75 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="ConvolutionPlan.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using System.Runtime.CompilerServices;
+    using System.Runtime.ConstrainedExecution;
+    using System.Runtime.InteropServices;
+    using System.Security;
+    using System.Security.Permissions;
+    using Genix.MachineLearning;
+
+    /// <summary>
+    /// Represents the matrix products of a convolution layer grouped into batches.
+    /// </summary>
+    /// <remarks>
+    /// The native code builds the plan for the shapes of the first call and builds it again when the shapes change.
+    /// </remarks>
+    internal sealed class ConvolutionPlan : SafeHandle
+    {
+        /// <summary>
+        /// The plans of the layers the weight tensors belong to, released together with the tensors.
+        /// </summary>
+        private static readonly ConditionalWeakTable<Tensor, ConvolutionPlan> Cache = new ConditionalWeakTable<Tensor, ConvolutionPlan>();
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ConvolutionPlan"/> class.
+        /// </summary>
+        [SecurityPermission(SecurityAction.InheritanceDemand, UnmanagedCode = true)]
+        [SecurityPermission(SecurityAction.Demand, UnmanagedCode = true)]
+        private ConvolutionPlan()
+            : base(IntPtr.Zero, true)
+        {
+        }
+
+        /// <inheritdoc />
+        public override bool IsInvalid => this.handle == IntPtr.Zero;
+
+        /// <summary>
+        /// Returns the plan of the convolution layer with the specified weights.
+        /// </summary>
+        /// <param name="w">The tensor that contains the weights of the convolution layer.</param>
+        /// <returns>
+        /// The <see cref="ConvolutionPlan"/> object associated with <paramref name="w"/>.
+        /// </returns>
+        public static ConvolutionPlan FromWeights(Tensor w)
+        {
+            return ConvolutionPlan.Cache.GetValue(w, _ => NativeMethods.convolution_plan_create());
+        }
+
+        /// <inheritdoc />
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.MayFail)]
+        protected override bool ReleaseHandle()
+        {
+            NativeMethods.convolution_plan_free(this.handle);
+            return true;
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.DNN.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern ConvolutionPlan convolution_plan_create();
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void convolution_plan_free(IntPtr filters);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="HalfPrecisionWeights.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using System.Runtime.ConstrainedExecution;
+    using System.Runtime.InteropServices;
+    using System.Security;
+    using System.Security.Permissions;
+    using Genix.MachineLearning;
+
+    /// <summary>
+    /// Represents the weights of a fully connected layer stored in 16 bits for inference.
+    /// </summary>
+    /// <remarks>
+    /// The packed weights do not follow the changes in the source tensor; pack them again after training.
+    /// </remarks>
+    public sealed class HalfPrecisionWeights : SafeHandle
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="HalfPrecisionWeights"/> class.
+        /// </summary>
+        [SecurityPermission(SecurityAction.InheritanceDemand, UnmanagedCode = true)]
+        [SecurityPermission(SecurityAction.Demand, UnmanagedCode = true)]
+        private HalfPrecisionWeights()
+            : base(IntPtr.Zero, true)
+        {
+        }
+
+        /// <inheritdoc />
+        public override bool IsInvalid => this.handle == IntPtr.Zero;
+
+        /// <summary>
+        /// Packs the weights of a fully connected layer in the specified precision.
+        /// </summary>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrix <paramref name="w"/> is row-major or column-major.</param>
+        /// <param name="precision">The format to store the weights in.</param>
+        /// <returns>
+        /// The <see cref="HalfPrecisionWeights"/> object that contains packed weights.
+        /// </returns>
+        public static HalfPrecisionWeights Pack(Tensor w, int numberOfNeurons, MatrixLayout matrixLayout, WeightsPrecision precision)
+        {
+            if (w == null)
+            {
+                throw new ArgumentNullException(nameof(w));
+            }
+
+            if (precision == WeightsPrecision.Single)
+            {
+                throw new ArgumentException("The weights must be stored in 16 bits.", nameof(precision));
+            }
+
+            return NativeMethods.half_weights_pack(
+                w.Length / numberOfNeurons,
+                numberOfNeurons,
+                w.Weights,
+                matrixLayout == MatrixLayout.ColumnMajor,
+                precision);
+        }
+
+        /// <inheritdoc />
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.MayFail)]
+        protected override bool ReleaseHandle()
+        {
+            NativeMethods.half_weights_free(this.handle);
+            return true;
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.DNN.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern HalfPrecisionWeights half_weights_pack(
+                int k,
+                int n,
+                [In] float[] w,
+                [MarshalAs(UnmanagedType.Bool)] bool transposed,
+                WeightsPrecision precision);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void half_weights_free(IntPtr weights);
+        }
+    }
+}
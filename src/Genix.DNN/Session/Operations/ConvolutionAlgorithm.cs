@@ -0,0 +1,59 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="ConvolutionAlgorithm.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    /// <summary>
+    /// Defines the algorithm that computes a convolution.
+    /// </summary>
+    public enum ConvolutionAlgorithm
+    {
+        /// <summary>
+        /// The algorithm is selected automatically from the layer shape and the processor.
+        /// </summary>
+        /// <remarks>
+        /// The layers with 3x3 kernels, stride 1 and enough channels use <see cref="Winograd2x2"/>.
+        /// Select one of the other algorithms explicitly when the rounding error of Winograd transforms is not acceptable.
+        /// </remarks>
+        Auto = 0,
+
+        /// <summary>
+        /// The convolution is computed as a series of matrix products.
+        /// </summary>
+        Gemm = 1,
+
+        /// <summary>
+        /// The convolution is computed directly by vectorized kernels that keep the results in processor registers.
+        /// </summary>
+        Direct = 2,
+
+        /// <summary>
+        /// The convolution and its input gradient are computed by Winograd F(2x2, 3x3) transforms that need 2.25 times fewer multiplications.
+        /// </summary>
+        /// <remarks>
+        /// Applies to 3x3 kernels with stride 1, other layers select the algorithm automatically.
+        /// </remarks>
+        Winograd2x2 = 3,
+
+        /// <summary>
+        /// The convolution and its input gradient are computed by Winograd F(4x4, 3x3) transforms that need 4 times fewer multiplications.
+        /// </summary>
+        /// <remarks>
+        /// Applies to 3x3 kernels with stride 1, other layers select the algorithm automatically.
+        /// The rounding error is several times larger than the error of <see cref="Winograd2x2"/>.
+        /// </remarks>
+        Winograd4x4 = 4,
+
+        /// <summary>
+        /// The convolution is computed as the matrix products of <see cref="Gemm"/> submitted in a few grouped batches.
+        /// </summary>
+        /// <remarks>
+        /// The batches are planned once for each shape of the layer and reused by the later calls.
+        /// Intel MKL runs a batch as a single call; other backends split it into ranges of products on the thread pool.
+        /// </remarks>
+        GemmBatch = 5,
+    }
+}
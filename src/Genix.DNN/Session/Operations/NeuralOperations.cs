@@ -9,10 +9,11 @@
 namespace Genix.DNN
 {
     using System;
+    using System.Collections.Generic;
+    using System.Linq;
     using System.Runtime.CompilerServices;
     using System.Runtime.InteropServices;
     using System.Security;
-    using System.Threading.Tasks;
     using Genix.Core;
     using Genix.MachineLearning;
 
@@ -108,6 +109,12 @@ namespace Genix.DNN
         {
             const string ActionName = "avg pool";
 
+            // a window that covers the whole image is global pooling
+            if (kernel.Width == x.Shape.GetAxis(Axis.X) && kernel.Height == x.Shape.GetAxis(Axis.Y) && kernel.PaddingX == 0 && kernel.PaddingY == 0)
+            {
+                return session.AdaptiveAveragePooling(x, 1, 1);
+            }
+
             return session.RunOperation(
                 ActionName,
                 () =>
@@ -249,6 +256,12 @@ namespace Genix.DNN
         {
             const string ActionName = "max pool";
 
+            // a window that covers the whole image is global pooling
+            if (kernel.Width == x.Shape.GetAxis(Axis.X) && kernel.Height == x.Shape.GetAxis(Axis.Y) && kernel.PaddingX == 0 && kernel.PaddingY == 0)
+            {
+                return session.AdaptiveMaxPooling(x, 1, 1);
+            }
+
             return session.RunOperation(
                 ActionName,
                 () =>
@@ -257,126 +270,248 @@ namespace Genix.DNN
 
                     Tensor y = session.AllocateTensor(ActionName, kernel.CalculateOutputShape(x.Shape), calculateGradient);
 
+                    // the native code pools over the axes 1 and 2, the channels are the innermost dimension
+                    int ksize1, ksize2, kstride1, kstride2, kpadding1, kpadding2;
+                    int[] xaxes, xstrides, yaxes, ystrides;
                     switch (x.Shape.Format)
                     {
                         case Shape.BWHC:
-                            NativeMethods.maxpooling(
-                                kernel.Width,
-                                kernel.Height,
-                                kernel.StrideX,
-                                kernel.StrideY,
-                                kernel.PaddingX,
-                                kernel.PaddingY,
-                                x.Weights,
-                                x.Axes,
-                                x.Strides,
-                                y.Weights,
-                                y.Axes,
-                                y.Strides);
+                            ksize1 = kernel.Width;
+                            ksize2 = kernel.Height;
+                            kstride1 = kernel.StrideX;
+                            kstride2 = kernel.StrideY;
+                            kpadding1 = kernel.PaddingX;
+                            kpadding2 = kernel.PaddingY;
+                            xaxes = x.Axes;
+                            xstrides = x.Strides;
+                            yaxes = y.Axes;
+                            ystrides = y.Strides;
                             break;
 
                         case Shape.BHWC:
-                            NativeMethods.maxpooling(
-                                kernel.Height,
-                                kernel.Width,
-                                kernel.StrideY,
-                                kernel.StrideX,
-                                kernel.PaddingY,
-                                kernel.PaddingX,
-                                x.Weights,
-                                x.Axes,
-                                x.Strides,
-                                y.Weights,
-                                y.Axes,
-                                y.Strides);
+                            ksize1 = kernel.Height;
+                            ksize2 = kernel.Width;
+                            kstride1 = kernel.StrideY;
+                            kstride2 = kernel.StrideX;
+                            kpadding1 = kernel.PaddingY;
+                            kpadding2 = kernel.PaddingX;
+                            xaxes = x.Axes;
+                            xstrides = x.Strides;
+                            yaxes = y.Axes;
+                            ystrides = y.Strides;
                             break;
 
                         case Shape.BCHW:
-                            NativeMethods.maxpooling(
-                                kernel.Height,
-                                kernel.Width,
-                                kernel.StrideY,
-                                kernel.StrideX,
-                                kernel.PaddingY,
-                                kernel.PaddingX,
-                                x.Weights,
-                                new[] { x.Axes[0] * x.Axes[1], x.Axes[2], x.Axes[3] },
-                                new[] { x.Strides[1], x.Strides[2], x.Strides[3] },
-                                y.Weights,
-                                new[] { y.Axes[0] * y.Axes[1], y.Axes[2], y.Axes[3] },
-                                new[] { y.Strides[1], y.Strides[2], y.Strides[3] });
+                            ksize1 = kernel.Height;
+                            ksize2 = kernel.Width;
+                            kstride1 = kernel.StrideY;
+                            kstride2 = kernel.StrideX;
+                            kpadding1 = kernel.PaddingY;
+                            kpadding2 = kernel.PaddingX;
+                            xaxes = new[] { x.Axes[0] * x.Axes[1], x.Axes[2], x.Axes[3] };
+                            xstrides = new[] { x.Strides[1], x.Strides[2], x.Strides[3] };
+                            yaxes = new[] { y.Axes[0] * y.Axes[1], y.Axes[2], y.Axes[3] };
+                            ystrides = new[] { y.Strides[1], y.Strides[2], y.Strides[3] };
                             break;
 
                         default:
                             throw new NotSupportedException("The tensor shape is not supported by this operation.");
                     }
+
+#if !NOLEARNING
+                    if (calculateGradient)
+                    {
+                        // remember where the maximums came from, one byte per output when the window position fits
+                        if (ksize1 * ksize2 < byte.MaxValue)
+                        {
+                            byte[] indices = new byte[y.Length];
+                            NativeMethods.maxpooling_indices_u8(
+                                ksize1,
+                                ksize2,
+                                kstride1,
+                                kstride2,
+                                kpadding1,
+                                kpadding2,
+                                x.Weights,
+                                xaxes,
+                                xstrides,
+                                y.Weights,
+                                yaxes,
+                                ystrides,
+                                indices);
+
+                            session.Push(
+                                ActionName,
+                                () => NativeMethods.maxpooling_gradient_indices_u8(
+                                    ksize1,
+                                    ksize2,
+                                    kstride1,
+                                    kstride2,
+                                    kpadding1,
+                                    kpadding2,
+                                    x.Gradient,
+                                    xaxes,
+                                    xstrides,
+                                    y.Gradient,
+                                    yaxes,
+                                    ystrides,
+                                    indices));
+                        }
+                        else
+                        {
+                            int[] indices = new int[y.Length];
+                            NativeMethods.maxpooling_indices_s32(
+                                ksize1,
+                                ksize2,
+                                kstride1,
+                                kstride2,
+                                kpadding1,
+                                kpadding2,
+                                x.Weights,
+                                xaxes,
+                                xstrides,
+                                y.Weights,
+                                yaxes,
+                                ystrides,
+                                indices);
+
+                            session.Push(
+                                ActionName,
+                                () => NativeMethods.maxpooling_gradient_indices_s32(
+                                    ksize1,
+                                    ksize2,
+                                    kstride1,
+                                    kstride2,
+                                    kpadding1,
+                                    kpadding2,
+                                    x.Gradient,
+                                    xaxes,
+                                    xstrides,
+                                    y.Gradient,
+                                    yaxes,
+                                    ystrides,
+                                    indices));
+                        }
+
+                        return y;
+                    }
+#endif
+
+                    NativeMethods.maxpooling(
+                        ksize1,
+                        ksize2,
+                        kstride1,
+                        kstride2,
+                        kpadding1,
+                        kpadding2,
+                        x.Weights,
+                        xaxes,
+                        xstrides,
+                        y.Weights,
+                        yaxes,
+                        ystrides);
+
+                    return y;
+                });
+        }
+
+        /// <summary>
+        /// Applies adaptive average pooling filter.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="width">The width of the output tensor.</param>
+        /// <param name="height">The height of the output tensor.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        /// <remarks>
+        /// The size of the pooling windows is derived from the size of the output.
+        /// The window of output element <c>i</c> covers input elements from <c>floor(i * X / width)</c> to <c>ceil((i + 1) * X / width)</c>, exclusive.
+        /// The output of size 1 x 1 is the global average pooling.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static Tensor AdaptiveAveragePooling(this Session session, Tensor x, int width, int height)
+        {
+            const string ActionName = "adaptive avg pool";
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    bool calculateGradient = session.CalculateGradients && x.CalculateGradient;
+
+                    Tensor y = session.AllocateTensor(
+                        ActionName,
+                        new Shape(x.Shape.Format, x.Shape.GetAxis(Axis.B), width, height, x.Shape.GetAxis(Axis.C)),
+                        calculateGradient);
+
+                    NeuralOperations.GetAdaptivePoolingAxes(x, y, out int[] xaxes, out int[] xstrides, out int[] yaxes, out int[] ystrides);
+
+                    NativeMethods.adaptive_avgpooling(x.Weights, xaxes, xstrides, y.Weights, yaxes, ystrides);
+
 #if !NOLEARNING
                     if (calculateGradient)
                     {
                         session.Push(
                             ActionName,
-                            () =>
-                            {
-                                switch (x.Shape.Format)
-                                {
-                                    case Shape.BWHC:
-                                        NativeMethods.maxpooling_gradient(
-                                            kernel.Width,
-                                            kernel.Height,
-                                            kernel.StrideX,
-                                            kernel.StrideY,
-                                            kernel.PaddingX,
-                                            kernel.PaddingY,
-                                            x.Weights,
-                                            x.Gradient,
-                                            x.Axes,
-                                            x.Strides,
-                                            y.Weights,
-                                            y.Gradient,
-                                            y.Axes,
-                                            y.Strides);
-                                        break;
+                            () => NativeMethods.adaptive_avgpooling_gradient(x.Gradient, xaxes, xstrides, y.Gradient, yaxes, ystrides));
+                    }
+#endif
 
-                                    case Shape.BHWC:
-                                        NativeMethods.maxpooling_gradient(
-                                            kernel.Height,
-                                            kernel.Width,
-                                            kernel.StrideY,
-                                            kernel.StrideX,
-                                            kernel.PaddingY,
-                                            kernel.PaddingX,
-                                            x.Weights,
-                                            x.Gradient,
-                                            x.Axes,
-                                            x.Strides,
-                                            y.Weights,
-                                            y.Gradient,
-                                            y.Axes,
-                                            y.Strides);
-                                        break;
+                    return y;
+                });
+        }
 
-                                    case Shape.BCHW:
-                                        NativeMethods.maxpooling_gradient(
-                                            kernel.Height,
-                                            kernel.Width,
-                                            kernel.StrideY,
-                                            kernel.StrideX,
-                                            kernel.PaddingY,
-                                            kernel.PaddingX,
-                                            x.Weights,
-                                            x.Gradient,
-                                            new[] { x.Axes[0] * x.Axes[1], x.Axes[2], x.Axes[3] },
-                                            new[] { x.Strides[1], x.Strides[2], x.Strides[3] },
-                                            y.Weights,
-                                            y.Gradient,
-                                            new[] { y.Axes[0] * y.Axes[1], y.Axes[2], y.Axes[3] },
-                                            new[] { y.Strides[1], y.Strides[2], y.Strides[3] });
-                                        break;
-                                }
-                            });
+        /// <summary>
+        /// Applies adaptive max pooling filter.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="width">The width of the output tensor.</param>
+        /// <param name="height">The height of the output tensor.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        /// <remarks>
+        /// The pooling windows are the same as in <see cref="AdaptiveAveragePooling"/>.
+        /// The output of size 1 x 1 is the global max pooling.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static Tensor AdaptiveMaxPooling(this Session session, Tensor x, int width, int height)
+        {
+            const string ActionName = "adaptive max pool";
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    bool calculateGradient = session.CalculateGradients && x.CalculateGradient;
+
+                    Tensor y = session.AllocateTensor(
+                        ActionName,
+                        new Shape(x.Shape.Format, x.Shape.GetAxis(Axis.B), width, height, x.Shape.GetAxis(Axis.C)),
+                        calculateGradient);
+
+                    NeuralOperations.GetAdaptivePoolingAxes(x, y, out int[] xaxes, out int[] xstrides, out int[] yaxes, out int[] ystrides);
+
+#if !NOLEARNING
+                    if (calculateGradient)
+                    {
+                        // remember where the maximums came from
+                        int[] indices = new int[y.Length];
+                        NativeMethods.adaptive_maxpooling(x.Weights, xaxes, xstrides, y.Weights, yaxes, ystrides, indices);
+
+                        session.Push(
+                            ActionName,
+                            () => NativeMethods.adaptive_maxpooling_gradient(x.Gradient, xaxes, xstrides, y.Gradient, yaxes, ystrides, indices));
+
+                        return y;
                     }
 #endif
 
+                    NativeMethods.adaptive_maxpooling(x.Weights, xaxes, xstrides, y.Weights, yaxes, ystrides, null);
+
                     return y;
                 });
         }
@@ -496,46 +631,49 @@ namespace Genix.DNN
                     bool calculateGradient = session.CalculateGradients && x.CalculateGradient;
 
                     Tensor y = session.AllocateTensor(ActionName, x.Shape, calculateGradient);
-                    Tensor scale = session.AllocateTensor("lrn wsp", x.Shape, false);
 
-                    // 1. calculate scale
                     // scale(i) = k + alpha / n * sum(x(j) ^ 2)
+                    // y(i) = x(i) * scale(i) ^ -beta
                     // scale will be later reused in back-propagation
-                    // use output as a temporary buffer
-                    Vectors.Square(x.Length, x.Weights, 0, scale.Weights, 0);
-                    NeuralOperations.LRNKernel(scale.Axes, scale.Strides, scale.Weights, y.Weights, kernelSize);
-                    scale.Set(k);
-                    scale.AddProductC(y, alpha / kernelSize);
+                    Tensor scale = session.AllocateTensor("lrn wsp", x.Shape, false);
 
-                    // 2. calculate forward tensor
-                    // y(i) = x(i) * scale(i) ^ -beta
-                    Vectors.Pow(scale.Length, scale.Weights, 0, -beta, y.Weights, 0);
-                    y.Mul(x);
+                    // the native code works with the axes [batch, positions, channels]
+                    int[] axes, strides;
+                    switch (x.Shape.Format)
+                    {
+                        case Shape.BWHC:
+                        case Shape.BHWC:
+                            axes = new[] { x.Axes[0], x.Axes[1] * x.Axes[2], x.Axes[3] };
+                            strides = new[] { x.Strides[0], x.Strides[2], x.Strides[3] };
+                            break;
+
+                        case Shape.BCHW:
+                            axes = new[] { x.Axes[0], x.Axes[2] * x.Axes[3], x.Axes[1] };
+                            strides = new[] { x.Strides[0], x.Strides[3], x.Strides[1] };
+                            break;
+
+                        default:
+                            throw new NotSupportedException("The tensor shape is not supported by this operation.");
+                    }
+
+                    NativeMethods.lrn(kernelSize, alpha, beta, k, x.Weights, axes, strides, scale.Weights, y.Weights);
 
 #if !NOLEARNING
                     if (calculateGradient)
                     {
                         session.Push(
                             ActionName,
-                            () =>
-                            {
-                                Tensor work = session.AllocateTensor("lrn wsp2", x.Shape, false);
-
-                                // 1. calculate x(i) * sum(y(j) * dy(j) / scale(j))
-                                // use dx as a temporary buffer
-                                Mathematics.Mul(y.Length, y.Weights, 0, y.Gradient, 0, x.Gradient, 0);
-                                Mathematics.Div(x.Length, scale.Weights, 0, x.Gradient, 0);
-
-                                NeuralOperations.LRNKernel(x.Shape.Axes, x.Shape.Strides, x.Gradient, work.Weights, kernelSize);
-                                work.Mul(x);
-
-                                // 2. calculate scale(i) ^ -beta * dy(i)
-                                Vectors.Pow(scale.Length, scale.Weights, 0, -beta, x.Gradient, 0);
-                                Mathematics.Mul(x.Length, y.Gradient, 0, x.Gradient, 0);
-
-                                // 3. calculate final sum
-                                Mathematics.AddProductC(x.Length, work.Weights, 0, -2.0f * alpha * beta / kernelSize, x.Gradient, 0);
-                            });
+                            () => NativeMethods.lrn_gradient(
+                                kernelSize,
+                                alpha,
+                                beta,
+                                x.Weights,
+                                x.Gradient,
+                                axes,
+                                strides,
+                                scale.Weights,
+                                y.Weights,
+                                y.Gradient));
                     }
 #endif
 
@@ -597,6 +735,34 @@ namespace Genix.DNN
             Kernel kernel,
             int numberOfFilters,
             MatrixLayout matrixLayout)
+        {
+            return session.Convolution(x, w, b, kernel, numberOfFilters, matrixLayout, ConvolutionAlgorithm.Auto);
+        }
+
+        /// <summary>
+        /// Computes a convolution cell using the specified algorithm.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
+        /// <param name="kernel">The convolution kernel.</param>
+        /// <param name="numberOfFilters">The number of filters in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/> and <paramref name="b"/> are row-major or column-major.</param>
+        /// <param name="algorithm">The algorithm that computes the convolution.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static Tensor Convolution(
+            this Session session,
+            Tensor x,
+            Tensor w,
+            Tensor b,
+            Kernel kernel,
+            int numberOfFilters,
+            MatrixLayout matrixLayout,
+            ConvolutionAlgorithm algorithm)
         {
             const string ActionName = "convolution";
 
@@ -616,6 +782,9 @@ namespace Genix.DNN
                             numberOfFilters),
                         calculateGradient);
 
+                    WinogradFilters filters = WinogradFilters.FromWeights(w);
+                    ConvolutionPlan plan = ConvolutionPlan.FromWeights(w);
+
                     NativeMethods.convolution(
                                 kernel.Width,
                                 kernel.Height,
@@ -632,7 +801,10 @@ namespace Genix.DNN
                                 x.Strides,
                                 y.Weights,
                                 y.Axes,
-                                y.Strides);
+                                y.Strides,
+                                algorithm,
+                                filters,
+                                plan);
 
 #if !NOLEARNING
                     if (calculateGradient)
@@ -663,7 +835,9 @@ namespace Genix.DNN
                                             x.Strides,
                                             y.Gradient,
                                             y.Axes,
-                                            y.Strides);
+                                            y.Strides,
+                                            algorithm,
+                                            filters);
                                     }
                                 }
                             });
@@ -674,34 +848,304 @@ namespace Genix.DNN
         }
 
         /// <summary>
-        /// Computes SRN (simple recurrent network) cell.
+        /// Computes a grouped convolution cell.
         /// </summary>
         /// <param name="session">The scope that executes this operation.</param>
         /// <param name="x">The tensor that contains the data.</param>
         /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
-        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
         /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
-        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
-        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/>, <paramref name="b"/>, and <paramref name="u"/> are row-major or column-major.</param>
+        /// <param name="kernel">The convolution kernel.</param>
+        /// <param name="numberOfFilters">The number of filters in the layer.</param>
+        /// <param name="groups">The number of groups the channels and the filters are split into.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/> and <paramref name="b"/> are row-major or column-major.</param>
         /// <returns>
         /// The <see cref="Tensor"/> that contains computed data.
         /// </returns>
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public static Tensor SRN(
+        /// <remarks>
+        /// The filters of each group see only the channels of the same group, so <paramref name="w"/> has <c>kernel.Size * channels / groups</c> rows.
+        /// When every group has one channel and one filter, the convolution is depthwise and is computed by per-channel vectorized kernels.
+        /// </remarks>
+        public static Tensor GroupConvolution(
             this Session session,
             Tensor x,
             Tensor w,
-            Tensor u,
             Tensor b,
-            int numberOfNeurons,
+            Kernel kernel,
+            int numberOfFilters,
+            int groups,
             MatrixLayout matrixLayout)
         {
-            const string ActionName = "srn";
+            const string ActionName = "group convolution";
 
-            // calculate gates = W * x + b
-            Tensor y = session.FullyConnected(x, w, b, matrixLayout);
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    bool calculateGradient = session.CalculateGradients;
 
-            int tt = y.Shape.GetAxis(Axis.B);               // number of vectors in time sequence
+                    Tensor y = session.AllocateTensor(
+                        ActionName,
+                        new Shape(
+                            x.Shape.Format,
+                            x.Shape.GetAxis(Axis.B),
+                            kernel.CalculateOutputWidth(x.Shape.GetAxis(Axis.X)),
+                            kernel.CalculateOutputHeight(x.Shape.GetAxis(Axis.Y)),
+                            numberOfFilters),
+                        calculateGradient);
+
+                    NativeMethods.group_convolution(
+                                kernel.Width,
+                                kernel.Height,
+                                kernel.StrideX,
+                                kernel.StrideY,
+                                kernel.PaddingX,
+                                kernel.PaddingY,
+                                groups,
+                                w.Weights,
+                                b.Weights,
+                                w.Axes,
+                                w.Strides,
+                                x.Weights,
+                                x.Axes,
+                                x.Strides,
+                                y.Weights,
+                                y.Axes,
+                                y.Strides);
+
+#if !NOLEARNING
+                    if (calculateGradient)
+                    {
+                        session.Push(
+                            ActionName,
+                            () =>
+                            {
+                                lock (w)
+                                {
+                                    lock (b)
+                                    {
+                                        NativeMethods.group_convolution_gradient(
+                                            kernel.Width,
+                                            kernel.Height,
+                                            kernel.StrideX,
+                                            kernel.StrideY,
+                                            kernel.PaddingX,
+                                            kernel.PaddingY,
+                                            groups,
+                                            w.Weights,
+                                            w.Gradient,
+                                            b.Gradient,
+                                            w.Axes,
+                                            w.Strides,
+                                            x.Weights,
+                                            x.CalculateGradient ? x.Gradient : null,
+                                            x.Axes,
+                                            x.Strides,
+                                            y.Gradient,
+                                            y.Axes,
+                                            y.Strides);
+                                    }
+                                }
+                            });
+                    }
+#endif
+                    return y;
+                });
+        }
+
+        /// <summary>
+        /// Computes a fully connected cell in 8-bit integers.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The weights matrix quantized by <see cref="QuantizedWeights.Pack"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/>.</param>
+        /// <param name="quantization">The parameters that quantize <paramref name="x"/>.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        /// <remarks>
+        /// The operation is for inference only and does not compute gradients.
+        /// </remarks>
+        public static Tensor QuantizedFullyConnected(
+            this Session session,
+            Tensor x,
+            QuantizedWeights w,
+            Tensor b,
+            QuantizationParameters quantization)
+        {
+            const string ActionName = "quantized fully connected";
+
+            if (quantization == null)
+            {
+                throw new ArgumentNullException(nameof(quantization));
+            }
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    int m = x.Axes[0];
+                    int k = x.Strides[0];
+                    int n = b.Length;
+
+                    Tensor y = session.AllocateTensor(ActionName, new Shape(new[] { m, n }), false);
+
+                    NativeMethods.quantized_fully_connected(
+                        m,
+                        k,
+                        n,
+                        w,
+                        b.Weights,
+                        x.Weights,
+                        y.Weights,
+                        quantization.Scale,
+                        quantization.ZeroPoint);
+
+                    return y;
+                });
+        }
+
+        /// <summary>
+        /// Computes a fully connected cell with the weights stored in 16 bits.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The weights matrix packed by <see cref="HalfPrecisionWeights.Pack"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/>.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        /// <remarks>
+        /// The operation is for inference only and does not compute gradients.
+        /// </remarks>
+        public static Tensor HalfPrecisionFullyConnected(
+            this Session session,
+            Tensor x,
+            HalfPrecisionWeights w,
+            Tensor b)
+        {
+            const string ActionName = "half precision fully connected";
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    int m = x.Axes[0];
+                    int k = x.Strides[0];
+                    int n = b.Length;
+
+                    Tensor y = session.AllocateTensor(ActionName, new Shape(new[] { m, n }), false);
+
+                    NativeMethods.half_fully_connected(
+                        m,
+                        k,
+                        n,
+                        w,
+                        b.Weights,
+                        x.Weights,
+                        y.Weights);
+
+                    return y;
+                });
+        }
+
+        /// <summary>
+        /// Computes a convolution cell in 8-bit integers.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The filters quantized by <see cref="QuantizedWeights.Pack"/> from the column-major weights matrix.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>.</param>
+        /// <param name="kernel">The convolution kernel.</param>
+        /// <param name="numberOfFilters">The number of filters in the layer.</param>
+        /// <param name="quantization">The parameters that quantize <paramref name="x"/>.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        /// <remarks>
+        /// The operation is for inference only and does not compute gradients.
+        /// </remarks>
+        public static Tensor QuantizedConvolution(
+            this Session session,
+            Tensor x,
+            QuantizedWeights w,
+            Tensor b,
+            Kernel kernel,
+            int numberOfFilters,
+            QuantizationParameters quantization)
+        {
+            const string ActionName = "quantized convolution";
+
+            if (quantization == null)
+            {
+                throw new ArgumentNullException(nameof(quantization));
+            }
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    Tensor y = session.AllocateTensor(
+                        ActionName,
+                        new Shape(
+                            x.Shape.Format,
+                            x.Shape.GetAxis(Axis.B),
+                            kernel.CalculateOutputWidth(x.Shape.GetAxis(Axis.X)),
+                            kernel.CalculateOutputHeight(x.Shape.GetAxis(Axis.Y)),
+                            numberOfFilters),
+                        false);
+
+                    NativeMethods.quantized_convolution(
+                                kernel.Width,
+                                kernel.Height,
+                                kernel.StrideX,
+                                kernel.StrideY,
+                                kernel.PaddingX,
+                                kernel.PaddingY,
+                                w,
+                                b.Weights,
+                                x.Weights,
+                                x.Axes,
+                                x.Strides,
+                                y.Weights,
+                                y.Axes,
+                                y.Strides,
+                                quantization.Scale,
+                                quantization.ZeroPoint);
+
+                    return y;
+                });
+        }
+
+        /// <summary>
+        /// Computes SRN (simple recurrent network) cell.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/>, <paramref name="b"/>, and <paramref name="u"/> are row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static Tensor SRN(
+            this Session session,
+            Tensor x,
+            Tensor w,
+            Tensor u,
+            Tensor b,
+            int numberOfNeurons,
+            MatrixLayout matrixLayout)
+        {
+            const string ActionName = "srn";
+
+            // calculate gates = W * x + b
+            Tensor y = session.FullyConnected(x, w, b, matrixLayout);
+
+            int tt = y.Shape.GetAxis(Axis.B);               // number of vectors in time sequence
             float[] uw = u.Weights;
             float[] yw = y.Weights;
 
@@ -787,18 +1231,286 @@ namespace Genix.DNN
                 {
                     bool calculateGradient = session.CalculateGradients;
 
-                    Tensor h = session.AllocateTensor("lstm", new Shape(new int[] { tt, numberOfNeurons }), calculateGradient);
-                    Tensor s = session.AllocateTensor("lstm cell", h.Shape, calculateGradient);
+                    Tensor h = session.AllocateTensor("lstm", new Shape(new int[] { tt, numberOfNeurons }), calculateGradient);
+                    Tensor s = session.AllocateTensor("lstm cell", h.Shape, calculateGradient);
+
+                    if (direction == RNNDirection.BiDirectional)
+                    {
+                        // both directions run concurrently
+                        NativeMethods.lstm_bidirectional(
+                            tt,
+                            numberOfNeurons,
+                            u.Weights,
+                            g.Weights,
+                            s.Weights,
+                            h.Weights,
+                            forgetBias,
+                            matrixLayout == MatrixLayout.RowMajor);
+                    }
+                    else
+                    {
+                        NativeMethods.lstm(
+                            tt,
+                            numberOfNeurons,
+                            u.Weights,
+                            g.Weights,
+                            s.Weights,
+                            h.Weights,
+                            forgetBias,
+                            true,
+                            matrixLayout == MatrixLayout.RowMajor);
+                    }
+
+                    if (calculateGradient)
+                    {
+                        session.Push(
+                            ActionName,
+                            () =>
+                            {
+                                if (direction == RNNDirection.BiDirectional)
+                                {
+                                    NativeMethods.lstm_bidirectional_gradient(
+                                        tt,
+                                        numberOfNeurons,
+                                        u.Weights,
+                                        u.Gradient,
+                                        g.Weights,
+                                        g.Gradient,
+                                        s.Weights,
+                                        s.Gradient,
+                                        h.Weights,
+                                        h.Gradient,
+                                        matrixLayout == MatrixLayout.RowMajor);
+                                }
+                                else
+                                {
+                                    NativeMethods.lstm_gradient(
+                                        tt,
+                                        numberOfNeurons,
+                                        u.Weights,
+                                        u.Gradient,
+                                        g.Weights,
+                                        g.Gradient,
+                                        s.Weights,
+                                        s.Gradient,
+                                        h.Weights,
+                                        h.Gradient,
+                                        true,
+                                        matrixLayout == MatrixLayout.RowMajor);
+                                }
+                            });
+                    }
+
+                    return h;
+                });
+        }
+
+        /// <summary>
+        /// Computes LSTM (long short-term memory) cell using hidden weights packed by <see cref="PackedRNNWeights.PackLSTM"/>.
+        /// The operation does not calculate gradients, use <see cref="LSTM(Session, Tensor, Tensor, Tensor, Tensor, RNNDirection, int, float, MatrixLayout)"/> for training.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="u">The packed hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
+        /// <param name="direction">The cell direction (forward-only or bi-directional).</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="forgetBias">The bias to add to forget gates.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/> and <paramref name="b"/> are row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        public static Tensor LSTM(
+            this Session session,
+            Tensor x,
+            Tensor w,
+            PackedRNNWeights u,
+            Tensor b,
+            RNNDirection direction,
+            int numberOfNeurons,
+            float forgetBias,
+            MatrixLayout matrixLayout)
+        {
+            const string ActionName = "lstm packed";
+
+            if (direction != RNNDirection.ForwardOnly)
+            {
+                throw new NotSupportedException("The packed LSTM supports forward-only cells.");
+            }
+
+            if (session.CalculateGradients)
+            {
+                throw new InvalidOperationException("The packed LSTM does not calculate gradients.");
+            }
+
+            // calculate gates = W * x + b
+            Tensor g = session.FullyConnected(x, w, b, matrixLayout);
+
+            int tt = g.Shape.GetAxis(0);                  // number of vectors in time sequence
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    Tensor h = session.AllocateTensor(ActionName, new Shape(new int[] { tt, numberOfNeurons }), false);
+                    Tensor s = session.AllocateTensor("lstm cell", h.Shape, false);
+
+                    NativeMethods.lstm_packed(
+                        tt,
+                        numberOfNeurons,
+                        u,
+                        g.Weights,
+                        s.Weights,
+                        h.Weights,
+                        forgetBias,
+                        true);
+
+                    return h;
+                });
+        }
+
+        /// <summary>
+        /// Computes LSTM (long short-term memory) cell over a mini-batch of sequences.
+        /// The sequences may have different lengths; the recurrent products of all sequences are computed as one matrix multiplication per time step.
+        /// The operation does not calculate gradients, use <see cref="LSTM(Session, Tensor, Tensor, Tensor, Tensor, RNNDirection, int, float, MatrixLayout)"/> for training.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="xs">The tensors that contain the sequences.</param>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
+        /// <param name="direction">The cell direction (forward-only or bi-directional).</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="forgetBias">The bias to add to forget gates.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/>, <paramref name="b"/>, and <paramref name="u"/> are row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> objects that contain computed data, one for each sequence in <paramref name="xs"/>.
+        /// </returns>
+        public static Tensor[] LSTM(
+            this Session session,
+            IList<Tensor> xs,
+            Tensor w,
+            Tensor u,
+            Tensor b,
+            RNNDirection direction,
+            int numberOfNeurons,
+            float forgetBias,
+            MatrixLayout matrixLayout)
+        {
+            const string ActionName = "lstm batch";
+
+            if (direction != RNNDirection.ForwardOnly)
+            {
+                throw new NotSupportedException("The batch LSTM supports forward-only cells.");
+            }
+
+            if (session.CalculateGradients)
+            {
+                throw new InvalidOperationException("The batch LSTM does not calculate gradients.");
+            }
+
+            // calculate gates = W * x + b
+            Tensor[] gs = xs.Select(x => session.FullyConnected(x, w, b, matrixLayout)).ToArray();
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    int batch = gs.Length;
+                    int glen = 4 * numberOfNeurons;
+
+                    int[] lengths = gs.Select(x => x.Shape.GetAxis(0)).ToArray();
+                    int steps = batch > 0 ? lengths.Max() : 0;
+
+                    // the native kernel takes the sequences interleaved by time step
+                    float[] g = new float[steps * batch * glen];
+                    for (int i = 0; i < batch; i++)
+                    {
+                        for (int t = 0; t < lengths[i]; t++)
+                        {
+                            Array.Copy(gs[i].Weights, t * glen, g, ((t * batch) + i) * glen, glen);
+                        }
+                    }
+
+                    float[] s = new float[steps * batch * numberOfNeurons];
+                    float[] y = new float[steps * batch * numberOfNeurons];
+
+                    NativeMethods.lstm_batch(
+                        steps,
+                        batch,
+                        numberOfNeurons,
+                        lengths,
+                        u.Weights,
+                        g,
+                        s,
+                        y,
+                        forgetBias,
+                        true,
+                        matrixLayout == MatrixLayout.RowMajor);
+
+                    Tensor[] hs = new Tensor[batch];
+                    for (int i = 0; i < batch; i++)
+                    {
+                        hs[i] = session.AllocateTensor(ActionName, new Shape(new int[] { lengths[i], numberOfNeurons }), false);
+
+                        for (int t = 0; t < lengths[i]; t++)
+                        {
+                            Array.Copy(y, ((t * batch) + i) * numberOfNeurons, hs[i].Weights, t * numberOfNeurons, numberOfNeurons);
+                        }
+                    }
+
+                    return hs;
+                });
+        }
+
+        /// <summary>
+        /// Computes GRU (gated recurrent unit) cell.
+        /// </summary>
+        /// <param name="session">The scope that executes this operation.</param>
+        /// <param name="x">The tensor that contains the data.</param>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
+        /// <param name="direction">The cell direction (forward-only or bi-directional).</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/>, <paramref name="b"/>, and <paramref name="u"/> are row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="Tensor"/> that contains computed data.
+        /// </returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static Tensor GRU(
+            this Session session,
+            Tensor x,
+            Tensor w,
+            Tensor u,
+            Tensor b,
+            RNNDirection direction,
+            int numberOfNeurons,
+            MatrixLayout matrixLayout)
+        {
+            const string ActionName = "gru";
+
+            // calculate gates = W * x + b
+            Tensor g = session.FullyConnected(x, w, b, matrixLayout);
+
+            int tt = g.Shape.GetAxis(0);                  // number of vectors in time sequence
+
+            return session.RunOperation(
+                ActionName,
+                () =>
+                {
+                    bool calculateGradient = session.CalculateGradients;
+
+                    Tensor h = session.AllocateTensor(ActionName, new Shape(new int[] { tt, numberOfNeurons }), calculateGradient);
 
-                    NativeMethods.lstm(
+                    NativeMethods.gru(
                         tt,
                         numberOfNeurons,
                         u.Weights,
                         g.Weights,
-                        s.Weights,
                         h.Weights,
-                        forgetBias,
-                        true, ////direction == RNNDirection.BiDirectional,
+                        direction == RNNDirection.BiDirectional,
                         matrixLayout == MatrixLayout.RowMajor);
 
                     if (calculateGradient)
@@ -807,18 +1519,16 @@ namespace Genix.DNN
                             ActionName,
                             () =>
                             {
-                                NativeMethods.lstm_gradient(
+                                NativeMethods.gru_gradient(
                                     tt,
                                     numberOfNeurons,
                                     u.Weights,
                                     u.Gradient,
                                     g.Weights,
                                     g.Gradient,
-                                    s.Weights,
-                                    s.Gradient,
                                     h.Weights,
                                     h.Gradient,
-                                    true, ////direction == RNNDirection.BiDirectional,
+                                    direction == RNNDirection.BiDirectional,
                                     matrixLayout == MatrixLayout.RowMajor);
                             });
                     }
@@ -828,31 +1538,36 @@ namespace Genix.DNN
         }
 
         /// <summary>
-        /// Computes GRU (gated recurrent unit) cell.
+        /// Computes GRU (gated recurrent unit) cell using hidden weights packed by <see cref="PackedRNNWeights.PackGRU"/>.
+        /// The operation does not calculate gradients, use <see cref="GRU(Session, Tensor, Tensor, Tensor, Tensor, RNNDirection, int, MatrixLayout)"/> for training.
         /// </summary>
         /// <param name="session">The scope that executes this operation.</param>
         /// <param name="x">The tensor that contains the data.</param>
         /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
-        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="u">The packed hidden weights matrix <paramref name="u"/>.</param>
         /// <param name="b">The tensor that contains the bias vector <paramref name="b"/> to add to each column of matrix <paramref name="w"/>. Can be null.</param>
         /// <param name="direction">The cell direction (forward-only or bi-directional).</param>
         /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
-        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/>, <paramref name="b"/>, and <paramref name="u"/> are row-major or column-major.</param>
+        /// <param name="matrixLayout">Specifies whether the matrices <paramref name="w"/> and <paramref name="b"/> are row-major or column-major.</param>
         /// <returns>
         /// The <see cref="Tensor"/> that contains computed data.
         /// </returns>
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public static Tensor GRU(
             this Session session,
             Tensor x,
             Tensor w,
-            Tensor u,
+            PackedRNNWeights u,
             Tensor b,
             RNNDirection direction,
             int numberOfNeurons,
             MatrixLayout matrixLayout)
         {
-            const string ActionName = "gru";
+            const string ActionName = "gru packed";
+
+            if (session.CalculateGradients)
+            {
+                throw new InvalidOperationException("The packed GRU does not calculate gradients.");
+            }
 
             // calculate gates = W * x + b
             Tensor g = session.FullyConnected(x, w, b, matrixLayout);
@@ -863,38 +1578,15 @@ namespace Genix.DNN
                 ActionName,
                 () =>
                 {
-                    bool calculateGradient = session.CalculateGradients;
-
-                    Tensor h = session.AllocateTensor(ActionName, new Shape(new int[] { tt, numberOfNeurons }), calculateGradient);
+                    Tensor h = session.AllocateTensor(ActionName, new Shape(new int[] { tt, numberOfNeurons }), false);
 
-                    NativeMethods.gru(
+                    NativeMethods.gru_packed(
                         tt,
                         numberOfNeurons,
-                        u.Weights,
+                        u,
                         g.Weights,
                         h.Weights,
-                        direction == RNNDirection.BiDirectional,
-                        matrixLayout == MatrixLayout.RowMajor);
-
-                    if (calculateGradient)
-                    {
-                        session.Push(
-                            ActionName,
-                            () =>
-                            {
-                                NativeMethods.gru_gradient(
-                                    tt,
-                                    numberOfNeurons,
-                                    u.Weights,
-                                    u.Gradient,
-                                    g.Weights,
-                                    g.Gradient,
-                                    h.Weights,
-                                    h.Gradient,
-                                    direction == RNNDirection.BiDirectional,
-                                    matrixLayout == MatrixLayout.RowMajor);
-                            });
-                    }
+                        direction == RNNDirection.BiDirectional);
 
                     return h;
                 });
@@ -947,33 +1639,37 @@ namespace Genix.DNN
         }
 
         /// <summary>
-        /// The local response normalization kernel.
+        /// Returns the axes and strides the native adaptive pooling works with.
+        /// The native code pools over the axes 1 and 2, the channels are the innermost dimension.
         /// </summary>
-        /// <param name="axes">The input tensor dimensions.</param>
-        /// <param name="strides">The input tensor strides.</param>
-        /// <param name="xw">The input tensor weights.</param>
-        /// <param name="yw">The output tensor weights.</param>
-        /// <param name="kernelSize">The number of channels to normalize across. Should be odd number.</param>
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private static void LRNKernel(int[] axes, int[] strides, float[] xw, float[] yw, int kernelSize)
+        /// <param name="x">The input tensor.</param>
+        /// <param name="y">The output tensor.</param>
+        /// <param name="xaxes">The axes of the input tensor.</param>
+        /// <param name="xstrides">The strides of the input tensor.</param>
+        /// <param name="yaxes">The axes of the output tensor.</param>
+        /// <param name="ystrides">The strides of the output tensor.</param>
+        private static void GetAdaptivePoolingAxes(Tensor x, Tensor y, out int[] xaxes, out int[] xstrides, out int[] yaxes, out int[] ystrides)
         {
-            CommonParallel.For(
-                0,
-                axes[0],
-                (a, b) =>
-                {
-                    for (; a < b; a++)
-                    {
-                        NativeMethods.LRNKernel(
-                            xw,
-                            yw,
-                            kernelSize,
-                            a,
-                            axes,
-                            strides);
-                    }
-                },
-                new ParallelOptions());
+            switch (x.Shape.Format)
+            {
+                case Shape.BWHC:
+                case Shape.BHWC:
+                    xaxes = x.Axes;
+                    xstrides = x.Strides;
+                    yaxes = y.Axes;
+                    ystrides = y.Strides;
+                    break;
+
+                case Shape.BCHW:
+                    xaxes = new[] { x.Axes[0] * x.Axes[1], x.Axes[2], x.Axes[3] };
+                    xstrides = new[] { x.Strides[1], x.Strides[2], x.Strides[3] };
+                    yaxes = new[] { y.Axes[0] * y.Axes[1], y.Axes[2], y.Axes[3] };
+                    ystrides = new[] { y.Strides[1], y.Strides[2], y.Strides[3] };
+                    break;
+
+                default:
+                    throw new NotSupportedException("The tensor shape is not supported by this operation.");
+            }
         }
 
         [SuppressUnmanagedCodeSecurity]
@@ -982,13 +1678,29 @@ namespace Genix.DNN
             private const string DllName = "Genix.DNN.Native.dll";
 
             [DllImport(NativeMethods.DllName)]
-            public static extern void LRNKernel(
-                [In] float[] x,
-                [In] float[] y,
+            public static extern void lrn(
+                int kernelSize,
+                float alpha,
+                float beta,
+                float k,
+                [In] float[] xw,
+                [In] int[] axes,
+                [In] int[] strides,
+                [Out] float[] scalew,
+                [Out] float[] yw);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void lrn_gradient(
                 int kernelSize,
-                int b,
+                float alpha,
+                float beta,
+                [In] float[] xw,
+                [In, Out] float[] dxw,
                 [In] int[] axes,
-                [In] int[] strides);
+                [In] int[] strides,
+                [In] float[] scalew,
+                [In] float[] yw,
+                [In] float[] dyw);
 
             [DllImport(NativeMethods.DllName)]
             public static extern void maxpooling(
@@ -1022,6 +1734,108 @@ namespace Genix.DNN
                 [In] int[] yaxes,
                 [In] int[] ystrides);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void maxpooling_indices_u8(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                [In] float[] xw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [Out] float[] yw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                [Out] byte[] indices);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void maxpooling_indices_s32(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                [In] float[] xw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [Out] float[] yw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                [Out] int[] indices);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void maxpooling_gradient_indices_u8(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                [In, Out] float[] dxw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [In] float[] dyw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                [In] byte[] indices);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void maxpooling_gradient_indices_s32(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                [In, Out] float[] dxw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [In] float[] dyw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                [In] int[] indices);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void adaptive_avgpooling(
+                [In] float[] xw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [Out] float[] yw,
+                [In] int[] yaxes,
+                [In] int[] ystrides);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void adaptive_avgpooling_gradient(
+                [In, Out] float[] dxw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [In] float[] dyw,
+                [In] int[] yaxes,
+                [In] int[] ystrides);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void adaptive_maxpooling(
+                [In] float[] xw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [Out] float[] yw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                [Out] int[] indices);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void adaptive_maxpooling_gradient(
+                [In, Out] float[] dxw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [In] float[] dyw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                [In] int[] indices);
+
             [DllImport(NativeMethods.DllName)]
             public static extern void avgpooling(
                 int ksize1,
@@ -1069,7 +1883,10 @@ namespace Genix.DNN
                 [In] int[] xstrides,
                 [Out] float[] yw,
                 [In] int[] yaxes,
-                [In] int[] ystrides);
+                [In] int[] ystrides,
+                ConvolutionAlgorithm algorithm,
+                WinogradFilters filters,
+                ConvolutionPlan plan);
 
             [DllImport(NativeMethods.DllName)]
             public static extern void convolution_gradient(
@@ -1090,8 +1907,93 @@ namespace Genix.DNN
                 [In] int[] xstrides,
                 [In] float[] dyw,
                 [In] int[] yaxes,
+                [In] int[] ystrides,
+                ConvolutionAlgorithm algorithm,
+                WinogradFilters filters);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void group_convolution(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                int groups,
+                [In] float[] ww,
+                [In] float[] bw,
+                [In] int[] waxes,
+                [In] int[] wstrides,
+                [In] float[] xw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [Out] float[] yw,
+                [In] int[] yaxes,
+                [In] int[] ystrides);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void group_convolution_gradient(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                int groups,
+                [In] float[] ww,
+                [Out] float[] dww,
+                [Out] float[] dbw,
+                [In] int[] waxes,
+                [In] int[] wstrides,
+                [In] float[] xw,
+                [Out] float[] dxw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [In] float[] dyw,
+                [In] int[] yaxes,
                 [In] int[] ystrides);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void quantized_convolution(
+                int ksize1,
+                int ksize2,
+                int kstride1,
+                int kstride2,
+                int kpadding1,
+                int kpadding2,
+                QuantizedWeights weights,
+                [In] float[] bw,
+                [In] float[] xw,
+                [In] int[] xaxes,
+                [In] int[] xstrides,
+                [Out] float[] yw,
+                [In] int[] yaxes,
+                [In] int[] ystrides,
+                float xscale,
+                int xzero);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void quantized_fully_connected(
+                int m,
+                int k,
+                int n,
+                QuantizedWeights weights,
+                [In] float[] bw,
+                [In] float[] xw,
+                [Out] float[] yw,
+                float xscale,
+                int xzero);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void half_fully_connected(
+                int m,
+                int k,
+                int n,
+                HalfPrecisionWeights weights,
+                [In] float[] bw,
+                [In] float[] xw,
+                [Out] float[] yw);
+
             [DllImport(NativeMethods.DllName)]
             public static extern void lstm(
                 int steps,
@@ -1104,6 +2006,56 @@ namespace Genix.DNN
                 [MarshalAs(UnmanagedType.Bool)] bool forward,
                 [MarshalAs(UnmanagedType.Bool)] bool rowmajor);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void lstm_batch(
+                int steps,
+                int batch,
+                int ylen,
+                [In] int[] lengths,
+                [In] float[] u,
+                [Out] float[] g,
+                [Out] float[] s,
+                [Out] float[] y,
+                float forgetBias,
+                [MarshalAs(UnmanagedType.Bool)] bool forward,
+                [MarshalAs(UnmanagedType.Bool)] bool rowmajor);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void lstm_packed(
+                int steps,
+                int ylen,
+                PackedRNNWeights u,
+                [Out] float[] g,
+                [Out] float[] s,
+                [Out] float[] y,
+                float forgetBias,
+                [MarshalAs(UnmanagedType.Bool)] bool forward);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void lstm_bidirectional(
+                int steps,
+                int ylen,
+                [In] float[] u,
+                [Out] float[] g,
+                [Out] float[] s,
+                [Out] float[] y,
+                float forgetBias,
+                [MarshalAs(UnmanagedType.Bool)] bool rowmajor);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void lstm_bidirectional_gradient(
+                int steps,
+                int ylen,
+                [In] float[] u,
+                [Out] float[] du,
+                [In] float[] g,
+                [Out] float[] dg,
+                [In] float[] s,
+                [Out] float[] ds,
+                [In] float[] y,
+                [Out] float[] dy,
+                [MarshalAs(UnmanagedType.Bool)] bool rowmajor);
+
             [DllImport(NativeMethods.DllName)]
             public static extern void lstm_gradient(
                 int steps,
@@ -1129,6 +2081,15 @@ namespace Genix.DNN
                 [MarshalAs(UnmanagedType.Bool)] bool bidirectional,
                 [MarshalAs(UnmanagedType.Bool)] bool rowmajor);
 
+            [DllImport(NativeMethods.DllName)]
+            public static extern void gru_packed(
+                int steps,
+                int ylen,
+                PackedRNNWeights u,
+                [In] float[] g,
+                [Out] float[] y,
+                [MarshalAs(UnmanagedType.Bool)] bool bidirectional);
+
             [DllImport(NativeMethods.DllName)]
             public static extern void gru_gradient(
                 int steps,
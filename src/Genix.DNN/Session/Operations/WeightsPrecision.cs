@@ -0,0 +1,33 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="WeightsPrecision.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    /// <summary>
+    /// Defines the format the weights are stored in for inference.
+    /// </summary>
+    /// <remarks>
+    /// The weights stored in 16 bits are converted to single precision as they are read,
+    /// and the results are accumulated in single precision.
+    /// </remarks>
+    public enum WeightsPrecision
+    {
+        /// <summary>
+        /// The weights are stored in single precision.
+        /// </summary>
+        Single = 0,
+
+        /// <summary>
+        /// The weights are stored in IEEE half precision: 11 bits of precision and the range of ±65504.
+        /// </summary>
+        Half = 1,
+
+        /// <summary>
+        /// The weights are stored in bfloat16: 8 bits of precision and the range of single precision.
+        /// </summary>
+        BFloat16 = 2,
+    }
+}
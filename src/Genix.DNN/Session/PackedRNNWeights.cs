@@ -0,0 +1,146 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="PackedRNNWeights.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using System.Runtime.ConstrainedExecution;
+    using System.Runtime.InteropServices;
+    using System.Security;
+    using System.Security.Permissions;
+    using Genix.MachineLearning;
+
+    /// <summary>
+    /// Represents hidden weights of a recurrent cell packed for repeated inference.
+    /// </summary>
+    /// <remarks>
+    /// The weights are copied into a layout that the native kernels read sequentially at every time step.
+    /// The packed weights do not follow the changes in the source tensor; pack them again after training.
+    /// The weights stored in 16 bits (see <see cref="WeightsPrecision"/>) take half the memory bandwidth at every time step.
+    /// </remarks>
+    public sealed class PackedRNNWeights : SafeHandle
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="PackedRNNWeights"/> class.
+        /// </summary>
+        [SecurityPermission(SecurityAction.InheritanceDemand, UnmanagedCode = true)]
+        [SecurityPermission(SecurityAction.Demand, UnmanagedCode = true)]
+        private PackedRNNWeights()
+            : base(IntPtr.Zero, true)
+        {
+        }
+
+        /// <inheritdoc />
+        public override bool IsInvalid => this.handle == IntPtr.Zero;
+
+        /// <summary>
+        /// Packs the hidden weights of LSTM cell.
+        /// </summary>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrix <paramref name="u"/> is row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="PackedRNNWeights"/> object that contains packed weights.
+        /// </returns>
+        public static PackedRNNWeights PackLSTM(Tensor u, int numberOfNeurons, MatrixLayout matrixLayout)
+        {
+            return PackedRNNWeights.PackLSTM(u, numberOfNeurons, matrixLayout, WeightsPrecision.Single);
+        }
+
+        /// <summary>
+        /// Packs the hidden weights of LSTM cell in the specified precision.
+        /// </summary>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrix <paramref name="u"/> is row-major or column-major.</param>
+        /// <param name="precision">The format to store the weights in.</param>
+        /// <returns>
+        /// The <see cref="PackedRNNWeights"/> object that contains packed weights.
+        /// </returns>
+        public static PackedRNNWeights PackLSTM(Tensor u, int numberOfNeurons, MatrixLayout matrixLayout, WeightsPrecision precision)
+        {
+            if (u == null)
+            {
+                throw new ArgumentNullException(nameof(u));
+            }
+
+            return NativeMethods.lstm_pack(numberOfNeurons, u.Weights, matrixLayout == MatrixLayout.RowMajor, precision);
+        }
+
+        /// <summary>
+        /// Packs the hidden weights of GRU cell.
+        /// </summary>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="direction">The cell direction (forward-only or bi-directional).</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrix <paramref name="u"/> is row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="PackedRNNWeights"/> object that contains packed weights.
+        /// </returns>
+        public static PackedRNNWeights PackGRU(Tensor u, RNNDirection direction, int numberOfNeurons, MatrixLayout matrixLayout)
+        {
+            return PackedRNNWeights.PackGRU(u, direction, numberOfNeurons, matrixLayout, WeightsPrecision.Single);
+        }
+
+        /// <summary>
+        /// Packs the hidden weights of GRU cell in the specified precision.
+        /// </summary>
+        /// <param name="u">The tensor that contains the hidden weights matrix <paramref name="u"/>.</param>
+        /// <param name="direction">The cell direction (forward-only or bi-directional).</param>
+        /// <param name="numberOfNeurons">The number of neurons in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrix <paramref name="u"/> is row-major or column-major.</param>
+        /// <param name="precision">The format to store the weights in.</param>
+        /// <returns>
+        /// The <see cref="PackedRNNWeights"/> object that contains packed weights.
+        /// </returns>
+        public static PackedRNNWeights PackGRU(Tensor u, RNNDirection direction, int numberOfNeurons, MatrixLayout matrixLayout, WeightsPrecision precision)
+        {
+            if (u == null)
+            {
+                throw new ArgumentNullException(nameof(u));
+            }
+
+            return NativeMethods.gru_pack(
+                numberOfNeurons,
+                u.Weights,
+                direction == RNNDirection.BiDirectional,
+                matrixLayout == MatrixLayout.RowMajor,
+                precision);
+        }
+
+        /// <inheritdoc />
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.MayFail)]
+        protected override bool ReleaseHandle()
+        {
+            NativeMethods.rnn_weights_free(this.handle);
+            return true;
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.DNN.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern PackedRNNWeights lstm_pack(
+                int ylen,
+                [In] float[] u,
+                [MarshalAs(UnmanagedType.Bool)] bool rowmajor,
+                WeightsPrecision precision);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern PackedRNNWeights gru_pack(
+                int ylen,
+                [In] float[] u,
+                [MarshalAs(UnmanagedType.Bool)] bool bidirectional,
+                [MarshalAs(UnmanagedType.Bool)] bool rowmajor,
+                WeightsPrecision precision);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void rnn_weights_free(IntPtr weights);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="QuantizedWeights.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using System.Runtime.ConstrainedExecution;
+    using System.Runtime.InteropServices;
+    using System.Security;
+    using System.Security.Permissions;
+    using Genix.MachineLearning;
+
+    /// <summary>
+    /// Represents the weights of a convolution or fully connected layer quantized to signed bytes for 8-bit inference.
+    /// </summary>
+    /// <remarks>
+    /// The quantized weights do not follow the changes in the source tensor; quantize them again after training.
+    /// </remarks>
+    public sealed class QuantizedWeights : SafeHandle
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="QuantizedWeights"/> class.
+        /// </summary>
+        [SecurityPermission(SecurityAction.InheritanceDemand, UnmanagedCode = true)]
+        [SecurityPermission(SecurityAction.Demand, UnmanagedCode = true)]
+        private QuantizedWeights()
+            : base(IntPtr.Zero, true)
+        {
+        }
+
+        /// <inheritdoc />
+        public override bool IsInvalid => this.handle == IntPtr.Zero;
+
+        /// <summary>
+        /// Quantizes the weights of a layer, one scale per neuron.
+        /// </summary>
+        /// <param name="w">The tensor that contains the weights matrix <paramref name="w"/>.</param>
+        /// <param name="numberOfNeurons">The number of neurons (filters) in the layer.</param>
+        /// <param name="matrixLayout">Specifies whether the matrix <paramref name="w"/> is row-major or column-major.</param>
+        /// <returns>
+        /// The <see cref="QuantizedWeights"/> object that contains quantized weights.
+        /// </returns>
+        public static QuantizedWeights Pack(Tensor w, int numberOfNeurons, MatrixLayout matrixLayout)
+        {
+            if (w == null)
+            {
+                throw new ArgumentNullException(nameof(w));
+            }
+
+            return NativeMethods.quantized_weights_pack(
+                w.Length / numberOfNeurons,
+                numberOfNeurons,
+                w.Weights,
+                matrixLayout == MatrixLayout.ColumnMajor);
+        }
+
+        /// <inheritdoc />
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.MayFail)]
+        protected override bool ReleaseHandle()
+        {
+            NativeMethods.quantized_weights_free(this.handle);
+            return true;
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.DNN.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern QuantizedWeights quantized_weights_pack(
+                int k,
+                int f,
+                [In] float[] w,
+                [MarshalAs(UnmanagedType.Bool)] bool transposed);
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void quantized_weights_free(IntPtr filters);
+        }
+    }
+}
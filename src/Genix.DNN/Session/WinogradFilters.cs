@@ -0,0 +1,76 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="WinogradFilters.cs" company="Noname, Inc.">
+// Copyright (c) 2018, Alexander Volgunin. All rights reserved.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Genix.DNN
+{
+    using System;
+    using System.Runtime.CompilerServices;
+    using System.Runtime.ConstrainedExecution;
+    using System.Runtime.InteropServices;
+    using System.Security;
+    using System.Security.Permissions;
+    using Genix.MachineLearning;
+
+    /// <summary>
+    /// Represents the filters of a convolution layer transformed for Winograd convolution.
+    /// </summary>
+    /// <remarks>
+    /// The native code keeps a copy of the weights the filters were transformed from,
+    /// so the filters are transformed again only after the weights change.
+    /// </remarks>
+    internal sealed class WinogradFilters : SafeHandle
+    {
+        /// <summary>
+        /// The transformed filters of the weight tensors, released together with the tensors.
+        /// </summary>
+        private static readonly ConditionalWeakTable<Tensor, WinogradFilters> Cache = new ConditionalWeakTable<Tensor, WinogradFilters>();
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="WinogradFilters"/> class.
+        /// </summary>
+        [SecurityPermission(SecurityAction.InheritanceDemand, UnmanagedCode = true)]
+        [SecurityPermission(SecurityAction.Demand, UnmanagedCode = true)]
+        private WinogradFilters()
+            : base(IntPtr.Zero, true)
+        {
+        }
+
+        /// <inheritdoc />
+        public override bool IsInvalid => this.handle == IntPtr.Zero;
+
+        /// <summary>
+        /// Returns the transformed filters of the specified weights.
+        /// </summary>
+        /// <param name="w">The tensor that contains the weights of the convolution layer.</param>
+        /// <returns>
+        /// The <see cref="WinogradFilters"/> object associated with <paramref name="w"/>.
+        /// </returns>
+        public static WinogradFilters FromWeights(Tensor w)
+        {
+            return WinogradFilters.Cache.GetValue(w, _ => NativeMethods.winograd_filters_create());
+        }
+
+        /// <inheritdoc />
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.MayFail)]
+        protected override bool ReleaseHandle()
+        {
+            NativeMethods.winograd_filters_free(this.handle);
+            return true;
+        }
+
+        [SuppressUnmanagedCodeSecurity]
+        private static class NativeMethods
+        {
+            private const string DllName = "Genix.DNN.Native.dll";
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern WinogradFilters winograd_filters_create();
+
+            [DllImport(NativeMethods.DllName)]
+            public static extern void winograd_filters_free(IntPtr filters);
+        }
+    }
+}
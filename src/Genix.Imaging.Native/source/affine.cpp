@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include <stdio.h>
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -75,7 +77,7 @@ GENIXAPI(int, affine)(
 
 	/* Work buffer size */
 	check_sts(status = ippiWarpGetBufferSize(pSpec, dstSize, &bufSize));
-	pBuffer = ippsMalloc_8u(bufSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufSize);
 
 	/* Function call */
 	switch (bitsPerPixel)
@@ -123,7 +125,7 @@ GENIXAPI(int, affine)(
 
 	EXIT_MAIN
 	ippsFree(pSpec);
-	ippsFree(pBuffer);
+	::scratch_pop(pBuffer);
 	return (int)status;
 }
 
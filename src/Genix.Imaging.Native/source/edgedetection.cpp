@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -47,7 +49,7 @@ GENIXAPI(int, canny)(
 	/* Find maximum buffer size and allocate buffer */
 	if (bufSizeSobV > bufSize) bufSize = bufSizeSobV;
 	if (bufSizeSobH > bufSize) bufSize = bufSizeSobH;
-	pBuffer = ippsMalloc_8u(bufSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufSize);
 
 	/* Allocate buffers for derivatives */
 	dx = ippiMalloc_16s_C1(width, height, &stridedx);
@@ -92,6 +94,6 @@ GENIXAPI(int, canny)(
 	EXIT_MAIN
 	ippiFree(dy);
 	ippiFree(dx);
-	ippiFree(pBuffer);
+	::scratch_pop(pBuffer);
 	return (int)status;
 }
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -50,7 +52,7 @@ GENIXAPI(int, filterRectangular)(
 		&specSize,
 		&bufferSize));
 	pSpec = (IppiFilterBorderSpec *)ippsMalloc_8u(specSize);
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Initialize filter */
 	check_sts(status = ippiFilterBorderInit_32f(
@@ -105,7 +107,7 @@ GENIXAPI(int, filterRectangular)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	ippsFree(pSpec);
 	return (int)status;
 }
@@ -138,7 +140,7 @@ GENIXAPI(int, filterBox)(
 		ipp8u,
 		bitsPerPixel / 8,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -184,7 +186,7 @@ GENIXAPI(int, filterBox)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -219,7 +221,7 @@ GENIXAPI(int, filterGaussian)(
 		&specSize,
 		&bufferSize));
 	pSpec = (IppFilterGaussianSpec *)ippsMalloc_8u(specSize);
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Initialize filter */
 	check_sts(status = ippiFilterGaussianInit(
@@ -261,7 +263,7 @@ GENIXAPI(int, filterGaussian)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	ippsFree(pSpec);
 	return (int)status;
 }
@@ -296,7 +298,7 @@ GENIXAPI(int, filterLaplace)(
 		ipp8u,
 		bitsPerPixel / 8,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -342,7 +344,7 @@ GENIXAPI(int, filterLaplace)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -400,7 +402,7 @@ GENIXAPI(int, filterSobel)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -447,7 +449,7 @@ GENIXAPI(int, filterSobelHoriz)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -494,7 +496,7 @@ GENIXAPI(int, filterSobelHorizSecond)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -541,7 +543,7 @@ GENIXAPI(int, filterSobelVert)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -588,7 +590,7 @@ GENIXAPI(int, filterSobelNegVert)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -635,7 +637,7 @@ GENIXAPI(int, filterSobelVertSecond)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -679,7 +681,7 @@ GENIXAPI(int, filterSobelCross)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -709,7 +711,7 @@ GENIXAPI(int, filterWiener)(
 		maskSize,
 		bitsPerPixel / 8,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -755,7 +757,7 @@ GENIXAPI(int, filterWiener)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -789,7 +791,7 @@ GENIXAPI(int, filterHipass)(
 		ipp8u,
 		bitsPerPixel / 8,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -835,7 +837,7 @@ GENIXAPI(int, filterHipass)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -866,7 +868,7 @@ GENIXAPI(int, filterLowpass)(
 		roiSize,
 		mask,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -886,7 +888,7 @@ GENIXAPI(int, filterLowpass)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -922,7 +924,7 @@ GENIXAPI(int, filterSumWindow)(
 		ipp8u,
 		bitsPerPixel / 8,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -968,7 +970,7 @@ GENIXAPI(int, filterSumWindow)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -1004,7 +1006,7 @@ GENIXAPI(int, filterSumWindow_32f)(
 		ipp32f,
 		numberOfChannels,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (numberOfChannels)
@@ -1050,7 +1052,7 @@ GENIXAPI(int, filterSumWindow_32f)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -1086,7 +1088,7 @@ GENIXAPI(int, filterMax)(
 		ipp8u,
 		bitsPerPixel / 8,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (bitsPerPixel)
@@ -1132,7 +1134,7 @@ GENIXAPI(int, filterMax)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -1168,7 +1170,7 @@ GENIXAPI(int, filterMax_32f)(
 		ipp32f,
 		numberOfChannels,
 		&bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Do filtering */
 	switch (numberOfChannels)
@@ -1214,6 +1216,6 @@ GENIXAPI(int, filterMax_32f)(
 	}
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -21,7 +23,7 @@ GENIXAPI(int, gradientVectorPrewitt_f32)(
 
 	/* Allocate buffer */
 	check_sts(status = ippiGradientVectorGetBufferSize(roiSize, maskSize, ipp32f, 1, &bufferSize));
-	pBuffer = ippsMalloc_8u(bufferSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufferSize);
 
 	/* Compute gradient using 3x3 Sobel operator (source ROI at point x=1, y=1) */
 	check_sts(status = ippiGradientVectorPrewitt_32f_C1R(
@@ -43,7 +45,7 @@ GENIXAPI(int, gradientVectorPrewitt_f32)(
 		pBuffer));
 
 	EXIT_MAIN
-		ippsFree(pBuffer);
+		::scratch_pop(pBuffer);
 	return (int)status;
 }
 
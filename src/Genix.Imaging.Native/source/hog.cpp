@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -47,7 +49,7 @@ GENIXAPI(int, hog)(
 
 	/* Compute the temporary work buffer size */
 	check_sts(status = ippiHOGGetBufferSize(pHOGctx, roiSize, &hogBuffSize));
-	pBuffer = ippsMalloc_8u(hogBuffSize);
+	pBuffer = (Ipp8u*)::scratch_push(hogBuffSize);
 
 	/* Compute size of HOG descriptor */
 	check_sts(status = ippiHOGGetDescriptorSize(pHOGctx, &winBuffSize));
@@ -68,7 +70,7 @@ GENIXAPI(int, hog)(
 
 	EXIT_MAIN
 	ippsFree(pHOGctx);
-	ippsFree(pBuffer);
+	::scratch_pop(pBuffer);
 	ippsFree(pDescriptor);
 	return (int)status;
 }
@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include <stdio.h>
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -35,7 +37,7 @@ GENIXAPI(int, houghline)(
 		delta,
 		maxLineCount,
 		&bufSize));
-	pBuffer = ippsMalloc_8u(bufSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufSize);
 
 	check_sts(status = ippiHoughLine_8u32f_C1R(
 		src + (ptrdiff_t(y) * stridesrc) + x,
@@ -52,7 +54,7 @@ GENIXAPI(int, houghline)(
 		// invert image back
 		ippiNot_8u_C1IR(const_cast<Ipp8u*>(src), stridesrc, roiSize);
 
-	ippiFree(pBuffer);
+	::scratch_pop(pBuffer);
 	return (int)status;
 }
 
@@ -86,7 +88,7 @@ GENIXAPI(int, houghprobline)(
 		delta,
 		&specSize,
 		&bufSize));
-	pBuffer = ippsMalloc_8u(bufSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufSize);
 	pSpec = (IppiHoughProbSpec*)ippsMalloc_8u(specSize);
 
 	check_sts(status = ippiHoughProbLineInit_8u32f_C1R(
@@ -113,6 +115,6 @@ GENIXAPI(int, houghprobline)(
 		ippiNot_8u_C1IR(const_cast<Ipp8u*>(src), stridesrc, roiSize);
 
 	ippsFree(pSpec);
-	ippiFree(pBuffer);
+	::scratch_pop(pBuffer);
 	return (int)status;
 }
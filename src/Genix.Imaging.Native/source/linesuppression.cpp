@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -35,7 +37,7 @@ GENIXAPI(int, supresslines)(
 		ipp8u,
 		numChannels,
 		&bufSize));
-	pBuffer = ippsMalloc_8u(bufSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufSize);
 
 	/* Line Suppression processing */
 	check_sts(status = ippiLineSuppression_8u_C1R(
@@ -56,5 +58,6 @@ GENIXAPI(int, supresslines)(
 
 	EXIT_MAIN
 		ippiFree(pFeature);
+	::scratch_pop(pBuffer);
 	return (int)status;
 }
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "ipp.h"
+#include "platform.h"
+#include "scratch.h"
 
 /* Next two defines are created to simplify code reading and understanding */
 #define EXIT_MAIN exitLine:                                  /* Label for Exit */
@@ -99,7 +101,7 @@ GENIXAPI(int, resize)(
 	}
 
 	check_sts(status = ippiResizeGetBufferSize_8u(pSpec, dstSize, bitsPerPixel / 8, &bufSize));
-	pBuffer = ippsMalloc_8u(bufSize);
+	pBuffer = (Ipp8u*)::scratch_push(bufSize);
 
 	/* Function call */
 	if (antialiasing)
@@ -204,7 +206,7 @@ GENIXAPI(int, resize)(
 
 	EXIT_MAIN
 	ippsFree(pSpec);
-	ippsFree(pBuffer);
+	::scratch_pop(pBuffer);
 	return (int)status;
 }
 
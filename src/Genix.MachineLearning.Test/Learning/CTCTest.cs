@@ -172,5 +172,41 @@
             score = loss.Loss(y, labels, true);
             Assert.AreEqual(expected, score, 1e-6);
         }
+
+        [TestMethod, Description("Batch of sequences with different length.")]
+        public void BatchTest()
+        {
+            const int A = 6;    // Alphabet size
+            int[] lengths = { 5, 3, 8, 2 };
+            int[][] labels = { new[] { 0, 1, 1, 0 }, new[] { 2, 3 }, new[] { 1, 2, 3, 4 }, new[] { 1, 1 } };
+
+            Random random = new Random(0);
+            Tensor[] ys = new Tensor[lengths.Length];
+            for (int n = 0; n < ys.Length; n++)
+            {
+                Tensor x = new Tensor(null, new[] { lengths[n], A });
+                for (int i = 0; i < x.Length; i++)
+                {
+                    x.Weights[i] = (float)random.NextDouble();
+                }
+
+                ys[n] = new Tensor(null, x.Axes);
+                Vectors.SoftMax(x.Length, x.Weights, 0, A, ys[n].Weights, 0);
+            }
+
+            CTCLoss loss = new CTCLoss() { BlankLabelIndex = 5 };
+            float[] scores = loss.Loss(ys, labels, true);
+
+            for (int n = 0; n < ys.Length; n++)
+            {
+                Tensor y = ys[n].Clone() as Tensor;
+                float score = loss.Loss(y, labels[n], true);
+
+                Assert.AreEqual(score, scores[n], 1e-5f);
+                Helpers.AreArraysEqual(y.Gradient, ys[n].Gradient);
+            }
+
+            Assert.AreEqual(float.PositiveInfinity, scores[3]);
+        }
     }
 }
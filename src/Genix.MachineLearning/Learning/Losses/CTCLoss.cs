@@ -7,8 +7,10 @@
 namespace Genix.MachineLearning.Learning
 {
     using System;
+    using System.Collections.Generic;
     using System.Diagnostics;
     using System.Diagnostics.CodeAnalysis;
+    using System.Linq;
     using System.Runtime.InteropServices;
     using System.Security;
     using Genix.Core;
@@ -48,146 +50,109 @@ namespace Genix.MachineLearning.Learning
             int A = y.Strides[0];       // Number of classes (alphabet size)
 #pragma warning restore SA1312 // Variable names must begin with lower-case letter
 
-            int[] labels = CTCLoss.InsertBlanks(expected, A, this.BlankLabelIndex, out int repeats);
-            if (L + repeats > T)
-            {
-                if (calculateGradient)
-                {
-                    Vectors.Copy(y.Length, y.Weights, 0, y.Gradient, 0);
-                }
+            CTCLoss.ValidateLabels(expected, A);
+
+            float[] losses = new float[1];
+            NativeMethods.CTCLossBatch(
+                1,
+                T,
+                A,
+                y.Weights,
+                new[] { T },
+                L,
+                expected,
+                new[] { L },
+                this.BlankLabelIndex,
+                losses,
+                calculateGradient ? y.Gradient : null);
+
+            Debug.Assert(!calculateGradient || !float.IsNaN(y.Gradient[0]), "Tensor contains invalid weight.");
+            Debug.Assert(!float.IsNaN(losses[0]), "Calculated loss is invalid.");
+            return losses[0];
+        }
 
-                // not enough elements to compute
-                return float.PositiveInfinity;
+        /// <summary>
+        /// Computes the losses for a batch of sequences.
+        /// </summary>
+        /// <param name="ys">The sequences that have been predicted. The sequences may have different length, but must have the same alphabet size.</param>
+        /// <param name="expected">The expected labels for each sequence.</param>
+        /// <param name="calculateGradient">Determines whether the gradients for <c>ys</c> should be calculated.</param>
+        /// <returns>The loss values for each sequence.</returns>
+        /// <remarks>
+        /// The sequences are padded to the same length and processed in parallel by a single native call.
+        /// </remarks>
+        public float[] Loss(IList<Tensor> ys, IList<int[]> expected, bool calculateGradient)
+        {
+            if (ys == null)
+            {
+                throw new ArgumentNullException(nameof(ys));
             }
 
-#pragma warning disable SA1312 // Variable names must begin with lower-case letter
-            int S = labels.Length;      // Number of labels with blanks
-#pragma warning restore SA1312 // Variable names must begin with lower-case letter
-
-            // convert predicted probabilities into log space
-            float[] ylog = new float[y.Length];
-            Vectors.Log(y.Length, y.Weights, 0, ylog, 0);
-
-            // compute alphas
-            float[] alphas = new float[T * S];
-            ////CTCLoss.CTCComputeAlphas(T, A, S, ylog, labels, alphas);
-            NativeMethods.CTCComputeAlphas(T, A, S, ylog, labels, alphas);
-
-            float logLossA = Mathematics.LogSumExp(alphas[alphas.Length - 1], alphas[alphas.Length - 2]);
-            if (float.IsNegativeInfinity(logLossA))
+            if (expected == null)
             {
-                if (calculateGradient)
-                {
-                    Vectors.Copy(y.Length, y.Weights, 0, y.Gradient, 0);
-                }
-
-                return float.PositiveInfinity;
+                throw new ArgumentNullException(nameof(expected));
             }
 
-            if (calculateGradient)
+            if (ys.Count != expected.Count)
             {
-                // compute betas
-                float[] betas = new float[T * S];
-                NativeMethods.CTCComputeBetas(T, A, S, ylog, labels, betas);
-                ////float logLossB = MKL.LogSumExp(betas.Weights[0], betas.Weights[1]);
-
-                // compute unnormalized gradient
-                Mathematics.Add(alphas.Length, betas, 0, alphas, 0);
-                NativeMethods.CTCReduceAlphasBetas(T, A, S, alphas, labels, y.Gradient);
-                Mathematics.Sub(y.Length, ylog, 0, y.Gradient, 0);
-                Mathematics.SubC(y.Length, logLossA, y.Gradient, 0);
-                Vectors.Exp(y.Length, y.Gradient, 0);
-
-                // remove NaN
-                // NaN may come from various sources (for instance log(y) where y = 0)
-                Arrays.Replace(y.Length, y.Gradient, 0, float.NaN, 0.0f, y.Gradient, 0);
-
-                Debug.Assert(!float.IsNaN(y.Gradient[0]), "Tensor contains invalid weight.");
+                throw new ArgumentException("The number of expected label sequences does not match the number of predicted sequences.");
             }
 
-            Debug.Assert(!float.IsNaN(logLossA), "Calculated loss is invalid.");
-            return -logLossA;
-        }
-
-#pragma warning disable SA1313 // Variable names must begin with lower-case letter
-        private static int[] InsertBlanks(int[] labels, int A, int blankIndex, out int repeats)
-#pragma warning restore SA1313 // Variable names must begin with lower-case letter
-        {
-            repeats = 0;
-
 #pragma warning disable SA1312 // Variable names must begin with lower-case letter
-            int L = labels.Length;      // Number of labels
-            int S = (2 * L) + 1;        // Number of labels with blanks
+            int N = ys.Count;                                       // Number of sequences
+            int T = N > 0 ? ys.Max(x => x.Axes[0]) : 0;             // Maximum number of mini-batches (time)
+            int A = N > 0 ? ys[0].Strides[0] : 0;                   // Number of classes (alphabet size)
+            int L = N > 0 ? expected.Max(x => x?.Length ?? 0) : 0;  // Maximum number of labels
 #pragma warning restore SA1312 // Variable names must begin with lower-case letter
 
-            int[] labelsWithBlanks = new int[S];
+            int[] lengths = new int[N];
+            int[] labelLengths = new int[N];
+            float[] y = new float[N * T * A];
+            int[] labels = new int[N * L];
 
-            for (int i = 0; i < L; i++)
+            for (int n = 0; n < N; n++)
             {
-                int label = labels[i];
-                if (label >= A)
+                Tensor yn = ys[n];
+                if (yn.Strides[0] != A)
                 {
-                    throw new ArgumentException("The label index is greater than alphabet size.");
+                    throw new ArgumentException("All sequences must have the same alphabet size.");
                 }
 
-                if (i > 0 && label == labels[i - 1])
-                {
-                    repeats++;
-                }
+                int[] expectedn = expected[n] ?? throw new ArgumentNullException(nameof(expected));
+                CTCLoss.ValidateLabels(expectedn, A);
 
-                labelsWithBlanks[2 * i] = blankIndex;
-                labelsWithBlanks[(2 * i) + 1] = label;
+                lengths[n] = yn.Axes[0];
+                labelLengths[n] = expectedn.Length;
+                Vectors.Copy(yn.Length, yn.Weights, 0, y, n * T * A);
+                Vectors.Copy(expectedn.Length, expectedn, 0, labels, n * L);
             }
 
-            labelsWithBlanks[S - 1] = blankIndex;
-
-            return labelsWithBlanks;
-        }
-
-        /*private static void CTCComputeAlphas(int T, int A, int S, float[] py, int[] labels, float[] pa)
-        {
-            MKL.Set(S * T, float.NegativeInfinity, pa, 0);
-            ////std::fill(pa, pa + (S * T), -INFINITY);
-
-            int start = MKL.Max(0, S - (2 * T));
-            int end = MKL.Min(2, S);
+            float[] losses = new float[N];
+            float[] dy = calculateGradient ? new float[y.Length] : null;
+            NativeMethods.CTCLossBatch(N, T, A, y, lengths, L, labels, labelLengths, this.BlankLabelIndex, losses, dy);
 
-            for (int i = start; i < end; i++)
+            if (calculateGradient)
             {
-                pa[i] = py[labels[i]];
+                for (int n = 0; n < N; n++)
+                {
+                    Tensor yn = ys[n];
+                    Vectors.Copy(yn.Length, dy, n * T * A, yn.Gradient, 0);
+                }
             }
 
-            int paoff = S;
-            int paoffprev = 0;
-            int pyoff = A;
+            return losses;
+        }
 
-            for (int t = 1; t < T; t++, paoff += S, paoffprev += S, pyoff += A)
+        private static void ValidateLabels(int[] labels, int alphabetSize)
+        {
+            for (int i = 0, ii = labels.Length; i < ii; i++)
             {
-                start = MKL.Max(0, S - (2 * (T - t)));
-                end = MKL.Min(2 * (t + 1), S);
-
-                int i = start;
-
-                if (i == 0)
-                {
-                    pa[paoff + i] = pa[paoffprev + i] + py[pyoff + labels[i]];
-
-                    i++;
-                }
-
-                for (; i < end; i++)
+                if (labels[i] >= alphabetSize)
                 {
-                    if ((i % 2) != 0 && i > 1 && labels[i] != labels[i - 2])
-                    {
-                        pa[paoff + i] = MKL.LogSumExp(pa[paoffprev + i], MKL.LogSumExp(pa[paoffprev + i - 1], pa[paoffprev + i - 2])) + py[pyoff + labels[i]];
-                    }
-                    else
-                    {
-                        pa[paoff + i] = MKL.LogSumExp(pa[paoffprev + i], pa[paoffprev + i - 1]) + py[pyoff + labels[i]];
-                    }
+                    throw new ArgumentException("The label index is greater than alphabet size.");
                 }
             }
-        }*/
+        }
 
         [SuppressUnmanagedCodeSecurity]
         private static class NativeMethods
@@ -195,13 +160,18 @@ namespace Genix.MachineLearning.Learning
             private const string DllName = "Genix.DNN.Native.dll";
 
             [DllImport(NativeMethods.DllName)]
-            public static extern void CTCComputeAlphas(int T, int A, int S, [In] float[] py, [In] int[] labels, [Out] float[] pa);
-
-            [DllImport(NativeMethods.DllName)]
-            public static extern void CTCComputeBetas(int T, int A, int S, [In] float[] py, [In] int[] labels, [Out] float[] pb);
-
-            [DllImport(NativeMethods.DllName)]
-            public static extern void CTCReduceAlphasBetas(int T, int A, int S, [In] float[] pab, [In] int[] labels, [Out] float[] pdy);
+            public static extern void CTCLossBatch(
+                int N,
+                int T,
+                int A,
+                [In] float[] y,
+                [In] int[] lengths,
+                int L,
+                [In] int[] labels,
+                [In] int[] labelLengths,
+                int blank,
+                [Out] float[] losses,
+                [Out] float[] dy);
         }
     }
 }